@@ -0,0 +1,79 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DISTANCE_INFO_H
+#define REACTPHYSICS3D_DISTANCE_INFO_H
+
+// Libraries
+#include <reactphysics3d/mathematics/Vector3.h>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class Collider;
+
+// Structure DistanceInfo
+/**
+ * This structure contains the result of a distance query between two shapes. The
+ * separating axis can be kept between two queries on the same pair of shapes so
+ * that the GJK algorithm starts from the axis found by the previous query.
+ */
+struct DistanceInfo {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Distance between the two shapes (zero if they overlap)
+        decimal distance;
+
+        /// Closest point on the first shape in world-space coordinates
+        Vector3 worldPoint1;
+
+        /// Closest point on the second shape in world-space coordinates
+        Vector3 worldPoint2;
+
+        /// Separating axis from the second shape toward the first shape in world-space
+        /// coordinates. A non-zero axis is used as the starting axis of the next query.
+        Vector3 separatingAxis;
+
+        /// Pointer to the collider of the second shape
+        Collider* collider;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DistanceInfo() : distance(0), worldPoint1(0, 0, 0), worldPoint2(0, 0, 0), separatingAxis(0, 0, 0), collider(nullptr) {
+
+        }
+
+        /// Destructor
+        ~DistanceInfo() = default;
+};
+
+}
+
+#endif
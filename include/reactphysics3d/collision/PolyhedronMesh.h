@@ -43,8 +43,56 @@ class PolygonVertexArray;
  */
 class PolyhedronMesh {
 
+    public:
+
+        /// Coordinates of the vertices, faces and edges of the mesh with one array per coordinate.
+        /// The edge i of the mesh is made of the twin half-edges 2*i and 2*i+1 of the half-edge structure.
+        struct FeaturesArrays {
+
+            /// Coordinates of the vertices
+            decimal* verticesX;
+            decimal* verticesY;
+            decimal* verticesZ;
+
+            /// Normals of the faces
+            decimal* facesNormalsX;
+            decimal* facesNormalsY;
+            decimal* facesNormalsZ;
+
+            /// Coordinates of a vertex of each face
+            decimal* facesPointsX;
+            decimal* facesPointsY;
+            decimal* facesPointsZ;
+
+            /// Coordinates of the start vertex of each edge (start vertex of the half-edge 2*i)
+            decimal* edgesStartsX;
+            decimal* edgesStartsY;
+            decimal* edgesStartsZ;
+
+            /// Directions of the edges (from the start vertex to the end vertex)
+            decimal* edgesDirectionsX;
+            decimal* edgesDirectionsY;
+            decimal* edgesDirectionsZ;
+
+            /// Normals of the faces of the half-edges 2*i of the edges
+            decimal* edgesFaces1NormalsX;
+            decimal* edgesFaces1NormalsY;
+            decimal* edgesFaces1NormalsZ;
+
+            /// Normals of the faces of the half-edges 2*i+1 of the edges
+            decimal* edgesFaces2NormalsX;
+            decimal* edgesFaces2NormalsY;
+            decimal* edgesFaces2NormalsZ;
+        };
+
     private:
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of vertices from which the support vertex is found by hill climbing
+        /// on the edges of the mesh instead of a linear search over all the vertices
+        static const uint NB_VERTICES_HILL_CLIMBING = 32;
+
         // -------------------- Attributes -------------------- //
 
         /// Reference to the memory allocator
@@ -60,6 +108,19 @@ class PolyhedronMesh {
         /// Array with the face normals
         Vector3* mFacesNormals;
 
+        /// Arrays with the coordinates of the vertices, faces and edges
+        FeaturesArrays mArrays;
+
+        /// Memory block of the arrays with the coordinates of the vertices, faces and edges
+        decimal* mFeaturesArraysData;
+
+        /// For each vertex, index in the mVerticesNeighbors array of its first neighbor
+        /// (the neighbors of vertex v are between mVerticesNeighborsStart[v] and mVerticesNeighborsStart[v+1])
+        uint* mVerticesNeighborsStart;
+
+        /// Indices of the vertices that are connected to each vertex by an edge
+        uint* mVerticesNeighbors;
+
         /// Centroid of the polyhedron
         Vector3 mCentroid;
 
@@ -71,6 +132,21 @@ class PolyhedronMesh {
         /// Create the half-edge structure of the mesh
         void createHalfEdgeStructure();
 
+        /// Allocate the features arrays and copy the vertices coordinates from the polygon vertex array
+        void initVertices();
+
+        /// Fill the faces and edges arrays (when the faces normals have been computed)
+        void initFacesAndEdges();
+
+        /// Compute the neighbors of each vertex from the half-edge structure
+        void computeVerticesNeighbors();
+
+        /// Return the index of the support vertex with a linear search over all the vertices
+        uint computeSupportVertexLinear(const Vector3& direction) const;
+
+        /// Return the index of the support vertex by hill climbing from a given vertex
+        uint computeSupportVertexHillClimbing(const Vector3& direction, uint startVertexIndex) const;
+
         /// Compute the faces normals
         void computeFacesNormals();
 
@@ -93,6 +169,18 @@ class PolyhedronMesh {
         /// Return a vertex
         Vector3 getVertex(uint index) const;
 
+        /// Return the index of the vertex with the largest projection on a given direction
+        uint getSupportVertex(const Vector3& direction, uint startVertexIndex = 0) const;
+
+        /// Return true if the support vertex is found by hill climbing instead of a linear search
+        bool isSupportVertexHillClimbing() const;
+
+        /// Return the number of edges (pairs of twin half-edges)
+        uint getNbEdges() const;
+
+        /// Return the arrays with the coordinates of the vertices, faces and edges
+        const FeaturesArrays& getFeaturesArrays() const;
+
         /// Return the number of faces
         uint getNbFaces() const;
 
@@ -121,6 +209,56 @@ inline uint PolyhedronMesh::getNbVertices() const {
     return mHalfEdgeStructure.getNbVertices();
 }
 
+// Return a vertex
+/**
+ * @param index Index of a given vertex in the mesh
+ * @return The coordinates of a given vertex in the mesh
+ */
+inline Vector3 PolyhedronMesh::getVertex(uint index) const {
+    assert(index < getNbVertices());
+    return Vector3(mArrays.verticesX[index], mArrays.verticesY[index], mArrays.verticesZ[index]);
+}
+
+// Return the index of the vertex with the largest projection on a given direction
+/// For a small mesh, all the vertices are tested. Otherwise, we climb on the edges of
+/// the mesh from a start vertex (the support vertex found for a close direction for
+/// instance) toward the vertices with a larger projection. Because the mesh is convex,
+/// the vertex where the climbing stops is the support vertex.
+/**
+ * @param direction Direction of the support vertex
+ * @param startVertexIndex Index of the vertex where the hill climbing starts
+ * @return The index of the support vertex
+ */
+inline uint PolyhedronMesh::getSupportVertex(const Vector3& direction, uint startVertexIndex) const {
+
+    if (!isSupportVertexHillClimbing()) {
+        return computeSupportVertexLinear(direction);
+    }
+
+    return computeSupportVertexHillClimbing(direction, startVertexIndex < getNbVertices() ? startVertexIndex : 0);
+}
+
+// Return true if the support vertex is found by hill climbing instead of a linear search
+inline bool PolyhedronMesh::isSupportVertexHillClimbing() const {
+    return getNbVertices() >= NB_VERTICES_HILL_CLIMBING;
+}
+
+// Return the number of edges (pairs of twin half-edges)
+/**
+ * @return The number of edges in the mesh
+ */
+inline uint PolyhedronMesh::getNbEdges() const {
+    return mHalfEdgeStructure.getNbHalfEdges() / 2;
+}
+
+// Return the arrays with the coordinates of the vertices, faces and edges
+/**
+ * @return The coordinates of the vertices, faces and edges of the mesh with one array per coordinate
+ */
+inline const PolyhedronMesh::FeaturesArrays& PolyhedronMesh::getFeaturesArrays() const {
+    return mArrays;
+}
+
 // Return the number of faces
 /**
  * @return The number of faces in the mesh
@@ -30,6 +30,7 @@
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/containers/Stack.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -85,6 +86,10 @@ struct TreeNode {
     /// Height of the node in the tree
     int16 height;
 
+    /// True if the leaf is in the list of moved shapes of the broad-phase (stored in
+    /// the padding after the height so that it does not increase the size of the node)
+    bool isMoved;
+
     /// Fat axis aligned bounding box (AABB) corresponding to the node
     AABB aabb;
 
@@ -94,6 +99,91 @@ struct TreeNode {
     bool isLeaf() const;
 };
 
+// Structure WideTreeNode
+/**
+ * This structure represents a node of the wide (multi-children) version of a
+ * dynamic AABB tree. The AABBs of the children are stored in single precision
+ * in a structure of arrays form so that they can all be tested at once
+ * using SIMD instructions (AVX with eight children and SSE with four children).
+ */
+struct WideTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Number of children of a wide node
+#if defined(__AVX__)
+    static const uint32 NB_CHILDREN = 8;
+#else
+    static const uint32 NB_CHILDREN = 4;
+#endif
+
+    /// Child ID of an unused child slot
+    static const int32 NULL_CHILD = -1;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Minimum coordinates of the AABBs of the children (rounded down)
+    float minX[NB_CHILDREN];
+    float minY[NB_CHILDREN];
+    float minZ[NB_CHILDREN];
+
+    /// Maximum coordinates of the AABBs of the children (rounded up)
+    float maxX[NB_CHILDREN];
+    float maxY[NB_CHILDREN];
+    float maxZ[NB_CHILDREN];
+
+    /// Children of the node. A positive value is the index of a wide node, a value
+    /// smaller than NULL_CHILD is a leaf of the binary tree (see getLeafNodeID())
+    int32 children[NB_CHILDREN];
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if a given child is a leaf
+    bool isLeafChild(uint32 childIndex) const;
+
+    /// Return the ID of the binary tree leaf of a given leaf child
+    int32 getLeafNodeID(uint32 childIndex) const;
+};
+
+// Structure QuantizedTreeNode
+/**
+ * This structure represents a node of the quantized (compressed) version of a
+ * dynamic AABB tree. The AABB of a node is stored with 16-bit offsets relative to
+ * the AABB of its parent, which is computed during the traversal of the tree. The
+ * two children of a node are adjacent in the array of nodes so that only the index
+ * of the first child is stored. Therefore, a node only takes 16 bytes.
+ */
+struct QuantizedTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Maximum value of a quantized offset
+    static const uint16 MAX_OFFSET = 65535;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Offsets of the minimum coordinates of the AABB from the minimum of the parent AABB
+    uint16 minOffsets[3];
+
+    /// Offsets of the maximum coordinates of the AABB from the maximum of the parent AABB
+    uint16 maxOffsets[3];
+
+    /// Index of the first child of the node (the second child is the next node). For
+    /// a leaf, this is a negative value that contains the ID of the binary tree leaf.
+    int32 index;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if the node is a leaf
+    bool isLeaf() const;
+
+    /// Return the ID of the binary tree leaf of a leaf node
+    int32 getLeafNodeID() const;
+
+    /// Compute the AABB of the node from the AABB of its parent
+    void computeAABB(const AABB& parentAABB, AABB& outAABB) const;
+};
+
 // Class DynamicAABBTreeOverlapCallback
 /**
  * Overlapping callback method that has to be used as parameter of the
@@ -127,6 +217,22 @@ class DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class DynamicAABBTreeRaycastPacketCallback
+/**
+ * Raycast callback in the Dynamic AABB Tree called when the AABB of a leaf
+ * node is hit by a ray of a packet of rays.
+ */
+class DynamicAABBTreeRaycastPacketCallback {
+
+    public:
+
+        // Called when the AABB of a leaf node is hit by the ray with a given index in the packet
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray, uint32 rayIndex)=0;
+
+        virtual ~DynamicAABBTreeRaycastPacketCallback() = default;
+
+};
+
 // Class DynamicAABBTree
 /**
  * This class implements a dynamic AABB tree that is used for broad-phase
@@ -136,6 +242,19 @@ class DynamicAABBTreeRaycastCallback {
  */
 class DynamicAABBTree {
 
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of bins used to evaluate the surface area heuristic during a top-down rebuild
+        static const uint32 NB_SAH_BINS = 16;
+
+    public:
+
+        /// Maximum number of rays in a packet of rays (the rays of a packet are tracked
+        /// with the bits of a 32-bits mask)
+        static const uint32 MAX_RAYCAST_PACKET_SIZE = 32;
+
     private:
 
         // -------------------- Attributes -------------------- //
@@ -161,6 +280,51 @@ class DynamicAABBTree {
         /// The fat AABB is the initial AABB inflated by a given percentage of its size.
         decimal mFatAABBInflatePercentage;
 
+        /// True if the wide version of the tree is used for the queries
+        bool mIsWideTreeEnabled;
+
+        /// True if the wide version of the tree matches the current binary tree
+        bool mIsWideTreeUpToDate;
+
+        /// Pointer to the memory location of the nodes of the wide tree (the root is the first node)
+        WideTreeNode* mWideNodes;
+
+        /// Number of nodes in the wide tree
+        int32 mNbWideNodes;
+
+        /// Number of allocated nodes in the wide tree
+        int32 mNbAllocatedWideNodes;
+
+        /// True if the quantized version of the tree is used for the queries
+        bool mIsQuantizedTreeEnabled;
+
+        /// True if the quantized version of the tree matches the current binary tree
+        bool mIsQuantizedTreeUpToDate;
+
+        /// Pointer to the memory location of the nodes of the quantized tree (the root is the first node)
+        QuantizedTreeNode* mQuantizedNodes;
+
+        /// Number of nodes in the quantized tree
+        int32 mNbQuantizedNodes;
+
+        /// Number of allocated nodes in the quantized tree
+        int32 mNbAllocatedQuantizedNodes;
+
+        /// AABB of the root of the quantized tree (the AABBs of the other nodes are relative to it)
+        AABB mQuantizedRootAABB;
+
+        /// ID of the next node to look at during the incremental optimization of the tree
+        int32 mNextOptimizedNodeID;
+
+        /// True if the new objects are not inserted in the tree until the end of the bulk insertion
+        bool mIsBulkInsertionActive;
+
+        /// Number of leaves added during the bulk insertion that are not in the tree yet
+        int32 mNbPendingLeaves;
+
+        /// Number of leaf insertions and removals since the last compaction of the nodes
+        uint32 mNbStructuralChanges;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -188,12 +352,48 @@ class DynamicAABBTree {
         /// Compute the height of a given node in the tree
         int computeHeight(int32 nodeID);
 
+        /// Split a range of leaves in two using the binned surface area heuristic
+        uint32 splitLeavesSAH(int32* leaves, uint32 nbLeaves) const;
+
         /// Internally add an object into the tree
         int32 addObjectInternal(const AABB& aabb);
 
+        /// Return true if a leaf has been added during the bulk insertion and is not in the tree yet
+        bool isPendingLeaf(int32 nodeID) const;
+
         /// Initialize the tree
         void init();
 
+        /// Release the memory of the wide tree
+        void releaseWideTree();
+
+        /// Return true if the queries can use the wide tree
+        bool canUseWideTree() const;
+
+        /// Report all the leaves of the wide tree overlapping with an AABB
+        void reportWideTreeLeavesOverlappingWithAABB(const AABB& aabb, Stack<int32>& stack, List<int32>& overlappingNodes) const;
+
+        /// Ray casting method using the wide tree
+        void raycastWideTree(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Release the memory of the quantized tree
+        void releaseQuantizedTree();
+
+        /// Return true if the queries can use the quantized tree
+        bool canUseQuantizedTree() const;
+
+        /// Report all the leaves of the quantized tree overlapping with an AABB
+        void reportQuantizedTreeLeavesOverlappingWithAABB(const AABB& aabb, Stack<Pair<int32, AABB>>& stack,
+                                                          List<int32>& overlappingNodes) const;
+
+        /// Ray casting method using the quantized tree
+        void raycastQuantizedTree(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Test a pair of nodes during a dual-tree traversal and return the pairs of children to test next
+        uint32 testNodePair(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                            int32 node1ID, int32 node2ID, Pair<int32, int32>* outChildNodePairs,
+                            List<Pair<int32, int32>>& outOverlappingNodes) const;
+
 #ifndef NDEBUG
 
         /// Check if the tree structure is valid (for debugging purpose)
@@ -226,6 +426,9 @@ class DynamicAABBTree {
         /// Update the dynamic tree after an object has moved.
         bool updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert = false);
 
+        /// Update the dynamic tree after an object has moved and extend its fat AABB along its predicted displacement
+        bool updateObject(int32 nodeID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert = false);
+
         /// Return the fat AABB corresponding to a given node ID
         const AABB& getFatAABB(int32 nodeID) const;
 
@@ -235,25 +438,107 @@ class DynamicAABBTree {
         /// Return the data pointer of a given leaf node of the tree
         void* getNodeDataPointer(int32 nodeID) const;
 
+        /// Return true if a given leaf node is in the list of moved shapes of the broad-phase
+        bool getIsLeafMoved(int32 nodeID) const;
+
+        /// Set whether a given leaf node is in the list of moved shapes of the broad-phase
+        void setIsLeafMoved(int32 nodeID, bool isMoved);
+
         /// Report all shapes overlapping with all the shapes in the map in parameter
         void reportAllShapesOverlappingWithShapes(const List<int32>& nodesToTest, size_t startIndex,
                                                   size_t endIndex, List<Pair<int32, int32>>& outOverlappingNodes) const;
 
+        /// Report all shapes overlapping with some shapes of another tree
+        void reportAllShapesOverlappingWithShapes(const DynamicAABBTree& shapesTree, const List<int32>& nodesToTest,
+                                                  size_t startIndex, size_t endIndex,
+                                                  List<Pair<int32, int32>>& outOverlappingNodes) const;
+
+        /// Mark some leaf nodes and all their ancestors in an array of flags (one flag per allocated node)
+        void markLeavesAndAncestors(const List<int32>& leafNodes, bool* outMarkedNodes) const;
+
+        /// Expand some pairs of nodes one level down during a dual-tree traversal
+        void expandNodePairs(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                             const List<Pair<int32, int32>>& nodePairs, List<Pair<int32, int32>>& outChildNodePairs,
+                             List<Pair<int32, int32>>& outOverlappingNodes) const;
+
+        /// Report all the pairs of overlapping leaves below some pairs of nodes using a dual-tree traversal
+        void reportAllOverlappingLeaves(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                                        const List<Pair<int32, int32>>& nodePairs, size_t startIndex, size_t endIndex,
+                                        List<Pair<int32, int32>>& outOverlappingNodes) const;
+
         /// Report all shapes overlapping with the AABB given in parameter.
         void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int>& overlappingNodes) const;
 
+        /// Report all shapes overlapping with the AABB given in parameter to a callback
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback) const;
+
         /// Ray casting method
         void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
 
+        /// Ray casting method for a packet of rays that share the traversal of the tree
+        void raycastPacket(const Ray* rays, uint32 nbRays, DynamicAABBTreeRaycastPacketCallback& callback,
+                           Stack<Pair<int32, uint32>>& stack) const;
+
         /// Compute the height of the tree
         int computeHeight();
 
         /// Return the root AABB of the tree
         AABB getRootAABB() const;
 
+        /// Return the ID of the root node of the tree
+        int32 getRootNodeID() const;
+
+        /// Return the number of nodes in the tree
+        int32 getNbNodes() const;
+
+        /// Return the number of allocated nodes in the tree
+        int32 getNbAllocatedNodes() const;
+
         /// Clear all the nodes and reset the tree
         void reset();
 
+        /// Rebuild the whole tree top-down from its current leaves using the surface area heuristic
+        void rebuildTopDown();
+
+        /// Reinsert a given number of leaves in the tree to improve its quality
+        void optimizeIncremental(uint32 nbLeavesToReinsert);
+
+        /// Return the surface area heuristic cost of the tree
+        decimal computeTreeCost() const;
+
+        /// Rewrite the array of nodes in depth-first order and return the new ID of each node
+        void compactNodes(int32* outNewNodeIDs);
+
+        /// Return the number of leaf insertions and removals since the last compaction of the nodes
+        uint32 getNbStructuralChanges() const;
+
+        /// Enable/Disable the use of the wide version of the tree for the queries
+        void setIsWideTreeEnabled(bool isEnabled);
+
+        /// Return true if the wide version of the tree is used for the queries
+        bool getIsWideTreeEnabled() const;
+
+        /// Enable/Disable the use of the quantized version of the tree for the queries
+        void setIsQuantizedTreeEnabled(bool isEnabled);
+
+        /// Return true if the quantized version of the tree is used for the queries
+        bool getIsQuantizedTreeEnabled() const;
+
+        /// Rebuild the quantized version of the tree if it is enabled and the tree has changed
+        void updateQuantizedTree();
+
+        /// Start a bulk insertion of objects
+        void beginBulkInsertion();
+
+        /// End the bulk insertion and build the tree with the objects that have been added
+        void endBulkInsertion();
+
+        /// Return true if a bulk insertion is active
+        bool getIsBulkInsertionActive() const;
+
+        /// Rebuild the wide version of the tree if it is enabled and the tree has changed
+        void updateWideTree();
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -268,6 +553,72 @@ inline bool TreeNode::isLeaf() const {
     return (height == 0);
 }
 
+// Return true if a given child is a leaf
+inline bool WideTreeNode::isLeafChild(uint32 childIndex) const {
+    assert(childIndex < NB_CHILDREN);
+    return children[childIndex] < NULL_CHILD;
+}
+
+// Return the ID of the binary tree leaf of a given leaf child
+inline int32 WideTreeNode::getLeafNodeID(uint32 childIndex) const {
+    assert(isLeafChild(childIndex));
+    return -children[childIndex] - 2;
+}
+
+// Return true if the node is a leaf
+inline bool QuantizedTreeNode::isLeaf() const {
+    return index < 0;
+}
+
+// Return the ID of the binary tree leaf of a leaf node
+inline int32 QuantizedTreeNode::getLeafNodeID() const {
+    assert(isLeaf());
+    return -index - 1;
+}
+
+// Compute the AABB of the node from the AABB of its parent
+/// The minimum is computed from the minimum of the parent and the maximum from the maximum of
+/// the parent so that the offsets 0 give exactly the AABB of the parent.
+inline void QuantizedTreeNode::computeAABB(const AABB& parentAABB, AABB& outAABB) const {
+    const Vector3& parentMin = parentAABB.getMin();
+    const Vector3& parentMax = parentAABB.getMax();
+    const Vector3 step = (parentMax - parentMin) * (decimal(1.0) / decimal(MAX_OFFSET));
+    outAABB.setMin(Vector3(parentMin.x + minOffsets[0] * step.x, parentMin.y + minOffsets[1] * step.y,
+                           parentMin.z + minOffsets[2] * step.z));
+    outAABB.setMax(Vector3(parentMax.x - maxOffsets[0] * step.x, parentMax.y - maxOffsets[1] * step.y,
+                           parentMax.z - maxOffsets[2] * step.z));
+}
+
+// Return true if the wide version of the tree is used for the queries
+inline bool DynamicAABBTree::getIsWideTreeEnabled() const {
+    return mIsWideTreeEnabled;
+}
+
+// Return true if the quantized version of the tree is used for the queries
+inline bool DynamicAABBTree::getIsQuantizedTreeEnabled() const {
+    return mIsQuantizedTreeEnabled;
+}
+
+// Return true if the queries can use the quantized tree
+inline bool DynamicAABBTree::canUseQuantizedTree() const {
+    return mIsQuantizedTreeEnabled && mIsQuantizedTreeUpToDate;
+}
+
+// Return true if a bulk insertion is active
+inline bool DynamicAABBTree::getIsBulkInsertionActive() const {
+    return mIsBulkInsertionActive;
+}
+
+// Return true if a leaf has been added during the bulk insertion and is not in the tree yet
+inline bool DynamicAABBTree::isPendingLeaf(int32 nodeID) const {
+    return mNodes[nodeID].isLeaf() && mNodes[nodeID].parentID == TreeNode::NULL_TREE_NODE && nodeID != mRootNodeID;
+}
+
+// Return true if the queries can use the wide tree
+inline bool DynamicAABBTree::canUseWideTree() const {
+    return mIsWideTreeEnabled && mIsWideTreeUpToDate;
+}
+
 // Return the fat AABB corresponding to a given node ID
 inline const AABB& DynamicAABBTree::getFatAABB(int32 nodeID) const {
     assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
@@ -288,11 +639,45 @@ inline void* DynamicAABBTree::getNodeDataPointer(int32 nodeID) const {
     return mNodes[nodeID].dataPointer;
 }
 
+// Return true if a given leaf node is in the list of moved shapes of the broad-phase
+/// The flag is false for the released nodes.
+inline bool DynamicAABBTree::getIsLeafMoved(int32 nodeID) const {
+    assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
+    return mNodes[nodeID].isMoved;
+}
+
+// Set whether a given leaf node is in the list of moved shapes of the broad-phase
+inline void DynamicAABBTree::setIsLeafMoved(int32 nodeID, bool isMoved) {
+    assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
+    assert(mNodes[nodeID].isLeaf());
+    mNodes[nodeID].isMoved = isMoved;
+}
+
 // Return the root AABB of the tree
 inline AABB DynamicAABBTree::getRootAABB() const {
     return getFatAABB(mRootNodeID);
 }
 
+// Return the ID of the root node of the tree
+inline int32 DynamicAABBTree::getRootNodeID() const {
+    return mRootNodeID;
+}
+
+// Return the number of nodes in the tree
+inline int32 DynamicAABBTree::getNbNodes() const {
+    return mNbNodes;
+}
+
+// Return the number of allocated nodes in the tree
+inline int32 DynamicAABBTree::getNbAllocatedNodes() const {
+    return mNbAllocatedNodes;
+}
+
+// Return the number of leaf insertions and removals since the last compaction of the nodes
+inline uint32 DynamicAABBTree::getNbStructuralChanges() const {
+    return mNbStructuralChanges;
+}
+
 // Add an object into the tree. This method creates a new leaf node in the tree and
 // returns the ID of the corresponding node.
 inline int32 DynamicAABBTree::addObject(const AABB& aabb, int32 data1, int32 data2) {
@@ -316,6 +701,18 @@ inline int32 DynamicAABBTree::addObject(const AABB& aabb, void* data) {
     return nodeId;
 }
 
+// Update the dynamic tree after an object has moved.
+/// The fat AABB of the node is the AABB inflated by the percentage of the tree if it has to be updated.
+inline bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert) {
+    return updateObject(nodeID, newAABB, Vector3::zero(), forceReinsert);
+}
+
+// Report all shapes overlapping with all the shapes in the map in parameter
+inline void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const List<int32>& nodesToTest, size_t startIndex,
+                                                                  size_t endIndex, List<Pair<int32, int32>>& outOverlappingNodes) const {
+    reportAllShapesOverlappingWithShapes(*this, nodesToTest, startIndex, endIndex, outOverlappingNodes);
+}
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 // Set the profiler
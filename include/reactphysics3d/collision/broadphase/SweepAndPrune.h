@@ -0,0 +1,331 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SWEEP_AND_PRUNE_H
+#define REACTPHYSICS3D_SWEEP_AND_PRUNE_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/containers/List.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class DynamicAABBTreeOverlapCallback;
+class DynamicAABBTreeRaycastCallback;
+class DynamicAABBTreeRaycastPacketCallback;
+class Profiler;
+class MemoryAllocator;
+
+// Structure SweepAndPruneProxy
+/**
+ * This structure represents an object stored in the sweep-and-prune.
+ */
+struct SweepAndPruneProxy {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Fat axis aligned bounding box (AABB) of the object
+    AABB aabb;
+
+    /// Pointer to the data of the object
+    void* dataPointer;
+
+    /// Index of the entry of the proxy in the sorted array (-1 if the proxy is free)
+    int32 entryIndex;
+
+    /// ID of the next free proxy
+    int32 nextProxyID;
+
+    /// True if the proxy is in the list of moved shapes of the broad-phase
+    bool isMoved;
+};
+
+// Structure SweepAndPruneEntry
+/**
+ * This structure represents the interval of a proxy on the sweep axis. The entries are
+ * stored in an array sorted by their minimum so that the sweep only reads contiguous memory.
+ */
+struct SweepAndPruneEntry {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Minimum of the fat AABB of the proxy on the sweep axis
+    decimal min;
+
+    /// Maximum of the fat AABB of the proxy on the sweep axis
+    decimal max;
+
+    /// ID of the proxy (-1 if the proxy has been removed)
+    int32 proxyID;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return true if the entry must be placed before another one in the sorted array
+    bool operator<(const SweepAndPruneEntry& entry) const;
+};
+
+// Class SweepAndPrune
+/**
+ * This class implements an incremental sweep-and-prune that can be used instead of
+ * the dynamic AABB tree for broad-phase collision detection. The intervals of the fat
+ * AABBs on a sweep axis are kept sorted in an array. Because the objects usually move a
+ * little between two frames, an insertion sort restores the order in almost linear time.
+ * The overlapping pairs are then found with a single sweep over the sorted array. The sweep
+ * axis is the axis with the largest spread of the objects so that, for instance, the objects
+ * lying on a large floor are not all overlapping on the sweep axis.
+ */
+class SweepAndPrune {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of new entries since the last sort that are inserted with the insertion
+        /// sort. If more entries have been added, the whole array is sorted again.
+        static const uint32 NB_MAX_NEW_ENTRIES_INSERTION_SORT = 32;
+
+        /// The sweep axis is changed when the spread of the objects along another axis becomes
+        /// larger than this factor times the spread along the current sweep axis
+        static const uint32 SWEEP_AXIS_CHANGE_FACTOR = 2;
+
+        /// Null proxy constant
+        static const int32 NULL_PROXY = -1;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Array with the proxies
+        SweepAndPruneProxy* mProxies;
+
+        /// Number of proxies in use
+        int32 mNbProxies;
+
+        /// Number of allocated proxies
+        int32 mNbAllocatedProxies;
+
+        /// ID of the first free proxy
+        int32 mFreeProxyID;
+
+        /// Array with the entries of the proxies sorted along the sweep axis
+        SweepAndPruneEntry* mEntries;
+
+        /// Number of entries (including the entries of the removed proxies)
+        uint32 mNbEntries;
+
+        /// Number of allocated entries
+        uint32 mNbAllocatedEntries;
+
+        /// Number of entries added since the last sort
+        uint32 mNbNewEntries;
+
+        /// Index of the sweep axis (0 for x, 1 for y and 2 for z)
+        int mSweepAxis;
+
+        /// True if the entries are sorted and do not contain removed proxies
+        bool mAreEntriesSorted;
+
+        /// The fat AABB is the initial AABB inflated by a given percentage of its size.
+        decimal mFatAABBInflatePercentage;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Allocate and return a new proxy
+        int32 allocateProxy();
+
+        /// Add a new entry at the end of the array of entries
+        void addEntry(int32 proxyID);
+
+        /// Set the interval of an entry from the fat AABB of its proxy
+        void setEntryInterval(SweepAndPruneEntry& entry) const;
+
+        /// Remove the entries of the removed proxies from the array of entries
+        void compactEntries();
+
+        /// Return the index of the axis with the largest spread of the proxies
+        int computeSweepAxis() const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SweepAndPrune(MemoryAllocator& allocator, decimal fatAABBInflatePercentage = decimal(0.0));
+
+        /// Destructor
+        ~SweepAndPrune();
+
+        /// Deleted copy-constructor
+        SweepAndPrune(const SweepAndPrune& sweepAndPrune) = delete;
+
+        /// Deleted assignment operator
+        SweepAndPrune& operator=(const SweepAndPrune& sweepAndPrune) = delete;
+
+        /// Add an object and return the ID of its proxy
+        int32 addObject(const AABB& aabb, void* data);
+
+        /// Remove an object
+        void removeObject(int32 proxyID);
+
+        /// Update the fat AABB of an object that has moved
+        bool updateObject(int32 proxyID, const AABB& newAABB, bool forceReinsert = false);
+
+        /// Update the fat AABB of an object that has moved and extend it along its predicted displacement
+        bool updateObject(int32 proxyID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert = false);
+
+        /// Return the fat AABB of a given proxy
+        const AABB& getFatAABB(int32 proxyID) const;
+
+        /// Return the data pointer of a given proxy
+        void* getProxyDataPointer(int32 proxyID) const;
+
+        /// Return true if a given proxy is in the list of moved shapes of the broad-phase
+        bool getIsProxyMoved(int32 proxyID) const;
+
+        /// Set whether a given proxy is in the list of moved shapes of the broad-phase
+        void setIsProxyMoved(int32 proxyID, bool isMoved);
+
+        /// Return the number of proxies
+        int32 getNbProxies() const;
+
+        /// Return the number of allocated proxies
+        int32 getNbAllocatedProxies() const;
+
+        /// Return the number of entries in the sorted array
+        uint32 getNbEntries() const;
+
+        /// Sort the entries along the sweep axis
+        void sortEntries();
+
+        /// Report the pairs of overlapping proxies with at least one moved proxy for a range of sorted entries
+        void reportAllOverlappingPairs(const bool* movedProxies, uint32 startIndex, uint32 endIndex,
+                                       List<Pair<int32, int32>>& outOverlappingProxies) const;
+
+        /// Report all the proxies that overlap with the AABB in parameter
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int>& overlappingProxies) const;
+
+        /// Report all the proxies that overlap with the AABB in parameter to a callback
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback) const;
+
+        /// Ray casting method
+        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Ray casting method for a packet of rays
+        void raycastPacket(const Ray* rays, uint32 nbRays, DynamicAABBTreeRaycastPacketCallback& callback) const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return true if the entry must be placed before another one in the sorted array
+/// The ID of the proxies is used to order the entries with the same minimum so that
+/// the order of the entries does not depend on the sorting algorithm.
+inline bool SweepAndPruneEntry::operator<(const SweepAndPruneEntry& entry) const {
+    return min < entry.min || (min == entry.min && proxyID < entry.proxyID);
+}
+
+// Return the fat AABB of a given proxy
+inline const AABB& SweepAndPrune::getFatAABB(int32 proxyID) const {
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    assert(mProxies[proxyID].entryIndex != NULL_PROXY);
+    return mProxies[proxyID].aabb;
+}
+
+// Return the data pointer of a given proxy
+inline void* SweepAndPrune::getProxyDataPointer(int32 proxyID) const {
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    assert(mProxies[proxyID].entryIndex != NULL_PROXY);
+    return mProxies[proxyID].dataPointer;
+}
+
+// Return true if a given proxy is in the list of moved shapes of the broad-phase
+/// The flag is false for the removed proxies.
+inline bool SweepAndPrune::getIsProxyMoved(int32 proxyID) const {
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    return mProxies[proxyID].isMoved;
+}
+
+// Set whether a given proxy is in the list of moved shapes of the broad-phase
+inline void SweepAndPrune::setIsProxyMoved(int32 proxyID, bool isMoved) {
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    assert(mProxies[proxyID].entryIndex != NULL_PROXY);
+    mProxies[proxyID].isMoved = isMoved;
+}
+
+// Return the number of proxies
+inline int32 SweepAndPrune::getNbProxies() const {
+    return mNbProxies;
+}
+
+// Return the number of allocated proxies
+inline int32 SweepAndPrune::getNbAllocatedProxies() const {
+    return mNbAllocatedProxies;
+}
+
+// Return the number of entries in the sorted array
+inline uint32 SweepAndPrune::getNbEntries() const {
+    return mNbEntries;
+}
+
+// Update the fat AABB of an object that has moved
+inline bool SweepAndPrune::updateObject(int32 proxyID, const AABB& newAABB, bool forceReinsert) {
+    return updateObject(proxyID, newAABB, Vector3::zero(), forceReinsert);
+}
+
+// Set the interval of an entry from the fat AABB of its proxy
+inline void SweepAndPrune::setEntryInterval(SweepAndPruneEntry& entry) const {
+    const AABB& aabb = mProxies[entry.proxyID].aabb;
+    entry.min = aabb.getMin()[mSweepAxis];
+    entry.max = aabb.getMax()[mSweepAxis];
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void SweepAndPrune::setProfiler(Profiler* profiler) {
+	mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+struct BoxVsBoxNarrowPhaseInfoBatch;
+class Transform;
+struct Vector3;
+
+// Class BoxVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between two box collision shapes. It uses the separating axis theorem with
+ * the fifteen possible separating axes of two oriented boxes (the three face
+ * normals of each box and the nine cross products of their edges) and directly
+ * clips the incident face of a box against the reference face of the other one.
+ * Contrary to the general convex polyhedron algorithm, it does not need to traverse
+ * the half-edge structure of the boxes.
+ */
+class BoxVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Relative and absolute bias used to make sure the algorithm returns the same penetration axis between frames
+        /// when there are multiple separating axis with almost the same penetration depth (see SATAlgorithm)
+        static const decimal SEPARATING_AXIS_RELATIVE_TOLERANCE;
+        static const decimal SEPARATING_AXIS_ABSOLUTE_TOLERANCE;
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the contact points between a face of a reference box and the incident face of the other box
+        bool computeFaceContactPoints(bool isReferenceBox1, const Vector3& referenceHalfExtents, const Vector3& incidentHalfExtents,
+                                      const Transform& referenceToIncident, const Transform& incidentToReference,
+                                      int referenceAxis, decimal referenceAxisSign,
+                                      BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex) const;
+
+        /// Compute the contact points between the face of box 1 or box 2 along a coordinate axis and the other box
+        bool computeAxisFaceContactPoints(bool isReferenceBox1, const Transform& box2ToBox1, const Transform& box1ToBox2,
+                                          int axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                          const Vector3& box2Center, BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch,
+                                          uint batchIndex) const;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        BoxVsBoxAlgorithm() = default;
+
+        /// Destructor
+        virtual ~BoxVsBoxAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        BoxVsBoxAlgorithm(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        BoxVsBoxAlgorithm& operator=(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between two boxes
+        bool testCollision(BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex,
+                           uint batchNbItems, bool clipWithPreviousAxisIfStillColliding);
+};
+
+}
+
+#endif
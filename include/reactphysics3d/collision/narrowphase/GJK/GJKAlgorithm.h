@@ -38,6 +38,8 @@ class ContactManifoldInfo;
 struct NarrowPhaseInfoBatch;
 class ConvexShape;
 class Profiler;
+class Transform;
+struct Vector3;
 class VoronoiSimplex;
 template<typename T> class List;
 
@@ -45,6 +47,7 @@ template<typename T> class List;
 constexpr decimal REL_ERROR = decimal(1.0e-3);
 constexpr decimal REL_ERROR_SQUARE = REL_ERROR * REL_ERROR;
 constexpr int MAX_ITERATIONS_GJK_RAYCAST = 32;
+constexpr decimal GJK_SWEEP_TOLERANCE = decimal(1.0e-4);
 
 // Class GJKAlgorithm
 /**
@@ -100,6 +103,21 @@ class GJKAlgorithm {
         void testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex,
                            uint batchNbItems, List<GJKResult>& gjkResults);
 
+        /// Compute the first contact between a translating convex shape and a fixed convex shape
+        bool sweep(const ConvexShape* shape1, const Transform& transform1, const Vector3& translation1,
+                   const ConvexShape* shape2, const Transform& transform2, decimal maxFraction,
+                   decimal& outHitFraction, Vector3& outWorldPoint, Vector3& outWorldNormal) const;
+
+        /// Return true if two convex shapes overlap
+        bool testOverlap(const ConvexShape* shape1, const Transform& transform1,
+                         const ConvexShape* shape2, const Transform& transform2) const;
+
+        /// Compute the distance and the closest points between two convex shapes
+        bool computeDistance(const ConvexShape* shape1, const Transform& transform1,
+                             const ConvexShape* shape2, const Transform& transform2,
+                             Vector3& inOutSeparatingAxis, decimal& outDistance,
+                             Vector3& outWorldPoint1, Vector3& outWorldPoint2) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
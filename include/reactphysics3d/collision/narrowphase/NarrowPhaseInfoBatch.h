@@ -90,6 +90,9 @@ struct NarrowPhaseInfoBatch {
         /// List of contact points created during the narrow-phase
         List<List<ContactPointInfo*>> contactPoints;
 
+        /// Memory allocators of the contact points of each item
+        List<MemoryAllocator*> contactPointsAllocators;
+
         /// Memory allocators for the collision shape (Used to release TriangleShape memory in destructor)
         List<MemoryAllocator*> collisionShapeAllocators;
 
@@ -106,7 +109,7 @@ struct NarrowPhaseInfoBatch {
         uint getNbObjects() const;
 
         /// Add shapes to be tested during narrow-phase collision detection into the batch
-        virtual void addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
+        virtual void addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, const Entity& collider1, const Entity& collider2, CollisionShape* shape1,
                                 CollisionShape* shape2, const Transform& shape1Transform,
                                 const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator& shapeAllocator);
 
@@ -117,6 +120,9 @@ struct NarrowPhaseInfoBatch {
         /// Reset the remaining contact points
         void resetContactPoints(uint index);
 
+        /// Set the memory allocator of the contact points of an item
+        void setContactPointsAllocator(uint index, MemoryAllocator& allocator);
+
         // Initialize the containers using cached capacity
         virtual void reserveMemory();
 
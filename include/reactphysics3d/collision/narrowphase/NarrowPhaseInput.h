@@ -32,6 +32,7 @@
 #include <reactphysics3d/collision/narrowphase/SphereVsSphereNarrowPhaseInfoBatch.h>
 #include <reactphysics3d/collision/narrowphase/CapsuleVsCapsuleNarrowPhaseInfoBatch.h>
 #include <reactphysics3d/collision/narrowphase/SphereVsCapsuleNarrowPhaseInfoBatch.h>
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxNarrowPhaseInfoBatch.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -61,6 +62,7 @@ class NarrowPhaseInput {
         NarrowPhaseInfoBatch mSphereVsConvexPolyhedronBatch;
         NarrowPhaseInfoBatch mCapsuleVsConvexPolyhedronBatch;
         NarrowPhaseInfoBatch mConvexPolyhedronVsConvexPolyhedronBatch;
+        BoxVsBoxNarrowPhaseInfoBatch mBoxVsBoxBatch;
 
     public:
 
@@ -91,6 +93,12 @@ class NarrowPhaseInput {
         /// Get a reference to the convex polyhedron vs convex polyhedron batch
         NarrowPhaseInfoBatch& getConvexPolyhedronVsConvexPolyhedronBatch();
 
+        /// Get a reference to the box vs box batch
+        BoxVsBoxNarrowPhaseInfoBatch& getBoxVsBoxBatch();
+
+        /// Get a reference to the batch of a given narrow-phase algorithm
+        NarrowPhaseInfoBatch& getBatch(NarrowPhaseAlgorithmType narrowPhaseAlgorithmType);
+
         /// Reserve memory for the containers with cached capacity
         void reserveMemory();
 
@@ -129,5 +137,10 @@ inline NarrowPhaseInfoBatch& NarrowPhaseInput::getConvexPolyhedronVsConvexPolyhe
    return mConvexPolyhedronVsConvexPolyhedronBatch;
 }
 
+// Get a reference to the box vs box batch contacts
+inline BoxVsBoxNarrowPhaseInfoBatch& NarrowPhaseInput::getBoxVsBoxBatch() {
+   return mBoxVsBoxBatch;
+}
+
 }
 #endif
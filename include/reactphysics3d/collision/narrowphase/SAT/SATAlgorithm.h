@@ -39,6 +39,7 @@ class SphereShape;
 class ContactManifoldInfo;
 struct NarrowPhaseInfoBatch;
 class ConvexPolyhedronShape;
+class ConvexMeshShape;
 class MemoryAllocator;
 class Profiler;
 
@@ -107,12 +108,17 @@ class SATAlgorithm {
         decimal testSingleFaceDirectionPolyhedronVsPolyhedron(const ConvexPolyhedronShape* polyhedron1,
                                                               const ConvexPolyhedronShape* polyhedron2,
                                                               const Transform& polyhedron1ToPolyhedron2,
-                                                              uint faceIndex) const;
+                                                              uint faceIndex, uint& supportVertexIndex2) const;
 
 
         /// Test all the normals of a polyhedron for separating axis in the polyhedron vs polyhedron case
         decimal testFacesDirectionPolyhedronVsPolyhedron(const ConvexPolyhedronShape* polyhedron1, const ConvexPolyhedronShape* polyhedron2,
-                                                        const Transform& polyhedron1ToPolyhedron2, uint& minFaceIndex) const;
+                                                        const Transform& polyhedron1ToPolyhedron2, uint& minFaceIndex,
+                                                        uint& supportVertexIndex2) const;
+
+        /// Test all the normals of a convex mesh for separating axis with the cached arrays of the two meshes
+        decimal testFacesDirectionConvexMeshVsConvexMesh(const ConvexMeshShape* mesh1, const ConvexMeshShape* mesh2,
+                                                         const Transform& mesh1ToMesh2, uint& minFaceIndex) const;
 
         /// Compute the penetration depth between a face of the polyhedron and a sphere along the polyhedron face normal direction
         decimal computePolyhedronFaceVsSpherePenetrationDepth(uint faceIndex, const ConvexPolyhedronShape* polyhedron,
@@ -88,12 +88,18 @@ class AABB {
         /// Inflate each side of the AABB by a given size
         void inflate(decimal dx, decimal dy, decimal dz);
 
+        /// Extend the AABB in the direction of a displacement vector
+        void extendAlongDisplacement(const Vector3& displacement);
+
         /// Return true if the current AABB is overlapping with the AABB in argument
         bool testCollision(const AABB& aabb) const;
 
         /// Return the volume of the AABB
         decimal getVolume() const;
 
+        /// Return the surface area of the AABB
+        decimal getSurfaceArea() const;
+
         /// Merge the AABB in parameter with the current one
         void mergeWithAABB(const AABB& aabb);
 
@@ -112,6 +118,12 @@ class AABB {
         /// Return true if the ray intersects the AABB
         bool testRayIntersect(const Ray& ray) const;
 
+        /// Return true if the AABB overlaps with a sphere
+        bool testCollisionSphere(const Vector3& sphereCenter, decimal sphereRadius) const;
+
+        /// Return true if the AABB may overlap with a frustum
+        bool testCollisionFrustum(const Frustum& frustum) const;
+
         /// Apply a scale factor to the AABB
         void applyScale(const Vector3& scale);
 
@@ -180,6 +192,27 @@ inline decimal AABB::getVolume() const {
     return (diff.x * diff.y * diff.z);
 }
 
+// Extend the AABB in the direction of a displacement vector
+/// Only the sides of the AABB in the direction of the displacement are moved so that
+/// the AABB contains both the current AABB and the AABB moved by the displacement.
+inline void AABB::extendAlongDisplacement(const Vector3& displacement) {
+
+    if (displacement.x < decimal(0.0)) mMinCoordinates.x += displacement.x;
+    else mMaxCoordinates.x += displacement.x;
+
+    if (displacement.y < decimal(0.0)) mMinCoordinates.y += displacement.y;
+    else mMaxCoordinates.y += displacement.y;
+
+    if (displacement.z < decimal(0.0)) mMinCoordinates.z += displacement.z;
+    else mMaxCoordinates.z += displacement.z;
+}
+
+// Return the surface area of the AABB
+inline decimal AABB::getSurfaceArea() const {
+    const Vector3 diff = mMaxCoordinates - mMinCoordinates;
+    return decimal(2.0) * (diff.x * diff.y + diff.y * diff.z + diff.z * diff.x);
+}
+
 // Return true if the AABB of a triangle intersects the AABB
 inline bool AABB::testCollisionTriangleAABB(const Vector3* trianglePoints) const {
 
@@ -194,6 +227,36 @@ inline bool AABB::testCollisionTriangleAABB(const Vector3* trianglePoints) const
     return true;
 }
 
+// Return true if the AABB overlaps with a sphere
+inline bool AABB::testCollisionSphere(const Vector3& sphereCenter, decimal sphereRadius) const {
+
+    // Compute the closest point of the AABB to the center of the sphere
+    const Vector3 closestPoint(clamp(sphereCenter.x, mMinCoordinates.x, mMaxCoordinates.x),
+                               clamp(sphereCenter.y, mMinCoordinates.y, mMaxCoordinates.y),
+                               clamp(sphereCenter.z, mMinCoordinates.z, mMaxCoordinates.z));
+
+    return (closestPoint - sphereCenter).lengthSquare() <= sphereRadius * sphereRadius;
+}
+
+// Return true if the AABB may overlap with a frustum
+/// The AABB is rejected if its corner that is the farthest along the normal of a plane
+/// is outside of this plane. This test is conservative: a few AABBs near the edges of
+/// the frustum are reported as overlapping even if they are outside of the frustum.
+inline bool AABB::testCollisionFrustum(const Frustum& frustum) const {
+
+    for (int i=0; i < Frustum::NB_PLANES; i++) {
+
+        const Vector3& normal = frustum.planeNormals[i];
+        const Vector3 farthestCorner(normal.x >= decimal(0.0) ? mMaxCoordinates.x : mMinCoordinates.x,
+                                     normal.y >= decimal(0.0) ? mMaxCoordinates.y : mMinCoordinates.y,
+                                     normal.z >= decimal(0.0) ? mMaxCoordinates.z : mMinCoordinates.z);
+
+        if (normal.dot(farthestCorner) + frustum.planeDistances[i] < decimal(0.0)) return false;
+    }
+
+    return true;
+}
+
 // Return true if a point is inside the AABB
 inline bool AABB::contains(const Vector3& point) const {
 
@@ -74,6 +74,10 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         /// Return a local support point in a given direction without the object margin.
         virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const override;
 
+        /// Return a local support point in a given direction without the object margin, starting
+        /// the search from the support vertex of a previous query
+        virtual Vector3 getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction, uint& inOutVertexIndex) const override;
+
         /// Return true if a point is inside the collision shape
         virtual bool testPointInside(const Vector3& localPoint, Collider* collider) const override;
 
@@ -99,6 +103,9 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         /// Return the scale
         const Vector3& getScale() const;
 
+        /// Return the polyhedron mesh of the shape
+        const PolyhedronMesh* getPolyhedronMesh() const;
+
         /// Set the scale
         void setScale(const Vector3& scale);
 
@@ -151,11 +158,36 @@ inline size_t ConvexMeshShape::getSizeInBytes() const {
     return sizeof(ConvexMeshShape);
 }
 
+// Return a local support point in a given direction without the object margin
+/// The vertex with the largest projection on the direction in the scaled mesh is the
+/// vertex of the unscaled mesh with the largest projection on the scaled direction.
+inline Vector3 ConvexMeshShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
+    return mPolyhedronMesh->getVertex(mPolyhedronMesh->getSupportVertex(direction * mScale)) * mScale;
+}
+
+// Return a local support point in a given direction without the object margin, starting
+// the search from the support vertex of a previous query
+/// For a mesh with many vertices, the support vertex is found by hill climbing on the
+/// edges of the mesh from the given vertex, which usually takes a few steps when the
+/// direction is close to the direction of the previous query.
+inline Vector3 ConvexMeshShape::getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction, uint& inOutVertexIndex) const {
+    inOutVertexIndex = mPolyhedronMesh->getSupportVertex(direction * mScale, inOutVertexIndex);
+    return mPolyhedronMesh->getVertex(inOutVertexIndex) * mScale;
+}
+
 // Return the scaling vector
 inline const Vector3& ConvexMeshShape::getScale() const {
     return mScale;
 }
 
+// Return the polyhedron mesh of the shape
+/**
+ * @return A pointer to the polyhedron mesh (vertices, faces and edges without the scale)
+ */
+inline const PolyhedronMesh* ConvexMeshShape::getPolyhedronMesh() const {
+    return mPolyhedronMesh;
+}
+
 // Set the scale
 /// Note that you might want to recompute the inertia tensor and center of mass of the body
 /// after changing the scale of a collision shape
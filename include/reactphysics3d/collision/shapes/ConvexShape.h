@@ -54,6 +54,10 @@ class ConvexShape : public CollisionShape {
         /// Return a local support point in a given direction without the object margin
         virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const=0;
 
+        /// Return a local support point in a given direction without the object margin, starting
+        /// the search from the support vertex of a previous query
+        virtual Vector3 getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction, uint& inOutVertexIndex) const;
+
     public :
 
         // -------------------- Methods -------------------- //
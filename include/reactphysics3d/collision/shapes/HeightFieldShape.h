@@ -29,6 +29,7 @@
 // Libraries
 #include <reactphysics3d/collision/shapes/ConcaveShape.h>
 #include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/containers/List.h>
 
 namespace reactphysics3d {
 
@@ -46,6 +47,9 @@ class TriangleShape;
  * your height field. Note that the HeightFieldShape will be re-centered based on its AABB. It means
  * that for instance, if the minimum height value is -200 and the maximum value is 400, the final
  * minimum height of the field in the simulation will be -300 and the maximum height will be 300.
+ * By default, the vertices normals of a triangle of the height field are the normal of the triangle.
+ * The vertices normals can also be precomputed as the average of the normals of the triangles around
+ * each grid point (like for a ConcaveMeshShape) at the cost of the memory to store one normal per grid point.
  */
 class HeightFieldShape : public ConcaveShape {
 
@@ -56,6 +60,32 @@ class HeightFieldShape : public ConcaveShape {
 
     protected:
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of quads of the grid along each side of a cell of the first level of the min/max height pyramid
+        static const int HEIGHT_PYRAMID_LEAF_SIZE = 4;
+
+        // -------------------- Types -------------------- //
+
+        /// Function that reads a range of consecutive height values of the grid
+        using HeightSamplingFunction = void (*)(const void* heightFieldData, uint startIndex, uint nbValues,
+                                                decimal integerHeightScale, decimal* outHeights);
+
+        // -------------------- Structures -------------------- //
+
+        /// Level of the min/max height pyramid
+        struct HeightPyramidLevel {
+
+            /// Number of cells of the level along the columns of the grid
+            int nbCellsX;
+
+            /// Number of cells of the level along the rows of the grid
+            int nbCellsY;
+
+            /// Index of the first cell of the level in the array of cells of the pyramid
+            uint startIndex;
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Number of columns in the grid of the height field
@@ -85,19 +115,42 @@ class HeightFieldShape : public ConcaveShape {
         /// Data type of the height values
         HeightDataType mHeightDataType;
 
+        /// Function that reads the height values (selected according to the data type of the height values)
+        HeightSamplingFunction mSampleHeights;
+
+        /// Index of the local-space axis along the columns of the grid
+        int mColumnAxis;
+
+        /// Index of the local-space axis along the rows of the grid
+        int mRowAxis;
+
+        /// Height of the grid points with a zero height value (without scaling)
+        decimal mHeightOrigin;
+
         /// Array of data with all the height values of the height field
         const void*	mHeightFieldData;
 
         /// Local AABB of the height field (without scaling)
         AABB mAABB;
 
+        /// Levels of the min/max height pyramid. A cell of the first level covers HEIGHT_PYRAMID_LEAF_SIZE x
+        /// HEIGHT_PYRAMID_LEAF_SIZE quads of the grid, a cell of the next level covers 2 x 2 cells of the
+        /// previous level and the last level has a single cell for the whole grid.
+        List<HeightPyramidLevel> mHeightPyramidLevels;
+
+        /// Minimum and maximum height values of the cells of the pyramid (two values per cell)
+        List<decimal> mHeightPyramidMinMax;
+
+        /// Normals of the grid points (without scaling) if the vertices normals are precomputed or empty otherwise
+        List<Vector3> mVerticesNormals;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
         HeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                          const void* heightFieldData, HeightDataType dataType, MemoryAllocator& allocator,
                          int upAxis = 1, decimal integerHeightScale = 1.0f,
-                         const Vector3& scaling = Vector3(1,1,1));
+                         const Vector3& scaling = Vector3(1,1,1), bool computeVerticesNormals = false);
 
         /// Raycast method with feedback information
         virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const override;
@@ -108,6 +161,32 @@ class HeightFieldShape : public ConcaveShape {
         /// Insert all the triangles into the dynamic AABB tree
         void initBVHTree();
 
+        /// Compute the min/max height pyramid of the grid
+        void initHeightPyramid();
+
+        /// Compute the normals of the grid points
+        void initVerticesNormals();
+
+        /// Return the vertex (local-coordinates without scaling) of a grid point with a given height value
+        Vector3 computeVertex(int x, int y, decimal height) const;
+
+        /// Compute the six vertices and vertices normals of the two triangles of a quad of the grid
+        void computeQuadTriangles(int i, int j, const decimal* quadHeights, Vector3* outTrianglesVertices,
+                                  Vector3* outTrianglesVerticesNormals) const;
+
+        /// Raycast against the two triangles of a quad of the grid
+        bool raycastQuad(int i, int j, const decimal* quadHeights, const Ray& ray, RaycastInfo& raycastInfo,
+                         Collider* collider, decimal& smallestHitFraction, MemoryAllocator& allocator) const;
+
+        /// Read the height values of a rectangle of grid points
+        void sampleGridHeights(int iMin, int jMin, int nbPointsX, int nbPointsY, decimal* outHeights) const;
+
+        /// Return the bounds of a cell of the min/max height pyramid in grid-space
+        void getHeightPyramidCellBounds(int level, int x, int y, Vector3& outMin, Vector3& outMax) const;
+
+        /// Convert a point from the local-space (without scaling) to the grid-space of the height field
+        Vector3 convertToGridSpace(const Vector3& localPoint) const;
+
         /// Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
         /// given the start vertex index pointer of the triangle.
         void getTriangleVerticesWithIndexPointer(int32 subPart, int32 triangleIndex,
@@ -148,6 +227,9 @@ class HeightFieldShape : public ConcaveShape {
         /// Return the type of height value in the height field
         HeightDataType getHeightDataType() const;
 
+        /// Return true if the vertices normals of the height field are precomputed
+        bool hasVerticesNormals() const;
+
         /// Return the local bounds of the shape in x, y and z directions.
         virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
 
@@ -183,7 +265,13 @@ inline HeightFieldShape::HeightDataType HeightFieldShape::getHeightDataType() co
 
 // Return the number of bytes used by the collision shape
 inline size_t HeightFieldShape::getSizeInBytes() const {
-    return sizeof(HeightFieldShape);
+    return sizeof(HeightFieldShape) + mHeightPyramidLevels.size() * sizeof(HeightPyramidLevel) +
+           mHeightPyramidMinMax.size() * sizeof(decimal) + mVerticesNormals.size() * sizeof(Vector3);
+}
+
+// Return true if the vertices normals of the height field are precomputed
+inline bool HeightFieldShape::hasVerticesNormals() const {
+    return mVerticesNormals.size() > 0;
 }
 
 // Return the height of a given (x,y) point in the height field
@@ -192,12 +280,21 @@ inline decimal HeightFieldShape::getHeightAt(int x, int y) const {
     assert(x >= 0 && x < mNbColumns);
     assert(y >= 0 && y < mNbRows);
 
-    switch(mHeightDataType) {
-        case HeightDataType::HEIGHT_FLOAT_TYPE : return ((float*)mHeightFieldData)[y * mNbColumns + x];
-        case HeightDataType::HEIGHT_DOUBLE_TYPE : return ((double*)mHeightFieldData)[y * mNbColumns + x];
-        case HeightDataType::HEIGHT_INT_TYPE : return ((int*)mHeightFieldData)[y * mNbColumns + x] * mIntegerHeightScale;
-        default: assert(false); return 0;
-    }
+    decimal height;
+    mSampleHeights(mHeightFieldData, y * mNbColumns + x, 1, mIntegerHeightScale, &height);
+
+    return height;
+}
+
+// Return the vertex (local-coordinates without scaling) of a grid point with a given height value
+inline Vector3 HeightFieldShape::computeVertex(int x, int y, decimal height) const {
+
+    Vector3 vertex;
+    vertex[mColumnAxis] = -mWidth * decimal(0.5) + x;
+    vertex[mRowAxis] = -mLength * decimal(0.5) + y;
+    vertex[mUpAxis] = mHeightOrigin + height;
+
+    return vertex;
 }
 
 // Return the closest inside integer grid value of a given floating grid value
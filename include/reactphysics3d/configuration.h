@@ -81,6 +81,20 @@ enum class JointsPositionCorrectionTechnique {BAUMGARTE_JOINTS, NON_LINEAR_GAUSS
 ///                 bodies momentum. This is the option used by default.
 enum class ContactsPositionCorrectionTechnique {BAUMGARTE_CONTACTS, SPLIT_IMPULSES};
 
+/// Algorithm used to find the overlapping pairs of moving colliders in the broad-phase
+/// DYNAMIC_AABB_TREE : Dynamic AABB tree. This is the option used by default.
+/// SWEEP_AND_PRUNE : Incremental sweep-and-prune. This can be faster when many small
+///                   colliders move a little bit at each frame (mostly planar worlds for instance).
+enum class BroadPhaseAlgorithmType {DYNAMIC_AABB_TREE, SWEEP_AND_PRUNE};
+
+/// Policy used to compute the fat AABBs of the colliders of the non-static bodies in the broad-phase
+/// CONSTANT_PERCENTAGE : The AABBs are inflated by a constant percentage of their size. This is the
+///                       option used by default.
+/// VELOCITY_PREDICTIVE : The AABBs are inflated by a smaller percentage of their size and extended
+///                       along the linear velocity of the body times the time step. Fast bodies leave
+///                       their fat AABB less often and slow bodies get tighter fat AABBs.
+enum class FatAABBMarginPolicy {CONSTANT_PERCENTAGE, VELOCITY_PREDICTIVE};
+
 // ------------------- Constants ------------------- //
 
 /// Smallest decimal value (negative)
@@ -103,6 +117,15 @@ constexpr decimal PI_TIMES_2 = decimal(6.28318530);
 /// without triggering a large modification of the tree each frame which can be costly
 constexpr decimal DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE = decimal(0.08);
 
+/// Percentage of the size of the AABBs used to inflate them in the broad-phase when the fat AABBs
+/// are also extended along the velocity of the bodies (FatAABBMarginPolicy::VELOCITY_PREDICTIVE)
+constexpr decimal PREDICTIVE_FAT_AABB_INFLATE_PERCENTAGE = decimal(0.02);
+
+/// In the middle-phase collision detection of a convex vs concave pair, the triangles of the concave shape
+/// are queried with the AABB of the convex shape inflated by this percentage of its size and they are
+/// reused in the next frames as long as the convex shape stays inside this inflated AABB
+constexpr decimal CONCAVE_TRIANGLES_CACHE_AABB_INFLATE_PERCENTAGE = decimal(0.25);
+
 /// Current version of ReactPhysics3D
 const std::string RP3D_VERSION = std::string("0.8.0");
 
@@ -298,7 +298,7 @@ class List {
         void addWithoutInit(uint nbElements) {
 
             // If we need to allocate more memory
-            if (mSize == mCapacity) {
+            if (mSize + nbElements > mCapacity) {
                 reserve(mCapacity == 0 ? nbElements : (mCapacity + nbElements) * 2);
             }
 
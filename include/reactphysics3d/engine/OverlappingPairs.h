@@ -28,6 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/collision/Collider.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/containers/Map.h>
 #include <reactphysics3d/containers/Pair.h>
 #include <reactphysics3d/containers/Set.h>
@@ -74,6 +75,12 @@ struct LastFrameCollisionInfo {
     /// Previous separating axis
     Vector3 gjkSeparatingAxis;
 
+    // ----- GJK and SAT Algorithms -----
+
+    /// Indices of the last support vertices of the two shapes (where the next support point search starts)
+    uint supportVertexIndex1;
+    uint supportVertexIndex2;
+
     // SAT Algorithm
     bool satIsAxisFacePolyhedron1;
     bool satIsAxisFacePolyhedron2;
@@ -81,6 +88,45 @@ struct LastFrameCollisionInfo {
     uint satMinEdge1Index;
     uint satMinEdge2Index;
 
+    // ----- Narrow-phase cache -----
+
+    /// Maximum number of contact points of a cached narrow-phase result
+    static const uint8 NB_MAX_CACHED_CONTACT_POINTS = 8;
+
+    /// Contact point of a cached narrow-phase result
+    struct CachedContactPoint {
+
+        /// Contact normal in the local-space of shape 1
+        Vector3 localNormal;
+
+        /// Penetration depth of the contact
+        decimal penetrationDepth;
+
+        /// Contact point in the local-space of shape 1
+        Vector3 localPoint1;
+
+        /// Contact point in the local-space of shape 2
+        Vector3 localPoint2;
+    };
+
+    /// True if the cached narrow-phase result below can be reused
+    bool isNarrowPhaseCacheValid;
+
+    /// True if the two shapes were colliding in the cached narrow-phase result
+    bool cachedIsColliding;
+
+    /// True if the contact points were computed in the cached narrow-phase result
+    bool cachedReportContacts;
+
+    /// Number of cached contact points
+    uint8 nbCachedContactPoints;
+
+    /// Transform from the local-space of shape 2 to the local-space of shape 1 when the result has been cached
+    Transform cachedShape2ToShape1Transform;
+
+    /// Cached contact points
+    CachedContactPoint cachedContactPoints[NB_MAX_CACHED_CONTACT_POINTS];
+
     /// Constructor
     LastFrameCollisionInfo() {
 
@@ -91,6 +137,44 @@ struct LastFrameCollisionInfo {
         wasUsingGJK = false;
 
         gjkSeparatingAxis = Vector3(0, 1, 0);
+        supportVertexIndex1 = 0;
+        supportVertexIndex2 = 0;
+
+        isNarrowPhaseCacheValid = false;
+        cachedIsColliding = false;
+        cachedReportContacts = false;
+        nbCachedContactPoints = 0;
+    }
+};
+
+// Structure ConcaveTrianglesCache
+/**
+ * This structure contains the triangles of the concave shape of a convex vs concave
+ * overlapping pair that overlap with an enlarged AABB of the convex shape. The
+ * middle-phase reuses those triangles as long as the AABB of the convex shape stays
+ * inside the enlarged AABB.
+ */
+struct ConcaveTrianglesCache {
+
+    /// True if the cached triangles are valid
+    bool isValid;
+
+    /// Enlarged AABB (in the local-space of the concave shape) used to query the cached triangles
+    AABB queryAABB;
+
+    /// Vertices of the cached triangles (three vertices per triangle)
+    List<Vector3> triangleVertices;
+
+    /// Vertices normals of the cached triangles (three normals per triangle)
+    List<Vector3> triangleVerticesNormals;
+
+    /// Ids of the cached triangles
+    List<uint> shapeIds;
+
+    /// Constructor
+    ConcaveTrianglesCache(MemoryAllocator& allocator)
+        : isValid(false), triangleVertices(allocator), triangleVerticesNormals(allocator), shapeIds(allocator) {
+
     }
 };
 
@@ -179,6 +263,10 @@ class OverlappingPairs {
         /// True if the colliders of the overlapping pair are colliding in the current frame
         bool* mCollidingInCurrentFrame;
 
+        /// Cached triangles of the concave shape of the convex vs concave pairs (nullptr until
+        /// the middle-phase of the pair has been computed once)
+        ConcaveTrianglesCache** mConcaveTrianglesCaches;
+
         /// Reference to the colliders components
         ColliderComponents& mColliderComponents;
 
@@ -212,6 +300,9 @@ class OverlappingPairs {
         /// Destroy a pair at a given index
         void destroyPair(uint64 index);
 
+        /// Release the memory of the last frame collision infos and of the triangles cache of a pair
+        void releasePairCaches(uint64 index);
+
         // Move a pair from a source to a destination index in the pairs array
         void movePairToIndex(uint64 srcIndex, uint64 destIndex);
 
@@ -282,9 +373,18 @@ class OverlappingPairs {
         /// Delete all the obsolete last frame collision info
         void clearObsoleteLastFrameCollisionInfos();
 
+        /// Invalidate the cached narrow-phase results of a pair
+        void invalidateNarrowPhaseCaches(uint64 pairIndex);
+
+        /// Return the triangles cache of a convex vs concave pair (created if necessary)
+        ConcaveTrianglesCache* getConcaveTrianglesCache(uint64 pairIndex);
+
         /// Set the collidingInPreviousFrame value with the collidinginCurrentFrame value for each pair
         void updateCollidingInPreviousFrame();
 
+        /// Update the broad-phase IDs and the IDs of the pairs after the broad-phase IDs of colliders have changed
+        void remapBroadPhaseIds(const Map<int32, int32>& mapOldToNewBroadPhaseIds, Map<uint64, uint64>& outMapOldToNewPairIds);
+
         /// Return the pair of bodies index of the pair
         static bodypair computeBodiesIndexPair(Entity body1Entity, Entity body2Entity);
 
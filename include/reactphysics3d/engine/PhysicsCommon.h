@@ -152,7 +152,7 @@ class PhysicsCommon {
         HeightFieldShape* createHeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                                                  const void* heightFieldData, HeightFieldShape::HeightDataType dataType,
                                                  int upAxis = 1, decimal integerHeightScale = 1.0f,
-                                                  const Vector3& scaling = Vector3(1,1,1));
+                                                  const Vector3& scaling = Vector3(1,1,1), bool computeVerticesNormals = false);
 
         /// Destroy a height-field shape
         void destroyHeightFieldShape(HeightFieldShape* heightFieldShape);
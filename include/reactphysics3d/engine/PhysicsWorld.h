@@ -50,6 +50,7 @@
 #include <reactphysics3d/systems/ContactSolverSystem.h>
 #include <reactphysics3d/systems/DynamicsSystem.h>
 #include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/engine/ThreadPool.h>
 #include <reactphysics3d/utils/DebugRenderer.h>
 #include <sstream>
 
@@ -124,6 +125,48 @@ class PhysicsWorld {
             /// than the value bellow, the manifold are considered to be similar.
             decimal cosAngleSimilarContactManifold;
 
+            /// Number of threads (including the thread calling PhysicsWorld::update()) used to run
+            /// the parallel parts of the collision detection. With a single thread, everything
+            /// runs sequentially on the calling thread.
+            uint nbWorkerThreads;
+
+            /// True if the broad-phase AABB trees also use a wide (SIMD-friendly) node layout for
+            /// their queries. This can reduce the cache misses of the queries on very large trees.
+            bool isBroadPhaseWideTreeEnabled;
+
+            /// True if the broad-phase AABB tree of the colliders of the static bodies also uses a
+            /// quantized (compressed) node layout for its queries. This reduces the memory traffic
+            /// of the queries on large static worlds.
+            bool isBroadPhaseStaticTreeQuantized;
+
+            /// Number of insertions and removals of colliders in the broad-phase trees after which
+            /// the nodes of the trees are rewritten in depth-first order to improve the cache locality
+            /// of the queries (zero to disable the automatic compaction)
+            uint broadPhaseCompactionThreshold;
+
+            /// Algorithm used by the broad-phase to find the overlapping pairs of the colliders
+            /// of the non-static bodies. The colliders of the static bodies are always stored in
+            /// an AABB tree.
+            BroadPhaseAlgorithmType broadPhaseAlgorithmType;
+
+            /// Policy used to compute the fat AABBs of the colliders of the non-static bodies in the broad-phase
+            FatAABBMarginPolicy fatAABBMarginPolicy;
+
+            /// With the VELOCITY_PREDICTIVE fat AABB policy, the fat AABBs are extended along the linear
+            /// displacement of the body during a time step multiplied by this factor
+            decimal fatAABBVelocityMultiplier;
+
+            /// True if the narrow-phase reuses the result (collision state and contact points) computed for two
+            /// colliders in a previous frame as long as their relative transform has not changed by more than
+            /// the tolerances below. This avoids running the narrow-phase algorithms on resting contacts.
+            bool isNarrowPhaseCacheEnabled;
+
+            /// Maximum relative translation (in meters) between two colliders for their cached narrow-phase result to be reused
+            decimal narrowPhaseCacheTranslationTolerance;
+
+            /// Maximum relative rotation angle (in radians) between two colliders for their cached narrow-phase result to be reused
+            decimal narrowPhaseCacheRotationTolerance;
+
             WorldSettings() {
 
                 worldName = "";
@@ -141,6 +184,16 @@ class PhysicsWorld {
                 defaultSleepAngularVelocity = decimal(3.0) * (PI / decimal(180.0));
                 nbMaxContactManifolds = 3;
                 cosAngleSimilarContactManifold = decimal(0.95);
+                nbWorkerThreads = 1;
+                isBroadPhaseWideTreeEnabled = false;
+                isBroadPhaseStaticTreeQuantized = false;
+                broadPhaseCompactionThreshold = 0;
+                broadPhaseAlgorithmType = BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE;
+                fatAABBMarginPolicy = FatAABBMarginPolicy::CONSTANT_PERCENTAGE;
+                fatAABBVelocityMultiplier = decimal(2.0);
+                isNarrowPhaseCacheEnabled = false;
+                narrowPhaseCacheTranslationTolerance = decimal(0.001);
+                narrowPhaseCacheRotationTolerance = decimal(0.001);
 
             }
 
@@ -166,6 +219,16 @@ class PhysicsWorld {
                 ss << "defaultSleepAngularVelocity=" << defaultSleepAngularVelocity << std::endl;
                 ss << "nbMaxContactManifolds=" << nbMaxContactManifolds << std::endl;
                 ss << "cosAngleSimilarContactManifold=" << cosAngleSimilarContactManifold << std::endl;
+                ss << "nbWorkerThreads=" << nbWorkerThreads << std::endl;
+                ss << "isBroadPhaseWideTreeEnabled=" << isBroadPhaseWideTreeEnabled << std::endl;
+                ss << "isBroadPhaseStaticTreeQuantized=" << isBroadPhaseStaticTreeQuantized << std::endl;
+                ss << "broadPhaseCompactionThreshold=" << broadPhaseCompactionThreshold << std::endl;
+                ss << "broadPhaseAlgorithmType=" << static_cast<int>(broadPhaseAlgorithmType) << std::endl;
+                ss << "fatAABBMarginPolicy=" << static_cast<int>(fatAABBMarginPolicy) << std::endl;
+                ss << "fatAABBVelocityMultiplier=" << fatAABBVelocityMultiplier << std::endl;
+                ss << "isNarrowPhaseCacheEnabled=" << isNarrowPhaseCacheEnabled << std::endl;
+                ss << "narrowPhaseCacheTranslationTolerance=" << narrowPhaseCacheTranslationTolerance << std::endl;
+                ss << "narrowPhaseCacheRotationTolerance=" << narrowPhaseCacheRotationTolerance << std::endl;
 
                 return ss.str();
             }
@@ -217,6 +280,9 @@ class PhysicsWorld {
         /// Slider joints Components
         SliderJointComponents mSliderJointsComponents;
 
+        /// Thread pool used to run the parallel parts of the simulation
+        ThreadPool mThreadPool;
+
         /// Reference to the collision detection
         CollisionDetectionSystem mCollisionDetection;
 
@@ -331,6 +397,37 @@ class PhysicsWorld {
         /// Ray cast method
         void raycast(const Ray& ray, RaycastCallback* raycastCallback, unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
 
+        /// Sweep a convex shape through the world and report the colliders it hits
+        void sweep(const ConvexShape* shape, const Transform& fromTransform, const Transform& toTransform,
+                   RaycastCallback* sweepCallback, unsigned short sweepWithCategoryMaskBits = 0xFFFF) const;
+
+        /// Compute the closest hit of each ray of a batch of rays
+        uint raycastBatch(const Ray* rays, uint nbRays, RaycastInfo* outHits,
+                          unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+
+        /// Find the colliders overlapping with an AABB
+        uint queryAABB(const AABB& aabb, Collider** outColliders, uint maxNbColliders,
+                       unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the colliders overlapping with a sphere
+        uint querySphere(const Vector3& center, decimal radius, Collider** outColliders, uint maxNbColliders,
+                         unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the colliders overlapping with a frustum
+        uint queryFrustum(const Frustum& frustum, Collider** outColliders, uint maxNbColliders,
+                          unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Find the colliders overlapping with a shape that is not attached to a body
+        uint overlapShape(const CollisionShape& shape, const Transform& transform, Collider** outColliders,
+                          uint maxNbColliders, unsigned short categoryMaskBits = 0xFFFF) const;
+
+        /// Compute the distance and the closest points between two convex colliders
+        bool computeDistance(Collider* collider1, Collider* collider2, DistanceInfo& distanceInfo) const;
+
+        /// Find the closest collider to a convex shape within a maximum distance
+        bool findClosestCollider(const ConvexShape& shape, const Transform& transform, decimal maxDistance,
+                                 DistanceInfo& outDistanceInfo, unsigned short categoryMaskBits = 0xFFFF) const;
+
         /// Return true if two bodies overlap (collide)
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -466,6 +563,27 @@ class PhysicsWorld {
         /// Return a reference to the Debug Renderer of the world
         DebugRenderer& getDebugRenderer();
 
+        /// Reinsert some leaves of the broad-phase trees to improve their quality
+        void optimizeBroadPhase(uint nbLeavesToReinsert);
+
+        /// Rebuild the broad-phase trees from scratch
+        void rebuildBroadPhase();
+
+        /// Rewrite the nodes of the broad-phase trees in depth-first order
+        void compactBroadPhase();
+
+        /// Return the cost of the broad-phase tree of the non-static colliders
+        decimal getBroadPhaseTreeCost() const;
+
+        /// Return the number of insertions and removals in the broad-phase tree of the non-static colliders
+        uint getNbBroadPhaseStructuralChanges() const;
+
+        /// Start a bulk load of colliders into the broad-phase
+        void beginBulkLoad();
+
+        /// End the bulk load of colliders and build the broad-phase trees
+        void endBulkLoad();
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Return a reference to the profiler
@@ -517,6 +635,149 @@ inline void PhysicsWorld::raycast(const Ray& ray,
     mCollisionDetection.raycast(raycastCallback, ray, raycastWithCategoryMaskBits);
 }
 
+// Sweep a convex shape through the world and report the colliders it hits
+/// The shape translates from the position of "fromTransform" to the position of "toTransform"
+/// while keeping the orientation of "fromTransform". For each collider hit by the shape, the
+/// notifyRaycastHit() method of the callback is called with the first contact: the hit fraction
+/// is the fraction of the translation where the shape touches the collider, the world point is
+/// on the collider and the world normal points from the collider toward the shape. If the shape
+/// already overlaps with a collider at "fromTransform", the hit fraction is zero. The value returned
+/// by the callback is used the same way as for the raycast() method. The colliders are not
+/// reported in any particular order.
+/**
+ * @param shape Convex shape to sweep
+ * @param fromTransform Local-to-world transform of the shape at the start of the sweep
+ * @param toTransform Local-to-world transform of the shape at the end of the sweep
+ * @param sweepCallback Pointer to the class with the callback method
+ * @param sweepWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                  colliders to be tested
+ */
+inline void PhysicsWorld::sweep(const ConvexShape* shape, const Transform& fromTransform, const Transform& toTransform,
+                                RaycastCallback* sweepCallback, unsigned short sweepWithCategoryMaskBits) const {
+    mCollisionDetection.sweep(shape, fromTransform, toTransform, sweepCallback, sweepWithCategoryMaskBits);
+}
+
+// Compute the closest hit of each ray of a batch of rays
+/// The closest hit of the i-th ray is written into the i-th raycast info of the output array.
+/// If a ray does not hit anything, the collider and the body of its raycast info are nullptr.
+/// The consecutive rays of the batch that start close to each other with similar directions
+/// share the traversal of the broad-phase. Therefore, sorting the rays (by origin and direction)
+/// can make the batch faster. Large batches are split between the threads of the world.
+/**
+ * @param rays Array with the rays to use for raycasting
+ * @param nbRays Number of rays in the array
+ * @param outHits Array with a raycast info for each ray where the closest hits are written
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    colliders to be raycasted
+ * @return The number of rays that hit a collider
+ */
+inline uint PhysicsWorld::raycastBatch(const Ray* rays, uint nbRays, RaycastInfo* outHits,
+                                       unsigned short raycastWithCategoryMaskBits) const {
+    return mCollisionDetection.mBroadPhaseSystem.raycastBatch(rays, nbRays, outHits, raycastWithCategoryMaskBits,
+                                                              mMemoryManager.getPoolAllocator());
+}
+
+// Find the colliders overlapping with an AABB
+/// The colliders whose world-space AABB overlaps with the AABB in parameter are written
+/// into a buffer provided by the caller. Nothing is allocated by the query. The returned value
+/// is the total number of overlapping colliders. If it is larger than the size of the buffer,
+/// only the first colliders have been written and the query can be done again with a larger buffer.
+/// The colliders of a bulk load that has not been ended are not reported.
+/**
+ * @param aabb AABB in world-space
+ * @param outColliders Buffer where the overlapping colliders are written
+ * @param maxNbColliders Number of colliders that can be written into the buffer
+ * @param categoryMaskBits Bits mask corresponding to the category of colliders to be reported
+ * @return The number of colliders overlapping with the AABB
+ */
+inline uint PhysicsWorld::queryAABB(const AABB& aabb, Collider** outColliders, uint maxNbColliders,
+                                    unsigned short categoryMaskBits) const {
+    return mCollisionDetection.mBroadPhaseSystem.queryAABB(aabb, categoryMaskBits, outColliders, maxNbColliders);
+}
+
+// Find the colliders overlapping with a sphere
+/// The colliders whose world-space AABB overlaps with the sphere are written into a buffer
+/// provided by the caller (see queryAABB()).
+/**
+ * @param center Center of the sphere in world-space
+ * @param radius Radius of the sphere
+ * @param outColliders Buffer where the overlapping colliders are written
+ * @param maxNbColliders Number of colliders that can be written into the buffer
+ * @param categoryMaskBits Bits mask corresponding to the category of colliders to be reported
+ * @return The number of colliders overlapping with the sphere
+ */
+inline uint PhysicsWorld::querySphere(const Vector3& center, decimal radius, Collider** outColliders, uint maxNbColliders,
+                                      unsigned short categoryMaskBits) const {
+    return mCollisionDetection.mBroadPhaseSystem.querySphere(center, radius, categoryMaskBits, outColliders, maxNbColliders);
+}
+
+// Find the colliders overlapping with a frustum
+/// The colliders whose world-space AABB is not completely outside of one of the planes of the
+/// frustum are written into a buffer provided by the caller (see queryAABB()). A few colliders
+/// close to the edges of the frustum can be reported even if they are outside of it.
+/**
+ * @param frustum Frustum in world-space
+ * @param outColliders Buffer where the overlapping colliders are written
+ * @param maxNbColliders Number of colliders that can be written into the buffer
+ * @param categoryMaskBits Bits mask corresponding to the category of colliders to be reported
+ * @return The number of colliders overlapping with the frustum
+ */
+inline uint PhysicsWorld::queryFrustum(const Frustum& frustum, Collider** outColliders, uint maxNbColliders,
+                                       unsigned short categoryMaskBits) const {
+    return mCollisionDetection.mBroadPhaseSystem.queryFrustum(frustum, categoryMaskBits, outColliders, maxNbColliders);
+}
+
+// Find the colliders overlapping with a shape that is not attached to a body
+/// Contrary to queryAABB(), the shape is tested against the actual shapes of the colliders
+/// (not only their AABBs) but no contact point is computed. No body or collider is created
+/// for the shape. The colliders are written into a buffer provided by the caller (see queryAABB()).
+/// A concave shape is never reported as overlapping with another concave shape.
+/**
+ * @param shape Collision shape to test
+ * @param transform Local-to-world transform of the shape
+ * @param outColliders Buffer where the overlapping colliders are written
+ * @param maxNbColliders Number of colliders that can be written into the buffer
+ * @param categoryMaskBits Bits mask corresponding to the category of colliders to be reported
+ * @return The number of colliders overlapping with the shape
+ */
+inline uint PhysicsWorld::overlapShape(const CollisionShape& shape, const Transform& transform, Collider** outColliders,
+                                       uint maxNbColliders, unsigned short categoryMaskBits) const {
+    return mCollisionDetection.overlapShape(&shape, transform, categoryMaskBits, outColliders, maxNbColliders);
+}
+
+// Compute the distance and the closest points between two convex colliders
+/// The separating axis stored in the distance info is used to start the search if it is not
+/// zero and it is replaced by the new separating axis. Keep the same distance info for a pair
+/// of colliders between two frames to start from the axis of the previous frame. If the colliders
+/// overlap, the distance is zero and the closest points are not computed. The two colliders
+/// must have a convex collision shape.
+/**
+ * @param collider1 Pointer to the first collider
+ * @param collider2 Pointer to the second collider
+ * @param distanceInfo Separating axis of the previous query and result of the query
+ * @return True if the two colliders are separated
+ */
+inline bool PhysicsWorld::computeDistance(Collider* collider1, Collider* collider2, DistanceInfo& distanceInfo) const {
+    return mCollisionDetection.computeDistance(collider1, collider2, distanceInfo);
+}
+
+// Find the closest collider to a convex shape within a maximum distance
+/// The shape is not attached to a body. The first point of the distance info is on the shape
+/// and the second one is on the closest collider. If the shape overlaps with a collider, the
+/// distance is zero and the closest points are not computed.
+/**
+ * @param shape Convex shape
+ * @param transform Local-to-world transform of the shape
+ * @param maxDistance Maximum distance between the shape and the colliders
+ * @param outDistanceInfo Distance to the closest collider and closest points
+ * @param categoryMaskBits Bits mask corresponding to the category of colliders to be tested
+ * @return True if a collider is closer than the maximum distance
+ */
+inline bool PhysicsWorld::findClosestCollider(const ConvexShape& shape, const Transform& transform, decimal maxDistance,
+                                              DistanceInfo& outDistanceInfo, unsigned short categoryMaskBits) const {
+    return mCollisionDetection.findClosestCollider(&shape, transform, maxDistance, categoryMaskBits, outDistanceInfo);
+}
+
 // Test collision and report contacts between two bodies.
 /// Use this method if you only want to get all the contacts between two bodies.
 /// All the contacts will be reported using the callback object in paramater.
@@ -0,0 +1,149 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_THREAD_POOL_H
+#define REACTPHYSICS3D_THREAD_POOL_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class MemoryAllocator;
+
+// Class ThreadPoolTask
+/**
+ * This is the interface of a job that can be executed by the thread pool. The job
+ * is split into a given number of tasks and the run() method is called once for
+ * each task index. Tasks of the same job can run concurrently on different threads.
+ */
+class ThreadPoolTask {
+
+    public:
+
+        /// Destructor
+        virtual ~ThreadPoolTask() = default;
+
+        /// Execute the task with a given index. The thread index is in the range
+        /// [0, ThreadPool::getNbThreads()) and can be used to select per-thread data.
+        virtual void run(uint32 taskIndex, uint32 threadIndex)=0;
+};
+
+// Class ThreadPool
+/**
+ * This class represents a set of persistent worker threads used to run the parallel
+ * parts of the simulation. The thread calling the execute() method also takes part
+ * in the work and always has the thread index zero. With a single thread, all the
+ * tasks are executed sequentially on the calling thread. Note that the profiler is not
+ * thread-safe. Therefore, when profiling is enabled, all the tasks are always executed
+ * on the calling thread.
+ */
+class ThreadPool {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Number of threads (including the calling thread)
+        uint32 mNbThreads;
+
+        /// Array with the worker threads (mNbThreads - 1 threads)
+        std::thread* mWorkers;
+
+        /// Mutex protecting the state of the current job
+        std::mutex mMutex;
+
+        /// Condition used to wake up the workers when a new job is available
+        std::condition_variable mWorkCondition;
+
+        /// Condition used to notify the calling thread that the workers have finished
+        std::condition_variable mDoneCondition;
+
+        /// Current job (null if there is no job in progress)
+        ThreadPoolTask* mTask;
+
+        /// Number of tasks of the current job
+        uint32 mNbTasks;
+
+        /// Index of the next task to execute in the current job
+        std::atomic<uint32> mNextTaskIndex;
+
+        /// Counter incremented each time a new job is started
+        uint64 mJobGeneration;
+
+        /// Number of workers currently executing tasks of the current job
+        uint32 mNbActiveWorkers;
+
+        /// True if the workers need to exit
+        bool mIsShuttingDown;
+
+        // -------------------- Methods -------------------- //
+
+        /// Main loop of a worker thread
+        void workerLoop(uint32 threadIndex);
+
+        /// Execute the remaining tasks of a job
+        void runTasks(ThreadPoolTask& task, uint32 nbTasks, uint32 threadIndex);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ThreadPool(uint32 nbThreads, MemoryAllocator& allocator);
+
+        /// Destructor
+        ~ThreadPool();
+
+        /// Deleted copy-constructor
+        ThreadPool(const ThreadPool& threadPool) = delete;
+
+        /// Deleted assignment operator
+        ThreadPool& operator=(const ThreadPool& threadPool) = delete;
+
+        /// Return the number of threads (including the calling thread)
+        uint32 getNbThreads() const;
+
+        /// Execute a given number of tasks and wait until all of them are finished
+        void execute(ThreadPoolTask& task, uint32 nbTasks);
+};
+
+// Return the number of threads (including the calling thread)
+inline uint32 ThreadPool::getNbThreads() const {
+    return mNbThreads;
+}
+
+}
+
+#endif
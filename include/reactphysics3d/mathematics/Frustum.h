@@ -0,0 +1,153 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_FRUSTUM_H
+#define REACTPHYSICS3D_FRUSTUM_H
+
+// Libraries
+#include <reactphysics3d/mathematics/Vector3.h>
+#include <reactphysics3d/mathematics/Transform.h>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Structure Frustum
+/**
+ * This structure represents a convex volume bounded by six planes (a view frustum
+ * for instance). Each plane is given by a unit normal pointing toward the inside of
+ * the frustum and a distance such that a point p is on the inner side of the plane if
+ * dot(normal, p) + distance >= 0. The planes are ordered by pairs of opposite planes:
+ * left and right, bottom and top and then near and far. The planes are specified in
+ * world-space coordinates.
+ */
+struct Frustum {
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of planes of the frustum
+        static const int NB_PLANES = 6;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Unit normals of the planes (pointing toward the inside of the frustum)
+        Vector3 planeNormals[NB_PLANES];
+
+        /// Distances of the planes
+        decimal planeDistances[NB_PLANES];
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor with the normals and distances of the six planes
+        Frustum(const Vector3* normals, const decimal* distances) {
+            for (int i=0; i < NB_PLANES; i++) {
+                planeNormals[i] = normals[i];
+                planeDistances[i] = distances[i];
+            }
+        }
+
+        /// Destructor
+        ~Frustum() = default;
+
+        /// Return true if a point is inside the frustum
+        bool contains(const Vector3& point) const;
+
+        /// Compute the eight corners of the frustum
+        void computeCorners(Vector3* outCorners) const;
+
+        /// Create the frustum of a perspective camera
+        static Frustum createPerspective(const Transform& transform, decimal fieldOfViewY, decimal aspectRatio,
+                                         decimal nearDistance, decimal farDistance);
+};
+
+// Return true if a point is inside the frustum
+inline bool Frustum::contains(const Vector3& point) const {
+    for (int i=0; i < NB_PLANES; i++) {
+        if (planeNormals[i].dot(point) + planeDistances[i] < decimal(0.0)) return false;
+    }
+    return true;
+}
+
+// Compute the eight corners of the frustum
+/// Each corner is the intersection of a plane of each pair of opposite planes. The
+/// array "outCorners" must have space for eight points.
+inline void Frustum::computeCorners(Vector3* outCorners) const {
+
+    for (int i=0; i < 8; i++) {
+
+        const int p1 = (i & 1);
+        const int p2 = 2 + ((i >> 1) & 1);
+        const int p3 = 4 + ((i >> 2) & 1);
+
+        const Vector3 n2CrossN3 = planeNormals[p2].cross(planeNormals[p3]);
+        const Vector3 n3CrossN1 = planeNormals[p3].cross(planeNormals[p1]);
+        const Vector3 n1CrossN2 = planeNormals[p1].cross(planeNormals[p2]);
+        const decimal denominator = planeNormals[p1].dot(n2CrossN3);
+        assert(std::abs(denominator) > MACHINE_EPSILON);
+
+        outCorners[i] = (planeDistances[p1] * n2CrossN3 + planeDistances[p2] * n3CrossN1 +
+                         planeDistances[p3] * n1CrossN2) * (decimal(-1.0) / denominator);
+    }
+}
+
+// Create the frustum of a perspective camera
+/// The camera is located at the origin of the transform and looks along the -Z axis of the
+/// transform (the Y axis is the up direction of the camera).
+/**
+ * @param transform Transform from the camera-space to the world-space
+ * @param fieldOfViewY Vertical field of view angle (in radians)
+ * @param aspectRatio Ratio between the width and the height of the view
+ * @param nearDistance Distance between the camera and the near plane
+ * @param farDistance Distance between the camera and the far plane
+ * @return The frustum in world-space
+ */
+inline Frustum Frustum::createPerspective(const Transform& transform, decimal fieldOfViewY, decimal aspectRatio,
+                                          decimal nearDistance, decimal farDistance) {
+
+    assert(nearDistance > decimal(0.0) && farDistance > nearDistance);
+
+    const decimal tanHalfFovY = std::tan(fieldOfViewY * decimal(0.5));
+    const decimal tanHalfFovX = tanHalfFovY * aspectRatio;
+
+    // Planes in camera-space
+    Vector3 normals[NB_PLANES] = {Vector3(1, 0, -tanHalfFovX), Vector3(-1, 0, -tanHalfFovX),
+                                  Vector3(0, 1, -tanHalfFovY), Vector3(0, -1, -tanHalfFovY),
+                                  Vector3(0, 0, -1), Vector3(0, 0, 1)};
+    decimal distances[NB_PLANES] = {0, 0, 0, 0, -nearDistance, farDistance};
+
+    // Transform the planes into world-space
+    const Quaternion& orientation = transform.getOrientation();
+    for (int i=0; i < NB_PLANES; i++) {
+        normals[i] = orientation * normals[i].getUnit();
+        distances[i] -= normals[i].dot(transform.getPosition());
+    }
+
+    return Frustum(normals, distances);
+}
+
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include <reactphysics3d/mathematics/Vector2.h>
 #include <reactphysics3d/mathematics/Transform.h>
 #include <reactphysics3d/mathematics/Ray.h>
+#include <reactphysics3d/mathematics/Frustum.h>
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/mathematics/mathematics_functions.h>
 #include <cstdio>
@@ -83,6 +83,23 @@ inline bool sameSign(decimal a, decimal b) {
     return a * b >= decimal(0.0);
 }
 
+/// Return the index of the lowest bit set in a non-zero 32-bits mask
+inline uint32 computeIndexLowestBit(uint32 mask) {
+
+    assert(mask != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32>(__builtin_ctz(mask));
+#else
+    uint32 index = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
 /// Return true if two vectors are parallel
 bool areParallelVectors(const Vector3& vector1, const Vector3& vector2);
 
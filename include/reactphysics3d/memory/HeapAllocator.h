@@ -51,7 +51,7 @@ class HeapAllocator : public MemoryAllocator {
         /**
          * Represent the header of a memory unit in the heap
          */
-        struct MemoryUnitHeader {
+        struct alignas(16) MemoryUnitHeader {
 
             public :
 
@@ -87,6 +87,10 @@ class HeapAllocator : public MemoryAllocator {
 
         static size_t INIT_ALLOCATED_SIZE;
 
+        /// Alignment (in bytes) of the allocated memory. The sizes of the memory units and
+        /// of their headers are multiples of it so that every unit starts at an aligned address.
+        static const size_t MEMORY_ALIGNMENT = 16;
+
         // -------------------- Attributes -------------------- //
 
         // Mutex
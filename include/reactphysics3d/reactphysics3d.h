@@ -54,6 +54,7 @@
 #include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/collision/Collider.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/DistanceInfo.h>
 #include <reactphysics3d/collision/TriangleMesh.h>
 #include <reactphysics3d/collision/PolyhedronMesh.h>
 #include <reactphysics3d/collision/TriangleVertexArray.h>
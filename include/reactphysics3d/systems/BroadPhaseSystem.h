@@ -28,11 +28,14 @@
 
 // Libraries
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/SweepAndPrune.h>
 #include <reactphysics3d/containers/LinkedList.h>
-#include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/containers/List.h>
+#include <reactphysics3d/containers/Map.h>
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/ThreadPool.h>
 #include <cstring>
 
 /// Namespace ReactPhysics3D
@@ -43,6 +46,7 @@ class CollisionDetectionSystem;
 class BroadPhaseSystem;
 class CollisionBody;
 class Collider;
+struct RaycastInfo;
 class MemoryManager;
 class Profiler;
 
@@ -67,13 +71,16 @@ class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
 // Class BroadPhaseRaycastCallback
 /**
  * Callback called when the AABB of a leaf node is hit by a ray the
- * broad-phase Dynamic AABB Tree.
+ * broad-phase Dynamic AABB Tree (or by a proxy of the sweep-and-prune).
  */
 class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        const DynamicAABBTree& mDynamicAABBTree;
+        const BroadPhaseSystem& mBroadPhaseSystem;
+
+        /// Flag to add to the node IDs to get the broad-phase IDs of the colliders
+        int32 mBroadPhaseIdFlag;
 
         unsigned short mRaycastWithCategoryMaskBits;
 
@@ -82,10 +89,10 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        BroadPhaseRaycastCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
-                                  RaycastTest& raycastTest)
-            : mDynamicAABBTree(dynamicAABBTree), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
-              mRaycastTest(raycastTest) {
+        BroadPhaseRaycastCallback(const BroadPhaseSystem& broadPhaseSystem, int32 broadPhaseIdFlag,
+                                  unsigned short raycastWithCategoryMaskBits, RaycastTest& raycastTest)
+            : mBroadPhaseSystem(broadPhaseSystem), mBroadPhaseIdFlag(broadPhaseIdFlag),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mRaycastTest(raycastTest) {
 
         }
 
@@ -97,23 +104,397 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class BroadPhaseRaycastPacketCallback
+/**
+ * Callback called when the AABB of a leaf node of the broad-phase is hit by a ray
+ * of a packet of rays during a batch of raycasts. It keeps the closest hit of each
+ * ray into an output array of raycast infos.
+ */
+class BroadPhaseRaycastPacketCallback : public DynamicAABBTreeRaycastPacketCallback  {
+
+    private :
+
+        const BroadPhaseSystem& mBroadPhaseSystem;
+
+        /// Bit to add to the node IDs to get the broad-phase IDs
+        int32 mBroadPhaseIdFlag;
+
+        /// Bits mask corresponding to the category of colliders to raycast
+        unsigned short mRaycastWithCategoryMaskBits;
+
+        /// Output raycast infos of the rays of the packet
+        RaycastInfo* mOutHits;
+
+    public:
+
+        // Constructor
+        BroadPhaseRaycastPacketCallback(const BroadPhaseSystem& broadPhaseSystem, unsigned short raycastWithCategoryMaskBits)
+            : mBroadPhaseSystem(broadPhaseSystem), mBroadPhaseIdFlag(0),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mOutHits(nullptr) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseRaycastPacketCallback() override = default;
+
+        /// Set the bit to add to the node IDs to get the broad-phase IDs
+        void setBroadPhaseIdFlag(int32 broadPhaseIdFlag) {
+            mBroadPhaseIdFlag = broadPhaseIdFlag;
+        }
+
+        /// Set the output raycast infos of the rays of the next packet
+        void setOutHits(RaycastInfo* outHits) {
+            mOutHits = outHits;
+        }
+
+        // Called for a broad-phase shape that has to be tested for raycast by a ray of the packet
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray, uint32 rayIndex) override;
+};
+
+// Enumeration RegionQueryType
+/// Shape of the region of a query of the colliders of the broad-phase
+enum class RegionQueryType {AABB_REGION, SPHERE_REGION, FRUSTUM_REGION};
+
+// Class BroadPhaseRegionQueryCallback
+/**
+ * Callback called when the fat AABB of a collider overlaps with the bounding AABB of the
+ * region of a query. The world-space AABB of the collider is then tested against the region
+ * and the collider is written into the output buffer of the query if it overlaps.
+ */
+class BroadPhaseRegionQueryCallback : public DynamicAABBTreeOverlapCallback {
+
+    private :
+
+        const BroadPhaseSystem& mBroadPhaseSystem;
+
+        /// Flag to add to the node IDs to get the broad-phase IDs of the colliders
+        int32 mBroadPhaseIdFlag;
+
+        /// Shape of the region of the query
+        RegionQueryType mRegionType;
+
+        /// AABB region of the query
+        AABB mAABB;
+
+        /// Center of the sphere region of the query
+        Vector3 mSphereCenter;
+
+        /// Radius of the sphere region of the query
+        decimal mSphereRadius;
+
+        /// Frustum region of the query
+        const Frustum* mFrustum;
+
+        unsigned short mCategoryMaskBits;
+
+        /// Buffer where the overlapping colliders are written
+        Collider** mOutColliders;
+
+        /// Number of colliders that can be written into the buffer
+        uint32 mMaxNbColliders;
+
+        /// Number of overlapping colliders found (can be larger than the size of the buffer)
+        uint32 mNbColliders;
+
+    public:
+
+        // Constructor
+        BroadPhaseRegionQueryCallback(const BroadPhaseSystem& broadPhaseSystem, const AABB& aabb, unsigned short categoryMaskBits,
+                                      Collider** outColliders, uint32 maxNbColliders)
+            : mBroadPhaseSystem(broadPhaseSystem), mBroadPhaseIdFlag(0), mRegionType(RegionQueryType::AABB_REGION),
+              mAABB(aabb), mSphereRadius(0), mFrustum(nullptr), mCategoryMaskBits(categoryMaskBits),
+              mOutColliders(outColliders), mMaxNbColliders(maxNbColliders), mNbColliders(0) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseRegionQueryCallback() override = default;
+
+        // Use a sphere region for the query
+        void setSphereRegion(const Vector3& center, decimal radius) {
+            mRegionType = RegionQueryType::SPHERE_REGION;
+            mSphereCenter = center;
+            mSphereRadius = radius;
+        }
+
+        // Use a frustum region for the query
+        void setFrustumRegion(const Frustum& frustum) {
+            mRegionType = RegionQueryType::FRUSTUM_REGION;
+            mFrustum = &frustum;
+        }
+
+        // Set the flag to add to the node IDs to get the broad-phase IDs of the colliders
+        void setBroadPhaseIdFlag(int32 broadPhaseIdFlag) {
+            mBroadPhaseIdFlag = broadPhaseIdFlag;
+        }
+
+        // Return the number of overlapping colliders found
+        uint32 getNbColliders() const {
+            return mNbColliders;
+        }
+
+        // Called when the fat AABB of a collider overlaps with the bounding AABB of the region
+        virtual void notifyOverlappingNode(int nodeId) override;
+};
+
+// Class BroadPhaseOverlappingPairsTask
+/**
+ * Task used to compute the overlapping pairs of a chunk of the shapes that have moved
+ * in the last frame. Each task writes its pairs into its own output list so that the
+ * lists can be merged in a deterministic order once all the tasks are finished.
+ */
+class BroadPhaseOverlappingPairsTask : public ThreadPoolTask {
+
+    private:
+
+        /// Tree to query
+        const DynamicAABBTree& mDynamicAABBTree;
+
+        /// Tree containing the shapes to test
+        const DynamicAABBTree& mShapesTree;
+
+        /// Node IDs (in the shapes tree) of the shapes to test
+        const List<int32>& mShapesToTest;
+
+        /// Number of shapes to test in each task
+        uint32 mNbShapesPerTask;
+
+        /// Array with the output list of overlapping nodes of each task
+        List<Pair<int32, int32>>* mTasksOverlappingNodes;
+
+    public:
+
+        // Constructor
+        BroadPhaseOverlappingPairsTask(const DynamicAABBTree& dynamicAABBTree, const DynamicAABBTree& shapesTree,
+                                       const List<int32>& shapesToTest, uint32 nbShapesPerTask,
+                                       List<Pair<int32, int32>>* tasksOverlappingNodes)
+            : mDynamicAABBTree(dynamicAABBTree), mShapesTree(shapesTree), mShapesToTest(shapesToTest),
+              mNbShapesPerTask(nbShapesPerTask), mTasksOverlappingNodes(tasksOverlappingNodes) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseOverlappingPairsTask() override = default;
+
+        // Compute the overlapping pairs of a chunk of the shapes to test
+        virtual void run(uint32 taskIndex, uint32 threadIndex) override;
+};
+
+// Class BroadPhaseDualTreeTraversalTask
+/**
+ * Task used to run a dual-tree traversal below a chunk of pairs of nodes. Each task writes
+ * its pairs into its own output list so that the lists can be merged in a deterministic order
+ * once all the tasks are finished.
+ */
+class BroadPhaseDualTreeTraversalTask : public ThreadPoolTask {
+
+    private:
+
+        /// First tree of the traversal
+        const DynamicAABBTree& mTree1;
+
+        /// Second tree of the traversal (can be the first one)
+        const DynamicAABBTree& mTree2;
+
+        /// Flags of the nodes of the first tree with a moved leaf in their sub-tree
+        const bool* mMarkedNodes1;
+
+        /// Flags of the nodes of the second tree with a moved leaf in their sub-tree
+        const bool* mMarkedNodes2;
+
+        /// Pairs of nodes where the traversal starts
+        const List<Pair<int32, int32>>& mNodePairs;
+
+        /// Number of pairs of nodes in each task
+        uint32 mNbNodePairsPerTask;
+
+        /// Array with the output list of overlapping nodes of each task
+        List<Pair<int32, int32>>* mTasksOverlappingNodes;
+
+    public:
+
+        // Constructor
+        BroadPhaseDualTreeTraversalTask(const DynamicAABBTree& tree1, const DynamicAABBTree& tree2,
+                                        const bool* markedNodes1, const bool* markedNodes2,
+                                        const List<Pair<int32, int32>>& nodePairs, uint32 nbNodePairsPerTask,
+                                        List<Pair<int32, int32>>* tasksOverlappingNodes)
+            : mTree1(tree1), mTree2(tree2), mMarkedNodes1(markedNodes1), mMarkedNodes2(markedNodes2),
+              mNodePairs(nodePairs), mNbNodePairsPerTask(nbNodePairsPerTask), mTasksOverlappingNodes(tasksOverlappingNodes) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseDualTreeTraversalTask() override = default;
+
+        // Run the dual-tree traversal below a chunk of pairs of nodes
+        virtual void run(uint32 taskIndex, uint32 threadIndex) override;
+};
+
+// Class BroadPhaseSweepAndPruneTask
+/**
+ * Task used to sweep a chunk of the sorted entries of the sweep-and-prune. Each task writes
+ * its pairs into its own output list so that the lists can be merged in a deterministic order
+ * once all the tasks are finished.
+ */
+class BroadPhaseSweepAndPruneTask : public ThreadPoolTask {
+
+    private:
+
+        /// Sweep-and-prune to sweep
+        const SweepAndPrune& mSweepAndPrune;
+
+        /// Flags of the proxies that have moved
+        const bool* mMovedProxies;
+
+        /// Number of entries in each task
+        uint32 mNbEntriesPerTask;
+
+        /// Array with the output list of overlapping proxies of each task
+        List<Pair<int32, int32>>* mTasksOverlappingNodes;
+
+    public:
+
+        // Constructor
+        BroadPhaseSweepAndPruneTask(const SweepAndPrune& sweepAndPrune, const bool* movedProxies, uint32 nbEntriesPerTask,
+                                    List<Pair<int32, int32>>* tasksOverlappingNodes)
+            : mSweepAndPrune(sweepAndPrune), mMovedProxies(movedProxies), mNbEntriesPerTask(nbEntriesPerTask),
+              mTasksOverlappingNodes(tasksOverlappingNodes) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseSweepAndPruneTask() override = default;
+
+        // Sweep a chunk of the sorted entries
+        virtual void run(uint32 taskIndex, uint32 threadIndex) override;
+};
+
+// Class BroadPhaseRaycastBatchTask
+/**
+ * Task used to raycast a chunk of the rays of a batch of raycasts. The consecutive
+ * coherent rays of the chunk are grouped into packets that share the traversal of
+ * the broad-phase.
+ */
+class BroadPhaseRaycastBatchTask : public ThreadPoolTask {
+
+    private:
+
+        /// Reference to the broad-phase
+        const BroadPhaseSystem& mBroadPhaseSystem;
+
+        /// Rays of the batch
+        const Ray* mRays;
+
+        /// Number of rays of the batch
+        uint32 mNbRays;
+
+        /// Number of rays in each task
+        uint32 mNbRaysPerTask;
+
+        /// Bits mask corresponding to the category of colliders to raycast
+        unsigned short mRaycastWithCategoryMaskBits;
+
+        /// Output raycast infos of the rays of the batch
+        RaycastInfo* mOutHits;
+
+        /// Memory allocator for the traversal stacks of the tasks
+        MemoryAllocator& mAllocator;
+
+    public:
+
+        // Constructor
+        BroadPhaseRaycastBatchTask(const BroadPhaseSystem& broadPhaseSystem, const Ray* rays, uint32 nbRays,
+                                   uint32 nbRaysPerTask, unsigned short raycastWithCategoryMaskBits,
+                                   RaycastInfo* outHits, MemoryAllocator& allocator)
+            : mBroadPhaseSystem(broadPhaseSystem), mRays(rays), mNbRays(nbRays), mNbRaysPerTask(nbRaysPerTask),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mOutHits(outHits), mAllocator(allocator) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseRaycastBatchTask() override = default;
+
+        // Raycast a chunk of the rays of the batch
+        virtual void run(uint32 taskIndex, uint32 threadIndex) override;
+};
+
 // Class BroadPhaseSystem
 /**
  * This class represents the broad-phase collision detection. The
  * goal of the broad-phase collision detection is to compute the pairs of colliders
  * that have their AABBs overlapping. Only those pairs of bodies will be tested
  * later for collision during the narrow-phase collision detection. A dynamic AABB
- * tree data structure is used for fast broad-phase collision detection.
+ * tree data structure is used for fast broad-phase collision detection. The colliders
+ * of static bodies are stored in a separate tree so that the moving shapes do not have
+ * to walk through the static geometry of the world when they are tested against each
+ * other and so that pairs between two static colliders are never generated. The colliders
+ * of the non-static bodies can also be stored in a sweep-and-prune instead of a tree.
  */
 class BroadPhaseSystem {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of moved shapes tested by a single task when the overlapping
+        /// pairs are computed in parallel
+        static const uint32 NB_MIN_SHAPES_PER_TASK = 256;
+
+        /// Number of tasks per thread used to balance the work between the threads
+        static const uint32 NB_TASKS_PER_THREAD = 4;
+
+        /// The dual-tree traversal is used to compute the overlapping pairs when at least one
+        /// collider out of this number of colliders has moved
+        static const uint32 DUAL_TREE_TRAVERSAL_MOVED_SHAPES_RATIO = 4;
+
+        /// The static tree is rebuilt top-down when at least one of its leaves out of this number
+        /// has been added or removed since its last rebuild
+        static const uint32 STATIC_TREE_REBUILD_CHANGES_RATIO = 4;
+
+        /// Number of pairs of sub-trees the dual-tree traversal is split into when it is large enough
+        static const uint32 NB_DUAL_TREE_TRAVERSAL_START_NODE_PAIRS = 64;
+
+        /// Bit set in the broad-phase ID of the colliders that are stored in the static tree
+        static const int32 STATIC_TREE_BROAD_PHASE_ID_FLAG = 1 << 30;
+
+        /// Minimum number of rays raycasted by a single task when a batch of raycasts is split
+        /// between the threads
+        static const uint32 NB_MIN_RAYS_PER_TASK = 256;
+
+        /// Maximum number of rays in a packet of rays of a batch of raycasts
+        static const uint32 RAYCAST_PACKET_SIZE = 16;
+
+        /// Minimum cosine of the angle between the directions of the rays of a packet
+        static constexpr decimal RAYCAST_PACKET_MIN_DIRECTIONS_COSINE = decimal(0.9);
+
         // -------------------- Attributes -------------------- //
 
-        /// Dynamic AABB tree
+        /// Dynamic AABB tree with the colliders of the non-static bodies
         DynamicAABBTree mDynamicAABBTree;
 
+        /// AABB tree with the colliders of the static bodies
+        DynamicAABBTree mStaticAABBTree;
+
+        /// Sweep-and-prune with the colliders of the non-static bodies (if it is used
+        /// instead of the dynamic AABB tree)
+        SweepAndPrune mSweepAndPrune;
+
+        /// Algorithm used for the colliders of the non-static bodies
+        BroadPhaseAlgorithmType mAlgorithmType;
+
+        /// Policy used to compute the fat AABBs of the colliders of the non-static bodies
+        FatAABBMarginPolicy mFatAABBMarginPolicy;
+
+        /// Factor applied to the displacement of a body during a time step to extend its fat AABBs
+        decimal mFatAABBVelocityMultiplier;
+
+        /// Number of colliders added or removed from the static tree since its last rebuild
+        uint32 mNbStaticTreeChangesSinceRebuild;
+
+        /// Number of insertions and removals of leaves in the trees after which the nodes of the
+        /// trees are compacted (zero if the trees are never compacted automatically)
+        uint32 mCompactionThreshold;
+
         /// Reference to the colliders components
         ColliderComponents& mCollidersComponents;
 
@@ -123,14 +504,22 @@ class BroadPhaseSystem {
         /// Reference to the rigid body components
         RigidBodyComponents& mRigidBodyComponents;
 
-        /// Set with the broad-phase IDs of all collision shapes that have moved (or have been
+        /// Array with the broad-phase IDs of all collision shapes that have moved (or have been
         /// created) during the last simulation step. Those are the shapes that need to be tested
-        /// for overlapping in the next simulation step.
-        Set<int> mMovedShapes;
+        /// for overlapping in the next simulation step. A flag stored in the tree node (or in the
+        /// proxy of the sweep-and-prune) of a shape tells if the shape is in the array. Therefore,
+        /// a shape is only added once and a removed shape simply has its flag reset.
+        List<int32> mMovedShapes;
+
+        /// True if a bulk insertion of colliders is active
+        bool mIsBulkInsertionActive;
 
         /// Reference to the collision detection object
         CollisionDetectionSystem& mCollisionDetection;
 
+        /// Thread pool used to compute the overlapping pairs in parallel
+        ThreadPool& mThreadPool;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -141,18 +530,77 @@ class BroadPhaseSystem {
 
         /// Notify the Dynamic AABB tree that a collider needs to be updated
         void updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
-                                    bool forceReInsert);
+                                    const Vector3& displacement, bool forceReInsert);
 
         /// Update the broad-phase state of some colliders components
         void updateCollidersComponents(uint32 startIndex, uint32 nbItems, decimal timeStep);
 
+        /// Insert a collider into the static or dynamic tree (or into the sweep-and-prune) and return its broad-phase ID
+        int32 insertColliderIntoTree(Collider* collider, const AABB& aabb);
+
+        /// Remove the node of a broad-phase ID from its tree (or from the sweep-and-prune)
+        void removeColliderFromTree(int32 broadPhaseId);
+
+        /// Return true if a broad-phase ID refers to a proxy of the sweep-and-prune
+        bool isSweepAndPruneBroadPhaseId(int32 broadPhaseId) const;
+
+        /// Return the ID of the tree node corresponding to a broad-phase ID
+        static int32 getTreeNodeId(int32 broadPhaseId);
+
+        /// Return true if the shape of a broad-phase ID is in the array of moved shapes
+        bool isMovedShape(int32 broadPhaseId) const;
+
+        /// Set whether the shape of a broad-phase ID is in the array of moved shapes
+        void setIsMovedShape(int32 broadPhaseId, bool isMoved);
+
+        /// Return the tree that contains the node of a given broad-phase ID
+        const DynamicAABBTree& getTree(int32 broadPhaseId) const;
+
+        /// Return the tree that contains the node of a given broad-phase ID
+        DynamicAABBTree& getTree(int32 broadPhaseId);
+
+        /// Rebuild the wide and quantized versions of the trees if necessary
+        void updateQueryTrees();
+
+        /// Report the pairs between the nodes of a tree and some shapes of another (or the same) tree
+        void reportOverlappingNodes(const DynamicAABBTree& tree, const DynamicAABBTree& shapesTree,
+                                    const List<int32>& shapesToTest, MemoryManager& memoryManager,
+                                    List<Pair<int32, int32>>& overlappingNodes);
+
+        /// Report the pairs of overlapping leaves of two trees (or of a single tree) with a dual-tree traversal
+        void reportOverlappingNodesDualTree(const DynamicAABBTree& tree1, const DynamicAABBTree& tree2,
+                                            const bool* markedNodes1, const bool* markedNodes2, uint32 nbMovedShapes,
+                                            MemoryManager& memoryManager, List<Pair<int32, int32>>& overlappingNodes);
+
+        /// Report the pairs of overlapping colliders with at least one moved collider when the
+        /// sweep-and-prune is used for the colliders of the non-static bodies
+        void reportOverlappingNodesSweepAndPrune(const List<int32>& dynamicShapesToTest, const List<int32>& staticShapesToTest,
+                                                 MemoryManager& memoryManager, List<Pair<int32, int32>>& overlappingNodes);
+
+        /// Create the output lists of overlapping nodes of some parallel tasks
+        List<Pair<int32, int32>>* createTasksOverlappingNodes(uint32 nbTasks, uint32 initCapacity,
+                                                              MemoryAllocator& allocator) const;
+
+        /// Report the colliders of the trees (or of the sweep-and-prune) overlapping with the bounding AABB of a query region
+        void reportCollidersInRegion(const AABB& boundingAABB, BroadPhaseRegionQueryCallback& callback) const;
+
+        /// Raycast a range of the rays of a batch with packets of coherent rays
+        void raycastBatchRange(const Ray* rays, uint32 startIndex, uint32 endIndex, unsigned short raycastWithCategoryMaskBits,
+                               RaycastInfo* outHits, MemoryAllocator& allocator) const;
+
+        /// Merge the output lists of overlapping nodes of some parallel tasks and destroy them
+        void mergeTasksOverlappingNodes(List<Pair<int32, int32>>* tasksOverlappingNodes, uint32 nbTasks,
+                                        MemoryAllocator& allocator, List<Pair<int32, int32>>& overlappingNodes) const;
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
         BroadPhaseSystem(CollisionDetectionSystem& collisionDetection, ColliderComponents& collidersComponents,
-                         TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents);
+                         TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents,
+                         ThreadPool& threadPool, bool isWideTreeEnabled, bool isStaticTreeQuantized, uint32 compactionThreshold,
+                         BroadPhaseAlgorithmType algorithmType, FatAABBMarginPolicy fatAABBMarginPolicy, decimal fatAABBVelocityMultiplier);
 
         /// Destructor
         ~BroadPhaseSystem() = default;
@@ -169,6 +617,12 @@ class BroadPhaseSystem {
         /// Remove a collider from the broad-phase collision detection
         void removeCollider(Collider* collider);
 
+        /// Move some colliders between the static and the dynamic trees after the type of their body has changed
+        void moveCollidersBetweenTrees(const List<Entity>& colliderEntities, Map<int32, int32>& outMapOldToNewBroadPhaseIds);
+
+        /// Return true if a collider has to be stored in the static tree
+        bool isColliderInStaticTree(Collider* collider) const;
+
         /// Update the broad-phase state of a single collider
         void updateCollider(Entity colliderEntity, decimal timeStep);
 
@@ -195,9 +649,54 @@ class BroadPhaseSystem {
         /// Return the fat AABB of a given broad-phase shape
         const AABB& getFatAABB(int broadPhaseId) const;
 
+        /// Return true if a broad-phase ID refers to a node of the static tree
+        static bool isStaticTreeBroadPhaseId(int32 broadPhaseId);
+
         /// Ray casting method
         void raycast(const Ray& ray, RaycastTest& raycastTest, unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Compute the closest hit of each ray of a batch of rays
+        uint32 raycastBatch(const Ray* rays, uint32 nbRays, RaycastInfo* outHits, unsigned short raycastWithCategoryMaskBits,
+                            MemoryAllocator& allocator) const;
+
+        /// Find the colliders overlapping with an AABB and write them into a buffer
+        uint32 queryAABB(const AABB& aabb, unsigned short categoryMaskBits, Collider** outColliders, uint32 maxNbColliders) const;
+
+        /// Find the colliders overlapping with a sphere and write them into a buffer
+        uint32 querySphere(const Vector3& center, decimal radius, unsigned short categoryMaskBits,
+                           Collider** outColliders, uint32 maxNbColliders) const;
+
+        /// Find the colliders overlapping with a frustum and write them into a buffer
+        uint32 queryFrustum(const Frustum& frustum, unsigned short categoryMaskBits,
+                            Collider** outColliders, uint32 maxNbColliders) const;
+
+        /// Start a bulk insertion of colliders
+        void beginBulkInsertion();
+
+        /// End the bulk insertion of colliders and build the trees
+        void endBulkInsertion();
+
+        /// Return true if a bulk insertion of colliders is active
+        bool getIsBulkInsertionActive() const;
+
+        /// Reinsert a given number of leaves in each tree to improve their quality
+        void optimizeTrees(uint32 nbLeavesToReinsert);
+
+        /// Rebuild the trees from scratch
+        void rebuildTrees();
+
+        /// Rewrite the nodes of the trees in depth-first order and update the broad-phase IDs
+        void compactTrees();
+
+        /// Return the surface area heuristic cost of the dynamic tree
+        decimal getDynamicTreeCost() const;
+
+        /// Return the surface area heuristic cost of the static tree
+        decimal getStaticTreeCost() const;
+
+        /// Return the number of insertions and removals of leaves in the dynamic tree since its last compaction
+        uint32 getNbDynamicTreeStructuralChanges() const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -205,24 +704,98 @@ class BroadPhaseSystem {
 
 #endif
 
+        // -------------------- Friendship -------------------- //
+
+        friend class BroadPhaseRaycastBatchTask;
 };
 
+// Return true if a broad-phase ID refers to a node of the static tree
+inline bool BroadPhaseSystem::isStaticTreeBroadPhaseId(int32 broadPhaseId) {
+    assert(broadPhaseId >= 0);
+    return (broadPhaseId & STATIC_TREE_BROAD_PHASE_ID_FLAG) != 0;
+}
+
+// Return true if a broad-phase ID refers to a proxy of the sweep-and-prune
+inline bool BroadPhaseSystem::isSweepAndPruneBroadPhaseId(int32 broadPhaseId) const {
+    return mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE && !isStaticTreeBroadPhaseId(broadPhaseId);
+}
+
+// Return the ID of the tree node corresponding to a broad-phase ID
+inline int32 BroadPhaseSystem::getTreeNodeId(int32 broadPhaseId) {
+    assert(broadPhaseId >= 0);
+    return broadPhaseId & ~STATIC_TREE_BROAD_PHASE_ID_FLAG;
+}
+
+// Return the tree that contains the node of a given broad-phase ID
+inline const DynamicAABBTree& BroadPhaseSystem::getTree(int32 broadPhaseId) const {
+    return isStaticTreeBroadPhaseId(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
+// Return the tree that contains the node of a given broad-phase ID
+inline DynamicAABBTree& BroadPhaseSystem::getTree(int32 broadPhaseId) {
+    return isStaticTreeBroadPhaseId(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
 // Return the fat AABB of a given broad-phase shape
 inline const AABB& BroadPhaseSystem::getFatAABB(int broadPhaseId) const  {
-    return mDynamicAABBTree.getFatAABB(broadPhaseId);
+    if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+        return mSweepAndPrune.getFatAABB(broadPhaseId);
+    }
+    return getTree(broadPhaseId).getFatAABB(getTreeNodeId(broadPhaseId));
+}
+
+// Return true if a bulk insertion of colliders is active
+inline bool BroadPhaseSystem::getIsBulkInsertionActive() const {
+    return mIsBulkInsertionActive;
+}
+
+// Return the surface area heuristic cost of the dynamic tree
+inline decimal BroadPhaseSystem::getDynamicTreeCost() const {
+    return mDynamicAABBTree.computeTreeCost();
+}
+
+// Return the surface area heuristic cost of the static tree
+inline decimal BroadPhaseSystem::getStaticTreeCost() const {
+    return mStaticAABBTree.computeTreeCost();
+}
+
+// Return the number of insertions and removals of leaves in the dynamic tree since its last compaction
+inline uint32 BroadPhaseSystem::getNbDynamicTreeStructuralChanges() const {
+    return mDynamicAABBTree.getNbStructuralChanges();
 }
 
 // Remove a collider from the array of colliders that have moved in the last simulation step
 // and that need to be tested again for broad-phase overlapping.
 inline void BroadPhaseSystem::removeMovedCollider(int broadPhaseID) {
 
-    // Remove the broad-phase ID from the set
-    mMovedShapes.remove(broadPhaseID);
+    // The broad-phase ID stays in the array but it will be skipped
+    setIsMovedShape(broadPhaseID, false);
+}
+
+// Return true if the shape of a broad-phase ID is in the array of moved shapes
+inline bool BroadPhaseSystem::isMovedShape(int32 broadPhaseId) const {
+    if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+        return mSweepAndPrune.getIsProxyMoved(broadPhaseId);
+    }
+    return getTree(broadPhaseId).getIsLeafMoved(getTreeNodeId(broadPhaseId));
+}
+
+// Set whether the shape of a broad-phase ID is in the array of moved shapes
+inline void BroadPhaseSystem::setIsMovedShape(int32 broadPhaseId, bool isMoved) {
+    if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+        mSweepAndPrune.setIsProxyMoved(broadPhaseId, isMoved);
+    }
+    else {
+        getTree(broadPhaseId).setIsLeafMoved(getTreeNodeId(broadPhaseId), isMoved);
+    }
 }
 
 // Return the collider corresponding to the broad-phase node id in parameter
 inline Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int broadPhaseId) const {
-    return static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(broadPhaseId));
+    if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+        return static_cast<Collider*>(mSweepAndPrune.getProxyDataPointer(broadPhaseId));
+    }
+    return static_cast<Collider*>(getTree(broadPhaseId).getNodeDataPointer(getTreeNodeId(broadPhaseId)));
 }
 
 #ifdef IS_RP3D_PROFILING_ENABLED
@@ -231,6 +804,8 @@ inline Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int broadPhaseId)
 inline void BroadPhaseSystem::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
 	mDynamicAABBTree.setProfiler(profiler);
+	mStaticAABBTree.setProfiler(profiler);
+	mSweepAndPrune.setProfiler(profiler);
 }
 
 #endif
@@ -43,6 +43,7 @@
 #include <reactphysics3d/containers/Set.h>
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/ThreadPool.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -52,10 +53,88 @@ class PhysicsWorld;
 class CollisionCallback;
 class OverlapCallback;
 class RaycastCallback;
+struct RaycastInfo;
+struct DistanceInfo;
+class ConvexShape;
 class ContactPoint;
 class MemoryManager;
 class EventListener;
 class CollisionDispatch;
+class ThreadPool;
+class SingleFrameAllocator;
+class CollisionDetectionSystem;
+
+// Class NarrowPhaseCollisionTask
+/**
+ * Task used to run the narrow-phase collision detection on a range of items of one of the
+ * narrow-phase batches. The items of a batch are only written by the task of their range and
+ * the contact points of an item are created with the frame allocator of the thread testing it.
+ * Therefore, the results do not depend on the number of threads.
+ */
+class NarrowPhaseCollisionTask : public ThreadPoolTask {
+
+    public:
+
+        /// Range of items of a narrow-phase batch
+        struct BatchRange {
+
+            /// Narrow-phase algorithm of the batch
+            NarrowPhaseAlgorithmType algorithmType;
+
+            /// Index of the first item of the range
+            uint startIndex;
+
+            /// Number of items of the range
+            uint nbItems;
+
+            /// Constructor
+            BatchRange(NarrowPhaseAlgorithmType algorithmType, uint startIndex, uint nbItems)
+                : algorithmType(algorithmType), startIndex(startIndex), nbItems(nbItems) {
+
+            }
+        };
+
+    private:
+
+        /// Reference to the collision detection system
+        CollisionDetectionSystem& mCollisionDetection;
+
+        /// Narrow-phase input with the batches to test
+        NarrowPhaseInput& mNarrowPhaseInput;
+
+        /// Ranges of items to test (one for each task)
+        const List<BatchRange>& mRanges;
+
+        /// True if the SAT algorithm can clip with the previous separating axis
+        bool mClipWithPreviousAxisIfStillColliding;
+
+        /// True if the cached narrow-phase results of the previous frames can be reused
+        bool mUseNarrowPhaseCache;
+
+        /// Memory allocator used by the calling thread
+        MemoryAllocator& mAllocator;
+
+        /// Array with the result of each task (true if a contact has been found)
+        bool* mTasksContactFound;
+
+    public:
+
+        // Constructor
+        NarrowPhaseCollisionTask(CollisionDetectionSystem& collisionDetection, NarrowPhaseInput& narrowPhaseInput,
+                                 const List<BatchRange>& ranges, bool clipWithPreviousAxisIfStillColliding,
+                                 bool useNarrowPhaseCache, MemoryAllocator& allocator, bool* tasksContactFound)
+            : mCollisionDetection(collisionDetection), mNarrowPhaseInput(narrowPhaseInput), mRanges(ranges),
+              mClipWithPreviousAxisIfStillColliding(clipWithPreviousAxisIfStillColliding),
+              mUseNarrowPhaseCache(useNarrowPhaseCache), mAllocator(allocator), mTasksContactFound(tasksContactFound) {
+
+        }
+
+        // Destructor
+        virtual ~NarrowPhaseCollisionTask() override = default;
+
+        // Run the narrow-phase collision detection on a range of items
+        virtual void run(uint32 taskIndex, uint32 threadIndex) override;
+};
 
 // Class CollisionDetectionSystem
 /**
@@ -75,11 +154,27 @@ class CollisionDetectionSystem {
         /// Maximum number of contact points in a reduced contact manifold
         static const int8 MAX_CONTACT_POINTS_IN_MANIFOLD = 4;
 
+        /// Number of colliders of the broad-phase queries that fit into a local array
+        static const uint32 NB_MAX_LOCAL_QUERY_COLLIDERS = 64;
+
+        /// Minimum number of narrow-phase items tested by a task of the thread pool
+        static const uint32 NB_MIN_NARROW_PHASE_ITEMS_PER_TASK = 64;
+
+        /// Number of narrow-phase tasks per thread (to balance the load between the threads)
+        static const uint32 NB_NARROW_PHASE_TASKS_PER_THREAD = 4;
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
         MemoryManager& mMemoryManager;
 
+        /// Thread pool used to run the parallel parts of the collision detection
+        ThreadPool& mThreadPool;
+
+        /// Single frame allocators of the worker threads of the thread pool (the calling
+        /// thread uses the single frame allocator of the memory manager)
+        List<SingleFrameAllocator*> mWorkerFrameAllocators;
+
         /// Reference the collider components
         ColliderComponents& mCollidersComponents;
 
@@ -211,12 +306,48 @@ class CollisionDetectionSystem {
         void addLostContactPair(uint64 overlappingPairIndex);
 
         /// Execute the narrow-phase collision detection algorithm on batches
-        bool testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator);
+        bool testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding,
+                                      bool useNarrowPhaseCache, MemoryAllocator& allocator);
+
+        /// Execute the narrow-phase collision detection on a range of items of a batch
+        bool testNarrowPhaseCollisionRange(NarrowPhaseInput& narrowPhaseInput, NarrowPhaseAlgorithmType algorithmType,
+                                           uint startIndex, uint nbItems, bool clipWithPreviousAxisIfStillColliding,
+                                           bool useNarrowPhaseCache, MemoryAllocator& allocator);
+
+        /// Execute the narrow-phase collision detection algorithm on a range of items of a batch
+        bool testNarrowPhaseAlgorithm(NarrowPhaseInput& narrowPhaseInput, NarrowPhaseAlgorithmType algorithmType,
+                                      uint startIndex, uint nbItems, bool clipWithPreviousAxisIfStillColliding,
+                                      MemoryAllocator& allocator);
+
+        /// Reuse the cached narrow-phase result of an item if the relative transform of its shapes has not changed
+        bool reuseCachedNarrowPhaseResult(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint index,
+                                          decimal maxTranslationSquare, decimal minRotationCos) const;
+
+        /// Cache the narrow-phase results of a range of items of a batch
+        void cacheNarrowPhaseResults(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint startIndex, uint nbItems) const;
 
         /// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
         void computeConvexVsConcaveMiddlePhase(uint64 pairIndex, MemoryAllocator& allocator,
                                                NarrowPhaseInput& narrowPhaseInput);
 
+        /// Find the colliders overlapping with an AABB in the broad-phase
+        Collider** findBroadPhaseColliders(const AABB& aabb, unsigned short categoryMaskBits, Collider** localColliders,
+                                           uint32 nbMaxLocalColliders, uint32& outNbColliders) const;
+
+        /// Release the array of colliders returned by findBroadPhaseColliders() if it has been allocated
+        void releaseBroadPhaseColliders(Collider** colliders, Collider** localColliders, uint32 nbColliders) const;
+
+        /// Return true if a shape overlaps with a collider
+        bool testOverlapShapeWithCollider(const CollisionShape* shape, const Transform& transform, Collider* collider) const;
+
+        /// Compute the distance between a convex shape and a collider if it is not larger than a maximum distance
+        bool computeDistanceToCollider(const ConvexShape* shape, const Transform& transform, Collider* collider,
+                                       decimal maxDistance, DistanceInfo& outDistanceInfo) const;
+
+        /// Compute the first hit of a translating convex shape with a collider
+        bool sweepAgainstCollider(const ConvexShape* shape, const Transform& fromTransform, const Vector3& translation,
+                                  Collider* collider, decimal maxFraction, RaycastInfo& outRaycastInfo) const;
+
         /// Swap the previous and current contacts lists
         void swapPreviousAndCurrentContacts();
 
@@ -286,10 +417,10 @@ class CollisionDetectionSystem {
         /// Constructor
         CollisionDetectionSystem(PhysicsWorld* world, ColliderComponents& collidersComponents,
                            TransformComponents& transformComponents, CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents,
-                           MemoryManager& memoryManager);
+                           MemoryManager& memoryManager, ThreadPool& threadPool);
 
         /// Destructor
-        ~CollisionDetectionSystem() = default;
+        ~CollisionDetectionSystem();
 
         /// Deleted copy-constructor
         CollisionDetectionSystem(const CollisionDetectionSystem& collisionDetection) = delete;
@@ -306,6 +437,9 @@ class CollisionDetectionSystem {
         /// Remove a collider from the collision detection
         void removeCollider(Collider* collider);
 
+        /// Move the colliders of a body between the static and dynamic broad-phase trees after its type has changed
+        void moveCollidersBetweenTrees(const List<Entity>& colliderEntities);
+
         /// Update a collider (that has moved for instance)
         void updateCollider(Entity colliderEntity, decimal timeStep);
 
@@ -324,16 +458,37 @@ class CollisionDetectionSystem {
         /// Notify that the overlapping pairs where a given collider is involved need to be tested for overlap
         void notifyOverlappingPairsToTestOverlap(Collider* collider);
 
+        /// Update the data that depend on the broad-phase IDs after the broad-phase IDs of colliders have changed
+        void remapBroadPhaseIds(const Map<int32, int32>& mapOldToNewBroadPhaseIds);
+
         /// Report contacts and triggers
         void reportContactsAndTriggers();
 
         /// Compute the collision detection
         void computeCollisionDetection();
 
+        /// Reset the single frame allocators of the worker threads
+        void resetWorkerFrameAllocators();
+
         /// Ray casting method
         void raycast(RaycastCallback* raycastCallback, const Ray& ray,
                      unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Find the colliders overlapping with a shape that is not in the world
+        uint32 overlapShape(const CollisionShape* shape, const Transform& transform, unsigned short categoryMaskBits,
+                            Collider** outColliders, uint32 maxNbColliders) const;
+
+        /// Compute the distance and the closest points between two convex colliders
+        bool computeDistance(Collider* collider1, Collider* collider2, DistanceInfo& distanceInfo) const;
+
+        /// Find the closest collider to a convex shape within a maximum distance
+        bool findClosestCollider(const ConvexShape* shape, const Transform& transform, decimal maxDistance,
+                                 unsigned short categoryMaskBits, DistanceInfo& outDistanceInfo) const;
+
+        /// Sweep a convex shape along a translation and report the colliders it hits
+        void sweep(const ConvexShape* shape, const Transform& fromTransform, const Transform& toTransform,
+                   RaycastCallback* callback, unsigned short sweepWithCategoryMaskBits) const;
+
         /// Return true if two bodies (collide) overlap
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -377,6 +532,7 @@ class CollisionDetectionSystem {
         friend class ConvexMeshShape;
         friend class RigidBody;
         friend class DebugRenderer;
+        friend class NarrowPhaseCollisionTask;
 };
 
 // Return a reference to the collision dispatch configuration
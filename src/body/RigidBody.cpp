@@ -66,10 +66,18 @@ BodyType RigidBody::getType() const {
  */
 void RigidBody::setType(BodyType type) {
 
-    if (mWorld.mRigidBodyComponents.getBodyType(mEntity) == type) return;
+    const BodyType previousType = mWorld.mRigidBodyComponents.getBodyType(mEntity);
+    if (previousType == type) return;
 
     mWorld.mRigidBodyComponents.setBodyType(mEntity, type);
 
+    // If the body becomes static or is not static anymore, its colliders need to be
+    // moved between the static and the dynamic trees of the broad-phase. Their overlapping
+    // pairs and contacts are kept (except the pairs with other static colliders).
+    if (previousType == BodyType::STATIC || type == BodyType::STATIC) {
+        mWorld.mCollisionDetection.moveCollidersBetweenTrees(mWorld.mCollisionBodyComponents.getColliders(mEntity));
+    }
+
     // If it is a static body
     if (type == BodyType::STATIC) {
 
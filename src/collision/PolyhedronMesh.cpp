@@ -29,8 +29,53 @@
 #include <reactphysics3d/collision/PolygonVertexArray.h>
 #include <cstdlib>
 
+#if !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED) && defined(__AVX__)
+    #include <immintrin.h>
+    #define RP3D_SUPPORT_VERTEX_SIMD
+#elif !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+    #include <xmmintrin.h>
+    #define RP3D_SUPPORT_VERTEX_SIMD
+#endif
+
 using namespace reactphysics3d;
 
+#ifdef RP3D_SUPPORT_VERTEX_SIMD
+
+// Operations on the SIMD registers that contain the values of several vertices
+#if defined(__AVX__)
+
+static const uint NB_SIMD_LANES = 8;
+
+typedef __m256 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm256_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm256_set1_ps(value); }
+static inline WideFloat wideLanesIndices() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm256_add_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm256_mul_ps(a, b); }
+static inline WideFloat wideGreater(WideFloat a, WideFloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline WideFloat wideSelect(WideFloat mask, WideFloat a, WideFloat b) { return _mm256_blendv_ps(b, a, mask); }
+static inline void wideStore(float* values, WideFloat a) { _mm256_storeu_ps(values, a); }
+
+#else
+
+static const uint NB_SIMD_LANES = 4;
+
+typedef __m128 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm_set1_ps(value); }
+static inline WideFloat wideLanesIndices() { return _mm_setr_ps(0, 1, 2, 3); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm_add_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm_mul_ps(a, b); }
+static inline WideFloat wideGreater(WideFloat a, WideFloat b) { return _mm_cmpgt_ps(a, b); }
+static inline WideFloat wideSelect(WideFloat mask, WideFloat a, WideFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline void wideStore(float* values, WideFloat a) { _mm_storeu_ps(values, a); }
+
+#endif
+
+#endif
+
 
 // Constructor
 /**
@@ -46,12 +91,19 @@ PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray, MemoryAll
    // Create the half-edge structure of the mesh
    createHalfEdgeStructure();
 
+   // Copy the vertices and compute their neighbors
+   initVertices();
+   computeVerticesNeighbors();
+
    // Create the face normals array
    mFacesNormals = new Vector3[mHalfEdgeStructure.getNbFaces()];
 
    // Compute the faces normals
    computeFacesNormals();
 
+   // Fill the faces and edges arrays
+   initFacesAndEdges();
+
    // Compute the centroid
    computeCentroid();
 }
@@ -59,6 +111,9 @@ PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray, MemoryAll
 // Destructor
 PolyhedronMesh::~PolyhedronMesh() {
     delete[] mFacesNormals;
+    delete[] mFeaturesArraysData;
+    delete[] mVerticesNeighborsStart;
+    delete[] mVerticesNeighbors;
 }
 
 // Create the half-edge structure of the mesh
@@ -92,39 +147,243 @@ void PolyhedronMesh::createHalfEdgeStructure() {
     mHalfEdgeStructure.init();
 }
 
-/// Return a vertex
-/**
- * @param index Index of a given vertex in the mesh
- * @return The coordinates of a given vertex in the mesh
- */
-Vector3 PolyhedronMesh::getVertex(uint index) const {
-    assert(index < getNbVertices());
-
-    // Get the vertex index in the array with all vertices
-    uint vertexIndex = mHalfEdgeStructure.getVertex(index).vertexPointIndex;
+// Allocate the features arrays and copy the vertices coordinates from the polygon vertex array
+/// The coordinates are stored in one array per axis so that the support vertex can be
+/// searched without reading the user vertex data (with its stride and data type).
+void PolyhedronMesh::initVertices() {
+
+    const uint nbVertices = getNbVertices();
+    const uint nbFaces = getNbFaces();
+    const uint nbEdges = getNbEdges();
+
+    // Allocate a single memory block for all the arrays
+    mFeaturesArraysData = new decimal[3 * nbVertices + 6 * nbFaces + 12 * nbEdges];
+    decimal* array = mFeaturesArraysData;
+    decimal** vertexArrays[3] = {&mArrays.verticesX, &mArrays.verticesY, &mArrays.verticesZ};
+    decimal** faceArrays[6] = {&mArrays.facesNormalsX, &mArrays.facesNormalsY, &mArrays.facesNormalsZ,
+                               &mArrays.facesPointsX, &mArrays.facesPointsY, &mArrays.facesPointsZ};
+    decimal** edgeArrays[12] = {&mArrays.edgesStartsX, &mArrays.edgesStartsY, &mArrays.edgesStartsZ,
+                                &mArrays.edgesDirectionsX, &mArrays.edgesDirectionsY, &mArrays.edgesDirectionsZ,
+                                &mArrays.edgesFaces1NormalsX, &mArrays.edgesFaces1NormalsY, &mArrays.edgesFaces1NormalsZ,
+                                &mArrays.edgesFaces2NormalsX, &mArrays.edgesFaces2NormalsY, &mArrays.edgesFaces2NormalsZ};
+    for (int i=0; i < 3; i++) {
+        *vertexArrays[i] = array;
+        array += nbVertices;
+    }
+    for (int i=0; i < 6; i++) {
+        *faceArrays[i] = array;
+        array += nbFaces;
+    }
+    for (int i=0; i < 12; i++) {
+        *edgeArrays[i] = array;
+        array += nbEdges;
+    }
 
     PolygonVertexArray::VertexDataType vertexType = mPolygonVertexArray->getVertexDataType();
     const unsigned char* verticesStart = mPolygonVertexArray->getVerticesStart();
     int vertexStride = mPolygonVertexArray->getVerticesStride();
 
-    Vector3 vertex;
-    if (vertexType == PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE) {
-        const float* vertices = (float*)(verticesStart + vertexIndex * vertexStride);
-        vertex.x = decimal(vertices[0]);
-        vertex.y = decimal(vertices[1]);
-        vertex.z = decimal(vertices[2]);
+    for (uint v=0; v < nbVertices; v++) {
+
+        // Get the vertex index in the array with all vertices
+        uint vertexIndex = mHalfEdgeStructure.getVertex(v).vertexPointIndex;
+
+        if (vertexType == PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE) {
+            const float* vertices = (float*)(verticesStart + vertexIndex * vertexStride);
+            mArrays.verticesX[v] = decimal(vertices[0]);
+            mArrays.verticesY[v] = decimal(vertices[1]);
+            mArrays.verticesZ[v] = decimal(vertices[2]);
+        }
+        else if (vertexType == PolygonVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE) {
+            const double* vertices = (double*)(verticesStart + vertexIndex * vertexStride);
+            mArrays.verticesX[v] = decimal(vertices[0]);
+            mArrays.verticesY[v] = decimal(vertices[1]);
+            mArrays.verticesZ[v] = decimal(vertices[2]);
+        }
+        else {
+            assert(false);
+        }
+    }
+}
+
+// Fill the faces and edges arrays (when the faces normals have been computed)
+void PolyhedronMesh::initFacesAndEdges() {
+
+    // For each face
+    for (uint f=0; f < getNbFaces(); f++) {
+
+        const Vector3 facePoint = getVertex(mHalfEdgeStructure.getFace(f).faceVertices[0]);
+        mArrays.facesNormalsX[f] = mFacesNormals[f].x;
+        mArrays.facesNormalsY[f] = mFacesNormals[f].y;
+        mArrays.facesNormalsZ[f] = mFacesNormals[f].z;
+        mArrays.facesPointsX[f] = facePoint.x;
+        mArrays.facesPointsY[f] = facePoint.y;
+        mArrays.facesPointsZ[f] = facePoint.z;
+    }
+
+    // For each edge
+    for (uint e=0; e < getNbEdges(); e++) {
+
+        const HalfEdgeStructure::Edge& edge = mHalfEdgeStructure.getHalfEdge(2 * e);
+        const HalfEdgeStructure::Edge& twinEdge = mHalfEdgeStructure.getHalfEdge(edge.twinEdgeIndex);
+        assert(edge.twinEdgeIndex == 2 * e + 1);
+
+        const Vector3 start = getVertex(edge.vertexIndex);
+        const Vector3 direction = getVertex(twinEdge.vertexIndex) - start;
+        const Vector3& face1Normal = mFacesNormals[edge.faceIndex];
+        const Vector3& face2Normal = mFacesNormals[twinEdge.faceIndex];
+        mArrays.edgesStartsX[e] = start.x;
+        mArrays.edgesStartsY[e] = start.y;
+        mArrays.edgesStartsZ[e] = start.z;
+        mArrays.edgesDirectionsX[e] = direction.x;
+        mArrays.edgesDirectionsY[e] = direction.y;
+        mArrays.edgesDirectionsZ[e] = direction.z;
+        mArrays.edgesFaces1NormalsX[e] = face1Normal.x;
+        mArrays.edgesFaces1NormalsY[e] = face1Normal.y;
+        mArrays.edgesFaces1NormalsZ[e] = face1Normal.z;
+        mArrays.edgesFaces2NormalsX[e] = face2Normal.x;
+        mArrays.edgesFaces2NormalsY[e] = face2Normal.y;
+        mArrays.edgesFaces2NormalsZ[e] = face2Normal.z;
+    }
+}
+
+// Compute the neighbors of each vertex from the half-edge structure
+/// Each half-edge connects its start vertex to the start vertex of its twin edge.
+void PolyhedronMesh::computeVerticesNeighbors() {
+
+    const uint nbVertices = getNbVertices();
+    const uint nbHalfEdges = mHalfEdgeStructure.getNbHalfEdges();
+    mVerticesNeighborsStart = new uint[nbVertices + 1];
+    mVerticesNeighbors = new uint[nbHalfEdges];
+
+    // Count the number of half-edges starting at each vertex
+    for (uint v=0; v <= nbVertices; v++) {
+        mVerticesNeighborsStart[v] = 0;
+    }
+    for (uint e=0; e < nbHalfEdges; e++) {
+        mVerticesNeighborsStart[mHalfEdgeStructure.getHalfEdge(e).vertexIndex + 1]++;
+    }
+    for (uint v=0; v < nbVertices; v++) {
+        mVerticesNeighborsStart[v + 1] += mVerticesNeighborsStart[v];
+    }
+
+    // Add the neighbor of each half-edge after the previous neighbors of its start vertex
+    uint* nbAddedNeighbors = new uint[nbVertices];
+    for (uint v=0; v < nbVertices; v++) {
+        nbAddedNeighbors[v] = 0;
     }
-    else if (vertexType == PolygonVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE) {
-        const double* vertices = (double*)(verticesStart + vertexIndex * vertexStride);
-        vertex.x = decimal(vertices[0]);
-        vertex.y = decimal(vertices[1]);
-        vertex.z = decimal(vertices[2]);
+    for (uint e=0; e < nbHalfEdges; e++) {
+
+        const HalfEdgeStructure::Edge& edge = mHalfEdgeStructure.getHalfEdge(e);
+        const uint neighbor = mHalfEdgeStructure.getHalfEdge(edge.twinEdgeIndex).vertexIndex;
+        mVerticesNeighbors[mVerticesNeighborsStart[edge.vertexIndex] + nbAddedNeighbors[edge.vertexIndex]] = neighbor;
+        nbAddedNeighbors[edge.vertexIndex]++;
     }
-    else {
-        assert(false);
+    delete[] nbAddedNeighbors;
+}
+
+// Return the index of the support vertex with a linear search over all the vertices
+uint PolyhedronMesh::computeSupportVertexLinear(const Vector3& direction) const {
+
+    const uint nbVertices = getNbVertices();
+
+    decimal maxDotProduct = DECIMAL_SMALLEST;
+    uint indexMaxDotProduct = 0;
+    uint v = 0;
+
+#ifdef RP3D_SUPPORT_VERTEX_SIMD
+
+    // Find the largest dot product (and its vertex) in each lane
+    if (nbVertices >= NB_SIMD_LANES) {
+
+        const WideFloat directionX = wideSet(direction.x);
+        const WideFloat directionY = wideSet(direction.y);
+        const WideFloat directionZ = wideSet(direction.z);
+        const WideFloat nbLanes = wideSet(float(NB_SIMD_LANES));
+        WideFloat indices = wideLanesIndices();
+        WideFloat maxDotProducts = wideSet(DECIMAL_SMALLEST);
+        WideFloat maxIndices = wideSet(0);
+
+        for (; v + NB_SIMD_LANES <= nbVertices; v += NB_SIMD_LANES) {
+
+            const WideFloat dotProducts = wideAdd(wideAdd(wideMul(directionX, wideLoad(&mArrays.verticesX[v])),
+                                                          wideMul(directionY, wideLoad(&mArrays.verticesY[v]))),
+                                                  wideMul(directionZ, wideLoad(&mArrays.verticesZ[v])));
+            const WideFloat isLarger = wideGreater(dotProducts, maxDotProducts);
+            maxDotProducts = wideSelect(isLarger, dotProducts, maxDotProducts);
+            maxIndices = wideSelect(isLarger, indices, maxIndices);
+            indices = wideAdd(indices, nbLanes);
+        }
+
+        // Keep the largest dot product of all the lanes (with the smallest vertex index if several are equal)
+        float laneDotProducts[NB_SIMD_LANES];
+        float laneIndices[NB_SIMD_LANES];
+        wideStore(laneDotProducts, maxDotProducts);
+        wideStore(laneIndices, maxIndices);
+        for (uint lane=0; lane < NB_SIMD_LANES; lane++) {
+            const uint index = static_cast<uint>(laneIndices[lane]);
+            if (laneDotProducts[lane] > maxDotProduct ||
+                (laneDotProducts[lane] == maxDotProduct && index < indexMaxDotProduct)) {
+                maxDotProduct = laneDotProducts[lane];
+                indexMaxDotProduct = index;
+            }
+        }
     }
 
-    return vertex;
+#endif
+
+    // For each remaining vertex of the mesh
+    for (; v < nbVertices; v++) {
+
+        // Compute the dot product of the current vertex
+        const decimal dotProduct = direction.x * mArrays.verticesX[v] + direction.y * mArrays.verticesY[v] + direction.z * mArrays.verticesZ[v];
+
+        // If the current dot product is larger than the maximum one
+        if (dotProduct > maxDotProduct) {
+            indexMaxDotProduct = v;
+            maxDotProduct = dotProduct;
+        }
+    }
+
+    return indexMaxDotProduct;
+}
+
+// Return the index of the support vertex by hill climbing from a given vertex
+/// At each step, we move to the neighbor vertex with the largest projection on the direction
+/// as long as this projection is larger than the one of the current vertex.
+uint PolyhedronMesh::computeSupportVertexHillClimbing(const Vector3& direction, uint startVertexIndex) const {
+
+    assert(startVertexIndex < getNbVertices());
+
+    uint currentVertex = startVertexIndex;
+    decimal maxDotProduct = direction.x * mArrays.verticesX[currentVertex] + direction.y * mArrays.verticesY[currentVertex] +
+                            direction.z * mArrays.verticesZ[currentVertex];
+
+    bool hasMoved;
+    do {
+
+        hasMoved = false;
+        const uint neighborsEnd = mVerticesNeighborsStart[currentVertex + 1];
+        uint bestVertex = currentVertex;
+
+        // For each neighbor of the current vertex
+        for (uint n = mVerticesNeighborsStart[currentVertex]; n < neighborsEnd; n++) {
+
+            const uint neighbor = mVerticesNeighbors[n];
+            const decimal dotProduct = direction.x * mArrays.verticesX[neighbor] + direction.y * mArrays.verticesY[neighbor] +
+                                       direction.z * mArrays.verticesZ[neighbor];
+            if (dotProduct > maxDotProduct) {
+                maxDotProduct = dotProduct;
+                bestVertex = neighbor;
+                hasMoved = true;
+            }
+        }
+
+        currentVertex = bestVertex;
+
+    } while (hasMoved);
+
+    return currentVertex;
 }
 
 // Compute the faces normals
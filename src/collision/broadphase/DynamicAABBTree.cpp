@@ -28,15 +28,226 @@
 #include <reactphysics3d/systems/BroadPhaseSystem.h>
 #include <reactphysics3d/containers/Stack.h>
 #include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define RP3D_WIDE_TREE_NODE_SIMD
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define RP3D_WIDE_TREE_NODE_SIMD
+#endif
 
 using namespace reactphysics3d;
 
 // Initialization of static variables
 const int32 TreeNode::NULL_TREE_NODE = -1;
+const uint32 WideTreeNode::NB_CHILDREN;
+const int32 WideTreeNode::NULL_CHILD;
+const uint16 QuantizedTreeNode::MAX_OFFSET;
+
+// Relative margin used to round the AABBs of the wide tree to single precision in a conservative way
+static const float WIDE_TREE_ROUNDING_EPSILON = 1e-6f;
+
+// Epsilon used in the ray tests of the wide tree to counteract arithmetic errors
+static const float WIDE_TREE_RAY_EPSILON = 0.00001f;
+
+// Round a value to single precision such that the result is not larger than the value
+static float roundDownToFloat(decimal value) {
+    const float result = static_cast<float>(value);
+    return result - (std::abs(result) + 1.0f) * WIDE_TREE_ROUNDING_EPSILON;
+}
+
+// Round a value to single precision such that the result is not smaller than the value
+static float roundUpToFloat(decimal value) {
+    const float result = static_cast<float>(value);
+    return result + (std::abs(result) + 1.0f) * WIDE_TREE_ROUNDING_EPSILON;
+}
+
+// Compute the quantized offsets of an AABB relative to the AABB of its parent
+/// The offsets are rounded down with one more step of margin so that the AABB computed from
+/// them contains the AABB in parameter. If it is not the case because of the rounding errors
+/// (when the step is smaller than the precision of the coordinates), the offset is set to zero
+/// and the coordinate of the parent AABB is used.
+static void quantizeAABB(const AABB& aabb, const AABB& parentAABB, QuantizedTreeNode& outNode) {
+
+    const decimal maxOffset = decimal(QuantizedTreeNode::MAX_OFFSET);
+
+    for (int i=0; i < 3; i++) {
+
+        const decimal step = (parentAABB.getMax()[i] - parentAABB.getMin()[i]) * (decimal(1.0) / maxOffset);
+
+        decimal minOffset = decimal(0.0);
+        decimal maxOffsetFromParent = decimal(0.0);
+        if (step > decimal(0.0)) {
+            minOffset = std::floor((aabb.getMin()[i] - parentAABB.getMin()[i]) / step) - decimal(1.0);
+            maxOffsetFromParent = std::floor((parentAABB.getMax()[i] - aabb.getMax()[i]) / step) - decimal(1.0);
+        }
+
+        outNode.minOffsets[i] = static_cast<uint16>(clamp(minOffset, decimal(0.0), maxOffset));
+        outNode.maxOffsets[i] = static_cast<uint16>(clamp(maxOffsetFromParent, decimal(0.0), maxOffset));
+    }
+
+    // Make sure that the quantized AABB contains the AABB
+    AABB quantizedAABB;
+    outNode.computeAABB(parentAABB, quantizedAABB);
+    for (int i=0; i < 3; i++) {
+        if (quantizedAABB.getMin()[i] > aabb.getMin()[i]) {
+            outNode.minOffsets[i] = 0;
+        }
+        if (quantizedAABB.getMax()[i] < aabb.getMax()[i]) {
+            outNode.maxOffsets[i] = 0;
+        }
+    }
+}
+
+#ifdef RP3D_WIDE_TREE_NODE_SIMD
+
+// Operations on the SIMD registers that contain one value for each child of a wide node
+#if defined(__AVX__)
+
+typedef __m256 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm256_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm256_set1_ps(value); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm256_add_ps(a, b); }
+static inline WideFloat wideSub(WideFloat a, WideFloat b) { return _mm256_sub_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm256_mul_ps(a, b); }
+static inline WideFloat wideAbs(WideFloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline WideFloat wideAnd(WideFloat a, WideFloat b) { return _mm256_and_ps(a, b); }
+static inline WideFloat wideOr(WideFloat a, WideFloat b) { return _mm256_or_ps(a, b); }
+static inline WideFloat wideLessEqual(WideFloat a, WideFloat b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+static inline WideFloat wideGreater(WideFloat a, WideFloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline uint32 wideMoveMask(WideFloat a) { return static_cast<uint32>(_mm256_movemask_ps(a)); }
+
+#else
+
+typedef __m128 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm_set1_ps(value); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm_add_ps(a, b); }
+static inline WideFloat wideSub(WideFloat a, WideFloat b) { return _mm_sub_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm_mul_ps(a, b); }
+static inline WideFloat wideAbs(WideFloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline WideFloat wideAnd(WideFloat a, WideFloat b) { return _mm_and_ps(a, b); }
+static inline WideFloat wideOr(WideFloat a, WideFloat b) { return _mm_or_ps(a, b); }
+static inline WideFloat wideLessEqual(WideFloat a, WideFloat b) { return _mm_cmple_ps(a, b); }
+static inline WideFloat wideGreater(WideFloat a, WideFloat b) { return _mm_cmpgt_ps(a, b); }
+static inline uint32 wideMoveMask(WideFloat a) { return static_cast<uint32>(_mm_movemask_ps(a)); }
+
+#endif
+
+#endif
+
+// Return a bit mask with the children of a wide node whose AABB overlaps with a given AABB
+static uint32 computeWideNodeOverlapMask(const WideTreeNode& node, const float* aabbMin, const float* aabbMax) {
+
+#ifdef RP3D_WIDE_TREE_NODE_SIMD
+
+    WideFloat overlap = wideAnd(wideLessEqual(wideLoad(node.minX), wideSet(aabbMax[0])),
+                                wideLessEqual(wideSet(aabbMin[0]), wideLoad(node.maxX)));
+    overlap = wideAnd(overlap, wideAnd(wideLessEqual(wideLoad(node.minY), wideSet(aabbMax[1])),
+                                       wideLessEqual(wideSet(aabbMin[1]), wideLoad(node.maxY))));
+    overlap = wideAnd(overlap, wideAnd(wideLessEqual(wideLoad(node.minZ), wideSet(aabbMax[2])),
+                                       wideLessEqual(wideSet(aabbMin[2]), wideLoad(node.maxZ))));
+
+    return wideMoveMask(overlap);
+
+#else
+
+    uint32 mask = 0;
+    for (uint32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+        if (node.minX[i] <= aabbMax[0] && aabbMin[0] <= node.maxX[i] &&
+            node.minY[i] <= aabbMax[1] && aabbMin[1] <= node.maxY[i] &&
+            node.minZ[i] <= aabbMax[2] && aabbMin[2] <= node.maxZ[i]) {
+            mask |= (1u << i);
+        }
+    }
+
+    return mask;
+
+#endif
+}
+
+// Return a bit mask with the children of a wide node whose AABB is intersected by a ray segment.
+/// This is the same separating axis test as in AABB::testRayIntersect() where "rayPointsSum" is the sum
+/// of the two points of the segment and "rayDirection" is the vector between those two points.
+static uint32 computeWideNodeRayMask(const WideTreeNode& node, const float* rayPointsSum, const float* rayDirection) {
+
+    const float adx = std::abs(rayDirection[0]) + WIDE_TREE_RAY_EPSILON;
+    const float ady = std::abs(rayDirection[1]) + WIDE_TREE_RAY_EPSILON;
+    const float adz = std::abs(rayDirection[2]) + WIDE_TREE_RAY_EPSILON;
+
+#ifdef RP3D_WIDE_TREE_NODE_SIMD
+
+    const WideFloat minX = wideLoad(node.minX);
+    const WideFloat minY = wideLoad(node.minY);
+    const WideFloat minZ = wideLoad(node.minZ);
+    const WideFloat maxX = wideLoad(node.maxX);
+    const WideFloat maxY = wideLoad(node.maxY);
+    const WideFloat maxZ = wideLoad(node.maxZ);
+
+    const WideFloat ex = wideSub(maxX, minX);
+    const WideFloat ey = wideSub(maxY, minY);
+    const WideFloat ez = wideSub(maxZ, minZ);
+    const WideFloat mx = wideSub(wideSet(rayPointsSum[0]), wideAdd(minX, maxX));
+    const WideFloat my = wideSub(wideSet(rayPointsSum[1]), wideAdd(minY, maxY));
+    const WideFloat mz = wideSub(wideSet(rayPointsSum[2]), wideAdd(minZ, maxZ));
+    const WideFloat dx = wideSet(rayDirection[0]);
+    const WideFloat dy = wideSet(rayDirection[1]);
+    const WideFloat dz = wideSet(rayDirection[2]);
+    const WideFloat adxs = wideSet(adx);
+    const WideFloat adys = wideSet(ady);
+    const WideFloat adzs = wideSet(adz);
+
+    // Test if the AABB face normals are separating axis
+    WideFloat separated = wideGreater(wideAbs(mx), wideAdd(ex, adxs));
+    separated = wideOr(separated, wideGreater(wideAbs(my), wideAdd(ey, adys)));
+    separated = wideOr(separated, wideGreater(wideAbs(mz), wideAdd(ez, adzs)));
+
+    // Test if the cross products between face normals and ray direction are separating axis
+    separated = wideOr(separated, wideGreater(wideAbs(wideSub(wideMul(my, dz), wideMul(mz, dy))),
+                                              wideAdd(wideMul(ey, adzs), wideMul(ez, adys))));
+    separated = wideOr(separated, wideGreater(wideAbs(wideSub(wideMul(mz, dx), wideMul(mx, dz))),
+                                              wideAdd(wideMul(ex, adzs), wideMul(ez, adxs))));
+    separated = wideOr(separated, wideGreater(wideAbs(wideSub(wideMul(mx, dy), wideMul(my, dx))),
+                                              wideAdd(wideMul(ex, adys), wideMul(ey, adxs))));
+
+    return ~wideMoveMask(separated) & ((1u << WideTreeNode::NB_CHILDREN) - 1);
+
+#else
+
+    uint32 mask = 0;
+    for (uint32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+
+        const float ex = node.maxX[i] - node.minX[i];
+        const float ey = node.maxY[i] - node.minY[i];
+        const float ez = node.maxZ[i] - node.minZ[i];
+        const float mx = rayPointsSum[0] - (node.minX[i] + node.maxX[i]);
+        const float my = rayPointsSum[1] - (node.minY[i] + node.maxY[i]);
+        const float mz = rayPointsSum[2] - (node.minZ[i] + node.maxZ[i]);
+
+        // Test if the AABB face normals are separating axis
+        if (std::abs(mx) > ex + adx || std::abs(my) > ey + ady || std::abs(mz) > ez + adz) continue;
+
+        // Test if the cross products between face normals and ray direction are separating axis
+        if (std::abs(my * rayDirection[2] - mz * rayDirection[1]) > ey * adz + ez * ady) continue;
+        if (std::abs(mz * rayDirection[0] - mx * rayDirection[2]) > ex * adz + ez * adx) continue;
+        if (std::abs(mx * rayDirection[1] - my * rayDirection[0]) > ex * ady + ey * adx) continue;
+
+        mask |= (1u << i);
+    }
+
+    return mask;
+
+#endif
+}
 
 // Constructor
 DynamicAABBTree::DynamicAABBTree(MemoryAllocator& allocator, decimal fatAABBInflatePercentage)
-                : mAllocator(allocator), mFatAABBInflatePercentage(fatAABBInflatePercentage) {
+                : mAllocator(allocator), mFatAABBInflatePercentage(fatAABBInflatePercentage),
+                  mIsWideTreeEnabled(false), mIsQuantizedTreeEnabled(false) {
 
     init();
 }
@@ -46,6 +257,9 @@ DynamicAABBTree::~DynamicAABBTree() {
 
     // Free the allocated memory for the nodes
     mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+
+    releaseWideTree();
+    releaseQuantizedTree();
 }
 
 // Initialize the tree
@@ -68,6 +282,45 @@ void DynamicAABBTree::init() {
     mNodes[mNbAllocatedNodes - 1].nextNodeID = TreeNode::NULL_TREE_NODE;
     mNodes[mNbAllocatedNodes - 1].height = -1;
     mFreeNodeID = 0;
+
+    mIsWideTreeUpToDate = false;
+    mWideNodes = nullptr;
+    mNbWideNodes = 0;
+    mNbAllocatedWideNodes = 0;
+    mIsQuantizedTreeUpToDate = false;
+    mQuantizedNodes = nullptr;
+    mNbQuantizedNodes = 0;
+    mNbAllocatedQuantizedNodes = 0;
+    mNextOptimizedNodeID = 0;
+    mIsBulkInsertionActive = false;
+    mNbPendingLeaves = 0;
+    mNbStructuralChanges = 0;
+}
+
+// Release the memory of the wide tree
+void DynamicAABBTree::releaseWideTree() {
+
+    if (mNbAllocatedWideNodes > 0) {
+        mAllocator.release(mWideNodes, static_cast<size_t>(mNbAllocatedWideNodes) * sizeof(WideTreeNode));
+    }
+
+    mWideNodes = nullptr;
+    mNbWideNodes = 0;
+    mNbAllocatedWideNodes = 0;
+    mIsWideTreeUpToDate = false;
+}
+
+// Release the memory of the quantized tree
+void DynamicAABBTree::releaseQuantizedTree() {
+
+    if (mNbAllocatedQuantizedNodes > 0) {
+        mAllocator.release(mQuantizedNodes, static_cast<size_t>(mNbAllocatedQuantizedNodes) * sizeof(QuantizedTreeNode));
+    }
+
+    mQuantizedNodes = nullptr;
+    mNbQuantizedNodes = 0;
+    mNbAllocatedQuantizedNodes = 0;
+    mIsQuantizedTreeUpToDate = false;
 }
 
 // Clear all the nodes and reset the tree
@@ -75,6 +328,8 @@ void DynamicAABBTree::reset() {
 
     // Free the allocated memory for the nodes
     mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+    releaseWideTree();
+    releaseQuantizedTree();
 
     // Initialize the tree
     init();
@@ -112,6 +367,7 @@ int32 DynamicAABBTree::allocateNode() {
     mFreeNodeID = mNodes[freeNodeID].nextNodeID;
     mNodes[freeNodeID].parentID = TreeNode::NULL_TREE_NODE;
     mNodes[freeNodeID].height = 0;
+    mNodes[freeNodeID].isMoved = false;
     mNbNodes++;
 
     return freeNodeID;
@@ -125,6 +381,7 @@ void DynamicAABBTree::releaseNode(int nodeID) {
     assert(mNodes[nodeID].height >= 0);
     mNodes[nodeID].nextNodeID = mFreeNodeID;
     mNodes[nodeID].height = -1;
+    mNodes[nodeID].isMoved = false;
     mFreeNodeID = nodeID;
     mNbNodes--;
 }
@@ -143,8 +400,17 @@ int32 DynamicAABBTree::addObjectInternal(const AABB& aabb) {
     // Set the height of the node in the tree
     mNodes[nodeID].height = 0;
 
-    // Insert the new leaf node in the tree
-    insertLeafNode(nodeID);
+    // During a bulk insertion, the leaf is only inserted in the tree at the end of the insertion
+    if (mIsBulkInsertionActive) {
+        mNbPendingLeaves++;
+        mIsWideTreeUpToDate = false;
+        mIsQuantizedTreeUpToDate = false;
+    }
+    else {
+
+        // Insert the new leaf node in the tree
+        insertLeafNode(nodeID);
+    }
     assert(mNodes[nodeID].isLeaf());
 
     assert(nodeID >= 0);
@@ -160,7 +426,12 @@ void DynamicAABBTree::removeObject(int32 nodeID) {
     assert(mNodes[nodeID].isLeaf());
 
     // Remove the node from the tree
-    removeLeafNode(nodeID);
+    if (isPendingLeaf(nodeID)) {
+        mNbPendingLeaves--;
+    }
+    else {
+        removeLeafNode(nodeID);
+    }
     releaseNode(nodeID);
 }
 
@@ -171,7 +442,10 @@ void DynamicAABBTree::removeObject(int32 nodeID) {
 /// If the "forceReInsert" parameter is true, we force the existing AABB to take the size
 /// of the "newAABB" parameter even if it is larger than "newAABB". This can be used to shrink the
 /// AABB in the tree for instance if the corresponding collision shape has been shrunk.
-bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert) {
+/// If the node is reinserted, its fat AABB is also extended along the "displacement" parameter
+/// (the predicted displacement of the object until the next update) so that a fast moving object
+/// does not leave its fat AABB at the next update.
+bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert) {
 
     RP3D_PROFILE("DynamicAABBTree::updateObject()", mProfiler);
 
@@ -184,19 +458,27 @@ bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool force
         return false;
     }
 
+    // A leaf added during the bulk insertion is not in the tree yet
+    const bool isPending = isPendingLeaf(nodeID);
+
     // If the new AABB is outside the fat AABB, we remove the corresponding node
-    removeLeafNode(nodeID);
+    if (!isPending) {
+        removeLeafNode(nodeID);
+    }
 
     // Compute the fat AABB by inflating the AABB with by a constant percentage of the size of the AABB
     mNodes[nodeID].aabb = newAABB;
     const Vector3 gap(newAABB.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
     mNodes[nodeID].aabb.mMinCoordinates -= gap;
     mNodes[nodeID].aabb.mMaxCoordinates += gap;
+    mNodes[nodeID].aabb.extendAlongDisplacement(displacement);
 
     assert(mNodes[nodeID].aabb.contains(newAABB));
 
     // Reinsert the node into the tree
-    insertLeafNode(nodeID);
+    if (!isPending) {
+        insertLeafNode(nodeID);
+    }
 
     return true;
 }
@@ -206,6 +488,10 @@ bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool force
 // with Box2D" by Ian Parberry.
 void DynamicAABBTree::insertLeafNode(int nodeID) {
 
+    mIsWideTreeUpToDate = false;
+    mIsQuantizedTreeUpToDate = false;
+    mNbStructuralChanges++;
+
     // If the tree is empty
     if (mRootNodeID == TreeNode::NULL_TREE_NODE) {
         mRootNodeID = nodeID;
@@ -336,6 +622,10 @@ void DynamicAABBTree::insertLeafNode(int nodeID) {
 // Remove a leaf node from the tree
 void DynamicAABBTree::removeLeafNode(int nodeID) {
 
+    mIsWideTreeUpToDate = false;
+    mIsQuantizedTreeUpToDate = false;
+    mNbStructuralChanges++;
+
     assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
     assert(mNodes[nodeID].isLeaf());
 
@@ -574,14 +864,61 @@ int32 DynamicAABBTree::balanceSubTreeAtNode(int32 nodeID) {
 }
 
 /// Take a list of shapes to be tested for broad-phase overlap and return a list of pair of overlapping shapes
-void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const List<int32>& nodesToTest, size_t startIndex,
-                                                           size_t endIndex, List<Pair<int32, int32>>& outOverlappingNodes) const {
+/// The node IDs of the shapes to test refer to nodes of the tree in parameter (which can be
+/// this tree). Each reported pair contains the node ID of the shape to test and the ID of the
+/// overlapping leaf node of this tree.
+void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const DynamicAABBTree& shapesTree, const List<int32>& nodesToTest,
+                                                           size_t startIndex, size_t endIndex,
+                                                           List<Pair<int32, int32>>& outOverlappingNodes) const {
 
     RP3D_PROFILE("DynamicAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
 
     // Create a stack with the nodes to visit
     Stack<int32> stack(mAllocator, 64);
 
+    // If the wide tree can be used
+    if (canUseWideTree()) {
+
+        List<int32> overlappingLeaves(mAllocator, 16);
+
+        // For each shape to be tested for overlap
+        for (size_t i=startIndex; i < endIndex; i++) {
+
+            assert(nodesToTest[i] != -1);
+
+            overlappingLeaves.clear();
+            reportWideTreeLeavesOverlappingWithAABB(shapesTree.getFatAABB(nodesToTest[i]), stack, overlappingLeaves);
+
+            for (uint32 j=0; j < overlappingLeaves.size(); j++) {
+                outOverlappingNodes.add(Pair<int32, int32>(nodesToTest[i], overlappingLeaves[j]));
+            }
+        }
+
+        return;
+    }
+
+    // If the quantized tree can be used
+    if (canUseQuantizedTree()) {
+
+        Stack<Pair<int32, AABB>> quantizedStack(mAllocator, 64);
+        List<int32> overlappingLeaves(mAllocator, 16);
+
+        // For each shape to be tested for overlap
+        for (size_t i=startIndex; i < endIndex; i++) {
+
+            assert(nodesToTest[i] != -1);
+
+            overlappingLeaves.clear();
+            reportQuantizedTreeLeavesOverlappingWithAABB(shapesTree.getFatAABB(nodesToTest[i]), quantizedStack, overlappingLeaves);
+
+            for (uint32 j=0; j < overlappingLeaves.size(); j++) {
+                outOverlappingNodes.add(Pair<int32, int32>(nodesToTest[i], overlappingLeaves[j]));
+            }
+        }
+
+        return;
+    }
+
     // For each shape to be tested for overlap
     for (uint i=startIndex; i < endIndex; i++) {
 
@@ -589,7 +926,7 @@ void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const List<int32>& no
 
         stack.push(mRootNodeID);
 
-        const AABB& shapeAABB = getFatAABB(nodesToTest[i]);
+        const AABB& shapeAABB = shapesTree.getFatAABB(nodesToTest[i]);
 
         // While there are still nodes to visit
         while(stack.size() > 0) {
@@ -625,6 +962,125 @@ void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const List<int32>& no
     }
 }
 
+// Mark some leaf nodes and all their ancestors in an array of flags (one flag per allocated node)
+/// The array in parameter must have been cleared before calling this method. During a dual-tree
+/// traversal, the pairs of sub-trees without any marked leaf are skipped.
+void DynamicAABBTree::markLeavesAndAncestors(const List<int32>& leafNodes, bool* outMarkedNodes) const {
+
+    for (uint32 i=0; i < leafNodes.size(); i++) {
+
+        assert(mNodes[leafNodes[i]].isLeaf());
+
+        // Mark the leaf and its ancestors until we find an already marked node
+        int32 nodeID = leafNodes[i];
+        while (nodeID != TreeNode::NULL_TREE_NODE && !outMarkedNodes[nodeID]) {
+            outMarkedNodes[nodeID] = true;
+            nodeID = mNodes[nodeID].parentID;
+        }
+    }
+}
+
+// Test a pair of nodes during a dual-tree traversal and return the pairs of children to test next
+/// A pair made of twice the same node of the same tree represents the pairs of leaves inside
+/// the sub-tree of this node. The pairs of overlapping leaves with at least one marked leaf are
+/// added into the output list. This method returns the number of child pairs (at most three).
+uint32 DynamicAABBTree::testNodePair(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                                     int32 node1ID, int32 node2ID, Pair<int32, int32>* outChildNodePairs,
+                                     List<Pair<int32, int32>>& outOverlappingNodes) const {
+
+    const TreeNode* node1 = mNodes + node1ID;
+    const TreeNode* node2 = tree2.mNodes + node2ID;
+
+    // If we need to find the overlapping pairs inside a single sub-tree
+    if (&tree2 == this && node1ID == node2ID) {
+
+        if (node1->isLeaf() || !markedNodes1[node1ID]) return 0;
+
+        outChildNodePairs[0] = Pair<int32, int32>(node1->children[0], node1->children[0]);
+        outChildNodePairs[1] = Pair<int32, int32>(node1->children[1], node1->children[1]);
+        outChildNodePairs[2] = Pair<int32, int32>(node1->children[0], node1->children[1]);
+
+        return 3;
+    }
+
+    // If none of the two sub-trees contains a marked leaf or if they do not overlap
+    if (!markedNodes1[node1ID] && !markedNodes2[node2ID]) return 0;
+    if (!node1->aabb.testCollision(node2->aabb)) return 0;
+
+    // If the two nodes are leaves, we report the pair
+    if (node1->isLeaf() && node2->isLeaf()) {
+        outOverlappingNodes.add(Pair<int32, int32>(node1ID, node2ID));
+        return 0;
+    }
+
+    // Otherwise, we descend into the largest internal node
+    if (node2->isLeaf() || (!node1->isLeaf() && node1->aabb.getVolume() >= node2->aabb.getVolume())) {
+
+        outChildNodePairs[0] = Pair<int32, int32>(node1->children[0], node2ID);
+        outChildNodePairs[1] = Pair<int32, int32>(node1->children[1], node2ID);
+    }
+    else {
+
+        outChildNodePairs[0] = Pair<int32, int32>(node1ID, node2->children[0]);
+        outChildNodePairs[1] = Pair<int32, int32>(node1ID, node2->children[1]);
+    }
+
+    return 2;
+}
+
+// Expand some pairs of nodes one level down during a dual-tree traversal
+/// This is used to split a dual-tree traversal into independent pairs of sub-trees.
+void DynamicAABBTree::expandNodePairs(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                                      const List<Pair<int32, int32>>& nodePairs, List<Pair<int32, int32>>& outChildNodePairs,
+                                      List<Pair<int32, int32>>& outOverlappingNodes) const {
+
+    Pair<int32, int32> childNodePairs[3] = {Pair<int32, int32>(0, 0), Pair<int32, int32>(0, 0), Pair<int32, int32>(0, 0)};
+
+    for (uint32 i=0; i < nodePairs.size(); i++) {
+
+        const uint32 nbChildNodePairs = testNodePair(tree2, markedNodes1, markedNodes2, nodePairs[i].first,
+                                                     nodePairs[i].second, childNodePairs, outOverlappingNodes);
+        for (uint32 c=0; c < nbChildNodePairs; c++) {
+            outChildNodePairs.add(childNodePairs[c]);
+        }
+    }
+}
+
+// Report all the pairs of overlapping leaves below some pairs of nodes using a dual-tree traversal
+/// The first node of each pair belongs to this tree and the second one to the tree in parameter (which
+/// can be this tree). Only the pairs with at least one marked leaf (see markLeavesAndAncestors()) are
+/// reported and each pair is reported only once.
+void DynamicAABBTree::reportAllOverlappingLeaves(const DynamicAABBTree& tree2, const bool* markedNodes1, const bool* markedNodes2,
+                                                 const List<Pair<int32, int32>>& nodePairs, size_t startIndex, size_t endIndex,
+                                                 List<Pair<int32, int32>>& outOverlappingNodes) const {
+
+    RP3D_PROFILE("DynamicAABBTree::reportAllOverlappingLeaves()", mProfiler);
+
+    Pair<int32, int32> childNodePairs[3] = {Pair<int32, int32>(0, 0), Pair<int32, int32>(0, 0), Pair<int32, int32>(0, 0)};
+
+    // Create a stack with the pairs of nodes to visit
+    Stack<Pair<int32, int32>> stack(mAllocator, 64);
+
+    for (size_t i=startIndex; i < endIndex; i++) {
+
+        if (nodePairs[i].first == TreeNode::NULL_TREE_NODE || nodePairs[i].second == TreeNode::NULL_TREE_NODE) continue;
+
+        stack.push(nodePairs[i]);
+
+        // While there are still pairs of nodes to visit
+        while(stack.size() > 0) {
+
+            const Pair<int32, int32> nodePair = stack.pop();
+
+            const uint32 nbChildNodePairs = testNodePair(tree2, markedNodes1, markedNodes2, nodePair.first,
+                                                         nodePair.second, childNodePairs, outOverlappingNodes);
+            for (uint32 c=0; c < nbChildNodePairs; c++) {
+                stack.push(childNodePairs[c]);
+            }
+        }
+    }
+}
+
 // Report all shapes overlapping with the AABB given in parameter.
 void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int32>& overlappingNodes) const {
 
@@ -632,6 +1088,20 @@ void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<
 
     // Create a stack with the nodes to visit
     Stack<int32> stack(mAllocator, 64);
+
+    // If the wide tree can be used
+    if (canUseWideTree()) {
+        reportWideTreeLeavesOverlappingWithAABB(aabb, stack, overlappingNodes);
+        return;
+    }
+
+    // If the quantized tree can be used
+    if (canUseQuantizedTree()) {
+        Stack<Pair<int32, AABB>> quantizedStack(mAllocator, 64);
+        reportQuantizedTreeLeavesOverlappingWithAABB(aabb, quantizedStack, overlappingNodes);
+        return;
+    }
+
     stack.push(mRootNodeID);
 
     // While there are still nodes to visit
@@ -665,11 +1135,63 @@ void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<
     }
 }
 
+// Report all shapes overlapping with the AABB given in parameter to a callback
+/// Contrary to the other version of this method, no list of results is filled. Therefore,
+/// the caller can process the overlapping shapes without any allocation.
+void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback) const {
+
+    RP3D_PROFILE("DynamicAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    // Create a stack with the nodes to visit
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(mRootNodeID);
+
+    // While there are still nodes to visit
+    while(stack.size() > 0) {
+
+        // Get the next node ID to visit
+        const int32 nodeIDToVisit = stack.pop();
+
+        // Skip it if it is a null node
+        if (nodeIDToVisit == TreeNode::NULL_TREE_NODE) continue;
+
+        // Get the corresponding node
+        const TreeNode* nodeToVisit = mNodes + nodeIDToVisit;
+
+        // If the AABB in parameter overlaps with the AABB of the node to visit
+        if (aabb.testCollision(nodeToVisit->aabb)) {
+
+            // If the node is a leaf
+            if (nodeToVisit->isLeaf()) {
+                callback.notifyOverlappingNode(nodeIDToVisit);
+            }
+            else {  // If the node is not a leaf
+
+                // We need to visit its children
+                stack.push(nodeToVisit->children[0]);
+                stack.push(nodeToVisit->children[1]);
+            }
+        }
+    }
+}
+
 // Ray casting method
 void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
 
     RP3D_PROFILE("DynamicAABBTree::raycast()", mProfiler);
 
+    // If the wide tree can be used
+    if (canUseWideTree()) {
+        raycastWideTree(ray, callback);
+        return;
+    }
+
+    // If the quantized tree can be used
+    if (canUseQuantizedTree()) {
+        raycastQuantizedTree(ray, callback);
+        return;
+    }
+
     decimal maxFraction = ray.maxFraction;
 
     Stack<int32> stack(mAllocator, 128);
@@ -727,6 +1249,894 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& ca
     }
 }
 
+// Ray casting method for a packet of rays that share the traversal of the tree
+/// The nodes are visited once for the whole packet. Each element of the stack contains a
+/// node and the mask of the rays of the packet that hit its parent. Only those rays are
+/// tested against the AABB of the node. This reduces the memory traffic when the rays are
+/// coherent (close to each other with similar directions). The stack is given by the
+/// caller so that it can be reused for many packets.
+void DynamicAABBTree::raycastPacket(const Ray* rays, uint32 nbRays, DynamicAABBTreeRaycastPacketCallback& callback,
+                                    Stack<Pair<int32, uint32>>& stack) const {
+
+    RP3D_PROFILE("DynamicAABBTree::raycastPacket()", mProfiler);
+
+    assert(nbRays > 0 && nbRays <= MAX_RAYCAST_PACKET_SIZE);
+
+    decimal maxFractions[MAX_RAYCAST_PACKET_SIZE];
+    for (uint32 i=0; i < nbRays; i++) {
+        maxFractions[i] = rays[i].maxFraction;
+    }
+
+    // Mask of the rays whose raycasting has not been stopped by the callback
+    uint32 activeRaysMask = nbRays == MAX_RAYCAST_PACKET_SIZE ? ~uint32(0) : (uint32(1) << nbRays) - 1;
+
+    stack.clear();
+    stack.push(Pair<int32, uint32>(mRootNodeID, activeRaysMask));
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, uint32> nodeRays = stack.pop();
+        const int32 nodeID = nodeRays.first;
+
+        // If it is a null node, skip it
+        if (nodeID == TreeNode::NULL_TREE_NODE) continue;
+
+        const TreeNode* node = mNodes + nodeID;
+
+        // Compute the mask of the rays that intersect with the AABB of the node
+        uint32 raysToTest = nodeRays.second & activeRaysMask;
+        uint32 hitRaysMask = 0;
+        while (raysToTest != 0) {
+
+            const uint32 rayIndex = computeIndexLowestBit(raysToTest);
+            raysToTest &= raysToTest - 1;
+
+            const Ray rayTemp(rays[rayIndex].point1, rays[rayIndex].point2, maxFractions[rayIndex]);
+            if (node->aabb.testRayIntersect(rayTemp)) {
+                hitRaysMask |= uint32(1) << rayIndex;
+            }
+        }
+
+        if (hitRaysMask == 0) continue;
+
+        // If the node is a leaf of the tree
+        if (node->isLeaf()) {
+
+            while (hitRaysMask != 0) {
+
+                const uint32 rayIndex = computeIndexLowestBit(hitRaysMask);
+                hitRaysMask &= hitRaysMask - 1;
+
+                // Call the callback that will raycast again the broad-phase shape
+                const Ray rayTemp(rays[rayIndex].point1, rays[rayIndex].point2, maxFractions[rayIndex]);
+                const decimal hitFraction = callback.raycastBroadPhaseShape(nodeID, rayTemp, rayIndex);
+
+                // If the user returned a hitFraction of zero, it means that
+                // the raycasting of this ray should stop here
+                if (hitFraction == decimal(0.0)) {
+                    activeRaysMask &= ~(uint32(1) << rayIndex);
+                }
+                else if (hitFraction > decimal(0.0) && hitFraction < maxFractions[rayIndex]) {
+                    maxFractions[rayIndex] = hitFraction;
+                }
+            }
+
+            if (activeRaysMask == 0) return;
+        }
+        else {  // If the node has children
+
+            // Push its children in the stack of nodes to explore with the rays that hit the node
+            stack.push(Pair<int32, uint32>(node->children[0], hitRaysMask));
+            stack.push(Pair<int32, uint32>(node->children[1], hitRaysMask));
+        }
+    }
+}
+
+// Range of leaves to build during a top-down rebuild of the tree
+struct TreeBuildRange {
+
+    /// Index of the first leaf of the range
+    uint32 startIndex;
+
+    /// Index after the last leaf of the range
+    uint32 endIndex;
+
+    /// ID of the parent node of the sub-tree to build
+    int32 parentNodeID;
+
+    /// Index of the sub-tree in the children of the parent node
+    int32 childIndex;
+
+    TreeBuildRange(uint32 startIndex, uint32 endIndex, int32 parentNodeID, int32 childIndex)
+        : startIndex(startIndex), endIndex(endIndex), parentNodeID(parentNodeID), childIndex(childIndex) {
+
+    }
+};
+
+// Rebuild the whole tree top-down from its current leaves using the surface area heuristic
+/// The IDs of the leaf nodes (and therefore the data stored in the tree) do not change. Only
+/// the internal nodes are recreated. This can be used to restore the quality of a tree that
+/// has been degraded by a lot of incremental insertions and removals.
+void DynamicAABBTree::rebuildTopDown() {
+
+    RP3D_PROFILE("DynamicAABBTree::rebuildTopDown()", mProfiler);
+
+    if (mNbNodes == 0) return;
+
+    mIsWideTreeUpToDate = false;
+    mIsQuantizedTreeUpToDate = false;
+
+    // Get all the leaves and release all the internal nodes
+    List<int32> leaves(mAllocator, static_cast<size_t>(mNbNodes / 2 + 1));
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+
+        // Skip the free nodes
+        if (mNodes[i].height < 0) continue;
+
+        if (mNodes[i].isLeaf()) {
+            leaves.add(i);
+        }
+        else {
+            releaseNode(i);
+        }
+    }
+
+    // Internal nodes in the order of their creation (a parent is always created before its children)
+    List<int32> internalNodes(mAllocator, leaves.size());
+
+    Stack<TreeBuildRange> stack(mAllocator, 64);
+    stack.push(TreeBuildRange(0, leaves.size(), TreeNode::NULL_TREE_NODE, 0));
+
+    while (stack.size() > 0) {
+
+        const TreeBuildRange range = stack.pop();
+        const uint32 nbLeaves = range.endIndex - range.startIndex;
+
+        int32 nodeID;
+        if (nbLeaves == 1) {
+            nodeID = leaves[range.startIndex];
+        }
+        else {
+
+            // Create an internal node and split its leaves in two children
+            nodeID = allocateNode();
+            internalNodes.add(nodeID);
+
+            const uint32 splitIndex = range.startIndex + splitLeavesSAH(&(leaves[range.startIndex]), nbLeaves);
+            stack.push(TreeBuildRange(splitIndex, range.endIndex, nodeID, 1));
+            stack.push(TreeBuildRange(range.startIndex, splitIndex, nodeID, 0));
+        }
+
+        // Link the node with its parent
+        mNodes[nodeID].parentID = range.parentNodeID;
+        if (range.parentNodeID == TreeNode::NULL_TREE_NODE) {
+            mRootNodeID = nodeID;
+        }
+        else {
+            mNodes[range.parentNodeID].children[range.childIndex] = nodeID;
+        }
+    }
+
+    // Compute the AABBs and heights of the internal nodes (children first)
+    for (int32 i=static_cast<int32>(internalNodes.size()) - 1; i >= 0; i--) {
+
+        TreeNode& node = mNodes[internalNodes[i]];
+        const TreeNode& leftChild = mNodes[node.children[0]];
+        const TreeNode& rightChild = mNodes[node.children[1]];
+
+        node.aabb.mergeTwoAABBs(leftChild.aabb, rightChild.aabb);
+        node.height = static_cast<int16>(std::max(leftChild.height, rightChild.height) + 1);
+    }
+
+    // The leaves of a bulk insertion are now in the tree
+    mNbPendingLeaves = 0;
+}
+
+// Split a range of leaves in two using the binned surface area heuristic
+/// The leaves are reordered so that the leaves of the first sub-tree come first. This method
+/// returns the number of leaves in the first sub-tree (which is always between one and the
+/// number of leaves minus one).
+uint32 DynamicAABBTree::splitLeavesSAH(int32* leaves, uint32 nbLeaves) const {
+
+    assert(nbLeaves >= 2);
+
+    if (nbLeaves == 2) return 1;
+
+    // Compute the bounds of the centers of the leaves
+    Vector3 minCenter = mNodes[leaves[0]].aabb.getCenter();
+    Vector3 maxCenter = minCenter;
+    for (uint32 i=1; i < nbLeaves; i++) {
+        const Vector3 center = mNodes[leaves[i]].aabb.getCenter();
+        minCenter = Vector3::min(minCenter, center);
+        maxCenter = Vector3::max(maxCenter, center);
+    }
+
+    // Split along the axis where the centers are the most spread
+    const Vector3 extent = maxCenter - minCenter;
+    const int axis = extent.getMaxAxis();
+
+    // If all the centers are at the same position, we split the range in the middle
+    if (extent[axis] <= MACHINE_EPSILON) return nbLeaves / 2;
+
+    const decimal binScale = decimal(NB_SAH_BINS) / extent[axis];
+
+    // Put the leaves into bins according to their center
+    uint32 binCounts[NB_SAH_BINS];
+    AABB binAABBs[NB_SAH_BINS];
+    for (uint32 b=0; b < NB_SAH_BINS; b++) {
+        binCounts[b] = 0;
+    }
+    for (uint32 i=0; i < nbLeaves; i++) {
+
+        const AABB& aabb = mNodes[leaves[i]].aabb;
+        const uint32 bin = std::min(NB_SAH_BINS - 1, static_cast<uint32>((aabb.getCenter()[axis] - minCenter[axis]) * binScale));
+
+        if (binCounts[bin] == 0) {
+            binAABBs[bin] = aabb;
+        }
+        else {
+            binAABBs[bin].mergeWithAABB(aabb);
+        }
+        binCounts[bin]++;
+    }
+
+    // Compute the surface areas and number of leaves on the left of each split plane
+    decimal leftAreas[NB_SAH_BINS];
+    uint32 leftCounts[NB_SAH_BINS];
+    AABB leftAABB;
+    uint32 leftCount = 0;
+    for (uint32 b=0; b < NB_SAH_BINS - 1; b++) {
+
+        if (binCounts[b] > 0) {
+            if (leftCount == 0) {
+                leftAABB = binAABBs[b];
+            }
+            else {
+                leftAABB.mergeWithAABB(binAABBs[b]);
+            }
+            leftCount += binCounts[b];
+        }
+
+        leftCounts[b] = leftCount;
+        leftAreas[b] = leftCount > 0 ? leftAABB.getSurfaceArea() : decimal(0.0);
+    }
+
+    // Find the split plane with the smallest cost
+    uint32 bestSplitBin = NB_SAH_BINS;
+    decimal bestCost = DECIMAL_LARGEST;
+    AABB rightAABB;
+    uint32 rightCount = 0;
+    for (uint32 b=NB_SAH_BINS - 1; b > 0; b--) {
+
+        if (binCounts[b] > 0) {
+            if (rightCount == 0) {
+                rightAABB = binAABBs[b];
+            }
+            else {
+                rightAABB.mergeWithAABB(binAABBs[b]);
+            }
+            rightCount += binCounts[b];
+        }
+
+        // Split plane between the bins b-1 and b
+        if (leftCounts[b - 1] > 0 && rightCount > 0) {
+
+            const decimal cost = leftAreas[b - 1] * leftCounts[b - 1] + rightAABB.getSurfaceArea() * rightCount;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplitBin = b - 1;
+            }
+        }
+    }
+
+    if (bestSplitBin == NB_SAH_BINS) return nbLeaves / 2;
+
+    // Move the leaves on the left of the split plane at the beginning of the range
+    uint32 nbLeftLeaves = 0;
+    for (uint32 i=0; i < nbLeaves; i++) {
+
+        const uint32 bin = std::min(NB_SAH_BINS - 1, static_cast<uint32>((mNodes[leaves[i]].aabb.getCenter()[axis] - minCenter[axis]) * binScale));
+        if (bin <= bestSplitBin) {
+            std::swap(leaves[i], leaves[nbLeftLeaves]);
+            nbLeftLeaves++;
+        }
+    }
+
+    assert(nbLeftLeaves > 0 && nbLeftLeaves < nbLeaves);
+
+    return nbLeftLeaves;
+}
+
+// Reinsert a given number of leaves in the tree to improve its quality
+/// The leaves are reinserted in a round-robin order so that calling this method at each
+/// simulation step (with a small number of leaves) incrementally optimizes the whole tree.
+/// The IDs of the leaf nodes do not change.
+void DynamicAABBTree::optimizeIncremental(uint32 nbLeavesToReinsert) {
+
+    RP3D_PROFILE("DynamicAABBTree::optimizeIncremental()", mProfiler);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    uint32 nbReinsertedLeaves = 0;
+
+    // Look at each node at most once
+    for (int32 i=0; i < mNbAllocatedNodes && nbReinsertedLeaves < nbLeavesToReinsert; i++) {
+
+        const int32 nodeID = mNextOptimizedNodeID;
+        mNextOptimizedNodeID = (mNextOptimizedNodeID + 1) % mNbAllocatedNodes;
+
+        // If the node is a leaf with a parent (not the whole tree and not a leaf
+        // of a bulk insertion), we reinsert it
+        if (mNodes[nodeID].height == 0 && mNodes[nodeID].parentID != TreeNode::NULL_TREE_NODE) {
+
+            removeLeafNode(nodeID);
+            insertLeafNode(nodeID);
+
+            nbReinsertedLeaves++;
+        }
+    }
+}
+
+// Start a bulk insertion of objects
+/// Until the call to endBulkInsertion(), the new objects are not inserted in the tree one by
+/// one. Their leaves are created but they are not visible to the queries of the tree. The
+/// objects can still be updated or removed during the bulk insertion.
+void DynamicAABBTree::beginBulkInsertion() {
+    mIsBulkInsertionActive = true;
+}
+
+// End the bulk insertion and build the tree with the objects that have been added
+/// If objects have been added since the call to beginBulkInsertion(), the whole tree is
+/// rebuilt top-down. This is much faster than inserting the objects one by one and gives
+/// a tree of better quality.
+void DynamicAABBTree::endBulkInsertion() {
+
+    mIsBulkInsertionActive = false;
+
+    if (mNbPendingLeaves > 0) {
+        rebuildTopDown();
+    }
+
+    assert(mNbPendingLeaves == 0);
+}
+
+// Rewrite the array of nodes in depth-first order and return the new ID of each node
+/// The nodes are allocated from a free list. After many insertions and removals, the nodes
+/// of a sub-tree are scattered in memory and a traversal of the tree has a bad locality.
+/// This method moves the nodes so that each node is followed by its sub-tree (the leaves that
+/// are not in the tree yet during a bulk insertion are placed after the tree) and the free nodes
+/// are at the end of the array. The array "outNewNodeIDs" must have one element per allocated
+/// node (see getNbAllocatedNodes()) and is filled with the new ID of each node (or -1 for
+/// the free nodes). The data stored in the leaves do not change but the IDs of the leaves
+/// must be updated by the caller.
+void DynamicAABBTree::compactNodes(int32* outNewNodeIDs) {
+
+    RP3D_PROFILE("DynamicAABBTree::compactNodes()", mProfiler);
+
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+        outNewNodeIDs[i] = TreeNode::NULL_TREE_NODE;
+    }
+
+    // Compute the new ID of each node of the tree in depth-first order
+    int32 nbNewNodes = 0;
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+
+        Stack<int32> stack(mAllocator, 64);
+        stack.push(mRootNodeID);
+
+        while (stack.size() > 0) {
+
+            const int32 nodeID = stack.pop();
+            outNewNodeIDs[nodeID] = nbNewNodes;
+            nbNewNodes++;
+
+            if (!mNodes[nodeID].isLeaf()) {
+                stack.push(mNodes[nodeID].children[1]);
+                stack.push(mNodes[nodeID].children[0]);
+            }
+        }
+    }
+
+    // The leaves that are not in the tree yet are placed after the tree
+    if (mNbPendingLeaves > 0) {
+        for (int32 i=0; i < mNbAllocatedNodes; i++) {
+            if (isPendingLeaf(i)) {
+                outNewNodeIDs[i] = nbNewNodes;
+                nbNewNodes++;
+            }
+        }
+    }
+
+    assert(nbNewNodes == mNbNodes);
+
+    // Copy the nodes at their new location
+    TreeNode* newNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode)));
+    assert(newNodes != nullptr);
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+
+        const int32 newNodeID = outNewNodeIDs[i];
+        if (newNodeID == TreeNode::NULL_TREE_NODE) continue;
+
+        TreeNode& newNode = newNodes[newNodeID];
+        newNode = mNodes[i];
+
+        if (newNode.parentID != TreeNode::NULL_TREE_NODE) {
+            newNode.parentID = outNewNodeIDs[newNode.parentID];
+        }
+        if (!newNode.isLeaf()) {
+            newNode.children[0] = outNewNodeIDs[newNode.children[0]];
+            newNode.children[1] = outNewNodeIDs[newNode.children[1]];
+        }
+    }
+
+    // Create the list of free nodes after the used nodes
+    for (int32 i=mNbNodes; i < mNbAllocatedNodes; i++) {
+        newNodes[i].nextNodeID = i + 1 < mNbAllocatedNodes ? i + 1 : TreeNode::NULL_TREE_NODE;
+        newNodes[i].height = -1;
+        newNodes[i].isMoved = false;
+    }
+    mFreeNodeID = mNbNodes < mNbAllocatedNodes ? mNbNodes : TreeNode::NULL_TREE_NODE;
+
+    mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+    mNodes = newNodes;
+
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+        mRootNodeID = outNewNodeIDs[mRootNodeID];
+    }
+
+    // The wide and quantized trees refer to the old IDs of the leaves
+    mIsWideTreeUpToDate = false;
+    mIsQuantizedTreeUpToDate = false;
+    mNextOptimizedNodeID = 0;
+    mNbStructuralChanges = 0;
+}
+
+// Return the surface area heuristic cost of the tree
+/// The cost is the sum of the surface areas of the internal nodes divided by the surface
+/// area of the root node. It is proportional to the expected number of internal nodes
+/// visited by a random query. A smaller cost means a better tree.
+decimal DynamicAABBTree::computeTreeCost() const {
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return decimal(0.0);
+
+    const decimal rootArea = mNodes[mRootNodeID].aabb.getSurfaceArea();
+    if (rootArea <= MACHINE_EPSILON) return decimal(0.0);
+
+    decimal internalNodesArea = decimal(0.0);
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+
+        // Only count the internal nodes
+        if (mNodes[i].height > 0) {
+            internalNodesArea += mNodes[i].aabb.getSurfaceArea();
+        }
+    }
+
+    return internalNodesArea / rootArea;
+}
+
+// Enable/Disable the use of the wide version of the tree for the queries
+/// When it is enabled, the wide tree has to be rebuilt with the updateWideTree() method after the
+/// tree has been modified. Until then, the queries use the binary tree.
+void DynamicAABBTree::setIsWideTreeEnabled(bool isEnabled) {
+
+    mIsWideTreeEnabled = isEnabled;
+
+    if (!isEnabled) {
+        releaseWideTree();
+    }
+}
+
+// Rebuild the wide version of the tree if it is enabled and the tree has changed
+/// Each node of the wide tree is created by collapsing the top levels of a sub-tree of the
+/// binary tree. The internal node with the largest volume is expanded until there are enough
+/// children to fill the wide node.
+void DynamicAABBTree::updateWideTree() {
+
+    if (!mIsWideTreeEnabled || mIsWideTreeUpToDate) return;
+
+    RP3D_PROFILE("DynamicAABBTree::updateWideTree()", mProfiler);
+
+    mNbWideNodes = 0;
+    mIsWideTreeUpToDate = true;
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    // Each wide node replaces at least one internal node of the binary tree
+    const int32 nbRequiredWideNodes = std::max(1, (mNbNodes - 1) / 2);
+    if (nbRequiredWideNodes > mNbAllocatedWideNodes) {
+
+        if (mNbAllocatedWideNodes > 0) {
+            mAllocator.release(mWideNodes, static_cast<size_t>(mNbAllocatedWideNodes) * sizeof(WideTreeNode));
+        }
+
+        mNbAllocatedWideNodes = std::max(nbRequiredWideNodes, 2 * mNbAllocatedWideNodes);
+        mWideNodes = static_cast<WideTreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedWideNodes) * sizeof(WideTreeNode)));
+        assert(mWideNodes != nullptr);
+    }
+
+    // Stack with the pairs (binary node, wide node) to build
+    Stack<Pair<int32, int32>> stack(mAllocator, 64);
+
+    mNbWideNodes = 1;
+    stack.push(Pair<int32, int32>(mRootNodeID, 0));
+
+    int32 candidates[WideTreeNode::NB_CHILDREN];
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, int32> nodes = stack.pop();
+        const TreeNode& binaryNode = mNodes[nodes.first];
+
+        // Collect the binary nodes that will become the children of the wide node
+        uint32 nbCandidates;
+        if (binaryNode.isLeaf()) {
+            candidates[0] = nodes.first;
+            nbCandidates = 1;
+        }
+        else {
+
+            candidates[0] = binaryNode.children[0];
+            candidates[1] = binaryNode.children[1];
+            nbCandidates = 2;
+
+            while (nbCandidates < WideTreeNode::NB_CHILDREN) {
+
+                // Find the internal node with the largest volume
+                int32 largestCandidateIndex = -1;
+                decimal largestVolume = decimal(-1.0);
+                for (uint32 i=0; i < nbCandidates; i++) {
+                    const TreeNode& candidate = mNodes[candidates[i]];
+                    if (!candidate.isLeaf() && candidate.aabb.getVolume() > largestVolume) {
+                        largestVolume = candidate.aabb.getVolume();
+                        largestCandidateIndex = static_cast<int32>(i);
+                    }
+                }
+
+                if (largestCandidateIndex < 0) break;
+
+                // Replace it by its two children
+                const TreeNode& largestCandidate = mNodes[candidates[largestCandidateIndex]];
+                candidates[largestCandidateIndex] = largestCandidate.children[0];
+                candidates[nbCandidates] = largestCandidate.children[1];
+                nbCandidates++;
+            }
+        }
+
+        // Fill the wide node
+        WideTreeNode& wideNode = mWideNodes[nodes.second];
+        for (uint32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+
+            if (i < nbCandidates) {
+
+                const TreeNode& candidate = mNodes[candidates[i]];
+                const Vector3& min = candidate.aabb.getMin();
+                const Vector3& max = candidate.aabb.getMax();
+                wideNode.minX[i] = roundDownToFloat(min.x);
+                wideNode.minY[i] = roundDownToFloat(min.y);
+                wideNode.minZ[i] = roundDownToFloat(min.z);
+                wideNode.maxX[i] = roundUpToFloat(max.x);
+                wideNode.maxY[i] = roundUpToFloat(max.y);
+                wideNode.maxZ[i] = roundUpToFloat(max.z);
+
+                if (candidate.isLeaf()) {
+                    wideNode.children[i] = -candidates[i] - 2;
+                }
+                else {
+                    assert(mNbWideNodes < mNbAllocatedWideNodes);
+                    wideNode.children[i] = mNbWideNodes;
+                    stack.push(Pair<int32, int32>(candidates[i], mNbWideNodes));
+                    mNbWideNodes++;
+                }
+            }
+            else {
+
+                // Unused child slot with an empty AABB
+                wideNode.minX[i] = wideNode.minY[i] = wideNode.minZ[i] = FLT_MAX;
+                wideNode.maxX[i] = wideNode.maxY[i] = wideNode.maxZ[i] = -FLT_MAX;
+                wideNode.children[i] = WideTreeNode::NULL_CHILD;
+            }
+        }
+    }
+}
+
+// Report all the leaves of the wide tree overlapping with an AABB
+/// The leaves are tested again with their exact AABB so that the same leaves are reported
+/// as with the binary tree.
+void DynamicAABBTree::reportWideTreeLeavesOverlappingWithAABB(const AABB& aabb, Stack<int32>& stack,
+                                                              List<int32>& overlappingNodes) const {
+
+    assert(canUseWideTree());
+
+    if (mNbWideNodes == 0) return;
+
+    const float aabbMin[3] = {roundDownToFloat(aabb.getMin().x), roundDownToFloat(aabb.getMin().y),
+                              roundDownToFloat(aabb.getMin().z)};
+    const float aabbMax[3] = {roundUpToFloat(aabb.getMax().x), roundUpToFloat(aabb.getMax().y),
+                              roundUpToFloat(aabb.getMax().z)};
+
+    stack.push(0);
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mWideNodes[stack.pop()];
+
+        // Test the AABBs of all the children at once
+        uint32 mask = computeWideNodeOverlapMask(node, aabbMin, aabbMax);
+
+        for (uint32 i=0; mask != 0; i++, mask >>= 1) {
+
+            if ((mask & 1) == 0 || node.children[i] == WideTreeNode::NULL_CHILD) continue;
+
+            if (node.isLeafChild(i)) {
+
+                const int32 leafNodeID = node.getLeafNodeID(i);
+                if (aabb.testCollision(mNodes[leafNodeID].aabb)) {
+                    overlappingNodes.add(leafNodeID);
+                }
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+}
+
+// Ray casting method using the wide tree
+void DynamicAABBTree::raycastWideTree(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    assert(canUseWideTree());
+
+    if (mNbWideNodes == 0) return;
+
+    decimal maxFraction = ray.maxFraction;
+
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(0);
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mWideNodes[stack.pop()];
+
+        // Compute the ray segment with the current maximum fraction
+        const Vector3 point2 = ray.point1 + maxFraction * (ray.point2 - ray.point1);
+        const Vector3 pointsSum = ray.point1 + point2;
+        const Vector3 direction = point2 - ray.point1;
+        const float rayPointsSum[3] = {static_cast<float>(pointsSum.x), static_cast<float>(pointsSum.y),
+                                       static_cast<float>(pointsSum.z)};
+        const float rayDirection[3] = {static_cast<float>(direction.x), static_cast<float>(direction.y),
+                                       static_cast<float>(direction.z)};
+
+        // Test the AABBs of all the children at once
+        uint32 mask = computeWideNodeRayMask(node, rayPointsSum, rayDirection);
+
+        for (uint32 i=0; mask != 0; i++, mask >>= 1) {
+
+            if ((mask & 1) == 0 || node.children[i] == WideTreeNode::NULL_CHILD) continue;
+
+            if (node.isLeafChild(i)) {
+
+                const int32 leafNodeID = node.getLeafNodeID(i);
+
+                Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+                // Test if the ray intersects with the exact AABB of the leaf
+                if (!mNodes[leafNodeID].aabb.testRayIntersect(rayTemp)) continue;
+
+                // Call the callback that will raycast again the broad-phase shape
+                decimal hitFraction = callback.raycastBroadPhaseShape(leafNodeID, rayTemp);
+
+                // If the user returned a hitFraction of zero, it means that
+                // the raycasting should stop here
+                if (hitFraction == decimal(0.0)) {
+                    return;
+                }
+
+                // If the user returned a positive fraction, we update the maximum fraction
+                if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                    maxFraction = hitFraction;
+                }
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+}
+
+// Enable/Disable the use of the quantized version of the tree for the queries
+/// The quantized tree is a compressed copy of the tree that is only used by the queries. It is
+/// meant for trees that are rarely modified (static colliders, triangle meshes). When it is
+/// enabled, the quantized tree has to be rebuilt with the updateQuantizedTree() method after
+/// the tree has been modified. Until then, the queries use the binary tree.
+void DynamicAABBTree::setIsQuantizedTreeEnabled(bool isEnabled) {
+
+    mIsQuantizedTreeEnabled = isEnabled;
+
+    if (!isEnabled) {
+        releaseQuantizedTree();
+    }
+}
+
+// Node of the binary tree to convert into a node of the quantized tree
+struct QuantizedTreeBuildNode {
+
+    /// ID of the node in the binary tree
+    int32 binaryNodeID;
+
+    /// Index of the node in the quantized tree
+    int32 quantizedNodeIndex;
+
+    /// AABB of the node computed from its quantized offsets
+    AABB aabb;
+
+    QuantizedTreeBuildNode(int32 binaryNodeID, int32 quantizedNodeIndex, const AABB& aabb)
+        : binaryNodeID(binaryNodeID), quantizedNodeIndex(quantizedNodeIndex), aabb(aabb) {
+
+    }
+};
+
+// Rebuild the quantized version of the tree if it is enabled and the tree has changed
+/// The nodes are stored in depth-first order with the two children of a node next to each
+/// other. The offsets of a node are computed relative to the quantized AABB of its parent
+/// (the one that the queries will compute) so that the quantized AABBs always contain the
+/// AABBs of the binary tree.
+void DynamicAABBTree::updateQuantizedTree() {
+
+    if (!mIsQuantizedTreeEnabled || mIsQuantizedTreeUpToDate) return;
+
+    RP3D_PROFILE("DynamicAABBTree::updateQuantizedTree()", mProfiler);
+
+    mNbQuantizedNodes = 0;
+    mIsQuantizedTreeUpToDate = true;
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    if (mNbNodes > mNbAllocatedQuantizedNodes) {
+
+        if (mNbAllocatedQuantizedNodes > 0) {
+            mAllocator.release(mQuantizedNodes, static_cast<size_t>(mNbAllocatedQuantizedNodes) * sizeof(QuantizedTreeNode));
+        }
+
+        mNbAllocatedQuantizedNodes = std::max(mNbNodes, 2 * mNbAllocatedQuantizedNodes);
+        mQuantizedNodes = static_cast<QuantizedTreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedQuantizedNodes) * sizeof(QuantizedTreeNode)));
+        assert(mQuantizedNodes != nullptr);
+    }
+
+    // The root stores the exact AABB of the root of the binary tree
+    mQuantizedRootAABB = mNodes[mRootNodeID].aabb;
+    QuantizedTreeNode& root = mQuantizedNodes[0];
+    for (int i=0; i < 3; i++) {
+        root.minOffsets[i] = 0;
+        root.maxOffsets[i] = 0;
+    }
+    mNbQuantizedNodes = 1;
+
+    Stack<QuantizedTreeBuildNode> stack(mAllocator, 64);
+    stack.push(QuantizedTreeBuildNode(mRootNodeID, 0, mQuantizedRootAABB));
+
+    while (stack.size() > 0) {
+
+        const QuantizedTreeBuildNode buildNode = stack.pop();
+        const TreeNode& binaryNode = mNodes[buildNode.binaryNodeID];
+        QuantizedTreeNode& node = mQuantizedNodes[buildNode.quantizedNodeIndex];
+
+        if (binaryNode.isLeaf()) {
+            node.index = -buildNode.binaryNodeID - 1;
+            continue;
+        }
+
+        // Store the two children next to each other
+        assert(mNbQuantizedNodes + 2 <= mNbAllocatedQuantizedNodes);
+        node.index = mNbQuantizedNodes;
+        mNbQuantizedNodes += 2;
+
+        for (int i=1; i >= 0; i--) {
+
+            const int32 childIndex = node.index + i;
+            QuantizedTreeNode& child = mQuantizedNodes[childIndex];
+            quantizeAABB(mNodes[binaryNode.children[i]].aabb, buildNode.aabb, child);
+
+            AABB childAABB;
+            child.computeAABB(buildNode.aabb, childAABB);
+            stack.push(QuantizedTreeBuildNode(binaryNode.children[i], childIndex, childAABB));
+        }
+    }
+}
+
+// Report all the leaves of the quantized tree overlapping with an AABB
+/// The stack contains the index of the nodes to visit with their AABB. The leaves are tested
+/// again with their exact AABB so that the same leaves are reported as with the binary tree.
+void DynamicAABBTree::reportQuantizedTreeLeavesOverlappingWithAABB(const AABB& aabb, Stack<Pair<int32, AABB>>& stack,
+                                                                   List<int32>& overlappingNodes) const {
+
+    assert(canUseQuantizedTree());
+
+    if (mNbQuantizedNodes == 0 || !aabb.testCollision(mQuantizedRootAABB)) return;
+
+    stack.push(Pair<int32, AABB>(0, mQuantizedRootAABB));
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const Pair<int32, AABB> nodeToVisit = stack.pop();
+        const QuantizedTreeNode& node = mQuantizedNodes[nodeToVisit.first];
+
+        if (node.isLeaf()) {
+
+            const int32 leafNodeID = node.getLeafNodeID();
+            if (aabb.testCollision(mNodes[leafNodeID].aabb)) {
+                overlappingNodes.add(leafNodeID);
+            }
+
+            continue;
+        }
+
+        // Test the AABBs of the two children
+        for (int32 i=0; i < 2; i++) {
+
+            AABB childAABB;
+            mQuantizedNodes[node.index + i].computeAABB(nodeToVisit.second, childAABB);
+            if (aabb.testCollision(childAABB)) {
+                stack.push(Pair<int32, AABB>(node.index + i, childAABB));
+            }
+        }
+    }
+}
+
+// Ray casting method using the quantized tree
+void DynamicAABBTree::raycastQuantizedTree(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    assert(canUseQuantizedTree());
+
+    if (mNbQuantizedNodes == 0) return;
+
+    decimal maxFraction = ray.maxFraction;
+
+    Stack<Pair<int32, AABB>> stack(mAllocator, 64);
+    stack.push(Pair<int32, AABB>(0, mQuantizedRootAABB));
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const Pair<int32, AABB> nodeToVisit = stack.pop();
+        const QuantizedTreeNode& node = mQuantizedNodes[nodeToVisit.first];
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the AABB of the node (the exact AABB for a leaf)
+        if (node.isLeaf()) {
+
+            const int32 leafNodeID = node.getLeafNodeID();
+            if (!mNodes[leafNodeID].aabb.testRayIntersect(rayTemp)) continue;
+
+            // Call the callback that will raycast again the broad-phase shape
+            decimal hitFraction = callback.raycastBroadPhaseShape(leafNodeID, rayTemp);
+
+            // If the user returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                return;
+            }
+
+            // If the user returned a positive fraction, we update the maximum fraction
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+        }
+        else if (nodeToVisit.second.testRayIntersect(rayTemp)) {
+
+            // Push the two children with their AABB in the stack of nodes to explore
+            for (int32 i=0; i < 2; i++) {
+                AABB childAABB;
+                mQuantizedNodes[node.index + i].computeAABB(nodeToVisit.second, childAABB);
+                stack.push(Pair<int32, AABB>(node.index + i, childAABB));
+            }
+        }
+    }
+}
+
 #ifndef NDEBUG
 
 // Check if the tree structure is valid (for debugging purpose)
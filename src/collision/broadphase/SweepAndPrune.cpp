@@ -0,0 +1,448 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/SweepAndPrune.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const uint32 SweepAndPrune::NB_MAX_NEW_ENTRIES_INSERTION_SORT;
+const uint32 SweepAndPrune::SWEEP_AXIS_CHANGE_FACTOR;
+const int32 SweepAndPrune::NULL_PROXY;
+
+// Constructor
+SweepAndPrune::SweepAndPrune(MemoryAllocator& allocator, decimal fatAABBInflatePercentage)
+              : mAllocator(allocator), mNbProxies(0), mNbAllocatedProxies(0), mFreeProxyID(NULL_PROXY),
+                mEntries(nullptr), mNbEntries(0), mNbAllocatedEntries(0), mNbNewEntries(0), mSweepAxis(0),
+                mAreEntriesSorted(true), mFatAABBInflatePercentage(fatAABBInflatePercentage) {
+
+    mProxies = nullptr;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Destructor
+SweepAndPrune::~SweepAndPrune() {
+
+    if (mNbAllocatedProxies > 0) {
+        mAllocator.release(mProxies, static_cast<size_t>(mNbAllocatedProxies) * sizeof(SweepAndPruneProxy));
+    }
+    if (mNbAllocatedEntries > 0) {
+        mAllocator.release(mEntries, mNbAllocatedEntries * sizeof(SweepAndPruneEntry));
+    }
+}
+
+// Allocate and return a new proxy
+int32 SweepAndPrune::allocateProxy() {
+
+    // If there is no more allocated proxy to use
+    if (mFreeProxyID == NULL_PROXY) {
+
+        assert(mNbProxies == mNbAllocatedProxies);
+
+        // Allocate more proxies
+        const int32 oldNbAllocatedProxies = mNbAllocatedProxies;
+        mNbAllocatedProxies = oldNbAllocatedProxies > 0 ? 2 * oldNbAllocatedProxies : 8;
+        SweepAndPruneProxy* oldProxies = mProxies;
+        mProxies = static_cast<SweepAndPruneProxy*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedProxies) * sizeof(SweepAndPruneProxy)));
+        assert(mProxies);
+        if (oldNbAllocatedProxies > 0) {
+            for (int32 i=0; i < oldNbAllocatedProxies; i++) {
+                new (mProxies + i) SweepAndPruneProxy(oldProxies[i]);
+            }
+            mAllocator.release(oldProxies, static_cast<size_t>(oldNbAllocatedProxies) * sizeof(SweepAndPruneProxy));
+        }
+
+        // Initialize the allocated proxies
+        for (int32 i=oldNbAllocatedProxies; i < mNbAllocatedProxies; i++) {
+            new (mProxies + i) SweepAndPruneProxy();
+            mProxies[i].entryIndex = NULL_PROXY;
+            mProxies[i].isMoved = false;
+            mProxies[i].nextProxyID = i + 1 < mNbAllocatedProxies ? i + 1 : NULL_PROXY;
+        }
+        mFreeProxyID = oldNbAllocatedProxies;
+    }
+
+    // Get the next free proxy
+    const int32 proxyID = mFreeProxyID;
+    mFreeProxyID = mProxies[proxyID].nextProxyID;
+    mNbProxies++;
+
+    return proxyID;
+}
+
+// Add a new entry at the end of the array of entries
+void SweepAndPrune::addEntry(int32 proxyID) {
+
+    // If the array of entries is full
+    if (mNbEntries == mNbAllocatedEntries) {
+
+        const uint32 oldNbAllocatedEntries = mNbAllocatedEntries;
+        mNbAllocatedEntries = oldNbAllocatedEntries > 0 ? 2 * oldNbAllocatedEntries : 8;
+        SweepAndPruneEntry* oldEntries = mEntries;
+        mEntries = static_cast<SweepAndPruneEntry*>(mAllocator.allocate(mNbAllocatedEntries * sizeof(SweepAndPruneEntry)));
+        assert(mEntries);
+        if (oldNbAllocatedEntries > 0) {
+            std::memcpy(mEntries, oldEntries, mNbEntries * sizeof(SweepAndPruneEntry));
+            mAllocator.release(oldEntries, oldNbAllocatedEntries * sizeof(SweepAndPruneEntry));
+        }
+    }
+
+    SweepAndPruneEntry& entry = mEntries[mNbEntries];
+    entry.proxyID = proxyID;
+    setEntryInterval(entry);
+    mProxies[proxyID].entryIndex = static_cast<int32>(mNbEntries);
+
+    mNbEntries++;
+    mNbNewEntries++;
+    mAreEntriesSorted = false;
+}
+
+// Add an object and return the ID of its proxy
+/// The entry of the new proxy is added at the end of the array and will
+/// find its place during the next call to sortEntries().
+int32 SweepAndPrune::addObject(const AABB& aabb, void* data) {
+
+    const int32 proxyID = allocateProxy();
+
+    // Create the fat AABB (inflate the AABB by a constant percentage of its size)
+    const Vector3 gap(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+    mProxies[proxyID].aabb.setMin(aabb.getMin() - gap);
+    mProxies[proxyID].aabb.setMax(aabb.getMax() + gap);
+    mProxies[proxyID].dataPointer = data;
+
+    addEntry(proxyID);
+
+    return proxyID;
+}
+
+// Remove an object
+/// The entry of the proxy is only marked as removed. It will be removed from
+/// the array during the next call to sortEntries().
+void SweepAndPrune::removeObject(int32 proxyID) {
+
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    assert(mProxies[proxyID].entryIndex != NULL_PROXY);
+
+    mEntries[mProxies[proxyID].entryIndex].proxyID = NULL_PROXY;
+    mAreEntriesSorted = false;
+
+    mProxies[proxyID].entryIndex = NULL_PROXY;
+    mProxies[proxyID].isMoved = false;
+    mProxies[proxyID].nextProxyID = mFreeProxyID;
+    mFreeProxyID = proxyID;
+    mNbProxies--;
+}
+
+// Update the fat AABB of an object that has moved
+/// If the new AABB of the object is still inside its fat AABB, nothing is done. Otherwise, the fat
+/// AABB is recomputed and the method returns true. If the "forceReinsert" parameter is true, the fat
+/// AABB is always recomputed (for instance if the corresponding collision shape has been shrunk).
+/// The new fat AABB is also extended along the predicted displacement of the object.
+bool SweepAndPrune::updateObject(int32 proxyID, const AABB& newAABB, const Vector3& displacement, bool forceReinsert) {
+
+    RP3D_PROFILE("SweepAndPrune::updateObject()", mProfiler);
+
+    assert(proxyID >= 0 && proxyID < mNbAllocatedProxies);
+    assert(mProxies[proxyID].entryIndex != NULL_PROXY);
+
+    SweepAndPruneProxy& proxy = mProxies[proxyID];
+
+    // If the new AABB is still inside the fat AABB of the proxy
+    if (!forceReinsert && proxy.aabb.contains(newAABB)) {
+        return false;
+    }
+
+    // Compute the fat AABB by inflating the AABB by a constant percentage of its size
+    const Vector3 gap(newAABB.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+    proxy.aabb.setMin(newAABB.getMin() - gap);
+    proxy.aabb.setMax(newAABB.getMax() + gap);
+    proxy.aabb.extendAlongDisplacement(displacement);
+
+    // Update the interval of the entry on the sweep axis
+    setEntryInterval(mEntries[proxy.entryIndex]);
+    mAreEntriesSorted = false;
+
+    return true;
+}
+
+// Remove the entries of the removed proxies from the array of entries
+void SweepAndPrune::compactEntries() {
+
+    uint32 nbEntries = 0;
+    for (uint32 i=0; i < mNbEntries; i++) {
+        if (mEntries[i].proxyID != NULL_PROXY) {
+            mEntries[nbEntries] = mEntries[i];
+            nbEntries++;
+        }
+    }
+
+    assert(nbEntries == static_cast<uint32>(mNbProxies));
+    mNbEntries = nbEntries;
+}
+
+// Return the index of the axis with the largest spread of the proxies
+/// If the spread along another axis is not much larger than along the current sweep
+/// axis, the current axis is kept to avoid sorting the entries again from scratch.
+int SweepAndPrune::computeSweepAxis() const {
+
+    if (mNbEntries < 2) return mSweepAxis;
+
+    // Compute the variance of the centers of the proxies along each axis
+    Vector3 sum(0, 0, 0);
+    Vector3 sumSquares(0, 0, 0);
+    for (uint32 i=0; i < mNbEntries; i++) {
+        const AABB& aabb = mProxies[mEntries[i].proxyID].aabb;
+        const Vector3 center = aabb.getCenter();
+        sum += center;
+        sumSquares += Vector3(center.x * center.x, center.y * center.y, center.z * center.z);
+    }
+    const decimal invNbEntries = decimal(1.0) / decimal(mNbEntries);
+    const Vector3 mean = sum * invNbEntries;
+    const Vector3 variance = sumSquares * invNbEntries - Vector3(mean.x * mean.x, mean.y * mean.y, mean.z * mean.z);
+
+    const int maxAxis = variance.getMaxAxis();
+    if (variance[maxAxis] > decimal(SWEEP_AXIS_CHANGE_FACTOR) * variance[mSweepAxis]) {
+        return maxAxis;
+    }
+
+    return mSweepAxis;
+}
+
+// Sort the entries along the sweep axis
+/// This method has to be called before reporting the overlapping pairs. Most of the time,
+/// the objects only move a little bit between two calls and an insertion sort is used. The
+/// entries are sorted from scratch when many objects have been added or when the sweep axis
+/// has changed.
+void SweepAndPrune::sortEntries() {
+
+    RP3D_PROFILE("SweepAndPrune::sortEntries()", mProfiler);
+
+    if (mAreEntriesSorted) return;
+
+    compactEntries();
+
+    // Choose the sweep axis
+    const int sweepAxis = computeSweepAxis();
+    bool isFullSortNeeded = mNbNewEntries > NB_MAX_NEW_ENTRIES_INSERTION_SORT;
+    if (sweepAxis != mSweepAxis) {
+
+        mSweepAxis = sweepAxis;
+        for (uint32 i=0; i < mNbEntries; i++) {
+            setEntryInterval(mEntries[i]);
+        }
+        isFullSortNeeded = true;
+    }
+
+    if (isFullSortNeeded) {
+        std::sort(mEntries, mEntries + mNbEntries);
+    }
+    else {
+
+        // Insertion sort
+        for (uint32 i=1; i < mNbEntries; i++) {
+
+            const SweepAndPruneEntry entry = mEntries[i];
+            uint32 j = i;
+            while (j > 0 && entry < mEntries[j - 1]) {
+                mEntries[j] = mEntries[j - 1];
+                j--;
+            }
+            mEntries[j] = entry;
+        }
+    }
+
+    // Update the index of the entry of each proxy
+    for (uint32 i=0; i < mNbEntries; i++) {
+        mProxies[mEntries[i].proxyID].entryIndex = static_cast<int32>(i);
+    }
+
+    mNbNewEntries = 0;
+    mAreEntriesSorted = true;
+}
+
+// Report the pairs of overlapping proxies with at least one moved proxy for a range of sorted entries
+/// Each pair is reported only once, by the entry with the smallest minimum on the sweep axis. The
+/// entries of the range are swept against all the following entries of the array so that the array
+/// can be split into several ranges that are processed in parallel. The entries must be sorted.
+void SweepAndPrune::reportAllOverlappingPairs(const bool* movedProxies, uint32 startIndex, uint32 endIndex,
+                                              List<Pair<int32, int32>>& outOverlappingProxies) const {
+
+    RP3D_PROFILE("SweepAndPrune::reportAllOverlappingPairs()", mProfiler);
+
+    assert(mAreEntriesSorted);
+    assert(endIndex <= mNbEntries);
+
+    for (uint32 i=startIndex; i < endIndex; i++) {
+
+        const SweepAndPruneEntry& entry = mEntries[i];
+        const bool isMoved = movedProxies[entry.proxyID];
+        const AABB& aabb = mProxies[entry.proxyID].aabb;
+
+        // For each following entry that overlaps with the current one on the sweep axis
+        for (uint32 j=i+1; j < mNbEntries && mEntries[j].min <= entry.max; j++) {
+
+            const int32 otherProxyID = mEntries[j].proxyID;
+
+            if ((isMoved || movedProxies[otherProxyID]) && aabb.testCollision(mProxies[otherProxyID].aabb)) {
+                outOverlappingProxies.add(Pair<int32, int32>(entry.proxyID, otherProxyID));
+            }
+        }
+    }
+}
+
+// Report all the proxies that overlap with the AABB in parameter
+void SweepAndPrune::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int>& overlappingProxies) const {
+
+    RP3D_PROFILE("SweepAndPrune::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    const decimal maxOnSweepAxis = aabb.getMax()[mSweepAxis];
+
+    for (uint32 i=0; i < mNbEntries; i++) {
+
+        const SweepAndPruneEntry& entry = mEntries[i];
+
+        // If the entries are sorted, the following entries cannot overlap with the AABB anymore
+        if (mAreEntriesSorted && entry.min > maxOnSweepAxis) break;
+
+        if (entry.proxyID != NULL_PROXY && mProxies[entry.proxyID].aabb.testCollision(aabb)) {
+            overlappingProxies.add(entry.proxyID);
+        }
+    }
+}
+
+// Report all the proxies that overlap with the AABB in parameter to a callback
+void SweepAndPrune::reportAllShapesOverlappingWithAABB(const AABB& aabb, DynamicAABBTreeOverlapCallback& callback) const {
+
+    RP3D_PROFILE("SweepAndPrune::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    const decimal maxOnSweepAxis = aabb.getMax()[mSweepAxis];
+
+    for (uint32 i=0; i < mNbEntries; i++) {
+
+        const SweepAndPruneEntry& entry = mEntries[i];
+
+        // If the entries are sorted, the following entries cannot overlap with the AABB anymore
+        if (mAreEntriesSorted && entry.min > maxOnSweepAxis) break;
+
+        if (entry.proxyID != NULL_PROXY && mProxies[entry.proxyID].aabb.testCollision(aabb)) {
+            callback.notifyOverlappingNode(entry.proxyID);
+        }
+    }
+}
+
+// Ray casting method
+void SweepAndPrune::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("SweepAndPrune::raycast()", mProfiler);
+
+    decimal maxFraction = ray.maxFraction;
+
+    for (uint32 i=0; i < mNbEntries; i++) {
+
+        const int32 proxyID = mEntries[i].proxyID;
+        if (proxyID == NULL_PROXY) continue;
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the fat AABB of the proxy
+        if (!mProxies[proxyID].aabb.testRayIntersect(rayTemp)) continue;
+
+        // Call the callback that will raycast again the broad-phase shape
+        const decimal hitFraction = callback.raycastBroadPhaseShape(proxyID, rayTemp);
+
+        // If the user returned a hitFraction of zero, it means that
+        // the raycasting should stop here
+        if (hitFraction == decimal(0.0)) {
+            return;
+        }
+
+        // If the user returned a positive fraction, we update the maximum fraction of the ray
+        if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+    }
+}
+
+// Ray casting method for a packet of rays
+/// The array of entries is read once for the whole packet instead of once per ray.
+void SweepAndPrune::raycastPacket(const Ray* rays, uint32 nbRays, DynamicAABBTreeRaycastPacketCallback& callback) const {
+
+    RP3D_PROFILE("SweepAndPrune::raycastPacket()", mProfiler);
+
+    assert(nbRays > 0 && nbRays <= DynamicAABBTree::MAX_RAYCAST_PACKET_SIZE);
+
+    decimal maxFractions[DynamicAABBTree::MAX_RAYCAST_PACKET_SIZE];
+    for (uint32 i=0; i < nbRays; i++) {
+        maxFractions[i] = rays[i].maxFraction;
+    }
+
+    // Mask of the rays whose raycasting has not been stopped by the callback
+    uint32 activeRaysMask = nbRays == DynamicAABBTree::MAX_RAYCAST_PACKET_SIZE ? ~uint32(0) : (uint32(1) << nbRays) - 1;
+
+    for (uint32 i=0; i < mNbEntries; i++) {
+
+        const int32 proxyID = mEntries[i].proxyID;
+        if (proxyID == NULL_PROXY) continue;
+
+        const AABB& aabb = mProxies[proxyID].aabb;
+
+        uint32 raysToTest = activeRaysMask;
+        while (raysToTest != 0) {
+
+            const uint32 rayIndex = computeIndexLowestBit(raysToTest);
+            raysToTest &= raysToTest - 1;
+
+            const Ray rayTemp(rays[rayIndex].point1, rays[rayIndex].point2, maxFractions[rayIndex]);
+
+            // Test if the ray intersects with the fat AABB of the proxy
+            if (!aabb.testRayIntersect(rayTemp)) continue;
+
+            // Call the callback that will raycast again the broad-phase shape
+            const decimal hitFraction = callback.raycastBroadPhaseShape(proxyID, rayTemp, rayIndex);
+
+            // If the user returned a hitFraction of zero, the raycasting of this ray should stop here
+            if (hitFraction == decimal(0.0)) {
+                activeRaysMask &= ~(uint32(1) << rayIndex);
+            }
+            else if (hitFraction > decimal(0.0) && hitFraction < maxFractions[rayIndex]) {
+                maxFractions[rayIndex] = hitFraction;
+            }
+        }
+
+        if (activeRaysMask == 0) return;
+    }
+}
@@ -0,0 +1,529 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxNarrowPhaseInfoBatch.h>
+#include <reactphysics3d/mathematics/Matrix3x3.h>
+#include <reactphysics3d/mathematics/mathematics_functions.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static variables initialization
+const decimal BoxVsBoxAlgorithm::SEPARATING_AXIS_RELATIVE_TOLERANCE = decimal(1.002);
+const decimal BoxVsBoxAlgorithm::SEPARATING_AXIS_ABSOLUTE_TOLERANCE = decimal(0.0005);
+
+// Maximum number of vertices of the incident face after clipping (each one of the
+// four clipping planes can add at most one vertex to the four vertices of the face)
+static const uint MAX_NB_CLIPPED_VERTICES = 8;
+
+// Clip a convex polygon with the plane "sign * x[axis] <= limit"
+/// The method returns the number of vertices of the clipped polygon
+static uint clipPolygonWithBoxPlane(const Vector3* vertices, uint nbVertices, int axis, decimal sign, decimal limit,
+                                    Vector3* outVertices) {
+
+    uint nbOutVertices = 0;
+
+    for (uint i=0; i < nbVertices; i++) {
+
+        const Vector3& v1 = vertices[i];
+        const Vector3& v2 = vertices[(i + 1) % nbVertices];
+        const decimal distance1 = sign * v1[axis] - limit;
+        const decimal distance2 = sign * v2[axis] - limit;
+
+        // If the first vertex is inside, we keep it
+        if (distance1 <= decimal(0.0)) {
+            outVertices[nbOutVertices++] = v1;
+        }
+
+        // If the edge crosses the plane, we add the intersection point
+        if ((distance1 < decimal(0.0) && distance2 > decimal(0.0)) || (distance1 > decimal(0.0) && distance2 < decimal(0.0))) {
+            const decimal t = distance1 / (distance1 - distance2);
+            outVertices[nbOutVertices++] = v1 + t * (v2 - v1);
+        }
+    }
+
+    assert(nbOutVertices <= MAX_NB_CLIPPED_VERTICES);
+
+    return nbOutVertices;
+}
+
+// Compute the penetration depth of two boxes along a face normal of box 1
+/// The depth is computed in the local-space of box 1 where "rotation" is the orientation of box 2
+static decimal computeBox1FacePenetrationDepth(int axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                               const Matrix3x3& absRotation, const Vector3& box2Center) {
+
+    return halfExtents1[axis] + halfExtents2.dot(absRotation.getRow(axis)) - std::abs(box2Center[axis]);
+}
+
+// Compute the penetration depth of two boxes along a face normal of box 2
+/// The depth is computed in the local-space of box 1 where "rotation" is the orientation of box 2
+static decimal computeBox2FacePenetrationDepth(int axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                               const Matrix3x3& rotation, const Matrix3x3& absRotation, const Vector3& box2Center) {
+
+    return halfExtents2[axis] + halfExtents1.dot(absRotation.getColumn(axis)) - std::abs(box2Center.dot(rotation.getColumn(axis)));
+}
+
+// Compute the penetration depth of two boxes along the cross product of an edge direction of each box
+/// The method returns false if the two edges are parallel (the axis is then one of the face normals).
+/// Otherwise, the unit axis (in the local-space of box 1) and the penetration depth along it are returned.
+static bool computeEdgesPenetrationDepth(int edge1Axis, int edge2Axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                         const Matrix3x3& rotation, const Vector3& box2Center, decimal& outPenetrationDepth,
+                                         Vector3& outAxis) {
+
+    Vector3 edge1Direction(0, 0, 0);
+    edge1Direction[edge1Axis] = decimal(1.0);
+    const Vector3 axis = edge1Direction.cross(rotation.getColumn(edge2Axis));
+
+    // If the two edges are parallel, the axis is one of the face normals
+    const decimal axisLengthSquare = axis.lengthSquare();
+    if (axisLengthSquare < decimal(0.00001)) return false;
+
+    const decimal projectedRadius1 = halfExtents1.x * std::abs(axis.x) + halfExtents1.y * std::abs(axis.y) +
+                                     halfExtents1.z * std::abs(axis.z);
+    const decimal projectedRadius2 = halfExtents2.x * std::abs(axis.dot(rotation.getColumn(0))) +
+                                     halfExtents2.y * std::abs(axis.dot(rotation.getColumn(1))) +
+                                     halfExtents2.z * std::abs(axis.dot(rotation.getColumn(2)));
+    const decimal axisLength = std::sqrt(axisLengthSquare);
+    outPenetrationDepth = (projectedRadius1 + projectedRadius2 - std::abs(axis.dot(box2Center))) / axisLength;
+    outAxis = axis / axisLength;
+
+    return true;
+}
+
+// Compute the closest points between the support edges of two boxes along an edges separating axis
+/// The axis (in the local-space of box 1) is made to point from box 1 toward box 2. The closest points are
+/// returned in the local-space of box 1. The method returns true if the closest point on each edge projects
+/// inside the other edge (otherwise the edges are not really in contact).
+static bool computeEdgesClosestPoints(int edge1Axis, int edge2Axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                      const Matrix3x3& rotation, const Vector3& box2Center, Vector3& axis,
+                                      Vector3& outClosestPointEdge1, Vector3& outClosestPointEdge2) {
+
+    // Make sure the axis points from box 1 toward box 2
+    if (axis.dot(box2Center) < decimal(0.0)) {
+        axis = -axis;
+    }
+
+    // Compute the edge of box 1 that is the most extreme along the axis
+    Vector3 edge1Center(0, 0, 0);
+    Vector3 edge1HalfDirection(0, 0, 0);
+    for (int k=0; k < 3; k++) {
+        if (k == edge1Axis) {
+            edge1HalfDirection[k] = halfExtents1[k];
+        }
+        else {
+            edge1Center[k] = axis[k] < decimal(0.0) ? -halfExtents1[k] : halfExtents1[k];
+        }
+    }
+
+    // Compute the edge of box 2 that is the most extreme along the opposite axis
+    Vector3 edge2Center = box2Center;
+    Vector3 edge2HalfDirection;
+    for (int k=0; k < 3; k++) {
+        const Vector3 box2Axis = rotation.getColumn(k);
+        if (k == edge2Axis) {
+            edge2HalfDirection = halfExtents2[k] * box2Axis;
+        }
+        else {
+            edge2Center -= (axis.dot(box2Axis) < decimal(0.0) ? -halfExtents2[k] : halfExtents2[k]) * box2Axis;
+        }
+    }
+
+    const Vector3 edge1A = edge1Center - edge1HalfDirection;
+    const Vector3 edge2A = edge2Center - edge2HalfDirection;
+    const Vector3 edge1Direction = decimal(2.0) * edge1HalfDirection;
+    const Vector3 edge2Direction = decimal(2.0) * edge2HalfDirection;
+
+    // Compute the closest points between the two edges
+    computeClosestPointBetweenTwoSegments(edge1A, edge1A + edge1Direction, edge2A, edge2A + edge2Direction,
+                                          outClosestPointEdge1, outClosestPointEdge2);
+
+    // Project the closest point of each edge onto the other edge (as in the SAT algorithm)
+    const decimal t1 = (outClosestPointEdge1 - edge2A).dot(edge2Direction) / edge2Direction.lengthSquare();
+    const decimal t2 = (outClosestPointEdge2 - edge1A).dot(edge1Direction) / edge1Direction.lengthSquare();
+
+    return t1 >= decimal(0.0) && t1 <= decimal(1.0) && t2 >= decimal(0.0) && t2 <= decimal(1.0);
+}
+
+// Compute the narrow-phase collision detection between two boxes
+/// All the separating axes are tested in the local-space of the first box where its
+/// face normals are the coordinate axes and the face normals of the second box are
+/// the columns of the rotation matrix between the two boxes. As in the SAT algorithm,
+/// the axis of the last frame is tested first (temporal coherence). For a box pair, the
+/// face index of the last frame collision info is the coordinate axis of the face normal
+/// and the edge indices are the coordinate axes of the edge directions.
+bool BoxVsBoxAlgorithm::testCollision(BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems,
+                                      bool clipWithPreviousAxisIfStillColliding) {
+
+    RP3D_PROFILE("BoxVsBoxAlgorithm::testCollision()", mProfiler);
+
+    bool isCollisionFound = false;
+
+    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+
+        assert(narrowPhaseInfoBatch.contactPoints[batchIndex].size() == 0);
+        assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
+
+        const Vector3& halfExtents1 = narrowPhaseInfoBatch.box1HalfExtents[batchIndex];
+        const Vector3& halfExtents2 = narrowPhaseInfoBatch.box2HalfExtents[batchIndex];
+
+        const Transform box2ToBox1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getInverse() *
+                                     narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+        const Transform box1ToBox2 = box2ToBox1.getInverse();
+
+        // The columns of this matrix are the face normals of box 2 in the local-space of box 1
+        const Matrix3x3 rotation = box2ToBox1.getOrientation().getMatrix();
+        const Vector3& box2Center = box2ToBox1.getPosition();
+
+        Matrix3x3 absRotation;
+        for (int i=0; i < 3; i++) {
+            for (int j=0; j < 3; j++) {
+                absRotation[i][j] = std::abs(rotation[i][j]);
+            }
+        }
+
+        // Get the last frame collision info
+        LastFrameCollisionInfo* lastFrameCollisionInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[batchIndex];
+
+        // If the last frame collision info is valid and was also using SAT algorithm
+        if (lastFrameCollisionInfo->isValid && lastFrameCollisionInfo->wasUsingSAT) {
+
+            // We perform temporal coherence, we check if there is still an overlapping along the previous minimum separating
+            // axis. If it is the case, we directly report the collision without testing all the axes again. If
+            // the boxes are still separated along this axis, we directly exit with no collision.
+
+            // If the previous separating axis (or axis with minimum penetration depth) was a face normal
+            if (lastFrameCollisionInfo->satIsAxisFacePolyhedron1 || lastFrameCollisionInfo->satIsAxisFacePolyhedron2) {
+
+                const bool isFaceBox1 = lastFrameCollisionInfo->satIsAxisFacePolyhedron1;
+                const int axis = static_cast<int>(lastFrameCollisionInfo->satMinAxisFaceIndex);
+                assert(axis >= 0 && axis < 3);
+                const decimal penetrationDepth = isFaceBox1 ?
+                            computeBox1FacePenetrationDepth(axis, halfExtents1, halfExtents2, absRotation, box2Center) :
+                            computeBox2FacePenetrationDepth(axis, halfExtents1, halfExtents2, rotation, absRotation, box2Center);
+
+                // If the previous axis was a separating axis and is still a separating axis in this frame
+                if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
+
+                    // Return no collision without testing all the axes
+                    continue;
+                }
+
+                // The two boxes were overlapping in the previous frame and still seem to overlap in this one
+                if (lastFrameCollisionInfo->wasColliding && clipWithPreviousAxisIfStillColliding && penetrationDepth > decimal(0.0)) {
+
+                    // Compute the contact points by clipping the incident face with the reference face of the previous frame
+                    if (computeAxisFaceContactPoints(isFaceBox1, box2ToBox1, box1ToBox2, axis, halfExtents1, halfExtents2,
+                                                 box2Center, narrowPhaseInfoBatch, batchIndex)) {
+
+                        // The boxes are still overlapping in the previous axis (the contact manifold is not empty).
+                        // Therefore, we can return without testing all the axes
+                        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+                        isCollisionFound = true;
+                        continue;
+                    }
+
+                    // The contact manifold is empty. Therefore, we have to test all the axes again
+                }
+            }
+            else {   // If the previous separating axis (or axis with minimum penetration depth) was the cross product of two edges
+
+                const int edge1Axis = static_cast<int>(lastFrameCollisionInfo->satMinEdge1Index);
+                const int edge2Axis = static_cast<int>(lastFrameCollisionInfo->satMinEdge2Index);
+                assert(edge1Axis >= 0 && edge1Axis < 3 && edge2Axis >= 0 && edge2Axis < 3);
+
+                decimal penetrationDepth;
+                Vector3 edgesAxis;
+                if (computeEdgesPenetrationDepth(edge1Axis, edge2Axis, halfExtents1, halfExtents2, rotation, box2Center,
+                                                 penetrationDepth, edgesAxis)) {
+
+                    // If the boxes were not overlapping in the previous frame and are still not overlapping in the current one
+                    if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
+
+                        // We have found a separating axis without testing all the axes
+                        continue;
+                    }
+
+                    // If the boxes were overlapping on the previous axis and still seem to overlap in this frame
+                    if (lastFrameCollisionInfo->wasColliding && clipWithPreviousAxisIfStillColliding && penetrationDepth > decimal(0.0)) {
+
+                        // If the closest points of the two edges do not fall inside the edges, the contact manifold is
+                        // empty and we need to test all the axes again
+                        Vector3 closestPointEdge1, closestPointEdge2;
+                        if (computeEdgesClosestPoints(edge1Axis, edge2Axis, halfExtents1, halfExtents2, rotation, box2Center,
+                                                      edgesAxis, closestPointEdge1, closestPointEdge2)) {
+
+                            // If we need to report contacts
+                            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                                const Vector3 normalWorld = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getOrientation() * edgesAxis;
+                                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                                                     closestPointEdge1, box1ToBox2 * closestPointEdge2);
+                            }
+
+                            narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+                            isCollisionFound = true;
+                            continue;
+                        }
+                    }
+                }
+            }
+        }
+
+        lastFrameCollisionInfo->wasUsingSAT = true;
+        lastFrameCollisionInfo->wasUsingGJK = false;
+
+        bool isSeparatingAxisFound = false;
+
+        // Test the face normals of box 1
+        decimal minPenetrationDepth1 = DECIMAL_LARGEST;
+        int minAxis1 = 0;
+        for (int i=0; i < 3 && !isSeparatingAxisFound; i++) {
+
+            const decimal penetrationDepth = computeBox1FacePenetrationDepth(i, halfExtents1, halfExtents2, absRotation, box2Center);
+            if (penetrationDepth <= decimal(0.0)) {
+
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = true;
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+                lastFrameCollisionInfo->satMinAxisFaceIndex = i;
+                isSeparatingAxisFound = true;
+            }
+            else if (penetrationDepth < minPenetrationDepth1) {
+                minPenetrationDepth1 = penetrationDepth;
+                minAxis1 = i;
+            }
+        }
+
+        // Test the face normals of box 2
+        decimal minPenetrationDepth2 = DECIMAL_LARGEST;
+        int minAxis2 = 0;
+        for (int j=0; j < 3 && !isSeparatingAxisFound; j++) {
+
+            const decimal penetrationDepth = computeBox2FacePenetrationDepth(j, halfExtents1, halfExtents2, rotation, absRotation, box2Center);
+            if (penetrationDepth <= decimal(0.0)) {
+
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
+                lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = true;
+                lastFrameCollisionInfo->satMinAxisFaceIndex = j;
+                isSeparatingAxisFound = true;
+            }
+            else if (penetrationDepth < minPenetrationDepth2) {
+                minPenetrationDepth2 = penetrationDepth;
+                minAxis2 = j;
+            }
+        }
+
+        // Test the cross products of the edges of box 1 with the edges of box 2
+        decimal minEdgesPenetrationDepth = DECIMAL_LARGEST;
+        int minEdge1Axis = 0;
+        int minEdge2Axis = 0;
+        Vector3 minEdgesAxis;
+        for (int i=0; i < 3 && !isSeparatingAxisFound; i++) {
+            for (int j=0; j < 3 && !isSeparatingAxisFound; j++) {
+
+                decimal penetrationDepth;
+                Vector3 axis;
+                if (!computeEdgesPenetrationDepth(i, j, halfExtents1, halfExtents2, rotation, box2Center, penetrationDepth, axis)) {
+                    continue;
+                }
+
+                if (penetrationDepth <= decimal(0.0)) {
+
+                    lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
+                    lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+                    lastFrameCollisionInfo->satMinEdge1Index = i;
+                    lastFrameCollisionInfo->satMinEdge2Index = j;
+                    isSeparatingAxisFound = true;
+                }
+                else if (penetrationDepth < minEdgesPenetrationDepth) {
+                    minEdgesPenetrationDepth = penetrationDepth;
+                    minEdge1Axis = i;
+                    minEdge2Axis = j;
+                    minEdgesAxis = axis;
+                }
+            }
+        }
+
+        if (isSeparatingAxisFound) {
+            continue;
+        }
+
+        // As in the SAT algorithm, we use a relative and absolute bias to favor the faces of box 1 over the faces
+        // of box 2 and the faces over the edges when the penetration depths are almost the same. This way, the
+        // reference face does not switch between frames for a resting contact (this is better for stability).
+        const bool isMinPenetrationFaceBox1 = minPenetrationDepth1 < minPenetrationDepth2 * SEPARATING_AXIS_RELATIVE_TOLERANCE +
+                                                                     SEPARATING_AXIS_ABSOLUTE_TOLERANCE;
+        const decimal minFacesPenetrationDepth = std::min(minPenetrationDepth1, minPenetrationDepth2);
+        const bool isMinPenetrationEdges = minEdgesPenetrationDepth * SEPARATING_AXIS_RELATIVE_TOLERANCE +
+                                           SEPARATING_AXIS_ABSOLUTE_TOLERANCE < minFacesPenetrationDepth;
+
+        // If the minimum penetration axis is a face normal
+        if (!isMinPenetrationEdges) {
+
+            const int minAxis = isMinPenetrationFaceBox1 ? minAxis1 : minAxis2;
+
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = isMinPenetrationFaceBox1;
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = !isMinPenetrationFaceBox1;
+            lastFrameCollisionInfo->satMinAxisFaceIndex = minAxis;
+
+            // There should be clipping points here. If it is not the case, it might be
+            // because of a numerical issue
+            if (!computeAxisFaceContactPoints(isMinPenetrationFaceBox1, box2ToBox1, box1ToBox2, minAxis, halfExtents1, halfExtents2,
+                                          box2Center, narrowPhaseInfoBatch, batchIndex)) {
+                continue;
+            }
+        }
+        else {    // If we have an edge vs edge contact
+
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
+            lastFrameCollisionInfo->satIsAxisFacePolyhedron2 = false;
+            lastFrameCollisionInfo->satMinEdge1Index = minEdge1Axis;
+            lastFrameCollisionInfo->satMinEdge2Index = minEdge2Axis;
+
+            // If we need to report contacts
+            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                // Compute the closest points between the two support edges (in the local-space of box 1)
+                Vector3 closestPointBox1Edge, closestPointBox2Edge;
+                computeEdgesClosestPoints(minEdge1Axis, minEdge2Axis, halfExtents1, halfExtents2, rotation, box2Center,
+                                          minEdgesAxis, closestPointBox1Edge, closestPointBox2Edge);
+
+                const Vector3 normalWorld = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getOrientation() * minEdgesAxis;
+
+                // Create the contact point
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, minEdgesPenetrationDepth,
+                                                     closestPointBox1Edge, box1ToBox2 * closestPointBox2Edge);
+            }
+        }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        isCollisionFound = true;
+    }
+
+    return isCollisionFound;
+}
+
+// Compute the contact points between a face of box 1 or box 2 and the incident face of the other box
+/// The face is the face of the given box with the normal along the coordinate axis "axis" that points
+/// toward the other box. The method returns true if contact points have been found.
+bool BoxVsBoxAlgorithm::computeAxisFaceContactPoints(bool isReferenceBox1, const Transform& box2ToBox1, const Transform& box1ToBox2,
+                                                     int axis, const Vector3& halfExtents1, const Vector3& halfExtents2,
+                                                     const Vector3& box2Center, BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch,
+                                                     uint batchIndex) const {
+
+    if (isReferenceBox1) {
+
+        // The reference face normal points toward box 2
+        const decimal sign = box2Center[axis] < decimal(0.0) ? decimal(-1.0) : decimal(1.0);
+        return computeFaceContactPoints(true, halfExtents1, halfExtents2, box1ToBox2, box2ToBox1, axis, sign,
+                                        narrowPhaseInfoBatch, batchIndex);
+    }
+
+    // The reference face normal points toward box 1
+    const decimal sign = box1ToBox2.getPosition()[axis] < decimal(0.0) ? decimal(-1.0) : decimal(1.0);
+    return computeFaceContactPoints(false, halfExtents2, halfExtents1, box2ToBox1, box1ToBox2, axis, sign,
+                                    narrowPhaseInfoBatch, batchIndex);
+}
+
+// Compute the contact points between a face of a reference box and the incident face of the other box
+/// The reference face is the face of the reference box with the normal "referenceAxisSign" times the
+/// "referenceAxis" coordinate axis (in the local-space of the reference box). The incident face is the face of
+/// the other box that is the most anti-parallel to this normal. This incident face is clipped with the four
+/// side planes of the reference face and the clipped points that are below the reference face are the contact
+/// points. The method returns true if contact points have been found.
+bool BoxVsBoxAlgorithm::computeFaceContactPoints(bool isReferenceBox1, const Vector3& referenceHalfExtents,
+                                                 const Vector3& incidentHalfExtents, const Transform& referenceToIncident,
+                                                 const Transform& incidentToReference, int referenceAxis, decimal referenceAxisSign,
+                                                 BoxVsBoxNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex) const {
+
+    Vector3 referenceNormal(0, 0, 0);
+    referenceNormal[referenceAxis] = referenceAxisSign;
+
+    // Find the incident face (most anti-parallel face)
+    const Vector3 referenceNormalIncidentSpace = referenceToIncident.getOrientation() * referenceNormal;
+    const int incidentAxis = referenceNormalIncidentSpace.getAbsoluteVector().getMaxAxis();
+    const decimal incidentAxisSign = referenceNormalIncidentSpace[incidentAxis] > decimal(0.0) ? decimal(-1.0) : decimal(1.0);
+
+    // Compute the vertices of the incident face (in the local-space of the reference box)
+    const int incidentAxisU = (incidentAxis + 1) % 3;
+    const int incidentAxisV = (incidentAxis + 2) % 3;
+    const decimal signsU[4] = {decimal(1.0), decimal(-1.0), decimal(-1.0), decimal(1.0)};
+    const decimal signsV[4] = {decimal(1.0), decimal(1.0), decimal(-1.0), decimal(-1.0)};
+    Vector3 polygonVertices[MAX_NB_CLIPPED_VERTICES];
+    Vector3 clippedVertices[MAX_NB_CLIPPED_VERTICES];
+    for (uint i=0; i < 4; i++) {
+        Vector3 vertex;
+        vertex[incidentAxis] = incidentAxisSign * incidentHalfExtents[incidentAxis];
+        vertex[incidentAxisU] = signsU[i] * incidentHalfExtents[incidentAxisU];
+        vertex[incidentAxisV] = signsV[i] * incidentHalfExtents[incidentAxisV];
+        polygonVertices[i] = incidentToReference * vertex;
+    }
+
+    // Clip the incident face with the side planes of the reference face
+    const int axisU = (referenceAxis + 1) % 3;
+    const int axisV = (referenceAxis + 2) % 3;
+    uint nbVertices = 4;
+    nbVertices = clipPolygonWithBoxPlane(polygonVertices, nbVertices, axisU, decimal(1.0), referenceHalfExtents[axisU], clippedVertices);
+    nbVertices = clipPolygonWithBoxPlane(clippedVertices, nbVertices, axisU, decimal(-1.0), referenceHalfExtents[axisU], polygonVertices);
+    nbVertices = clipPolygonWithBoxPlane(polygonVertices, nbVertices, axisV, decimal(1.0), referenceHalfExtents[axisV], clippedVertices);
+    nbVertices = clipPolygonWithBoxPlane(clippedVertices, nbVertices, axisV, decimal(-1.0), referenceHalfExtents[axisV], polygonVertices);
+
+    // Compute the world normal (from box 1 toward box 2)
+    const Vector3 normalWorld = isReferenceBox1 ?
+                                narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getOrientation() * referenceNormal :
+                                -(narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex].getOrientation() * referenceNormal);
+
+    // We only keep the clipped points that are below the reference face
+    bool contactPointsFound = false;
+    for (uint i=0; i < nbVertices; i++) {
+
+        const decimal penetrationDepth = referenceHalfExtents[referenceAxis] - referenceAxisSign * polygonVertices[i][referenceAxis];
+
+        if (penetrationDepth > decimal(0.0)) {
+
+            contactPointsFound = true;
+
+            // If we need to report contacts
+            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                // Convert the clipped point into the local-space of the incident box
+                const Vector3 contactPointIncidentBox = referenceToIncident * polygonVertices[i];
+
+                // Project the contact point onto the reference face
+                Vector3 contactPointReferenceBox = polygonVertices[i];
+                contactPointReferenceBox[referenceAxis] = referenceAxisSign * referenceHalfExtents[referenceAxis];
+
+                // Create a new contact point
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                                     isReferenceBox1 ? contactPointReferenceBox : contactPointIncidentBox,
+                                                     isReferenceBox1 ? contactPointIncidentBox : contactPointReferenceBox);
+            }
+        }
+    }
+
+    return contactPointsFound;
+}
@@ -0,0 +1,76 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxNarrowPhaseInfoBatch.h>
+#include <reactphysics3d/collision/shapes/BoxShape.h>
+
+using namespace reactphysics3d;
+
+// Constructor
+BoxVsBoxNarrowPhaseInfoBatch::BoxVsBoxNarrowPhaseInfoBatch(MemoryAllocator& allocator, OverlappingPairs& overlappingPairs)
+      : NarrowPhaseInfoBatch(allocator, overlappingPairs), box1HalfExtents(allocator), box2HalfExtents(allocator) {
+
+}
+
+// Add shapes to be tested during narrow-phase collision detection into the batch
+void BoxVsBoxNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, const Entity& collider1, const Entity& collider2, CollisionShape* shape1, CollisionShape* shape2,
+                                                      const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator &shapeAllocator) {
+
+    NarrowPhaseInfoBatch::addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform,
+                                             shape2Transform, needToReportContacts, shapeAllocator);
+
+    assert(shape1->getName() == CollisionShapeName::BOX);
+    assert(shape2->getName() == CollisionShapeName::BOX);
+
+    const BoxShape* box1 = static_cast<const BoxShape*>(shape1);
+    const BoxShape* box2 = static_cast<const BoxShape*>(shape2);
+
+    box1HalfExtents.add(box1->getHalfExtents());
+    box2HalfExtents.add(box2->getHalfExtents());
+}
+
+// Initialize the containers using cached capacity
+void BoxVsBoxNarrowPhaseInfoBatch::reserveMemory() {
+
+    NarrowPhaseInfoBatch::reserveMemory();
+
+    box1HalfExtents.reserve(mCachedCapacity);
+    box2HalfExtents.reserve(mCachedCapacity);
+}
+
+// Clear all the objects in the batch
+void BoxVsBoxNarrowPhaseInfoBatch::clear() {
+
+    // Note that we clear the following containers and we release their allocated memory. Therefore,
+    // if the memory allocator is a single frame allocator, the memory is deallocated and will be
+    // allocated in the next frame at a possibly different location in memory (remember that the
+    // location of the allocated memory of a single frame allocator might change between two frames)
+
+    NarrowPhaseInfoBatch::clear();
+
+    box1HalfExtents.clear(true);
+    box2HalfExtents.clear(true);
+}
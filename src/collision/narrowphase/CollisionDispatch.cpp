@@ -38,6 +38,7 @@ CollisionDispatch::CollisionDispatch(MemoryAllocator& allocator) : mAllocator(al
     mSphereVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(SphereVsConvexPolyhedronAlgorithm))) SphereVsConvexPolyhedronAlgorithm();
     mCapsuleVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(CapsuleVsConvexPolyhedronAlgorithm))) CapsuleVsConvexPolyhedronAlgorithm();
     mConvexPolyhedronVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(ConvexPolyhedronVsConvexPolyhedronAlgorithm))) ConvexPolyhedronVsConvexPolyhedronAlgorithm();
+    mBoxVsBoxAlgorithm = new (allocator.allocate(sizeof(BoxVsBoxAlgorithm))) BoxVsBoxAlgorithm();
 
     // Fill in the collision matrix
     fillInCollisionMatrix();
@@ -65,6 +66,9 @@ CollisionDispatch::~CollisionDispatch() {
     if (mIsConvexPolyhedronVsConvexPolyhedronDefault) {
         mAllocator.release(mConvexPolyhedronVsConvexPolyhedronAlgorithm, sizeof(ConvexPolyhedronVsConvexPolyhedronAlgorithm));
     }
+    if (mIsBoxVsBoxDefault) {
+        mAllocator.release(mBoxVsBoxAlgorithm, sizeof(BoxVsBoxAlgorithm));
+    }
 }
 
 // Select and return the narrow-phase collision detection algorithm to
@@ -184,6 +188,17 @@ void CollisionDispatch::setConvexPolyhedronVsConvexPolyhedronAlgorithm(ConvexPol
     fillInCollisionMatrix();
 }
 
+// Set the Box vs Box narrow-phase collision detection algorithm
+void CollisionDispatch::setBoxVsBoxAlgorithm(BoxVsBoxAlgorithm* algorithm) {
+
+    if (mIsBoxVsBoxDefault) {
+        mAllocator.release(mBoxVsBoxAlgorithm, sizeof(BoxVsBoxAlgorithm));
+        mIsBoxVsBoxDefault = false;
+    }
+
+    mBoxVsBoxAlgorithm = algorithm;
+}
+
 
 // Fill-in the collision detection matrix
 void CollisionDispatch::fillInCollisionMatrix() {
@@ -213,5 +228,18 @@ NarrowPhaseAlgorithmType CollisionDispatch::selectNarrowPhaseAlgorithm(const Col
     return mCollisionMatrix[shape1Index][shape2Index];
 }
 
+// Return the corresponding narrow-phase algorithm type to use for two convex collision shapes
+/// Two boxes are tested with the dedicated box vs box algorithm instead of the
+/// general convex polyhedron vs convex polyhedron algorithm
+NarrowPhaseAlgorithmType CollisionDispatch::selectNarrowPhaseAlgorithm(const CollisionShape* shape1,
+                                                                       const CollisionShape* shape2) const {
+
+    if (shape1->getName() == CollisionShapeName::BOX && shape2->getName() == CollisionShapeName::BOX) {
+        return NarrowPhaseAlgorithmType::BoxVsBox;
+    }
+
+    return selectNarrowPhaseAlgorithm(shape1->getType(), shape2->getType());
+}
+
 
 
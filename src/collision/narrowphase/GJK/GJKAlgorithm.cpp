@@ -111,9 +111,11 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
 
         do {
 
-            // Compute the support points for original objects (without margins) A and B
-            suppA = shape1->getLocalSupportPointWithoutMargin(-v);
-            suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMargin(rotateToBody2 * v);
+            // Compute the support points for original objects (without margins) A and B (the search
+            // starts from the support vertices of the previous iteration or of the previous frame)
+            suppA = shape1->getLocalSupportPointWithoutMarginFromVertex(-v, lastFrameCollisionInfo->supportVertexIndex1);
+            suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * v,
+                                                                                       lastFrameCollisionInfo->supportVertexIndex2);
 
             // Compute the support point for the Minkowski difference A-B
             w = suppA - suppB;
@@ -127,7 +129,7 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
                 lastFrameCollisionInfo->gjkSeparatingAxis = v;
 
                 // No intersection, we return
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 noIntersection = true;
                 break;
@@ -202,14 +204,14 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
 
             // If the penetration depth is negative (due too numerical errors), there is no contact
             if (penetrationDepth <= decimal(0.0)) {
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 continue;
             }
 
             // Do not generate a contact point with zero normal length
             if (normal.lengthSquare() < MACHINE_EPSILON) {
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 continue;
             }
@@ -225,13 +227,276 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
                 narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, pA, pB);
             }
 
-            assert(gjkResults.size() == batchIndex);
+            assert(gjkResults.size() == batchIndex - batchStartIndex);
             gjkResults.add(GJKResult::COLLIDE_IN_MARGIN);
 
             continue;
         }
 
-        assert(gjkResults.size() == batchIndex);
+        assert(gjkResults.size() == batchIndex - batchStartIndex);
         gjkResults.add(GJKResult::INTERPENETRATE);
     }
 }
+
+// Compute the first contact between a translating convex shape and a fixed convex shape
+/// This method implements the GJK ray cast algorithm described in the paper "Ray Casting
+/// against General Convex Objects with Application to Continuous Collision Detection" by
+/// Gino van den Bergen. A ray starting at the origin with the direction of the translation is
+/// cast against the Minkowski difference A-B of the two shapes. The GJK algorithm runs on
+/// the original objects (without margins) and the contact is found when the distance between
+/// them is equal to the sum of the margins. Therefore, the spheres and capsules are swept
+/// exactly. If the shapes already overlap at the start of the translation, a hit with a
+/// zero hit fraction is returned.
+/**
+ * @param shape1 Shape that translates
+ * @param transform1 Local-to-world transform of the first shape at the start of the translation
+ * @param translation1 Translation of the first shape (in world-space)
+ * @param shape2 Fixed shape
+ * @param transform2 Local-to-world transform of the second shape
+ * @param maxFraction Maximum fraction of the translation to test
+ * @param outHitFraction Fraction of the translation where the shapes start to touch
+ * @param outWorldPoint Contact point on the second shape (in world-space)
+ * @param outWorldNormal Contact normal on the second shape toward the first shape (in world-space)
+ * @return True if the shapes touch before the maximum fraction of the translation
+ */
+bool GJKAlgorithm::sweep(const ConvexShape* shape1, const Transform& transform1, const Vector3& translation1,
+                         const ConvexShape* shape2, const Transform& transform2, decimal maxFraction,
+                         decimal& outHitFraction, Vector3& outWorldPoint, Vector3& outWorldNormal) const {
+
+    RP3D_PROFILE("GJKAlgorithm::sweep()", mProfiler);
+
+    // The GJK algorithm is done in local space of body 1
+    const Transform body2Tobody1 = transform1.getInverse() * transform2;
+    const Quaternion rotateToBody2 = transform2.getOrientation().getInverse() * transform1.getOrientation();
+    const Vector3 r = transform1.getOrientation().getInverse() * translation1;
+
+    // Sum of margins of both objects
+    const decimal margin = shape1->getMargin() + shape2->getMargin();
+
+    VoronoiSimplex simplex;
+
+    decimal lambda = decimal(0.0);  // Current lower bound of the hit fraction
+    Vector3 offset(0, 0, 0);        // Translation of the object A at the current hit fraction
+    Vector3 n(0, 0, 0);             // Last separating axis
+
+    // Indices of the last support vertices of the shapes (where the next support point search starts)
+    uint supportVertex1 = 0;
+    uint supportVertex2 = 0;
+
+    // Initial point of the Minkowski difference A-B
+    Vector3 v = shape1->getLocalSupportPointWithoutMarginFromVertex(r, supportVertex1) -
+                body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * -r, supportVertex2);
+    decimal distSquare = v.lengthSquare();
+
+    int nbIterations = 0;
+    while (nbIterations < MAX_ITERATIONS_GJK_RAYCAST) {
+
+        nbIterations++;
+
+        // If the distance between the objects is the sum of the margins, the contact is found
+        const decimal dist = std::sqrt(distSquare);
+        if (dist <= margin + GJK_SWEEP_TOLERANCE) break;
+
+        // Compute the support points for original objects (without margins) A and B
+        const Vector3 suppA = shape1->getLocalSupportPointWithoutMarginFromVertex(-v, supportVertex1);
+        const Vector3 suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * v, supportVertex2);
+
+        // Support point of the Minkowski difference A-B at the current hit fraction
+        Vector3 w = suppA + offset - suppB;
+
+        const decimal vDotW = v.dot(w);
+
+        // If the enlarged objects are separated along the axis v
+        if (vDotW > margin * dist) {
+
+            // If the object A does not move toward the object B, there is no hit
+            const decimal vDotR = v.dot(r);
+            if (vDotR >= -MACHINE_EPSILON * MACHINE_EPSILON) return false;
+
+            // Move the object A until the enlarged objects touch along the axis v
+            lambda = lambda - (vDotW - margin * dist) / vDotR;
+            if (lambda > maxFraction) return false;
+
+            offset = lambda * r;
+            w = suppA + offset - suppB;
+            n = v;
+
+            // Update the points of the simplex with the new translation of the object A
+            Vector3 suppPointsA[4];
+            Vector3 suppPointsB[4];
+            Vector3 points[4];
+            const int nbPoints = simplex.getSimplex(suppPointsA, suppPointsB, points);
+            for (int i = nbPoints - 1; i >= 0; i--) {
+                simplex.removePoint(i);
+            }
+            for (int i=0; i < nbPoints; i++) {
+                simplex.addPoint(suppPointsA[i] + offset - suppPointsB[i], suppPointsA[i], suppPointsB[i]);
+            }
+        }
+        else if (distSquare - vDotW <= distSquare * REL_ERROR_SQUARE) {
+
+            // The point v is the closest point of A-B and the objects touch in the margins
+            break;
+        }
+
+        // If the simplex cannot get closer to the origin
+        if (simplex.isPointInSimplex(w)) break;
+
+        // Add the new support point to the simplex
+        simplex.addPoint(w, suppA, suppB);
+
+        // Compute the point of the simplex closest to the origin
+        if (!simplex.computeClosestPoint(v)) {
+            v.setAllValues(0, 0, 0);
+        }
+        distSquare = v.lengthSquare();
+    }
+
+    // Compute the contact normal (from object B toward object A)
+    Vector3 normal;
+    if (distSquare > MACHINE_EPSILON) {
+        normal = v / std::sqrt(distSquare);
+    }
+    else if (n.lengthSquare() > MACHINE_EPSILON) {
+        normal = n.getUnit();
+    }
+    else if (r.lengthSquare() > MACHINE_EPSILON) {
+        normal = -r.getUnit();
+    }
+    else {
+        normal.setAllValues(0, 0, 0);
+    }
+
+    // Compute the contact point on the object B
+    Vector3 pointB;
+    if (simplex.isEmpty()) {
+        pointB = body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * normal, supportVertex2);
+    }
+    else {
+        Vector3 closestPoint;
+        Vector3 pointA;
+        simplex.computeClosestPoint(closestPoint);
+        simplex.computeClosestPointsOfAandB(pointA, pointB);
+    }
+    pointB += shape2->getMargin() * normal;
+
+    outHitFraction = lambda;
+    outWorldPoint = transform1 * pointB;
+    outWorldNormal = transform1.getOrientation() * normal;
+
+    return true;
+}
+
+
+// Return true if two convex shapes overlap
+/// This is a sweep of the first shape with a zero translation. The margins of the shapes
+/// are taken into account.
+bool GJKAlgorithm::testOverlap(const ConvexShape* shape1, const Transform& transform1,
+                               const ConvexShape* shape2, const Transform& transform2) const {
+
+    decimal hitFraction;
+    Vector3 worldPoint;
+    Vector3 worldNormal;
+    return sweep(shape1, transform1, Vector3::zero(), shape2, transform2, decimal(1.0), hitFraction, worldPoint, worldNormal);
+}
+
+// Compute the distance and the closest points between two convex shapes
+/// The GJK algorithm runs on the original objects (without margins) until the closest
+/// points converge and the closest points are then projected on the margins. The search
+/// starts from the separating axis in parameter if it is not zero (the axis found by a
+/// previous query on the same pair of shapes for instance) and the new separating axis
+/// is written back into it. If the shapes overlap, the distance is zero, false is
+/// returned and the closest points are not computed.
+/**
+ * @param shape1 First shape
+ * @param transform1 Local-to-world transform of the first shape
+ * @param shape2 Second shape
+ * @param transform2 Local-to-world transform of the second shape
+ * @param inOutSeparatingAxis Separating axis from the second shape toward the first shape (in world-space)
+ * @param outDistance Distance between the two shapes
+ * @param outWorldPoint1 Closest point on the first shape (in world-space)
+ * @param outWorldPoint2 Closest point on the second shape (in world-space)
+ * @return True if the shapes are separated
+ */
+bool GJKAlgorithm::computeDistance(const ConvexShape* shape1, const Transform& transform1,
+                                   const ConvexShape* shape2, const Transform& transform2,
+                                   Vector3& inOutSeparatingAxis, decimal& outDistance,
+                                   Vector3& outWorldPoint1, Vector3& outWorldPoint2) const {
+
+    RP3D_PROFILE("GJKAlgorithm::computeDistance()", mProfiler);
+
+    outDistance = decimal(0.0);
+
+    // The GJK algorithm is done in local space of body 1
+    const Transform body2Tobody1 = transform1.getInverse() * transform2;
+    const Quaternion rotateToBody2 = transform2.getOrientation().getInverse() * transform1.getOrientation();
+
+    // Start from the cached separating axis if there is one
+    Vector3 v = transform1.getOrientation().getInverse() * inOutSeparatingAxis;
+    if (v.lengthSquare() < MACHINE_EPSILON) {
+        v.setAllValues(0, 1, 0);
+    }
+
+    VoronoiSimplex simplex;
+    decimal distSquare = DECIMAL_LARGEST;
+    decimal prevDistSquare;
+
+    // Indices of the last support vertices of the shapes (where the next support point search starts)
+    uint supportVertex1 = 0;
+    uint supportVertex2 = 0;
+
+    do {
+
+        // Compute the support point of the Minkowski difference A-B (without margins)
+        const Vector3 suppA = shape1->getLocalSupportPointWithoutMarginFromVertex(-v, supportVertex1);
+        const Vector3 suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMarginFromVertex(rotateToBody2 * v, supportVertex2);
+        const Vector3 w = suppA - suppB;
+
+        // If the closest point cannot be improved anymore
+        if (simplex.isPointInSimplex(w) || distSquare - v.dot(w) <= distSquare * REL_ERROR_SQUARE) {
+            break;
+        }
+
+        simplex.addPoint(w, suppA, suppB);
+
+        if (simplex.isAffinelyDependent()) break;
+
+        // Compute the point of the simplex closest to the origin
+        if (!simplex.computeClosestPoint(v)) break;
+
+        prevDistSquare = distSquare;
+        distSquare = v.lengthSquare();
+
+        // If the distance to the closest point doesn't improve a lot
+        if (prevDistSquare - distSquare <= MACHINE_EPSILON * prevDistSquare) {
+            simplex.backupClosestPointInSimplex(v);
+            distSquare = v.lengthSquare();
+            break;
+        }
+
+    } while(!simplex.isFull() && distSquare > MACHINE_EPSILON * simplex.getMaxLengthSquareOfAPoint());
+
+    // If the original objects (without margins) overlap
+    if (distSquare <= MACHINE_EPSILON || simplex.isEmpty()) return false;
+
+    inOutSeparatingAxis = transform1.getOrientation() * v;
+
+    // If the objects overlap in their margins
+    const decimal dist = std::sqrt(distSquare);
+    const decimal margin1 = shape1->getMargin();
+    const decimal margin2 = shape2->getMargin();
+    if (dist <= margin1 + margin2) return false;
+
+    // Compute the closest points of both objects and project them on the margins
+    Vector3 pA;
+    Vector3 pB;
+    simplex.computeClosestPointsOfAandB(pA, pB);
+    pA -= (margin1 / dist) * v;
+    pB += (margin2 / dist) * v;
+
+    outDistance = dist - margin1 - margin2;
+    outWorldPoint1 = transform1 * pA;
+    outWorldPoint2 = transform1 * pB;
+
+    return true;
+}
@@ -37,8 +37,8 @@ NarrowPhaseInfoBatch::NarrowPhaseInfoBatch(MemoryAllocator& allocator, Overlappi
       : mMemoryAllocator(allocator), mOverlappingPairs(overlappingPairs), overlappingPairIds(allocator),
         colliderEntities1(allocator), colliderEntities2(allocator), collisionShapes1(allocator), collisionShapes2(allocator),
         shape1ToWorldTransforms(allocator), shape2ToWorldTransforms(allocator), reportContacts(allocator),
-        isColliding(allocator), contactPoints(allocator), collisionShapeAllocators(allocator),
-        lastFrameCollisionInfos(allocator) {
+        isColliding(allocator), contactPoints(allocator), contactPointsAllocators(allocator),
+        collisionShapeAllocators(allocator), lastFrameCollisionInfos(allocator) {
 
 }
 
@@ -48,7 +48,7 @@ NarrowPhaseInfoBatch::~NarrowPhaseInfoBatch() {
 }
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
-void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
+void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, const Entity& collider1, const Entity& collider2, CollisionShape* shape1, CollisionShape* shape2,
                                               const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts,
                                               MemoryAllocator& shapeAllocator) {
 
@@ -62,6 +62,7 @@ void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, E
     reportContacts.add(needToReportContacts);
     collisionShapeAllocators.add(&shapeAllocator);
     contactPoints.add(List<ContactPointInfo*>(mMemoryAllocator));
+    contactPointsAllocators.add(&mOverlappingPairs.getTemporaryAllocator());
     isColliding.add(false);
 
     // Add a collision info for the two collision shapes into the overlapping pair (if not present yet)
@@ -77,7 +78,7 @@ void NarrowPhaseInfoBatch::addContactPoint(uint index, const Vector3& contactNor
     assert(penDepth > decimal(0.0));
 
     // Get the memory allocator
-    MemoryAllocator& allocator = mOverlappingPairs.getTemporaryAllocator();
+    MemoryAllocator& allocator = *(contactPointsAllocators[index]);
 
     // Create the contact point info
     ContactPointInfo* contactPointInfo = new (allocator.allocate(sizeof(ContactPointInfo)))
@@ -91,7 +92,7 @@ void NarrowPhaseInfoBatch::addContactPoint(uint index, const Vector3& contactNor
 void NarrowPhaseInfoBatch::resetContactPoints(uint index) {
 
     // Get the memory allocator
-    MemoryAllocator& allocator = mOverlappingPairs.getTemporaryAllocator();
+    MemoryAllocator& allocator = *(contactPointsAllocators[index]);
 
     // For each remaining contact point info
     for (uint i=0; i < contactPoints[index].size(); i++) {
@@ -108,6 +109,21 @@ void NarrowPhaseInfoBatch::resetContactPoints(uint index) {
     contactPoints[index].clear();
 }
 
+// Set the memory allocator of the contact points of an item
+/// This is used when the narrow-phase runs on several threads so that the contact points
+/// of each item are allocated with the memory allocator of the thread testing the item.
+/// The item must not have any contact point yet.
+void NarrowPhaseInfoBatch::setContactPointsAllocator(uint index, MemoryAllocator& allocator) {
+
+    assert(contactPoints[index].size() == 0);
+
+    contactPointsAllocators[index] = &allocator;
+
+    // Recreate the list of contact points with the new allocator
+    contactPoints[index].~List<ContactPointInfo*>();
+    new (&(contactPoints[index])) List<ContactPointInfo*>(allocator);
+}
+
 // Initialize the containers using cached capacity
 void NarrowPhaseInfoBatch::reserveMemory() {
 
@@ -123,6 +139,7 @@ void NarrowPhaseInfoBatch::reserveMemory() {
     lastFrameCollisionInfos.reserve(mCachedCapacity);
     isColliding.reserve(mCachedCapacity);
     contactPoints.reserve(mCachedCapacity);
+    contactPointsAllocators.reserve(mCachedCapacity);
 }
 
 // Clear all the objects in the batch
@@ -163,4 +180,5 @@ void NarrowPhaseInfoBatch::clear() {
     lastFrameCollisionInfos.clear(true);
     isColliding.clear(true);
     contactPoints.clear(true);
+    contactPointsAllocators.clear(true);
 }
@@ -34,7 +34,7 @@ NarrowPhaseInput::NarrowPhaseInput(MemoryAllocator& allocator, OverlappingPairs&
     :mSphereVsSphereBatch(allocator, overlappingPairs), mSphereVsCapsuleBatch(allocator, overlappingPairs),
      mCapsuleVsCapsuleBatch(allocator, overlappingPairs), mSphereVsConvexPolyhedronBatch(allocator, overlappingPairs),
      mCapsuleVsConvexPolyhedronBatch(allocator, overlappingPairs),
-     mConvexPolyhedronVsConvexPolyhedronBatch(allocator, overlappingPairs) {
+     mConvexPolyhedronVsConvexPolyhedronBatch(allocator, overlappingPairs), mBoxVsBoxBatch(allocator, overlappingPairs) {
 
 }
 
@@ -62,6 +62,9 @@ void NarrowPhaseInput::addNarrowPhaseTest(uint64 pairId, uint64 pairIndex, Entit
         case NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron:
             mConvexPolyhedronVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
             break;
+        case NarrowPhaseAlgorithmType::BoxVsBox:
+            mBoxVsBoxBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            break;
         case NarrowPhaseAlgorithmType::None:
             // Must never happen
             assert(false);
@@ -69,6 +72,25 @@ void NarrowPhaseInput::addNarrowPhaseTest(uint64 pairId, uint64 pairIndex, Entit
     }
 }
 
+// Get a reference to the batch of a given narrow-phase algorithm
+NarrowPhaseInfoBatch& NarrowPhaseInput::getBatch(NarrowPhaseAlgorithmType narrowPhaseAlgorithmType) {
+
+    switch (narrowPhaseAlgorithmType) {
+        case NarrowPhaseAlgorithmType::SphereVsSphere: return mSphereVsSphereBatch;
+        case NarrowPhaseAlgorithmType::SphereVsCapsule: return mSphereVsCapsuleBatch;
+        case NarrowPhaseAlgorithmType::CapsuleVsCapsule: return mCapsuleVsCapsuleBatch;
+        case NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron: return mSphereVsConvexPolyhedronBatch;
+        case NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron: return mCapsuleVsConvexPolyhedronBatch;
+        case NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron: return mConvexPolyhedronVsConvexPolyhedronBatch;
+        case NarrowPhaseAlgorithmType::BoxVsBox: return mBoxVsBoxBatch;
+        case NarrowPhaseAlgorithmType::None: break;
+    }
+
+    // Must never happen
+    assert(false);
+    return mConvexPolyhedronVsConvexPolyhedronBatch;
+}
+
 /// Reserve memory for the containers with cached capacity
 void NarrowPhaseInput::reserveMemory() {
 
@@ -78,6 +100,7 @@ void NarrowPhaseInput::reserveMemory() {
     mSphereVsConvexPolyhedronBatch.reserveMemory();
     mCapsuleVsConvexPolyhedronBatch.reserveMemory();
     mConvexPolyhedronVsConvexPolyhedronBatch.reserveMemory();
+    mBoxVsBoxBatch.reserveMemory();
 }
 
 // Clear
@@ -89,4 +112,5 @@ void NarrowPhaseInput::clear() {
     mSphereVsConvexPolyhedronBatch.clear();
     mCapsuleVsConvexPolyhedronBatch.clear();
     mConvexPolyhedronVsConvexPolyhedronBatch.clear();
+    mBoxVsBoxBatch.clear();
 }
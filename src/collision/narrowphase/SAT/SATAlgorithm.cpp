@@ -32,13 +32,131 @@
 #include <reactphysics3d/engine/OverlappingPairs.h>
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
 #include <reactphysics3d/collision/shapes/TriangleShape.h>
+#include <reactphysics3d/collision/shapes/ConvexMeshShape.h>
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <cassert>
 
+#if !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED) && defined(__AVX__)
+    #include <immintrin.h>
+    #define RP3D_SAT_SIMD
+#elif !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+    #include <xmmintrin.h>
+    #define RP3D_SAT_SIMD
+#endif
+
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
 
+// Number of faces or edges of a convex mesh that are tested together
+#if defined(__AVX__)
+static const uint NB_SIMD_LANES = 8;
+#else
+static const uint NB_SIMD_LANES = 4;
+#endif
+
+#ifdef RP3D_SAT_SIMD
+
+// Operations on the SIMD registers that contain one value for each face or edge
+#if defined(__AVX__)
+
+typedef __m256 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm256_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm256_set1_ps(value); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm256_add_ps(a, b); }
+static inline WideFloat wideSub(WideFloat a, WideFloat b) { return _mm256_sub_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm256_mul_ps(a, b); }
+static inline WideFloat wideMin(WideFloat a, WideFloat b) { return _mm256_min_ps(a, b); }
+static inline WideFloat wideAnd(WideFloat a, WideFloat b) { return _mm256_and_ps(a, b); }
+static inline WideFloat wideLess(WideFloat a, WideFloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline uint32 wideMoveMask(WideFloat a) { return static_cast<uint32>(_mm256_movemask_ps(a)); }
+static inline void wideStore(float* values, WideFloat a) { _mm256_storeu_ps(values, a); }
+
+#else
+
+typedef __m128 WideFloat;
+
+static inline WideFloat wideLoad(const float* values) { return _mm_loadu_ps(values); }
+static inline WideFloat wideSet(float value) { return _mm_set1_ps(value); }
+static inline WideFloat wideAdd(WideFloat a, WideFloat b) { return _mm_add_ps(a, b); }
+static inline WideFloat wideSub(WideFloat a, WideFloat b) { return _mm_sub_ps(a, b); }
+static inline WideFloat wideMul(WideFloat a, WideFloat b) { return _mm_mul_ps(a, b); }
+static inline WideFloat wideMin(WideFloat a, WideFloat b) { return _mm_min_ps(a, b); }
+static inline WideFloat wideAnd(WideFloat a, WideFloat b) { return _mm_and_ps(a, b); }
+static inline WideFloat wideLess(WideFloat a, WideFloat b) { return _mm_cmplt_ps(a, b); }
+static inline uint32 wideMoveMask(WideFloat a) { return static_cast<uint32>(_mm_movemask_ps(a)); }
+static inline void wideStore(float* values, WideFloat a) { _mm_storeu_ps(values, a); }
+
+#endif
+
+// Return the dot products between a vector (one value for all the lanes) and the vectors of the lanes
+static inline WideFloat wideDot(const Vector3& a, WideFloat bX, WideFloat bY, WideFloat bZ) {
+    return wideAdd(wideAdd(wideMul(wideSet(a.x), bX), wideMul(wideSet(a.y), bY)), wideMul(wideSet(a.z), bZ));
+}
+
+#endif
+
+// Return a bit mask with the edges of the second convex mesh (starting at "firstEdgeIndex") that build
+// a minkowski face with an edge of the first convex mesh
+/// This is the test of the testGaussMapArcsIntersect() method for NB_SIMD_LANES edges of the second mesh
+/// at a time. The normals "a" and "b" of the adjacent faces and the direction of the edge of the first mesh
+/// are given in the local-space of the second mesh. Because the arc BxA of the first edge is the opposite
+/// of its direction (and the same for the second edge), the signs of the products of the test are computed
+/// with the edges directions.
+static uint32 computeMinkowskiFacesMask(const PolyhedronMesh::FeaturesArrays& edges2, const Vector3& scale2,
+                                        uint firstEdgeIndex, uint nbEdges2, const Vector3& a, const Vector3& b,
+                                        const Vector3& edge1Direction) {
+
+    const uint nbEdges = std::min(NB_SIMD_LANES, nbEdges2 - firstEdgeIndex);
+
+#ifdef RP3D_SAT_SIMD
+
+    if (nbEdges == NB_SIMD_LANES) {
+
+        const uint e = firstEdgeIndex;
+
+        // Directions of the edges of the second mesh (with the scale of the mesh)
+        const WideFloat directionX = wideMul(wideSet(scale2.x), wideLoad(&edges2.edgesDirectionsX[e]));
+        const WideFloat directionY = wideMul(wideSet(scale2.y), wideLoad(&edges2.edgesDirectionsY[e]));
+        const WideFloat directionZ = wideMul(wideSet(scale2.z), wideLoad(&edges2.edgesDirectionsZ[e]));
+
+        const WideFloat cba = wideDot(edge1Direction, wideLoad(&edges2.edgesFaces1NormalsX[e]), wideLoad(&edges2.edgesFaces1NormalsY[e]),
+                                      wideLoad(&edges2.edgesFaces1NormalsZ[e]));
+        const WideFloat dba = wideDot(edge1Direction, wideLoad(&edges2.edgesFaces2NormalsX[e]), wideLoad(&edges2.edgesFaces2NormalsY[e]),
+                                      wideLoad(&edges2.edgesFaces2NormalsZ[e]));
+        const WideFloat adc = wideDot(a, directionX, directionY, directionZ);
+        const WideFloat bdc = wideDot(b, directionX, directionY, directionZ);
+
+        const WideFloat zero = wideSet(0.0f);
+        const WideFloat isMinkowskiFace = wideAnd(wideAnd(wideLess(wideMul(cba, dba), zero), wideLess(wideMul(adc, bdc), zero)),
+                                                  wideLess(wideMul(cba, bdc), zero));
+        return wideMoveMask(isMinkowskiFace);
+    }
+
+#endif
+
+    uint32 mask = 0;
+    for (uint lane=0; lane < nbEdges; lane++) {
+
+        const uint e = firstEdgeIndex + lane;
+        const Vector3 direction(scale2.x * edges2.edgesDirectionsX[e], scale2.y * edges2.edgesDirectionsY[e],
+                                scale2.z * edges2.edgesDirectionsZ[e]);
+        const decimal cba = edge1Direction.x * edges2.edgesFaces1NormalsX[e] + edge1Direction.y * edges2.edgesFaces1NormalsY[e] +
+                            edge1Direction.z * edges2.edgesFaces1NormalsZ[e];
+        const decimal dba = edge1Direction.x * edges2.edgesFaces2NormalsX[e] + edge1Direction.y * edges2.edgesFaces2NormalsY[e] +
+                            edge1Direction.z * edges2.edgesFaces2NormalsZ[e];
+        const decimal adc = a.dot(direction);
+        const decimal bdc = b.dot(direction);
+
+        if (cba * dba < decimal(0.0) && adc * bdc < decimal(0.0) && cba * bdc < decimal(0.0)) {
+            mask |= (1u << lane);
+        }
+    }
+
+    return mask;
+}
+
 // Static variables initialization
 const decimal SATAlgorithm::SEPARATING_AXIS_RELATIVE_TOLERANCE = decimal(1.002);
 const decimal SATAlgorithm::SEPARATING_AXIS_ABSOLUTE_TOLERANCE = decimal(0.0005);
@@ -521,7 +639,8 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
             if (lastFrameCollisionInfo->satIsAxisFacePolyhedron1) {
 
                 decimal penetrationDepth = testSingleFaceDirectionPolyhedronVsPolyhedron(polyhedron1, polyhedron2, polyhedron1ToPolyhedron2,
-                                                     lastFrameCollisionInfo->satMinAxisFaceIndex);
+                                                     lastFrameCollisionInfo->satMinAxisFaceIndex,
+                                                     lastFrameCollisionInfo->supportVertexIndex2);
 
                 // If the previous axis was a separating axis and is still a separating axis in this frame
                 if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
@@ -561,7 +680,8 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
                                        // was a face normal of polyhedron 2
 
                 decimal penetrationDepth = testSingleFaceDirectionPolyhedronVsPolyhedron(polyhedron2, polyhedron1, polyhedron2ToPolyhedron1,
-                                                     lastFrameCollisionInfo->satMinAxisFaceIndex);
+                                                     lastFrameCollisionInfo->satMinAxisFaceIndex,
+                                                     lastFrameCollisionInfo->supportVertexIndex1);
 
                 // If the previous axis was a separating axis and is still a separating axis in this frame
                 if (!lastFrameCollisionInfo->wasColliding && penetrationDepth <= decimal(0.0)) {
@@ -689,7 +809,8 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
 
         // Test all the face normals of the polyhedron 1 for separating axis
         uint faceIndex1;
-        decimal penetrationDepth1 = testFacesDirectionPolyhedronVsPolyhedron(polyhedron1, polyhedron2, polyhedron1ToPolyhedron2, faceIndex1);
+        decimal penetrationDepth1 = testFacesDirectionPolyhedronVsPolyhedron(polyhedron1, polyhedron2, polyhedron1ToPolyhedron2, faceIndex1,
+                                                                             lastFrameCollisionInfo->supportVertexIndex2);
         if (penetrationDepth1 <= decimal(0.0)) {
 
             lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = true;
@@ -702,7 +823,8 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
 
         // Test all the face normals of the polyhedron 2 for separating axis
         uint faceIndex2;
-        decimal penetrationDepth2 = testFacesDirectionPolyhedronVsPolyhedron(polyhedron2, polyhedron1, polyhedron2ToPolyhedron1, faceIndex2);
+        decimal penetrationDepth2 = testFacesDirectionPolyhedronVsPolyhedron(polyhedron2, polyhedron1, polyhedron2ToPolyhedron1, faceIndex2,
+                                                                             lastFrameCollisionInfo->supportVertexIndex1);
         if (penetrationDepth2 <= decimal(0.0)) {
 
             lastFrameCollisionInfo->satIsAxisFacePolyhedron1 = false;
@@ -741,6 +863,16 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
 
         bool separatingAxisFound = false;
 
+        // If the two polyhedra are convex meshes, the edges of polyhedron 2 that build a minkowski face with
+        // an edge of polyhedron 1 are found by groups with the cached arrays of the meshes
+        const bool areConvexMeshes = polyhedron1->getName() == CollisionShapeName::CONVEX_MESH &&
+                                     polyhedron2->getName() == CollisionShapeName::CONVEX_MESH;
+        const PolyhedronMesh::FeaturesArrays* edges2 = areConvexMeshes ?
+            &(static_cast<const ConvexMeshShape*>(polyhedron2)->getPolyhedronMesh()->getFeaturesArrays()) : nullptr;
+        const Vector3 scale2 = areConvexMeshes ? static_cast<const ConvexMeshShape*>(polyhedron2)->getScale() : Vector3(1, 1, 1);
+        const uint nbEdges2 = polyhedron2->getNbHalfEdges() / 2;
+        uint32 minkowskiFacesMask = 0;
+
         // Test the cross products of edges of polyhedron 1 with edges of polyhedron 2 for separating axis
         for (uint i=0; i < polyhedron1->getNbHalfEdges(); i += 2) {
 
@@ -751,18 +883,39 @@ bool SATAlgorithm::testCollisionConvexPolyhedronVsConvexPolyhedron(NarrowPhaseIn
             const Vector3 edge1B = polyhedron1ToPolyhedron2 * polyhedron1->getVertexPosition(polyhedron1->getHalfEdge(edge1.nextEdgeIndex).vertexIndex);
             const Vector3 edge1Direction = edge1B - edge1A;
 
+            // Normals of the faces adjacent to the edge of polyhedron 1 (in local-space of polyhedron 2)
+            Vector3 edge1FaceNormal1;
+            Vector3 edge1FaceNormal2;
+            if (areConvexMeshes) {
+                edge1FaceNormal1 = polyhedron1ToPolyhedron2.getOrientation() * polyhedron1->getFaceNormal(edge1.faceIndex);
+                edge1FaceNormal2 = polyhedron1ToPolyhedron2.getOrientation() * polyhedron1->getFaceNormal(polyhedron1->getHalfEdge(edge1.twinEdgeIndex).faceIndex);
+            }
+
             for (uint j=0; j < polyhedron2->getNbHalfEdges(); j += 2) {
 
                 // Get an edge of polyhedron 2
                 const HalfEdgeStructure::Edge& edge2 = polyhedron2->getHalfEdge(j);
 
-                const Vector3 edge2A = polyhedron2->getVertexPosition(edge2.vertexIndex);
-                const Vector3 edge2B = polyhedron2->getVertexPosition(polyhedron2->getHalfEdge(edge2.nextEdgeIndex).vertexIndex);
-                const Vector3 edge2Direction = edge2B - edge2A;
+                // Test if the two edges build a minkowski face (and the cross product is
+                // therefore a candidate for separating axis)
+                bool isMinkowskiFace;
+                if (areConvexMeshes) {
+                    const uint lane = (j / 2) % NB_SIMD_LANES;
+                    if (lane == 0) {
+                        minkowskiFacesMask = computeMinkowskiFacesMask(*edges2, scale2, j / 2, nbEdges2, edge1FaceNormal1,
+                                                                       edge1FaceNormal2, edge1Direction);
+                    }
+                    isMinkowskiFace = (minkowskiFacesMask & (1u << lane)) != 0;
+                }
+                else {
+                    isMinkowskiFace = testEdgesBuildMinkowskiFace(polyhedron1, edge1, polyhedron2, edge2, polyhedron1ToPolyhedron2);
+                }
 
-                // If the two edges build a minkowski face (and the cross product is
-                // therefore a candidate for separating axis
-                if (testEdgesBuildMinkowskiFace(polyhedron1, edge1, polyhedron2, edge2, polyhedron1ToPolyhedron2)) {
+                if (isMinkowskiFace) {
+
+                    const Vector3 edge2A = polyhedron2->getVertexPosition(edge2.vertexIndex);
+                    const Vector3 edge2B = polyhedron2->getVertexPosition(polyhedron2->getHalfEdge(edge2.nextEdgeIndex).vertexIndex);
+                    const Vector3 edge2Direction = edge2B - edge2A;
 
                     Vector3 separatingAxisPolyhedron2Space;
 
@@ -1052,10 +1205,12 @@ decimal SATAlgorithm::computeDistanceBetweenEdges(const Vector3& edge1A, const V
 
 
 // Return the penetration depth between two polyhedra along a face normal axis of the first polyhedron
+/// The search of the support point of the second polyhedron starts at the vertex "supportVertexIndex2"
+/// and the new support vertex is written back into it.
 decimal SATAlgorithm::testSingleFaceDirectionPolyhedronVsPolyhedron(const ConvexPolyhedronShape* polyhedron1,
                                                                     const ConvexPolyhedronShape* polyhedron2,
                                                                     const Transform& polyhedron1ToPolyhedron2,
-                                                                    uint faceIndex) const {
+                                                                    uint faceIndex, uint& supportVertexIndex2) const {
 
     RP3D_PROFILE("SATAlgorithm::testSingleFaceDirectionPolyhedronVsPolyhedron", mProfiler);
 
@@ -1068,7 +1223,7 @@ decimal SATAlgorithm::testSingleFaceDirectionPolyhedronVsPolyhedron(const Convex
     const Vector3 faceNormalPolyhedron2Space = polyhedron1ToPolyhedron2.getOrientation() * faceNormal;
 
     // Get the support point of polyhedron 2 in the inverse direction of face normal
-    const Vector3 supportPoint = polyhedron2->getLocalSupportPointWithoutMargin(-faceNormalPolyhedron2Space);
+    const Vector3 supportPoint = polyhedron2->getLocalSupportPointWithoutMarginFromVertex(-faceNormalPolyhedron2Space, supportVertexIndex2);
 
     // Compute the penetration depth
     const Vector3 faceVertex = polyhedron1ToPolyhedron2 * polyhedron1->getVertexPosition(face.faceVertices[0]);
@@ -1081,17 +1236,28 @@ decimal SATAlgorithm::testSingleFaceDirectionPolyhedronVsPolyhedron(const Convex
 decimal SATAlgorithm::testFacesDirectionPolyhedronVsPolyhedron(const ConvexPolyhedronShape* polyhedron1,
                                                                const ConvexPolyhedronShape* polyhedron2,
                                                                const Transform& polyhedron1ToPolyhedron2,
-                                                               uint& minFaceIndex) const {
+                                                               uint& minFaceIndex, uint& supportVertexIndex2) const {
 
     RP3D_PROFILE("SATAlgorithm::testFacesDirectionPolyhedronVsPolyhedron", mProfiler);
 
+    // If the two polyhedra are convex meshes and the support points of the second one are found
+    // with a linear search, we test all the faces with the cached arrays of the meshes
+    if (polyhedron1->getName() == CollisionShapeName::CONVEX_MESH && polyhedron2->getName() == CollisionShapeName::CONVEX_MESH) {
+
+        const ConvexMeshShape* mesh1 = static_cast<const ConvexMeshShape*>(polyhedron1);
+        const ConvexMeshShape* mesh2 = static_cast<const ConvexMeshShape*>(polyhedron2);
+        if (!mesh2->getPolyhedronMesh()->isSupportVertexHillClimbing()) {
+            return testFacesDirectionConvexMeshVsConvexMesh(mesh1, mesh2, polyhedron1ToPolyhedron2, minFaceIndex);
+        }
+    }
+
     decimal minPenetrationDepth = DECIMAL_LARGEST;
 
     // For each face of the first polyhedron
     for (uint f = 0; f < polyhedron1->getNbFaces(); f++) {
 
         decimal penetrationDepth = testSingleFaceDirectionPolyhedronVsPolyhedron(polyhedron1, polyhedron2,
-                                                                                 polyhedron1ToPolyhedron2, f);
+                                                                                 polyhedron1ToPolyhedron2, f, supportVertexIndex2);
 
         // If the penetration depth is negative, we have found a separating axis
         if (penetrationDepth <= decimal(0.0)) {
@@ -1110,6 +1276,110 @@ decimal SATAlgorithm::testFacesDirectionPolyhedronVsPolyhedron(const ConvexPolyh
 }
 
 
+// Test all the normals of a convex mesh for separating axis with the cached arrays of the two meshes
+/// For each face of the first mesh, the penetration depth is the distance between the face plane and the
+/// support point of the second mesh in the inverse direction of the face normal. NB_SIMD_LANES faces are
+/// tested at a time against all the vertices of the second mesh. As with the
+/// testFacesDirectionPolyhedronVsPolyhedron() method, we return as soon as a separating face is found.
+decimal SATAlgorithm::testFacesDirectionConvexMeshVsConvexMesh(const ConvexMeshShape* mesh1, const ConvexMeshShape* mesh2,
+                                                               const Transform& mesh1ToMesh2, uint& minFaceIndex) const {
+
+    RP3D_PROFILE("SATAlgorithm::testFacesDirectionConvexMeshVsConvexMesh", mProfiler);
+
+    const PolyhedronMesh::FeaturesArrays& faces1 = mesh1->getPolyhedronMesh()->getFeaturesArrays();
+    const PolyhedronMesh::FeaturesArrays& vertices2 = mesh2->getPolyhedronMesh()->getFeaturesArrays();
+    const uint nbFaces1 = mesh1->getNbFaces();
+    const uint nbVertices2 = mesh2->getNbVertices();
+    const Vector3& scale1 = mesh1->getScale();
+    const Vector3& scale2 = mesh2->getScale();
+    const Matrix3x3 rotation = mesh1ToMesh2.getOrientation().getMatrix();
+    const Vector3& translation = mesh1ToMesh2.getPosition();
+
+    decimal minPenetrationDepth = DECIMAL_LARGEST;
+    uint f = 0;
+
+#ifdef RP3D_SAT_SIMD
+
+    for (; f + NB_SIMD_LANES <= nbFaces1; f += NB_SIMD_LANES) {
+
+        // Face normals in the local-space of the second mesh
+        const WideFloat normalX = wideLoad(&faces1.facesNormalsX[f]);
+        const WideFloat normalY = wideLoad(&faces1.facesNormalsY[f]);
+        const WideFloat normalZ = wideLoad(&faces1.facesNormalsZ[f]);
+        const WideFloat normal2X = wideDot(rotation[0], normalX, normalY, normalZ);
+        const WideFloat normal2Y = wideDot(rotation[1], normalX, normalY, normalZ);
+        const WideFloat normal2Z = wideDot(rotation[2], normalX, normalY, normalZ);
+
+        // Distances of the face planes to the origin of the second mesh
+        const WideFloat planeDistances = wideAdd(wideDot(scale1, wideMul(normalX, wideLoad(&faces1.facesPointsX[f])),
+                                                                 wideMul(normalY, wideLoad(&faces1.facesPointsY[f])),
+                                                                 wideMul(normalZ, wideLoad(&faces1.facesPointsZ[f]))),
+                                                 wideDot(translation, normal2X, normal2Y, normal2Z));
+
+        // Compute the smallest projection of the vertices of the second mesh on the face normals
+        const WideFloat scaledNormal2X = wideMul(wideSet(scale2.x), normal2X);
+        const WideFloat scaledNormal2Y = wideMul(wideSet(scale2.y), normal2Y);
+        const WideFloat scaledNormal2Z = wideMul(wideSet(scale2.z), normal2Z);
+        WideFloat minProjections = wideSet(DECIMAL_LARGEST);
+        for (uint v=0; v < nbVertices2; v++) {
+            const Vector3 vertex(vertices2.verticesX[v], vertices2.verticesY[v], vertices2.verticesZ[v]);
+            minProjections = wideMin(minProjections, wideDot(vertex, scaledNormal2X, scaledNormal2Y, scaledNormal2Z));
+        }
+
+        float penetrationDepths[NB_SIMD_LANES];
+        wideStore(penetrationDepths, wideSub(planeDistances, minProjections));
+
+        for (uint lane=0; lane < NB_SIMD_LANES; lane++) {
+
+            // If the penetration depth is negative, we have found a separating axis
+            if (penetrationDepths[lane] <= decimal(0.0)) {
+                minFaceIndex = f + lane;
+                return penetrationDepths[lane];
+            }
+
+            // Check if we have found a new minimum penetration axis
+            if (penetrationDepths[lane] < minPenetrationDepth) {
+                minPenetrationDepth = penetrationDepths[lane];
+                minFaceIndex = f + lane;
+            }
+        }
+    }
+
+#endif
+
+    // For each remaining face of the first mesh
+    for (; f < nbFaces1; f++) {
+
+        const Vector3 normal(faces1.facesNormalsX[f], faces1.facesNormalsY[f], faces1.facesNormalsZ[f]);
+        const Vector3 facePoint(scale1.x * faces1.facesPointsX[f], scale1.y * faces1.facesPointsY[f], scale1.z * faces1.facesPointsZ[f]);
+        const Vector3 normal2 = rotation * normal;
+        const decimal planeDistance = normal.dot(facePoint) + normal2.dot(translation);
+
+        const Vector3 scaledNormal2(scale2.x * normal2.x, scale2.y * normal2.y, scale2.z * normal2.z);
+        decimal minProjection = DECIMAL_LARGEST;
+        for (uint v=0; v < nbVertices2; v++) {
+            minProjection = std::min(minProjection, scaledNormal2.x * vertices2.verticesX[v] + scaledNormal2.y * vertices2.verticesY[v] +
+                                                    scaledNormal2.z * vertices2.verticesZ[v]);
+        }
+
+        const decimal penetrationDepth = planeDistance - minProjection;
+
+        // If the penetration depth is negative, we have found a separating axis
+        if (penetrationDepth <= decimal(0.0)) {
+            minFaceIndex = f;
+            return penetrationDepth;
+        }
+
+        // Check if we have found a new minimum penetration axis
+        if (penetrationDepth < minPenetrationDepth) {
+            minPenetrationDepth = penetrationDepth;
+            minFaceIndex = f;
+        }
+    }
+
+    return minPenetrationDepth;
+}
+
 // Return true if two edges of two polyhedrons build a minkowski face (and can therefore be a separating axis)
 bool SATAlgorithm::testEdgesBuildMinkowskiFace(const ConvexPolyhedronShape* polyhedron1, const HalfEdgeStructure::Edge& edge1,
                                                const ConvexPolyhedronShape* polyhedron2, const HalfEdgeStructure::Edge& edge2,
@@ -70,6 +70,11 @@ void ConcaveMeshShape::initBVHTree() {
             mDynamicAABBTree.addObject(aabb, subPart, triangleIndex);
         }
     }
+
+    // The tree does not change anymore. Therefore, the queries can use its quantized version
+    // that needs less memory bandwidth.
+    mDynamicAABBTree.setIsQuantizedTreeEnabled(true);
+    mDynamicAABBTree.updateQuantizedTree();
 }
 
 // Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
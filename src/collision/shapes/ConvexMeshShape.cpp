@@ -47,38 +47,6 @@ ConvexMeshShape::ConvexMeshShape(PolyhedronMesh* polyhedronMesh, MemoryAllocator
     recalculateBounds();
 }
 
-// Return a local support point in a given direction without the object margin.
-/// If the edges information is not used for collision detection, this method will go through
-/// the whole vertices list and pick up the vertex with the largest dot product in the support
-/// direction. This is an O(n) process with "n" being the number of vertices in the mesh.
-/// However, if the edges information is used, we can cache the previous support vertex and use
-/// it as a start in a hill-climbing (local search) process to find the new support vertex which
-/// will be in most of the cases very close to the previous one. Using hill-climbing, this method
-/// runs in almost constant time.
-Vector3 ConvexMeshShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
-
-    decimal maxDotProduct = DECIMAL_SMALLEST;
-    uint indexMaxDotProduct = 0;
-
-    // For each vertex of the mesh
-    for (uint i=0; i<mPolyhedronMesh->getNbVertices(); i++) {
-
-        // Compute the dot product of the current vertex
-        decimal dotProduct = direction.dot(mPolyhedronMesh->getVertex(i));
-
-        // If the current dot product is larger than the maximum one
-        if (dotProduct > maxDotProduct) {
-            indexMaxDotProduct = i;
-            maxDotProduct = dotProduct;
-        }
-    }
-
-    assert(maxDotProduct >= decimal(0.0));
-
-    // Return the vertex with the largest dot product in the support direction
-    return mPolyhedronMesh->getVertex(indexMaxDotProduct) * mScale;
-}
-
 // Recompute the bounds of the mesh
 void ConvexMeshShape::recalculateBounds() {
 
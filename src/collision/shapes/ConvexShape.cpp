@@ -54,3 +54,18 @@ Vector3 ConvexShape::getLocalSupportPointWithMargin(const Vector3& direction) co
 
     return supportPoint;
 }
+
+// Return a local support point in a given direction without the object margin, starting
+// the search from the support vertex of a previous query
+/// The index of a vertex is only used by the shapes with many vertices (convex meshes). The
+/// other shapes compute their support point directly and do not modify the index.
+/**
+ * @param direction Direction of the support point (in local-space)
+ * @param inOutVertexIndex Index of the vertex where to start the search (the index of the
+ *                         new support vertex is written back into it)
+ * @return The support point (in local-space)
+ */
+Vector3 ConvexShape::getLocalSupportPointWithoutMarginFromVertex(const Vector3& direction, uint& inOutVertexIndex) const {
+    (void)inOutVertexIndex;
+    return getLocalSupportPointWithoutMargin(direction);
+}
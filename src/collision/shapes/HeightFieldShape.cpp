@@ -27,9 +27,31 @@
 #include <reactphysics3d/collision/shapes/HeightFieldShape.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
 
 using namespace reactphysics3d;
 
+// Read a range of consecutive height values of a floating-point type
+template<typename T>
+static void sampleFloatingPointHeights(const void* heightFieldData, uint startIndex, uint nbValues,
+                                       decimal /*integerHeightScale*/, decimal* outHeights) {
+
+    const T* heights = static_cast<const T*>(heightFieldData) + startIndex;
+    for (uint i=0; i < nbValues; i++) {
+        outHeights[i] = static_cast<decimal>(heights[i]);
+    }
+}
+
+// Read a range of consecutive integer height values
+static void sampleIntegerHeights(const void* heightFieldData, uint startIndex, uint nbValues,
+                                 decimal integerHeightScale, decimal* outHeights) {
+
+    const int* heights = static_cast<const int*>(heightFieldData) + startIndex;
+    for (uint i=0; i < nbValues; i++) {
+        outHeights[i] = heights[i] * integerHeightScale;
+    }
+}
+
 // Constructor
 /**
  * @param nbGridColumns Number of columns in the grid of the height field
@@ -40,14 +62,19 @@ using namespace reactphysics3d;
  * @param dataType Data type for the height values (int, float, double)
  * @param upAxis Integer representing the up axis direction (0 for x, 1 for y and 2 for z)
  * @param integerHeightScale Scaling factor used to scale the height values (only when height values type is integer)
+ * @param scaling Scaling factor of the height field
+ * @param computeVerticesNormals True if the normals of the grid points must be precomputed (instead of
+ *                               using the normal of each triangle as normal of its vertices)
  */
 HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                                    const void* heightFieldData, HeightDataType dataType, MemoryAllocator& allocator, int upAxis,
-                                   decimal integerHeightScale, const Vector3& scaling)
+                                   decimal integerHeightScale, const Vector3& scaling, bool computeVerticesNormals)
                  : ConcaveShape(CollisionShapeName::HEIGHTFIELD, allocator, scaling), mNbColumns(nbGridColumns), mNbRows(nbGridRows),
                    mWidth(nbGridColumns - 1), mLength(nbGridRows - 1), mMinHeight(minHeight),
                    mMaxHeight(maxHeight), mUpAxis(upAxis), mIntegerHeightScale(integerHeightScale),
-                   mHeightDataType(dataType) {
+                   mHeightDataType(dataType), mColumnAxis(upAxis == 0 ? 1 : 0), mRowAxis(upAxis == 2 ? 1 : 2),
+                   mHeightOrigin(-(maxHeight - minHeight) * decimal(0.5) - minHeight),
+                   mHeightPyramidLevels(allocator), mHeightPyramidMinMax(allocator), mVerticesNormals(allocator) {
 
     assert(nbGridColumns >= 2);
     assert(nbGridRows >= 2);
@@ -58,6 +85,15 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
 
     mHeightFieldData = heightFieldData;
 
+    // Select the function to read the height values once so that the height values are
+    // not read with a switch on the data type for each vertex
+    switch(mHeightDataType) {
+        case HeightDataType::HEIGHT_FLOAT_TYPE : mSampleHeights = &sampleFloatingPointHeights<float>; break;
+        case HeightDataType::HEIGHT_DOUBLE_TYPE : mSampleHeights = &sampleFloatingPointHeights<double>; break;
+        case HeightDataType::HEIGHT_INT_TYPE : mSampleHeights = &sampleIntegerHeights; break;
+        default: assert(false); mSampleHeights = &sampleFloatingPointHeights<float>;
+    }
+
     decimal halfHeight = (mMaxHeight - mMinHeight) * decimal(0.5);
     assert(halfHeight >= 0);
 
@@ -74,6 +110,142 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
         mAABB.setMin(Vector3(-mWidth * decimal(0.5), -mLength * decimal(0.5), -halfHeight));
         mAABB.setMax(Vector3(mWidth * decimal(0.5), mLength * decimal(0.5), halfHeight));
     }
+
+    // Compute the min/max height pyramid
+    initHeightPyramid();
+
+    // Compute the normals of the grid points if necessary
+    if (computeVerticesNormals) {
+        initVerticesNormals();
+    }
+}
+
+// Compute the min/max height pyramid of the grid
+/// The pyramid is used to skip the parts of the grid that cannot be hit by a ray or that
+/// cannot overlap with an AABB because of their height values.
+void HeightFieldShape::initHeightPyramid() {
+
+    const int nbQuadsX = mNbColumns - 1;
+    const int nbQuadsY = mNbRows - 1;
+
+    // Compute the first level of the pyramid from the height values of the grid
+    HeightPyramidLevel level;
+    level.nbCellsX = (nbQuadsX + HEIGHT_PYRAMID_LEAF_SIZE - 1) / HEIGHT_PYRAMID_LEAF_SIZE;
+    level.nbCellsY = (nbQuadsY + HEIGHT_PYRAMID_LEAF_SIZE - 1) / HEIGHT_PYRAMID_LEAF_SIZE;
+    level.startIndex = 0;
+    mHeightPyramidLevels.add(level);
+
+    mHeightPyramidMinMax.reserve(static_cast<uint>(level.nbCellsX * level.nbCellsY) * 3);
+
+    for (int y=0; y < level.nbCellsY; y++) {
+        for (int x=0; x < level.nbCellsX; x++) {
+
+            // Grid points of the cell (including the points shared with the next cells)
+            const int iMin = x * HEIGHT_PYRAMID_LEAF_SIZE;
+            const int jMin = y * HEIGHT_PYRAMID_LEAF_SIZE;
+            const int iMax = std::min(iMin + HEIGHT_PYRAMID_LEAF_SIZE, nbQuadsX);
+            const int jMax = std::min(jMin + HEIGHT_PYRAMID_LEAF_SIZE, nbQuadsY);
+
+            decimal heights[(HEIGHT_PYRAMID_LEAF_SIZE + 1) * (HEIGHT_PYRAMID_LEAF_SIZE + 1)];
+            const int nbPoints = (iMax - iMin + 1) * (jMax - jMin + 1);
+            sampleGridHeights(iMin, jMin, iMax - iMin + 1, jMax - jMin + 1, heights);
+
+            decimal minHeight = DECIMAL_LARGEST;
+            decimal maxHeight = DECIMAL_SMALLEST;
+            for (int k=0; k < nbPoints; k++) {
+                minHeight = std::min(minHeight, heights[k]);
+                maxHeight = std::max(maxHeight, heights[k]);
+            }
+
+            mHeightPyramidMinMax.add(minHeight);
+            mHeightPyramidMinMax.add(maxHeight);
+        }
+    }
+
+    // Compute each next level from the previous one until a level has a single cell
+    while (level.nbCellsX > 1 || level.nbCellsY > 1) {
+
+        const HeightPyramidLevel previousLevel = level;
+
+        level.nbCellsX = (previousLevel.nbCellsX + 1) / 2;
+        level.nbCellsY = (previousLevel.nbCellsY + 1) / 2;
+        level.startIndex = mHeightPyramidMinMax.size() / 2;
+        mHeightPyramidLevels.add(level);
+
+        for (int y=0; y < level.nbCellsY; y++) {
+            for (int x=0; x < level.nbCellsX; x++) {
+
+                decimal minHeight = DECIMAL_LARGEST;
+                decimal maxHeight = DECIMAL_SMALLEST;
+                for (int c=0; c < 4; c++) {
+
+                    const int childX = x * 2 + (c & 1);
+                    const int childY = y * 2 + (c >> 1);
+                    if (childX < previousLevel.nbCellsX && childY < previousLevel.nbCellsY) {
+                        const uint childIndex = previousLevel.startIndex + childY * previousLevel.nbCellsX + childX;
+                        minHeight = std::min(minHeight, mHeightPyramidMinMax[childIndex * 2]);
+                        maxHeight = std::max(maxHeight, mHeightPyramidMinMax[childIndex * 2 + 1]);
+                    }
+                }
+
+                mHeightPyramidMinMax.add(minHeight);
+                mHeightPyramidMinMax.add(maxHeight);
+            }
+        }
+    }
+}
+
+// Compute the normals of the grid points
+/// The normal of a grid point is the average of the normals of the triangles around the point
+/// weighted by their incident angle at the point (as for the vertices of a TriangleVertexArray).
+/// The normals are computed without the scaling of the shape.
+void HeightFieldShape::initVerticesNormals() {
+
+    const uint nbVertices = static_cast<uint>(mNbColumns * mNbRows);
+    mVerticesNormals.reserve(nbVertices);
+    for (uint v=0; v < nbVertices; v++) {
+        mVerticesNormals.add(Vector3::zero());
+    }
+
+    // For each quad of the grid
+    for (int j=0; j < mNbRows - 1; j++) {
+        for (int i=0; i < mNbColumns - 1; i++) {
+
+            // Indices of the grid points of the two triangles of the quad (same order as in computeQuadTriangles())
+            const uint p1 = j * mNbColumns + i;
+            const uint p2 = (j + 1) * mNbColumns + i;
+            const uint p3 = j * mNbColumns + i + 1;
+            const uint p4 = (j + 1) * mNbColumns + i + 1;
+            const uint trianglesIndices[6] = {p1, p2, p3, p3, p2, p4};
+
+            const Vector3 quadVertices[4] = {computeVertex(i, j, getHeightAt(i, j)), computeVertex(i, j + 1, getHeightAt(i, j + 1)),
+                                             computeVertex(i + 1, j, getHeightAt(i + 1, j)),
+                                             computeVertex(i + 1, j + 1, getHeightAt(i + 1, j + 1))};
+            const uint trianglesVertices[6] = {0, 1, 2, 2, 1, 3};
+
+            for (int t=0; t < 2; t++) {
+
+                // For each vertex of the triangle
+                for (int v=0; v < 3; v++) {
+
+                    const Vector3& vertex = quadVertices[trianglesVertices[t * 3 + v]];
+                    const Vector3 a = quadVertices[trianglesVertices[t * 3 + (v + 1) % 3]] - vertex;
+                    const Vector3 b = quadVertices[trianglesVertices[t * 3 + (v + 2) % 3]] - vertex;
+
+                    // Weight the normal of the triangle with its incident angle at the vertex
+                    const Vector3 crossProduct = a.cross(b);
+                    decimal sinA = crossProduct.length() / (a.length() * b.length());
+                    sinA = std::min(std::max(sinA, decimal(0.0)), decimal(1.0));
+                    mVerticesNormals[trianglesIndices[t * 3 + v]] += std::asin(sinA) * crossProduct;
+                }
+            }
+        }
+    }
+
+    // Normalize the computed normals
+    for (uint v=0; v < nbVertices; v++) {
+        mVerticesNormals[v].normalize();
+    }
 }
 
 // Return the local bounds of the shape in x, y and z directions.
@@ -134,63 +306,124 @@ void HeightFieldShape::computeOverlappingTriangles(const AABB& localAABB, List<V
    assert(jMin >= 0 && jMin < mNbRows);
    assert(jMax >= 0 && jMax < mNbRows);
 
-   // For each sub-grid points (except the last ones one each dimension)
-   for (int i = iMin; i < iMax; i++) {
-       for (int j = jMin; j < jMax; j++) {
-
-           // Compute the four point of the current quad
-           const Vector3 p1 = getVertexAt(i, j);
-           const Vector3 p2 = getVertexAt(i, j + 1);
-           const Vector3 p3 = getVertexAt(i + 1, j);
-           const Vector3 p4 = getVertexAt(i + 1, j + 1);
-
-           // Generate the first triangle for the current grid rectangle
-           triangleVertices.add(p1);
-           triangleVertices.add(p2);
-           triangleVertices.add(p3);
-
-           // Compute the triangle normal
-           Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           triangleVerticesNormals.add(triangle1Normal);
-           triangleVerticesNormals.add(triangle1Normal);
-           triangleVerticesNormals.add(triangle1Normal);
-
-           // Compute the shape ID
-           shapeIds.add(computeTriangleShapeId(i, j, 0));
-
-           // Generate the second triangle for the current grid rectangle
-           triangleVertices.add(p3);
-           triangleVertices.add(p2);
-           triangleVertices.add(p4);
-
-           // Compute the triangle normal
-           Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           triangleVerticesNormals.add(triangle2Normal);
-           triangleVerticesNormals.add(triangle2Normal);
-           triangleVerticesNormals.add(triangle2Normal);
-
-           // Compute the shape ID
-           shapeIds.add(computeTriangleShapeId(i, j, 1));
+   // Range of the height values of the AABB
+   const decimal aabbMinHeight = aabb.getMin()[mUpAxis] - mHeightOrigin;
+   const decimal aabbMaxHeight = aabb.getMax()[mUpAxis] - mHeightOrigin;
+
+   const HeightPyramidLevel& leafLevel = mHeightPyramidLevels[0];
+
+   // For each cell of the first level of the height pyramid that contains quads of the sub-grid
+   for (int cellY = jMin / HEIGHT_PYRAMID_LEAF_SIZE; cellY * HEIGHT_PYRAMID_LEAF_SIZE < jMax; cellY++) {
+       for (int cellX = iMin / HEIGHT_PYRAMID_LEAF_SIZE; cellX * HEIGHT_PYRAMID_LEAF_SIZE < iMax; cellX++) {
+
+           // If the height values of the cell are not overlapping with the AABB, we skip the quads of the cell
+           const uint cellIndex = leafLevel.startIndex + cellY * leafLevel.nbCellsX + cellX;
+           if (mHeightPyramidMinMax[cellIndex * 2] > aabbMaxHeight || mHeightPyramidMinMax[cellIndex * 2 + 1] < aabbMinHeight) {
+               continue;
+           }
+
+           const int cellIMin = std::max(iMin, cellX * HEIGHT_PYRAMID_LEAF_SIZE);
+           const int cellIMax = std::min(iMax, (cellX + 1) * HEIGHT_PYRAMID_LEAF_SIZE);
+           const int cellJMin = std::max(jMin, cellY * HEIGHT_PYRAMID_LEAF_SIZE);
+           const int cellJMax = std::min(jMax, (cellY + 1) * HEIGHT_PYRAMID_LEAF_SIZE);
+
+           // Read the height values of the grid points of the quads inside the cell
+           decimal heights[(HEIGHT_PYRAMID_LEAF_SIZE + 1) * (HEIGHT_PYRAMID_LEAF_SIZE + 1)];
+           const int nbPointsX = cellIMax - cellIMin + 1;
+           sampleGridHeights(cellIMin, cellJMin, nbPointsX, cellJMax - cellJMin + 1, heights);
+
+           // For each quad of the sub-grid inside the cell
+           for (int i = cellIMin; i < cellIMax; i++) {
+               for (int j = cellJMin; j < cellJMax; j++) {
+
+                   const int heightIndex = (j - cellJMin) * nbPointsX + i - cellIMin;
+                   const decimal quadHeights[4] = {heights[heightIndex], heights[heightIndex + nbPointsX],
+                                                   heights[heightIndex + 1], heights[heightIndex + nbPointsX + 1]};
+
+                   // If the quad is below or above the AABB, we skip it
+                   const decimal quadMinHeight = std::min(std::min(quadHeights[0], quadHeights[1]), std::min(quadHeights[2], quadHeights[3]));
+                   const decimal quadMaxHeight = std::max(std::max(quadHeights[0], quadHeights[1]), std::max(quadHeights[2], quadHeights[3]));
+                   if (quadMinHeight > aabbMaxHeight || quadMaxHeight < aabbMinHeight) {
+                       continue;
+                   }
+
+                   // Compute the two triangles of the quad
+                   Vector3 quadTrianglesVertices[6];
+                   Vector3 quadTrianglesVerticesNormals[6];
+                   computeQuadTriangles(i, j, quadHeights, quadTrianglesVertices, quadTrianglesVerticesNormals);
+
+                   for (int k=0; k < 6; k++) {
+                       triangleVertices.add(quadTrianglesVertices[k]);
+                       triangleVerticesNormals.add(quadTrianglesVerticesNormals[k]);
+                   }
+
+                   // Compute the shape IDs of the two triangles
+                   shapeIds.add(computeTriangleShapeId(i, j, 0));
+                   shapeIds.add(computeTriangleShapeId(i, j, 1));
+               }
+           }
        }
    }
 }
 
+// Compute the six vertices and vertices normals of the two triangles of a quad of the grid
+/// The four height values of the quad are given in the order (i, j), (i, j+1), (i+1, j) and (i+1, j+1).
+/// The vertices of the first triangle are written in the first three elements of the output
+/// arrays and the vertices of the second triangle in the next three elements.
+void HeightFieldShape::computeQuadTriangles(int i, int j, const decimal* quadHeights, Vector3* outTrianglesVertices,
+                                            Vector3* outTrianglesVerticesNormals) const {
+
+    // Compute the four point of the current quad
+    const Vector3 p1 = computeVertex(i, j, quadHeights[0]) * mScale;
+    const Vector3 p2 = computeVertex(i, j + 1, quadHeights[1]) * mScale;
+    const Vector3 p3 = computeVertex(i + 1, j, quadHeights[2]) * mScale;
+    const Vector3 p4 = computeVertex(i + 1, j + 1, quadHeights[3]) * mScale;
+
+    // Generate the first triangle for the current grid rectangle
+    outTrianglesVertices[0] = p1;
+    outTrianglesVertices[1] = p2;
+    outTrianglesVertices[2] = p3;
+
+    // Generate the second triangle for the current grid rectangle
+    outTrianglesVertices[3] = p3;
+    outTrianglesVertices[4] = p2;
+    outTrianglesVertices[5] = p4;
+
+    // If the vertices normals have been precomputed
+    if (mVerticesNormals.size() > 0) {
+
+        // Scale the normals of the grid points (with the inverse of the scaling)
+        const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
+        const Vector3 n1 = (mVerticesNormals[j * mNbColumns + i] * inverseScale).getUnit();
+        const Vector3 n2 = (mVerticesNormals[(j + 1) * mNbColumns + i] * inverseScale).getUnit();
+        const Vector3 n3 = (mVerticesNormals[j * mNbColumns + i + 1] * inverseScale).getUnit();
+        const Vector3 n4 = (mVerticesNormals[(j + 1) * mNbColumns + i + 1] * inverseScale).getUnit();
+
+        outTrianglesVerticesNormals[0] = n1;
+        outTrianglesVerticesNormals[1] = n2;
+        outTrianglesVerticesNormals[2] = n3;
+        outTrianglesVerticesNormals[3] = n3;
+        outTrianglesVerticesNormals[4] = n2;
+        outTrianglesVerticesNormals[5] = n4;
+
+        return;
+    }
+
+    // Compute the triangles normals
+    const Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
+    const Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
+
+    // Use the triangle face normal as vertices normals (this is an aproximation. The correct
+    // solution would be to compute all the normals of the neighbor triangles and use their
+    // weighted average (with incident angle as weight) at the vertices. This is what we do when
+    // the vertices normals are precomputed at the HeightFieldShape constructor but it requires
+    // extra memory to store them.
+    for (int k=0; k < 3; k++) {
+        outTrianglesVerticesNormals[k] = triangle1Normal;
+        outTrianglesVerticesNormals[3 + k] = triangle2Normal;
+    }
+}
+
 // Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and
 // the AABB to collide
 void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoords, const AABB& aabbToCollide) const {
@@ -221,39 +454,172 @@ void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoor
     maxCoords[2] = computeIntegerGridValue(maxPoint.z) + 1;
 }
 
+// Compute the fraction where a ray enters an axis-aligned box
+/// Return false if the ray does not intersect the box between the fraction zero and the maximum fraction
+static bool computeRayBoxEnterFraction(const Vector3& rayStart, const Vector3& rayDirection, const Vector3& boxMin,
+                                       const Vector3& boxMax, decimal maxFraction, decimal& outEnterFraction) {
+
+    decimal enterFraction = decimal(0.0);
+    decimal exitFraction = maxFraction;
+
+    for (int axis=0; axis < 3; axis++) {
+
+        // If the ray is parallel to the slab of the axis
+        if (std::abs(rayDirection[axis]) < MACHINE_EPSILON) {
+            if (rayStart[axis] < boxMin[axis] || rayStart[axis] > boxMax[axis]) return false;
+        }
+        else {
+
+            const decimal inverseDirection = decimal(1.0) / rayDirection[axis];
+            decimal fraction1 = (boxMin[axis] - rayStart[axis]) * inverseDirection;
+            decimal fraction2 = (boxMax[axis] - rayStart[axis]) * inverseDirection;
+            if (fraction1 > fraction2) std::swap(fraction1, fraction2);
+
+            enterFraction = std::max(enterFraction, fraction1);
+            exitFraction = std::min(exitFraction, fraction2);
+            if (enterFraction > exitFraction) return false;
+        }
+    }
+
+    outEnterFraction = enterFraction;
+
+    return true;
+}
+
 // Raycast method with feedback information
 /// Note that only the first triangle hit by the ray in the mesh will be returned, even if
-/// the ray hits many triangles.
+/// the ray hits many triangles. The cells of the min/max height pyramid crossed by the ray are
+/// visited from the top of the pyramid and in the order of the ray so that only the quads of
+/// the grid close to the ray are tested and the cells after the closest hit are skipped.
 bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const {
 
-    // TODO : Implement raycasting without using an AABB for the ray
-    //        but using a dynamic AABB tree or octree instead
-
     RP3D_PROFILE("HeightFieldShape::raycast()", mProfiler);
 
-    // Compute the AABB for the ray
-    const Vector3 rayEnd = ray.point1 + ray.maxFraction * (ray.point2 - ray.point1);
-    const AABB rayAABB(Vector3::min(ray.point1, rayEnd), Vector3::max(ray.point1, rayEnd));
-
-    // Compute the triangles overlapping with the ray AABB
-    List<Vector3> triangleVertices(allocator);
-    List<Vector3> triangleVerticesNormals(allocator);
-    List<uint> shapeIds(allocator);
-    computeOverlappingTriangles(rayAABB, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+    // Cell of the pyramid to visit
+    struct PyramidCell {
+        int level;
+        int x;
+        int y;
+        decimal enterFraction;
+    };
 
-    assert(triangleVertices.size() == triangleVerticesNormals.size());
-    assert(shapeIds.size() == triangleVertices.size() / 3);
-    assert(triangleVertices.size() % 3 == 0);
-    assert(triangleVerticesNormals.size() % 3 == 0);
+    // Compute the ray in the grid-space (the fractions along the ray are the same in both spaces)
+    const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
+    const Vector3 rayStart = convertToGridSpace(ray.point1 * inverseScale);
+    const Vector3 rayDirection = convertToGridSpace(ray.point2 * inverseScale) - rayStart;
 
     bool isHit = false;
     decimal smallestHitFraction = ray.maxFraction;
 
-    // For each overlapping triangle
-    for (uint i=0; i < shapeIds.size(); i++)
-    {
+    // Stack of the cells to visit (at most three pending cells per level plus the children of a cell)
+    PyramidCell cellsToVisit[3 * 32 + 4];
+    int nbCellsToVisit = 0;
+
+    Vector3 cellMin;
+    Vector3 cellMax;
+    decimal enterFraction;
+    const int topLevel = static_cast<int>(mHeightPyramidLevels.size()) - 1;
+    const decimal epsilon = decimal(0.001);
+    const Vector3 cellEpsilon(epsilon, epsilon, epsilon * std::max(decimal(1.0), mMaxHeight - mMinHeight));
+    getHeightPyramidCellBounds(topLevel, 0, 0, cellMin, cellMax);
+    if (computeRayBoxEnterFraction(rayStart, rayDirection, cellMin, cellMax, smallestHitFraction, enterFraction)) {
+        cellsToVisit[nbCellsToVisit++] = {topLevel, 0, 0, enterFraction};
+    }
+
+    while (nbCellsToVisit > 0) {
+
+        const PyramidCell cell = cellsToVisit[--nbCellsToVisit];
+
+        // If the ray has already hit a triangle before entering the cell
+        if (cell.enterFraction > smallestHitFraction) continue;
+
+        // If the cell is in the first level of the pyramid, we test the quads of the cell
+        if (cell.level == 0) {
+
+            const int iMin = cell.x * HEIGHT_PYRAMID_LEAF_SIZE;
+            const int jMin = cell.y * HEIGHT_PYRAMID_LEAF_SIZE;
+            const int iMax = std::min(iMin + HEIGHT_PYRAMID_LEAF_SIZE, mNbColumns - 1);
+            const int jMax = std::min(jMin + HEIGHT_PYRAMID_LEAF_SIZE, mNbRows - 1);
+
+            // Read the height values of the grid points of the cell
+            decimal heights[(HEIGHT_PYRAMID_LEAF_SIZE + 1) * (HEIGHT_PYRAMID_LEAF_SIZE + 1)];
+            const int nbPointsX = iMax - iMin + 1;
+            sampleGridHeights(iMin, jMin, nbPointsX, jMax - jMin + 1, heights);
+
+            for (int j = jMin; j < jMax; j++) {
+                for (int i = iMin; i < iMax; i++) {
+
+                    const int heightIndex = (j - jMin) * nbPointsX + i - iMin;
+                    const decimal quadHeights[4] = {heights[heightIndex], heights[heightIndex + nbPointsX],
+                                                    heights[heightIndex + 1], heights[heightIndex + nbPointsX + 1]};
+
+                    // If the ray does not cross the bounds of the quad before the closest hit, we skip it
+                    const Vector3 quadMin(decimal(i), decimal(j), std::min(std::min(quadHeights[0], quadHeights[1]),
+                                                                           std::min(quadHeights[2], quadHeights[3])));
+                    const Vector3 quadMax(decimal(i + 1), decimal(j + 1), std::max(std::max(quadHeights[0], quadHeights[1]),
+                                                                                   std::max(quadHeights[2], quadHeights[3])));
+                    if (!computeRayBoxEnterFraction(rayStart, rayDirection, quadMin - cellEpsilon, quadMax + cellEpsilon,
+                                                    smallestHitFraction, enterFraction)) {
+                        continue;
+                    }
+
+                    isHit |= raycastQuad(i, j, quadHeights, ray, raycastInfo, collider, smallestHitFraction, allocator);
+                }
+            }
+
+            continue;
+        }
+
+        // Compute the children cells crossed by the ray sorted by increasing enter fraction
+        PyramidCell children[4];
+        int nbChildren = 0;
+        const int childLevel = cell.level - 1;
+        for (int c=0; c < 4; c++) {
+
+            const int childX = cell.x * 2 + (c & 1);
+            const int childY = cell.y * 2 + (c >> 1);
+            if (childX >= mHeightPyramidLevels[childLevel].nbCellsX || childY >= mHeightPyramidLevels[childLevel].nbCellsY) continue;
+
+            getHeightPyramidCellBounds(childLevel, childX, childY, cellMin, cellMax);
+            if (computeRayBoxEnterFraction(rayStart, rayDirection, cellMin, cellMax, smallestHitFraction, enterFraction)) {
+
+                int k = nbChildren;
+                while (k > 0 && children[k - 1].enterFraction > enterFraction) {
+                    children[k] = children[k - 1];
+                    k--;
+                }
+                children[k] = {childLevel, childX, childY, enterFraction};
+                nbChildren++;
+            }
+        }
+
+        // Push the children such that the closest one is visited first
+        assert(nbCellsToVisit + nbChildren <= 3 * 32 + 4);
+        for (int c = nbChildren - 1; c >= 0; c--) {
+            cellsToVisit[nbCellsToVisit++] = children[c];
+        }
+    }
+
+    return isHit;
+}
+
+// Raycast against the two triangles of a quad of the grid
+/// The raycast info is only updated if a triangle is hit at a fraction not larger than the
+/// smallest hit fraction (which is then updated)
+bool HeightFieldShape::raycastQuad(int i, int j, const decimal* quadHeights, const Ray& ray, RaycastInfo& raycastInfo,
+                                   Collider* collider, decimal& smallestHitFraction, MemoryAllocator& allocator) const {
+
+    Vector3 trianglesVertices[6];
+    Vector3 trianglesVerticesNormals[6];
+    computeQuadTriangles(i, j, quadHeights, trianglesVertices, trianglesVerticesNormals);
+
+    bool isHit = false;
+
+    // For each triangle of the quad
+    for (uint t=0; t < 2; t++) {
+
         // Create a triangle collision shape
-        TriangleShape triangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
+        TriangleShape triangleShape(&(trianglesVertices[t * 3]), &(trianglesVerticesNormals[t * 3]), computeTriangleShapeId(i, j, t), allocator);
         triangleShape.setRaycastTestType(getRaycastTestType());
 
     #ifdef IS_RP3D_PROFILING_ENABLED
@@ -289,25 +655,51 @@ bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collide
     return isHit;
 }
 
+// Return the bounds of a cell of the min/max height pyramid in grid-space
+/// In grid-space, the x and y coordinates are the column and row coordinates of the grid and the
+/// z coordinate is the height value. The bounds are slightly enlarged to be robust to rounding errors.
+void HeightFieldShape::getHeightPyramidCellBounds(int level, int x, int y, Vector3& outMin, Vector3& outMax) const {
+
+    const HeightPyramidLevel& pyramidLevel = mHeightPyramidLevels[level];
+    const uint cellIndex = pyramidLevel.startIndex + y * pyramidLevel.nbCellsX + x;
+    const int cellSize = HEIGHT_PYRAMID_LEAF_SIZE << level;
+
+    const decimal epsilon = decimal(0.001);
+    const decimal heightEpsilon = epsilon * std::max(decimal(1.0), mMaxHeight - mMinHeight);
+
+    outMin.setAllValues(decimal(x * cellSize) - epsilon, decimal(y * cellSize) - epsilon,
+                        mHeightPyramidMinMax[cellIndex * 2] - heightEpsilon);
+    outMax.setAllValues(decimal(std::min((x + 1) * cellSize, mNbColumns - 1)) + epsilon,
+                        decimal(std::min((y + 1) * cellSize, mNbRows - 1)) + epsilon,
+                        mHeightPyramidMinMax[cellIndex * 2 + 1] + heightEpsilon);
+}
+
+// Convert a point from the local-space (without scaling) to the grid-space of the height field
+/// In grid-space, the x and y coordinates are the column and row coordinates of the grid and the
+/// z coordinate is the height value (as returned by getHeightAt()).
+Vector3 HeightFieldShape::convertToGridSpace(const Vector3& localPoint) const {
+
+    return Vector3(localPoint[mColumnAxis] + mWidth * decimal(0.5), localPoint[mRowAxis] + mLength * decimal(0.5),
+                   localPoint[mUpAxis] - mHeightOrigin);
+}
+
+// Read the height values of a rectangle of grid points
+/// The height values are written row by row in the output array that must have space
+/// for nbPointsX x nbPointsY values.
+void HeightFieldShape::sampleGridHeights(int iMin, int jMin, int nbPointsX, int nbPointsY, decimal* outHeights) const {
+
+    assert(iMin >= 0 && iMin + nbPointsX <= mNbColumns);
+    assert(jMin >= 0 && jMin + nbPointsY <= mNbRows);
+
+    for (int j=0; j < nbPointsY; j++) {
+        mSampleHeights(mHeightFieldData, (jMin + j) * mNbColumns + iMin, nbPointsX, mIntegerHeightScale, outHeights + j * nbPointsX);
+    }
+}
+
 // Return the vertex (local-coordinates) of the height field at a given (x,y) position
 Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
 
-    // Get the height value
-    const decimal height = getHeightAt(x, y);
-
-    // Height values origin
-    const decimal heightOrigin = -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
-
-    Vector3 vertex;
-    switch (mUpAxis) {
-        case 0: vertex = Vector3(heightOrigin + height, -mWidth * decimal(0.5) + x, -mLength * decimal(0.5) + y);
-                break;
-        case 1: vertex = Vector3(-mWidth * decimal(0.5) + x, heightOrigin + height, -mLength * decimal(0.5) + y);
-                break;
-        case 2: vertex = Vector3(-mWidth * decimal(0.5) + x, -mLength * decimal(0.5) + y, heightOrigin + height);
-                break;
-        default: assert(false);
-    }
+    const Vector3 vertex = computeVertex(x, y, getHeightAt(x, y));
 
     assert(mAABB.contains(vertex));
 
@@ -329,6 +721,7 @@ std::string HeightFieldShape::to_string() const {
     ss << ", maxHeight=" << mMaxHeight << std::endl;
     ss << ", upAxis=" << mUpAxis << std::endl;
     ss << ", integerHeightScale=" << mIntegerHeightScale << std::endl;
+    ss << ", hasVerticesNormals=" << hasVerticesNormals() << std::endl;
     ss << "}";
 
     return ss.str();
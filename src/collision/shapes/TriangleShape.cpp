@@ -300,7 +300,8 @@ bool TriangleShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider*
 
     // Compute the local hit point using the barycentric coordinates
     const Vector3 localHitPoint = u * mPoints[0] + v * mPoints[1] + w * mPoints[2];
-    const decimal hitFraction = (localHitPoint - ray.point1).length() / pq.length();
+    // The hit fraction is signed to reject the intersections behind the origin of the ray
+    const decimal hitFraction = (localHitPoint - ray.point1).dot(pq) / pq.lengthSquare();
 
     if (hitFraction < decimal(0.0) || hitFraction > ray.maxFraction) return false;
 
@@ -40,7 +40,8 @@ OverlappingPairs::OverlappingPairs(MemoryAllocator& persistentMemoryAllocator, M
                   mNbPairs(0), mConcavePairsStartIndex(0), mPairDataSize(sizeof(uint64) + sizeof(int32) + sizeof(int32) + sizeof(Entity) +
                                                                          sizeof(Entity) + sizeof(Map<uint64, LastFrameCollisionInfo*>) +
                                                                          sizeof(bool) + sizeof(bool) + sizeof(NarrowPhaseAlgorithmType) +
-                                                                         sizeof(bool) + sizeof(bool) + sizeof(bool)),
+                                                                         sizeof(bool) + sizeof(bool) + sizeof(bool) +
+                                                                         sizeof(ConcaveTrianglesCache*)),
                   mNbAllocatedPairs(0), mBuffer(nullptr),
                   mMapPairIdToPairIndex(persistentMemoryAllocator),
                   mColliderComponents(colliderComponents), mCollisionBodyComponents(collisionBodyComponents),
@@ -59,15 +60,8 @@ OverlappingPairs::~OverlappingPairs() {
         // Destroy all the remaining pairs
         for (uint32 i = 0; i < mNbPairs; i++) {
 
-            // Remove all the remaining last frame collision info
-            for (auto it = mLastFrameCollisionInfos[i].begin(); it != mLastFrameCollisionInfos[i].end(); ++it) {
-
-                // Call the constructor
-                it->second->~LastFrameCollisionInfo();
-
-                // Release memory
-                mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
-            }
+            // Remove all the remaining last frame collision info and the triangles cache
+            releasePairCaches(i);
 
             // Remove the involved overlapping pair to the two colliders
             assert(mColliderComponents.getOverlappingPairs(mColliders1[i]).find(mPairIds[i]) != mColliderComponents.getOverlappingPairs(mColliders1[i]).end());
@@ -134,15 +128,8 @@ void OverlappingPairs::removePair(uint64 pairId) {
     // we replace it with the last element of the array. But we need to make sure that convex
     // and concave pairs stay grouped together.
 
-    // Remove all the remaining last frame collision info
-    for (auto it = mLastFrameCollisionInfos[index].begin(); it != mLastFrameCollisionInfos[index].end(); ++it) {
-
-        // Call the constructor
-        it->second->~LastFrameCollisionInfo();
-
-        // Release memory
-        mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
-    }
+    // Remove all the remaining last frame collision info and the triangles cache
+    releasePairCaches(index);
 
     // Remove the involved overlapping pair to the two colliders
     assert(mColliderComponents.getOverlappingPairs(mColliders1[index]).find(pairId) != mColliderComponents.getOverlappingPairs(mColliders1[index]).end());
@@ -207,7 +194,8 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
     Entity* newColliders1 = reinterpret_cast<Entity*>(newPairBroadPhaseId2 + nbPairsToAllocate);
     Entity* newColliders2 = reinterpret_cast<Entity*>(newColliders1 + nbPairsToAllocate);
     Map<uint64, LastFrameCollisionInfo*>* newLastFrameCollisionInfos = reinterpret_cast<Map<uint64, LastFrameCollisionInfo*>*>(newColliders2 + nbPairsToAllocate);
-    bool* newNeedToTestOverlap = reinterpret_cast<bool*>(newLastFrameCollisionInfos + nbPairsToAllocate);
+    ConcaveTrianglesCache** newConcaveTrianglesCaches = reinterpret_cast<ConcaveTrianglesCache**>(newLastFrameCollisionInfos + nbPairsToAllocate);
+    bool* newNeedToTestOverlap = reinterpret_cast<bool*>(newConcaveTrianglesCaches + nbPairsToAllocate);
     bool* newIsActive = reinterpret_cast<bool*>(newNeedToTestOverlap + nbPairsToAllocate);
     NarrowPhaseAlgorithmType* newNarrowPhaseAlgorithmType = reinterpret_cast<NarrowPhaseAlgorithmType*>(newIsActive + nbPairsToAllocate);
     bool* newIsShape1Convex = reinterpret_cast<bool*>(newNarrowPhaseAlgorithmType + nbPairsToAllocate);
@@ -224,6 +212,7 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
         memcpy(newColliders1, mColliders1, mNbPairs * sizeof(Entity));
         memcpy(newColliders2, mColliders2, mNbPairs * sizeof(Entity));
         memcpy(newLastFrameCollisionInfos, mLastFrameCollisionInfos, mNbPairs * sizeof(Map<uint64, LastFrameCollisionInfo*>));
+        memcpy(newConcaveTrianglesCaches, mConcaveTrianglesCaches, mNbPairs * sizeof(ConcaveTrianglesCache*));
         memcpy(newNeedToTestOverlap, mNeedToTestOverlap, mNbPairs * sizeof(bool));
         memcpy(newIsActive, mIsActive, mNbPairs * sizeof(bool));
         memcpy(newNarrowPhaseAlgorithmType, mNarrowPhaseAlgorithmType, mNbPairs * sizeof(NarrowPhaseAlgorithmType));
@@ -248,6 +237,7 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
     mIsShape1Convex = newIsShape1Convex;
     mCollidingInPreviousFrame = wereCollidingInPreviousFrame;
     mCollidingInCurrentFrame = areCollidingInCurrentFrame;
+    mConcaveTrianglesCaches = newConcaveTrianglesCaches;
 
     mNbAllocatedPairs = nbPairsToAllocate;
 }
@@ -285,7 +275,7 @@ uint64 OverlappingPairs::addPair(Collider* shape1, Collider* shape2) {
     NarrowPhaseAlgorithmType algorithmType;
     if (isConvexVsConvex) {
 
-        algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(collisionShape1->getType(), collisionShape2->getType());
+        algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(collisionShape1, collisionShape2);
     }
     else {
 
@@ -306,6 +296,7 @@ uint64 OverlappingPairs::addPair(Collider* shape1, Collider* shape2) {
     new (mIsShape1Convex + index) bool(isShape1Convex);
     new (mCollidingInPreviousFrame + index) bool(false);
     new (mCollidingInCurrentFrame + index) bool(false);
+    new (mConcaveTrianglesCaches + index) ConcaveTrianglesCache*(nullptr);
 
     // Map the entity with the new component lookup index
     mMapPairIdToPairIndex.add(Pair<uint64, uint64>(pairId, index));
@@ -345,6 +336,7 @@ void OverlappingPairs::movePairToIndex(uint64 srcIndex, uint64 destIndex) {
     mIsShape1Convex[destIndex] = mIsShape1Convex[srcIndex];
     mCollidingInPreviousFrame[destIndex] = mCollidingInPreviousFrame[srcIndex];
     mCollidingInCurrentFrame[destIndex] = mCollidingInCurrentFrame[srcIndex];
+    mConcaveTrianglesCaches[destIndex] = mConcaveTrianglesCaches[srcIndex];
 
     // Destroy the source pair
     destroyPair(srcIndex);
@@ -373,6 +365,7 @@ void OverlappingPairs::swapPairs(uint64 index1, uint64 index2) {
     bool isShape1Convex = mIsShape1Convex[index1];
     bool wereCollidingInPreviousFrame = mCollidingInPreviousFrame[index1];
     bool areCollidingInCurrentFrame = mCollidingInCurrentFrame[index1];
+    ConcaveTrianglesCache* concaveTrianglesCache = mConcaveTrianglesCaches[index1];
 
     // Destroy pair 1
     destroyPair(index1);
@@ -392,6 +385,7 @@ void OverlappingPairs::swapPairs(uint64 index1, uint64 index2) {
     mIsShape1Convex[index2] = isShape1Convex;
     mCollidingInPreviousFrame[index2] = wereCollidingInPreviousFrame;
     mCollidingInCurrentFrame[index2] = areCollidingInCurrentFrame;
+    mConcaveTrianglesCaches[index2] = concaveTrianglesCache;
 
     // Update the pairID to pair index mapping
     mMapPairIdToPairIndex.add(Pair<uint64, uint64>(pairId, index2));
@@ -416,6 +410,43 @@ void OverlappingPairs::destroyPair(uint64 index) {
     mNarrowPhaseAlgorithmType[index].~NarrowPhaseAlgorithmType();
 }
 
+// Release the memory of the last frame collision infos and of the triangles cache of a pair
+void OverlappingPairs::releasePairCaches(uint64 index) {
+
+    assert(index < mNbPairs);
+
+    // Remove all the remaining last frame collision info
+    for (auto it = mLastFrameCollisionInfos[index].begin(); it != mLastFrameCollisionInfos[index].end(); ++it) {
+
+        // Call the constructor
+        it->second->~LastFrameCollisionInfo();
+
+        // Release memory
+        mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
+    }
+
+    // Remove the triangles cache
+    if (mConcaveTrianglesCaches[index] != nullptr) {
+
+        mConcaveTrianglesCaches[index]->~ConcaveTrianglesCache();
+        mPersistentAllocator.release(mConcaveTrianglesCaches[index], sizeof(ConcaveTrianglesCache));
+        mConcaveTrianglesCaches[index] = nullptr;
+    }
+}
+
+// Return the triangles cache of a convex vs concave pair (created if necessary)
+ConcaveTrianglesCache* OverlappingPairs::getConcaveTrianglesCache(uint64 pairIndex) {
+
+    assert(pairIndex >= mConcavePairsStartIndex && pairIndex < mNbPairs);
+
+    if (mConcaveTrianglesCaches[pairIndex] == nullptr) {
+        mConcaveTrianglesCaches[pairIndex] = new (mPersistentAllocator.allocate(sizeof(ConcaveTrianglesCache)))
+                                             ConcaveTrianglesCache(mPersistentAllocator);
+    }
+
+    return mConcaveTrianglesCaches[pairIndex];
+}
+
 // Update whether a given overlapping pair is active or not
 void OverlappingPairs::updateOverlappingPairIsActive(uint64 pairId) {
 
@@ -516,6 +547,17 @@ void OverlappingPairs::clearObsoleteLastFrameCollisionInfos() {
     }
 }
 
+// Invalidate the cached narrow-phase results of a pair
+/// This is used when the size of a collision shape of the pair has changed
+void OverlappingPairs::invalidateNarrowPhaseCaches(uint64 pairIndex) {
+
+    assert(pairIndex < mNbPairs);
+
+    for (auto it = mLastFrameCollisionInfos[pairIndex].begin(); it != mLastFrameCollisionInfos[pairIndex].end(); ++it) {
+        it->second->isNarrowPhaseCacheValid = false;
+    }
+}
+
 // Set the collidingInPreviousFrame value with the collidinginCurrentFrame value for each pair
 void OverlappingPairs::updateCollidingInPreviousFrame() {
 
@@ -525,3 +567,46 @@ void OverlappingPairs::updateCollidingInPreviousFrame() {
         mCollidingInPreviousFrame[i] = mCollidingInCurrentFrame[i];
     }
 }
+
+// Update the broad-phase IDs and the IDs of the pairs after the broad-phase IDs of colliders have changed
+/// The broad-phase IDs that are not in the map do not change. The pairs keep their index in the
+/// arrays. The old and new IDs of the pairs are returned in the "outMapOldToNewPairIds" map.
+void OverlappingPairs::remapBroadPhaseIds(const Map<int32, int32>& mapOldToNewBroadPhaseIds,
+                                          Map<uint64, uint64>& outMapOldToNewPairIds) {
+
+    RP3D_PROFILE("OverlappingPairs::remapBroadPhaseIds()", mProfiler);
+
+    // The lists of pairs of the colliders are filled again with the new IDs below
+    for (uint64 i=0; i < mNbPairs; i++) {
+        mColliderComponents.getOverlappingPairs(mColliders1[i]).clear();
+        mColliderComponents.getOverlappingPairs(mColliders2[i]).clear();
+    }
+    mMapPairIdToPairIndex.clear();
+
+    // For each overlapping pair
+    for (uint64 i=0; i < mNbPairs; i++) {
+
+        auto it1 = mapOldToNewBroadPhaseIds.find(mPairBroadPhaseId1[i]);
+        if (it1 != mapOldToNewBroadPhaseIds.end()) {
+            mPairBroadPhaseId1[i] = it1->second;
+        }
+        auto it2 = mapOldToNewBroadPhaseIds.find(mPairBroadPhaseId2[i]);
+        if (it2 != mapOldToNewBroadPhaseIds.end()) {
+            mPairBroadPhaseId2[i] = it2->second;
+        }
+
+        // Compute the new ID of the pair
+        const uint32 broadPhase1Id = static_cast<uint32>(mPairBroadPhaseId1[i]);
+        const uint32 broadPhase2Id = static_cast<uint32>(mPairBroadPhaseId2[i]);
+        const uint64 pairId = pairNumbers(std::max(broadPhase1Id, broadPhase2Id), std::min(broadPhase1Id, broadPhase2Id));
+
+        outMapOldToNewPairIds.add(Pair<uint64, uint64>(mPairIds[i], pairId));
+        mPairIds[i] = pairId;
+
+        assert(!mMapPairIdToPairIndex.containsKey(pairId));
+        mMapPairIdToPairIndex.add(Pair<uint64, uint64>(pairId, i));
+
+        mColliderComponents.getOverlappingPairs(mColliders1[i]).add(pairId);
+        mColliderComponents.getOverlappingPairs(mColliders2[i]).add(pairId);
+    }
+}
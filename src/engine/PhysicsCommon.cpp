@@ -338,14 +338,19 @@ void PhysicsCommon::destroyConvexMeshShape(ConvexMeshShape* convexMeshShape) {
  * @param dataType Data type for the height values (int, float, double)
  * @param upAxis Integer representing the up axis direction (0 for x, 1 for y and 2 for z)
  * @param integerHeightScale Scaling factor used to scale the height values (only when height values type is integer)
+ * @param scaling Scaling factor of the height field
+ * @param computeVerticesNormals True if the normals of the grid points must be precomputed (instead of
+ *                               using the normal of each triangle as normal of its vertices)
  * @return A pointer to the created height field shape
  */
 HeightFieldShape* PhysicsCommon::createHeightFieldShape(int nbGridColumns, int nbGridRows, decimal minHeight, decimal maxHeight,
                                          const void* heightFieldData, HeightFieldShape::HeightDataType dataType,
-                                         int upAxis, decimal integerHeightScale, const Vector3& scaling) {
+                                         int upAxis, decimal integerHeightScale, const Vector3& scaling,
+                                         bool computeVerticesNormals) {
 
     HeightFieldShape* shape = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(HeightFieldShape))) HeightFieldShape(nbGridColumns, nbGridRows, minHeight, maxHeight,
-                                         heightFieldData, dataType, mMemoryManager.getHeapAllocator(), upAxis, integerHeightScale, scaling);
+                                         heightFieldData, dataType, mMemoryManager.getHeapAllocator(), upAxis, integerHeightScale, scaling,
+                                         computeVerticesNormals);
 
     mHeightFieldShapes.add(shape);
 
@@ -56,8 +56,9 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, const WorldSettings& wo
                 mTransformComponents(mMemoryManager.getHeapAllocator()), mCollidersComponents(mMemoryManager.getHeapAllocator()),
                 mJointsComponents(mMemoryManager.getHeapAllocator()), mBallAndSocketJointsComponents(mMemoryManager.getHeapAllocator()),
                 mFixedJointsComponents(mMemoryManager.getHeapAllocator()), mHingeJointsComponents(mMemoryManager.getHeapAllocator()),
-                mSliderJointsComponents(mMemoryManager.getHeapAllocator()), mCollisionDetection(this, mCollidersComponents, mTransformComponents, mCollisionBodyComponents, mRigidBodyComponents,
-                                        mMemoryManager),
+                mSliderJointsComponents(mMemoryManager.getHeapAllocator()), mThreadPool(mConfig.nbWorkerThreads, mMemoryManager.getHeapAllocator()),
+                mCollisionDetection(this, mCollidersComponents, mTransformComponents, mCollisionBodyComponents, mRigidBodyComponents,
+                                    mMemoryManager, mThreadPool),
                 mCollisionBodies(mMemoryManager.getHeapAllocator()), mEventListener(nullptr),
                 mName(worldSettings.worldName),  mIslands(mMemoryManager.getSingleFrameAllocator()), mProcessContactPairsOrderIslands(mMemoryManager.getSingleFrameAllocator()),
                 mContactSolverSystem(mMemoryManager, *this, mIslands, mCollisionBodyComponents, mRigidBodyComponents,
@@ -384,8 +385,9 @@ void PhysicsWorld::update(decimal timeStep) {
         mDebugRenderer.computeDebugRenderingPrimitives(*this);
     }
 
-    // Reset the single frame memory allocator
+    // Reset the single frame memory allocators
     mMemoryManager.resetFrameAllocator();
+    mCollisionDetection.resetWorkerFrameAllocators();
 }
 
 
@@ -1022,6 +1024,87 @@ void PhysicsWorld::setSleepAngularVelocity(decimal sleepAngularVelocity) {
              "Physics World: sleepAngularVelocity= " + std::to_string(sleepAngularVelocity),  __FILE__, __LINE__);
 }
 
+// Reinsert some leaves of the broad-phase trees to improve their quality
+/// The quality of the broad-phase trees decreases when the colliders move around for a
+/// long time. This method can be called at each frame (for instance when there is some time
+/// left in the frame budget) to incrementally optimize the trees.
+/**
+ * @param nbLeavesToReinsert Maximum number of colliders to reinsert in each tree
+ */
+void PhysicsWorld::optimizeBroadPhase(uint nbLeavesToReinsert) {
+    mCollisionDetection.mBroadPhaseSystem.optimizeTrees(nbLeavesToReinsert);
+}
+
+// Rebuild the broad-phase trees from scratch
+/// The trees are rebuilt top-down using the surface area heuristic. This is more expensive
+/// than optimizeBroadPhase() but gives trees of better quality.
+void PhysicsWorld::rebuildBroadPhase() {
+
+    mCollisionDetection.mBroadPhaseSystem.rebuildTrees();
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: Rebuild the broad-phase trees",  __FILE__, __LINE__);
+}
+
+// Rewrite the nodes of the broad-phase trees in depth-first order
+/// After many colliders have been added and removed, the nodes of the broad-phase trees are
+/// scattered in memory. This method moves the nodes of each sub-tree next to each other which
+/// reduces the cache misses of the queries. The broad-phase IDs of the colliders change but
+/// the contacts of the colliders are kept. The compaction can also be triggered automatically
+/// with the WorldSettings::broadPhaseCompactionThreshold setting.
+void PhysicsWorld::compactBroadPhase() {
+
+    mCollisionDetection.mBroadPhaseSystem.compactTrees();
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: Compact the broad-phase trees",  __FILE__, __LINE__);
+}
+
+// Return the cost of the broad-phase tree of the non-static colliders
+/// The cost is based on the surface area heuristic and is proportional to the average number
+/// of tree nodes visited by a query. It can be used to monitor the quality of the tree over time
+/// and to decide when to call optimizeBroadPhase() or rebuildBroadPhase().
+/**
+ * @return The cost of the broad-phase tree (smaller is better)
+ */
+decimal PhysicsWorld::getBroadPhaseTreeCost() const {
+    return mCollisionDetection.mBroadPhaseSystem.getDynamicTreeCost();
+}
+
+// Return the number of insertions and removals in the broad-phase tree of the non-static colliders
+/// A collider that moves out of its fat AABB is removed from the tree and inserted again. This
+/// number can be used to compare the fat AABB margin policies. It is reset when the tree is compacted.
+/**
+ * @return The number of insertions and removals of leaves since the last compaction of the tree
+ */
+uint PhysicsWorld::getNbBroadPhaseStructuralChanges() const {
+    return mCollisionDetection.mBroadPhaseSystem.getNbDynamicTreeStructuralChanges();
+}
+
+// Start a bulk load of colliders into the broad-phase
+/// When many colliders are added at once (when a level is loaded for instance), inserting them one
+/// by one into the broad-phase trees is slow and gives trees of poor quality. Between the calls to
+/// beginBulkLoad() and endBulkLoad(), the new colliders are only stored and the trees are built in
+/// a single top-down pass by endBulkLoad(). The new colliders are not visible to the raycasts
+/// before the call to endBulkLoad(). If the world is updated (or tested for collisions) before the
+/// call to endBulkLoad(), the bulk load ends automatically at that point.
+void PhysicsWorld::beginBulkLoad() {
+
+    mCollisionDetection.mBroadPhaseSystem.beginBulkInsertion();
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: Begin bulk load",  __FILE__, __LINE__);
+}
+
+// End the bulk load of colliders and build the broad-phase trees
+void PhysicsWorld::endBulkLoad() {
+
+    mCollisionDetection.mBroadPhaseSystem.endBulkInsertion();
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: End bulk load",  __FILE__, __LINE__);
+}
+
 // Set the time a body is required to stay still before sleeping
 /**
  * @param timeBeforeSleep Time a body is required to stay still before sleeping (in seconds)
@@ -0,0 +1,163 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/engine/ThreadPool.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <cassert>
+#include <new>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Constructor
+ThreadPool::ThreadPool(uint32 nbThreads, MemoryAllocator& allocator)
+           : mAllocator(allocator), mNbThreads(nbThreads > 0 ? nbThreads : 1), mWorkers(nullptr), mTask(nullptr),
+             mNbTasks(0), mNextTaskIndex(0), mJobGeneration(0), mNbActiveWorkers(0), mIsShuttingDown(false) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    // The profiler is not thread-safe, all the tasks are executed on the calling thread
+    mNbThreads = 1;
+
+#endif
+
+    // Create the worker threads
+    if (mNbThreads > 1) {
+
+        mWorkers = static_cast<std::thread*>(mAllocator.allocate((mNbThreads - 1) * sizeof(std::thread)));
+        for (uint32 i=0; i < mNbThreads - 1; i++) {
+            new (mWorkers + i) std::thread(&ThreadPool::workerLoop, this, i + 1);
+        }
+    }
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+
+    if (mWorkers != nullptr) {
+
+        // Ask the workers to exit
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsShuttingDown = true;
+        }
+        mWorkCondition.notify_all();
+
+        // Wait for the workers and destroy them
+        for (uint32 i=0; i < mNbThreads - 1; i++) {
+            mWorkers[i].join();
+            mWorkers[i].~thread();
+        }
+
+        mAllocator.release(mWorkers, (mNbThreads - 1) * sizeof(std::thread));
+    }
+}
+
+// Execute a given number of tasks and wait until all of them are finished
+/// The tasks are distributed dynamically between the calling thread and the worker threads.
+/// Therefore, a given task index can be executed on any thread. The tasks must not call
+/// the execute() method of the same thread pool again.
+void ThreadPool::execute(ThreadPoolTask& task, uint32 nbTasks) {
+
+    if (nbTasks == 0) return;
+
+    // If there is no worker or a single task, execute everything on the calling thread
+    if (mNbThreads == 1 || nbTasks == 1) {
+        for (uint32 i=0; i < nbTasks; i++) {
+            task.run(i, 0);
+        }
+        return;
+    }
+
+    // Publish the new job for the workers
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        assert(mTask == nullptr);
+        mTask = &task;
+        mNbTasks = nbTasks;
+        mNextTaskIndex.store(0);
+        mJobGeneration++;
+    }
+    mWorkCondition.notify_all();
+
+    // The calling thread also executes tasks
+    runTasks(task, nbTasks, 0);
+
+    // Wait until the workers that have joined the job have finished their tasks. Then, we
+    // close the job so that a worker that wakes up late does not execute any task of it
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this] { return mNbActiveWorkers == 0; });
+    mTask = nullptr;
+    mNbTasks = 0;
+}
+
+// Execute the remaining tasks of a job
+void ThreadPool::runTasks(ThreadPoolTask& task, uint32 nbTasks, uint32 threadIndex) {
+
+    uint32 taskIndex = mNextTaskIndex.fetch_add(1);
+    while (taskIndex < nbTasks) {
+        task.run(taskIndex, threadIndex);
+        taskIndex = mNextTaskIndex.fetch_add(1);
+    }
+}
+
+// Main loop of a worker thread
+void ThreadPool::workerLoop(uint32 threadIndex) {
+
+    uint64 lastJobGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true) {
+
+        // Wait for a new job
+        mWorkCondition.wait(lock, [this, lastJobGeneration] {
+            return mIsShuttingDown || mJobGeneration != lastJobGeneration;
+        });
+
+        if (mIsShuttingDown) return;
+
+        lastJobGeneration = mJobGeneration;
+
+        // If the job has already been closed, there is nothing to do
+        if (mTask == nullptr) continue;
+
+        ThreadPoolTask* task = mTask;
+        const uint32 nbTasks = mNbTasks;
+        mNbActiveWorkers++;
+
+        lock.unlock();
+
+        runTasks(*task, nbTasks, threadIndex);
+
+        lock.lock();
+
+        mNbActiveWorkers--;
+        if (mNbActiveWorkers == 0) {
+            mDoneCondition.notify_one();
+        }
+    }
+}
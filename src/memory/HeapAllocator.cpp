@@ -115,6 +115,9 @@ void* HeapAllocator::allocate(size_t size) {
     // We cannot allocate zero bytes
     if (size == 0) return nullptr;
 
+    // Round the size up so that the next memory unit stays aligned
+    size = (size + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1);
+
 #ifndef NDEBUG
         mNbTimesAllocateMethodCalled++;
 #endif
@@ -36,11 +36,22 @@ using namespace reactphysics3d;
 
 // Constructor
 BroadPhaseSystem::BroadPhaseSystem(CollisionDetectionSystem& collisionDetection, ColliderComponents& collidersComponents,
-                                   TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents)
-                    :mDynamicAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE),
-                     mCollidersComponents(collidersComponents), mTransformsComponents(transformComponents),
+                                   TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents,
+                                   ThreadPool& threadPool, bool isWideTreeEnabled, bool isStaticTreeQuantized, uint32 compactionThreshold,
+                                   BroadPhaseAlgorithmType algorithmType, FatAABBMarginPolicy fatAABBMarginPolicy, decimal fatAABBVelocityMultiplier)
+                    :mDynamicAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(),
+                                      fatAABBMarginPolicy == FatAABBMarginPolicy::VELOCITY_PREDICTIVE ?
+                                      PREDICTIVE_FAT_AABB_INFLATE_PERCENTAGE : DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE),
+                     mStaticAABBTree(collisionDetection.getMemoryManager().getPoolAllocator()),
+                     mSweepAndPrune(collisionDetection.getMemoryManager().getPoolAllocator(),
+                                    fatAABBMarginPolicy == FatAABBMarginPolicy::VELOCITY_PREDICTIVE ?
+                                    PREDICTIVE_FAT_AABB_INFLATE_PERCENTAGE : DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE),
+                     mAlgorithmType(algorithmType), mFatAABBMarginPolicy(fatAABBMarginPolicy),
+                     mFatAABBVelocityMultiplier(fatAABBVelocityMultiplier), mNbStaticTreeChangesSinceRebuild(0),
+                     mCompactionThreshold(compactionThreshold), mCollidersComponents(collidersComponents), mTransformsComponents(transformComponents),
                      mRigidBodyComponents(rigidBodyComponents), mMovedShapes(collisionDetection.getMemoryManager().getPoolAllocator()),
-                     mCollisionDetection(collisionDetection) {
+                     mIsBulkInsertionActive(false),
+                     mCollisionDetection(collisionDetection), mThreadPool(threadPool) {
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -49,6 +60,11 @@ BroadPhaseSystem::BroadPhaseSystem(CollisionDetectionSystem& collisionDetection,
 
 #endif
 
+    mDynamicAABBTree.setIsWideTreeEnabled(isWideTreeEnabled);
+    mStaticAABBTree.setIsWideTreeEnabled(isWideTreeEnabled);
+
+    // The static tree is rarely modified and can use a compressed version of its nodes for the queries
+    mStaticAABBTree.setIsQuantizedTreeEnabled(isStaticTreeQuantized);
 }
 
 // Return true if the two broad-phase collision shapes are overlapping
@@ -59,8 +75,8 @@ bool BroadPhaseSystem::testOverlappingShapes(int32 shape1BroadPhaseId, int32 sha
     assert(shape1BroadPhaseId != -1 && shape2BroadPhaseId != -1);
 
     // Get the two AABBs of the collision shapes
-    const AABB& aabb1 = mDynamicAABBTree.getFatAABB(shape1BroadPhaseId);
-    const AABB& aabb2 = mDynamicAABBTree.getFatAABB(shape2BroadPhaseId);
+    const AABB& aabb1 = getFatAABB(shape1BroadPhaseId);
+    const AABB& aabb2 = getFatAABB(shape2BroadPhaseId);
 
     // Check if the two AABBs are overlapping
     return aabb1.testCollision(aabb2);
@@ -72,9 +88,201 @@ void BroadPhaseSystem::raycast(const Ray& ray, RaycastTest& raycastTest,
 
     RP3D_PROFILE("BroadPhaseSystem::raycast()", mProfiler);
 
-    BroadPhaseRaycastCallback broadPhaseRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
+    BroadPhaseRaycastCallback dynamicRaycastCallback(*this, 0, raycastWithCategoryMaskBits, raycastTest);
+    if (mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
+        mSweepAndPrune.raycast(ray, dynamicRaycastCallback);
+    }
+    else {
+        mDynamicAABBTree.raycast(ray, dynamicRaycastCallback);
+    }
+
+    BroadPhaseRaycastCallback staticRaycastCallback(*this, STATIC_TREE_BROAD_PHASE_ID_FLAG, raycastWithCategoryMaskBits, raycastTest);
+    mStaticAABBTree.raycast(ray, staticRaycastCallback);
+}
+
+// Compute the closest hit of each ray of a batch of rays
+/// The closest hit of the i-th ray is written into outHits[i] (whose collider is nullptr if the
+/// ray does not hit anything) and the number of rays with a hit is returned. The consecutive rays
+/// of the batch with close origins and similar directions are raycasted together as a packet
+/// so that they share the traversal of the broad-phase. Therefore, the rays should be sorted
+/// to improve the coherence of the packets. Large batches are split into chunks that are
+/// raycasted in parallel by the thread pool. No memory is allocated per ray.
+uint32 BroadPhaseSystem::raycastBatch(const Ray* rays, uint32 nbRays, RaycastInfo* outHits,
+                                      unsigned short raycastWithCategoryMaskBits, MemoryAllocator& allocator) const {
+
+    RP3D_PROFILE("BroadPhaseSystem::raycastBatch()", mProfiler);
+
+    for (uint32 i=0; i < nbRays; i++) {
+        outHits[i].hitFraction = rays[i].maxFraction;
+        outHits[i].meshSubpart = -1;
+        outHits[i].triangleIndex = -1;
+        outHits[i].body = nullptr;
+        outHits[i].collider = nullptr;
+    }
+
+    const uint32 nbThreads = mThreadPool.getNbThreads();
+
+    // If there are enough rays, we split them into chunks that are raycasted in parallel
+    if (nbThreads > 1 && nbRays >= 2 * NB_MIN_RAYS_PER_TASK) {
+
+        const uint32 nbTasks = std::min(nbThreads * NB_TASKS_PER_THREAD, nbRays / NB_MIN_RAYS_PER_TASK);
+        const uint32 nbRaysPerTask = (nbRays + nbTasks - 1) / nbTasks;
+
+        BroadPhaseRaycastBatchTask task(*this, rays, nbRays, nbRaysPerTask, raycastWithCategoryMaskBits, outHits, allocator);
+        mThreadPool.execute(task, nbTasks);
+    }
+    else if (nbRays > 0) {
+        raycastBatchRange(rays, 0, nbRays, raycastWithCategoryMaskBits, outHits, allocator);
+    }
+
+    uint32 nbHits = 0;
+    for (uint32 i=0; i < nbRays; i++) {
+        if (outHits[i].collider != nullptr) nbHits++;
+    }
+
+    return nbHits;
+}
+
+// Raycast a range of the rays of a batch with packets of coherent rays
+/// A packet starts with the first ray that is not raycasted yet and contains the following
+/// rays whose direction is close to the direction of the first ray and whose origin is closer
+/// to the origin of the first ray than its length.
+void BroadPhaseSystem::raycastBatchRange(const Ray* rays, uint32 startIndex, uint32 endIndex,
+                                         unsigned short raycastWithCategoryMaskBits, RaycastInfo* outHits,
+                                         MemoryAllocator& allocator) const {
+
+    // Stack used by all the packets of the range to traverse the trees
+    Stack<Pair<int32, uint32>> stack(allocator, 64);
+
+    BroadPhaseRaycastPacketCallback callback(*this, raycastWithCategoryMaskBits);
+
+    uint32 packetStartIndex = startIndex;
+    while (packetStartIndex < endIndex) {
+
+        const Ray& firstRay = rays[packetStartIndex];
+        const Vector3 firstRayVector = firstRay.point2 - firstRay.point1;
+        const decimal firstRayLengthSquare = firstRayVector.lengthSquare();
+
+        // Find the rays of the packet
+        uint32 packetEndIndex = packetStartIndex + 1;
+        if (firstRayLengthSquare > MACHINE_EPSILON) {
+
+            const Vector3 firstRayDirection = firstRayVector / std::sqrt(firstRayLengthSquare);
+            const uint32 maxPacketEndIndex = std::min(endIndex, packetStartIndex + RAYCAST_PACKET_SIZE);
+            while (packetEndIndex < maxPacketEndIndex) {
+
+                const Ray& ray = rays[packetEndIndex];
+                const Vector3 rayVector = ray.point2 - ray.point1;
+                const decimal rayLengthSquare = rayVector.lengthSquare();
+                if (rayLengthSquare <= MACHINE_EPSILON) break;
+
+                const decimal directionsCosine = firstRayDirection.dot(rayVector) / std::sqrt(rayLengthSquare);
+                if (directionsCosine < RAYCAST_PACKET_MIN_DIRECTIONS_COSINE) break;
+                if ((ray.point1 - firstRay.point1).lengthSquare() > firstRayLengthSquare) break;
+
+                packetEndIndex++;
+            }
+        }
+
+        const Ray* packetRays = rays + packetStartIndex;
+        const uint32 nbPacketRays = packetEndIndex - packetStartIndex;
+        callback.setOutHits(outHits + packetStartIndex);
+
+        callback.setBroadPhaseIdFlag(0);
+        if (mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
+            mSweepAndPrune.raycastPacket(packetRays, nbPacketRays, callback);
+        }
+        else {
+            mDynamicAABBTree.raycastPacket(packetRays, nbPacketRays, callback, stack);
+        }
+
+        callback.setBroadPhaseIdFlag(STATIC_TREE_BROAD_PHASE_ID_FLAG);
+        mStaticAABBTree.raycastPacket(packetRays, nbPacketRays, callback, stack);
+
+        packetStartIndex = packetEndIndex;
+    }
+}
+
+// Find the colliders overlapping with an AABB and write them into a buffer
+/// A collider is reported if its world-space AABB overlaps with the AABB in parameter. At most
+/// "maxNbColliders" colliders are written into the buffer but the returned number is the total
+/// number of overlapping colliders. Therefore, if it is larger than the size of the buffer,
+/// the query can be done again with a larger buffer.
+uint32 BroadPhaseSystem::queryAABB(const AABB& aabb, unsigned short categoryMaskBits,
+                                   Collider** outColliders, uint32 maxNbColliders) const {
+
+    RP3D_PROFILE("BroadPhaseSystem::queryAABB()", mProfiler);
+
+    BroadPhaseRegionQueryCallback callback(*this, aabb, categoryMaskBits, outColliders, maxNbColliders);
+    reportCollidersInRegion(aabb, callback);
+
+    return callback.getNbColliders();
+}
+
+// Find the colliders overlapping with a sphere and write them into a buffer
+/// A collider is reported if its world-space AABB overlaps with the sphere.
+uint32 BroadPhaseSystem::querySphere(const Vector3& center, decimal radius, unsigned short categoryMaskBits,
+                                     Collider** outColliders, uint32 maxNbColliders) const {
+
+    RP3D_PROFILE("BroadPhaseSystem::querySphere()", mProfiler);
+
+    const Vector3 radiusVector(radius, radius, radius);
+    const AABB boundingAABB(center - radiusVector, center + radiusVector);
+
+    BroadPhaseRegionQueryCallback callback(*this, boundingAABB, categoryMaskBits, outColliders, maxNbColliders);
+    callback.setSphereRegion(center, radius);
+    reportCollidersInRegion(boundingAABB, callback);
+
+    return callback.getNbColliders();
+}
+
+// Find the colliders overlapping with a frustum and write them into a buffer
+/// A collider is reported if its world-space AABB is not outside of one of the planes of the frustum.
+uint32 BroadPhaseSystem::queryFrustum(const Frustum& frustum, unsigned short categoryMaskBits,
+                                      Collider** outColliders, uint32 maxNbColliders) const {
+
+    RP3D_PROFILE("BroadPhaseSystem::queryFrustum()", mProfiler);
+
+    // Compute the AABB of the corners of the frustum
+    Vector3 corners[8];
+    frustum.computeCorners(corners);
+    Vector3 minCorner = corners[0];
+    Vector3 maxCorner = corners[0];
+    for (int i=1; i < 8; i++) {
+        minCorner = Vector3::min(minCorner, corners[i]);
+        maxCorner = Vector3::max(maxCorner, corners[i]);
+    }
+    const AABB boundingAABB(minCorner, maxCorner);
+
+    BroadPhaseRegionQueryCallback callback(*this, boundingAABB, categoryMaskBits, outColliders, maxNbColliders);
+    callback.setFrustumRegion(frustum);
+    reportCollidersInRegion(boundingAABB, callback);
+
+    return callback.getNbColliders();
+}
+
+// Report the colliders of the trees (or of the sweep-and-prune) overlapping with the bounding AABB of a query region
+void BroadPhaseSystem::reportCollidersInRegion(const AABB& boundingAABB, BroadPhaseRegionQueryCallback& callback) const {
+
+    callback.setBroadPhaseIdFlag(0);
+    if (mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
+        mSweepAndPrune.reportAllShapesOverlappingWithAABB(boundingAABB, callback);
+    }
+    else {
+        mDynamicAABBTree.reportAllShapesOverlappingWithAABB(boundingAABB, callback);
+    }
+
+    callback.setBroadPhaseIdFlag(STATIC_TREE_BROAD_PHASE_ID_FLAG);
+    mStaticAABBTree.reportAllShapesOverlappingWithAABB(boundingAABB, callback);
+}
+
+// Return true if a collider has to be stored in the static tree
+bool BroadPhaseSystem::isColliderInStaticTree(Collider* collider) const {
+
+    const Entity bodyEntity = mCollidersComponents.getBody(collider->getEntity());
 
-    mDynamicAABBTree.raycast(ray, broadPhaseRaycastCallback);
+    return mRigidBodyComponents.hasComponent(bodyEntity) &&
+           mRigidBodyComponents.getBodyType(bodyEntity) == BodyType::STATIC;
 }
 
 // Add a collider into the broad-phase collision detection
@@ -82,11 +290,12 @@ void BroadPhaseSystem::addCollider(Collider* collider, const AABB& aabb) {
 
     assert(collider->getBroadPhaseId() == -1);
 
-    // Add the collision shape into the dynamic AABB tree and get its broad-phase ID
-    int nodeId = mDynamicAABBTree.addObject(aabb, collider);
+    // Add the collision shape into the static or dynamic AABB tree (or into the sweep-and-prune)
+    // and get its broad-phase ID
+    const int32 broadPhaseId = insertColliderIntoTree(collider, aabb);
 
     // Set the broad-phase ID of the collider
-    mCollidersComponents.setBroadPhaseId(collider->getEntity(), nodeId);
+    mCollidersComponents.setBroadPhaseId(collider->getEntity(), broadPhaseId);
 
     // Add the collision shape into the array of bodies that have moved (or have been created)
     // during the last simulation step
@@ -102,12 +311,78 @@ void BroadPhaseSystem::removeCollider(Collider* collider) {
 
     mCollidersComponents.setBroadPhaseId(collider->getEntity(), -1);
 
-    // Remove the collision shape from the dynamic AABB tree
-    mDynamicAABBTree.removeObject(broadPhaseID);
-
-    // Remove the collision shape into the array of shapes that have moved (or have been created)
+    // Remove the collision shape from the array of shapes that have moved (or have been created)
     // during the last simulation step
     removeMovedCollider(broadPhaseID);
+
+    // Remove the collision shape from its AABB tree (or from the sweep-and-prune)
+    removeColliderFromTree(broadPhaseID);
+}
+
+// Move some colliders between the static and the dynamic trees after the type of their body has changed
+/// The colliders that are already in the correct tree are not modified. The old and new broad-phase
+/// IDs of the moved colliders are returned in the "outMapOldToNewBroadPhaseIds" map so that the
+/// overlapping pairs of the colliders can be kept with their new IDs.
+void BroadPhaseSystem::moveCollidersBetweenTrees(const List<Entity>& colliderEntities,
+                                                 Map<int32, int32>& outMapOldToNewBroadPhaseIds) {
+
+    RP3D_PROFILE("BroadPhaseSystem::moveCollidersBetweenTrees()", mProfiler);
+
+    for (uint32 i=0; i < colliderEntities.size(); i++) {
+
+        assert(mCollidersComponents.mMapEntityToComponentIndex.containsKey(colliderEntities[i]));
+        const uint32 index = mCollidersComponents.mMapEntityToComponentIndex[colliderEntities[i]];
+
+        const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[index];
+        if (broadPhaseId == -1) continue;
+
+        Collider* collider = mCollidersComponents.mColliders[index];
+        if (isStaticTreeBroadPhaseId(broadPhaseId) == isColliderInStaticTree(collider)) continue;
+
+        // Compute the world-space AABB of the collision shape
+        const uint32 bodyIndex = mTransformsComponents.mMapEntityToComponentIndex[mCollidersComponents.mBodiesEntities[index]];
+        const Transform& transform = mTransformsComponents.mTransforms[bodyIndex];
+        AABB aabb;
+        mCollidersComponents.mCollisionShapes[index]->computeAABB(aabb, transform * mCollidersComponents.mLocalToBodyTransforms[index]);
+
+        // Remove the collider from its tree and insert it into the other one
+        removeMovedCollider(broadPhaseId);
+        removeColliderFromTree(broadPhaseId);
+        const int32 newBroadPhaseId = insertColliderIntoTree(collider, aabb);
+
+        mCollidersComponents.mBroadPhaseIds[index] = newBroadPhaseId;
+        outMapOldToNewBroadPhaseIds.add(Pair<int32, int32>(broadPhaseId, newBroadPhaseId));
+
+        // The collider needs to be tested against the colliders of its new tree
+        addMovedCollider(newBroadPhaseId, collider);
+    }
+}
+
+// Insert a collider into the static or dynamic tree (or into the sweep-and-prune) and return its broad-phase ID
+int32 BroadPhaseSystem::insertColliderIntoTree(Collider* collider, const AABB& aabb) {
+
+    if (isColliderInStaticTree(collider)) {
+        mNbStaticTreeChangesSinceRebuild++;
+        return mStaticAABBTree.addObject(aabb, collider) | STATIC_TREE_BROAD_PHASE_ID_FLAG;
+    }
+    if (mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
+        return mSweepAndPrune.addObject(aabb, collider);
+    }
+    return mDynamicAABBTree.addObject(aabb, collider);
+}
+
+// Remove the node of a broad-phase ID from its tree (or from the sweep-and-prune)
+void BroadPhaseSystem::removeColliderFromTree(int32 broadPhaseId) {
+
+    if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+        mSweepAndPrune.removeObject(broadPhaseId);
+    }
+    else {
+        getTree(broadPhaseId).removeObject(getTreeNodeId(broadPhaseId));
+        if (isStaticTreeBroadPhaseId(broadPhaseId)) {
+            mNbStaticTreeChangesSinceRebuild++;
+        }
+    }
 }
 
 // Update the broad-phase state of a single collider
@@ -131,16 +406,157 @@ void BroadPhaseSystem::updateColliders(decimal timeStep) {
     if (mCollidersComponents.getNbEnabledComponents() > 0) {
         updateCollidersComponents(0, mCollidersComponents.getNbEnabledComponents(), timeStep);
     }
+
+    // Rebuild the wide and quantized trees so that the queries between two updates can use them
+    updateQueryTrees();
+}
+
+// Rebuild the wide and quantized versions of the trees if necessary
+void BroadPhaseSystem::updateQueryTrees() {
+    mDynamicAABBTree.updateWideTree();
+    mStaticAABBTree.updateWideTree();
+    mStaticAABBTree.updateQuantizedTree();
+}
+
+// Start a bulk insertion of colliders
+/// Until the call to endBulkInsertion(), the colliders added to the broad-phase are not inserted
+/// in the trees one by one. This should be used when many colliders are added at once (when a level
+/// is loaded for instance).
+void BroadPhaseSystem::beginBulkInsertion() {
+
+    mIsBulkInsertionActive = true;
+    mDynamicAABBTree.beginBulkInsertion();
+    mStaticAABBTree.beginBulkInsertion();
+}
+
+// End the bulk insertion of colliders and build the trees
+/// The trees with new colliders are rebuilt top-down in a single pass and all the new
+/// colliders are registered as moved so that their pairs are computed in the next step.
+void BroadPhaseSystem::endBulkInsertion() {
+
+    RP3D_PROFILE("BroadPhaseSystem::endBulkInsertion()", mProfiler);
+
+    if (!mIsBulkInsertionActive) return;
+
+    mIsBulkInsertionActive = false;
+
+    // If the static tree has new leaves, we rebuild it with them in a single pass
+    if (mNbStaticTreeChangesSinceRebuild > 0) {
+        mStaticAABBTree.rebuildTopDown();
+        mNbStaticTreeChangesSinceRebuild = 0;
+    }
+
+    mDynamicAABBTree.endBulkInsertion();
+    mStaticAABBTree.endBulkInsertion();
+
+    updateQueryTrees();
+}
+
+// Reinsert a given number of leaves in each tree to improve their quality
+/// This can be called at each simulation step with a small number of leaves to
+/// amortize the optimization of the trees over time.
+void BroadPhaseSystem::optimizeTrees(uint32 nbLeavesToReinsert) {
+
+    RP3D_PROFILE("BroadPhaseSystem::optimizeTrees()", mProfiler);
+
+    mDynamicAABBTree.optimizeIncremental(nbLeavesToReinsert);
+    mStaticAABBTree.optimizeIncremental(nbLeavesToReinsert);
+
+    updateQueryTrees();
+}
+
+// Rebuild the trees from scratch
+void BroadPhaseSystem::rebuildTrees() {
+
+    RP3D_PROFILE("BroadPhaseSystem::rebuildTrees()", mProfiler);
+
+    mDynamicAABBTree.rebuildTopDown();
+    mStaticAABBTree.rebuildTopDown();
+    mNbStaticTreeChangesSinceRebuild = 0;
+
+    updateQueryTrees();
+}
+
+// Rewrite the nodes of the trees in depth-first order and update the broad-phase IDs
+/// The nodes of a sub-tree become contiguous in memory which improves the cache locality of the
+/// queries. Because the IDs of the tree nodes change, the broad-phase IDs of the colliders, the
+/// array of moved shapes and all the overlapping pairs and contact pairs (whose IDs are computed
+/// from the broad-phase IDs) are updated. The sweep-and-prune proxies are not modified.
+void BroadPhaseSystem::compactTrees() {
+
+    RP3D_PROFILE("BroadPhaseSystem::compactTrees()", mProfiler);
+
+    // The colliders of a bulk insertion need to be in the trees
+    if (mIsBulkInsertionActive) {
+        endBulkInsertion();
+    }
+
+    MemoryAllocator& allocator = mCollisionDetection.getMemoryManager().getPoolAllocator();
+
+    const int32 nbAllocatedDynamicNodes = mDynamicAABBTree.getNbAllocatedNodes();
+    const int32 nbAllocatedStaticNodes = mStaticAABBTree.getNbAllocatedNodes();
+    int32* newDynamicNodeIDs = static_cast<int32*>(allocator.allocate(static_cast<size_t>(nbAllocatedDynamicNodes) * sizeof(int32)));
+    int32* newStaticNodeIDs = static_cast<int32*>(allocator.allocate(static_cast<size_t>(nbAllocatedStaticNodes) * sizeof(int32)));
+
+    if (mAlgorithmType != BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
+        mDynamicAABBTree.compactNodes(newDynamicNodeIDs);
+    }
+    mStaticAABBTree.compactNodes(newStaticNodeIDs);
+
+    // Update the broad-phase IDs of the colliders
+    Map<int32, int32> mapOldToNewBroadPhaseIds(allocator, mCollidersComponents.getNbComponents());
+    for (uint32 i=0; i < mCollidersComponents.getNbComponents(); i++) {
+
+        const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[i];
+        if (broadPhaseId == -1 || isSweepAndPruneBroadPhaseId(broadPhaseId)) continue;
+
+        const int32 newBroadPhaseId = isStaticTreeBroadPhaseId(broadPhaseId) ?
+                                      newStaticNodeIDs[getTreeNodeId(broadPhaseId)] | STATIC_TREE_BROAD_PHASE_ID_FLAG :
+                                      newDynamicNodeIDs[broadPhaseId];
+        assert(getTreeNodeId(newBroadPhaseId) >= 0);
+
+        mCollidersComponents.mBroadPhaseIds[i] = newBroadPhaseId;
+        mapOldToNewBroadPhaseIds.add(Pair<int32, int32>(broadPhaseId, newBroadPhaseId));
+    }
+
+    // Update the array of moved shapes (the entries of the removed shapes are dropped)
+    List<int32> movedShapes(allocator, mMovedShapes.size());
+    for (uint32 i=0; i < mMovedShapes.size(); i++) {
+
+        const int32 broadPhaseId = mMovedShapes[i];
+        if (isSweepAndPruneBroadPhaseId(broadPhaseId)) {
+            movedShapes.add(broadPhaseId);
+            continue;
+        }
+
+        auto it = mapOldToNewBroadPhaseIds.find(broadPhaseId);
+        if (it != mapOldToNewBroadPhaseIds.end()) {
+            movedShapes.add(it->second);
+        }
+    }
+    mMovedShapes = movedShapes;
+
+    // Update the overlapping pairs and contact pairs
+    mCollisionDetection.remapBroadPhaseIds(mapOldToNewBroadPhaseIds);
+
+    allocator.release(newDynamicNodeIDs, static_cast<size_t>(nbAllocatedDynamicNodes) * sizeof(int32));
+    allocator.release(newStaticNodeIDs, static_cast<size_t>(nbAllocatedStaticNodes) * sizeof(int32));
+
+    updateQueryTrees();
 }
 
 // Notify the broad-phase that a collision shape has moved and need to be updated
+/// The "displacement" parameter is the predicted displacement of the collider until the next update. The fat
+/// AABB of the collider is extended along this displacement if the collider needs to be reinserted.
 void BroadPhaseSystem::updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
-                                              bool forceReInsert) {
+                                              const Vector3& displacement, bool forceReInsert) {
 
     assert(broadPhaseId >= 0);
 
-    // Update the dynamic AABB tree according to the movement of the collision shape
-    bool hasBeenReInserted = mDynamicAABBTree.updateObject(broadPhaseId, aabb, forceReInsert);
+    // Update the AABB tree (or the sweep-and-prune) according to the movement of the collision shape
+    const bool hasBeenReInserted = isSweepAndPruneBroadPhaseId(broadPhaseId) ?
+                                   mSweepAndPrune.updateObject(broadPhaseId, aabb, displacement, forceReInsert) :
+                                   getTree(broadPhaseId).updateObject(getTreeNodeId(broadPhaseId), aabb, displacement, forceReInsert);
 
     // If the collision shape has moved out of its fat AABB (and therefore has been reinserted
     // into the tree).
@@ -183,8 +599,14 @@ void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbIte
             // we need to reset the broad-phase AABB to its new size
             const bool forceReInsert = mCollidersComponents.mHasCollisionShapeChangedSize[i];
 
+            // Predict the displacement of the collider until the next update from the linear velocity of its body
+            Vector3 displacement(0, 0, 0);
+            if (mFatAABBMarginPolicy == FatAABBMarginPolicy::VELOCITY_PREDICTIVE && mRigidBodyComponents.hasComponent(bodyEntity)) {
+                displacement = mRigidBodyComponents.getLinearVelocity(bodyEntity) * (timeStep * mFatAABBVelocityMultiplier);
+            }
+
             // Update the broad-phase state of the collider
-            updateColliderInternal(broadPhaseId, mCollidersComponents.mColliders[i], aabb, forceReInsert);
+            updateColliderInternal(broadPhaseId, mCollidersComponents.mColliders[i], aabb, displacement, forceReInsert);
 
             mCollidersComponents.mHasCollisionShapeChangedSize[i] = false;
         }
@@ -198,42 +620,419 @@ void BroadPhaseSystem::addMovedCollider(int broadPhaseID, Collider* collider) {
 
     assert(broadPhaseID != -1);
 
-    // Store the broad-phase ID into the array of shapes that have moved
-    mMovedShapes.add(broadPhaseID);
+    // Store the broad-phase ID into the array of shapes that have moved (if it is not already there)
+    if (!isMovedShape(broadPhaseID)) {
+        setIsMovedShape(broadPhaseID, true);
+        mMovedShapes.add(broadPhaseID);
+    }
 
     // Notify that the overlapping pairs where this shape is involved need to be tested for overlap
     mCollisionDetection.notifyOverlappingPairsToTestOverlap(collider);
 }
 
 // Compute all the overlapping pairs of collision shapes
+/// The moved shapes of the dynamic tree are tested against both trees while the moved shapes
+/// of the static tree are only tested against the dynamic tree. Therefore, pairs between two
+/// static colliders are never reported. When a large part of the colliders has moved, a
+/// dual-tree traversal is used instead of one query per moved shape so that the upper levels
+/// of the trees are not visited again for each shape.
 void BroadPhaseSystem::computeOverlappingPairs(MemoryManager& memoryManager, List<Pair<int32, int32>>& overlappingNodes) {
 
     RP3D_PROFILE("BroadPhaseSystem::computeOverlappingPairs()", mProfiler);
 
-    // Get the list of the colliders that have moved or have been created in the last frame
-    List<int> shapesToTest = mMovedShapes.toList(memoryManager.getPoolAllocator());
+    // The colliders of a bulk insertion that has not been ended are not in the trees yet
+    if (mIsBulkInsertionActive) {
+        endBulkInsertion();
+    }
+
+    // The static tree is only modified when static colliders are added, removed or moved. A few changes
+    // are inserted and removed incrementally but the tree is rebuilt completely (with a better quality)
+    // once a large part of its leaves has changed since its last rebuild.
+    const uint32 nbStaticLeaves = static_cast<uint32>((mStaticAABBTree.getNbNodes() + 1) / 2);
+    if (mNbStaticTreeChangesSinceRebuild > 0 &&
+        STATIC_TREE_REBUILD_CHANGES_RATIO * mNbStaticTreeChangesSinceRebuild >= nbStaticLeaves) {
+        mStaticAABBTree.rebuildTopDown();
+        mNbStaticTreeChangesSinceRebuild = 0;
+    }
+
+    // After many insertions and removals, the nodes of the trees are scattered in memory
+    if (mCompactionThreshold > 0 &&
+        mDynamicAABBTree.getNbStructuralChanges() + mStaticAABBTree.getNbStructuralChanges() >= mCompactionThreshold) {
+        compactTrees();
+    }
+
+    // Make sure the queries use the wide and quantized trees if they are enabled
+    updateQueryTrees();
+
+    // Get the tree node IDs of the colliders that have moved or have been created in the last frame
+    List<int32> dynamicShapesToTest(memoryManager.getPoolAllocator(), mMovedShapes.size());
+    List<int32> staticShapesToTest(memoryManager.getPoolAllocator());
+    for (uint32 i=0; i < mMovedShapes.size(); i++) {
+
+        const int32 broadPhaseId = mMovedShapes[i];
+
+        // Skip the shapes that have been removed (or whose ID appears again in the array
+        // because it has been reused by a new shape)
+        if (!isMovedShape(broadPhaseId)) {
+            continue;
+        }
+        setIsMovedShape(broadPhaseId, false);
+
+        if (isStaticTreeBroadPhaseId(broadPhaseId)) {
+            staticShapesToTest.add(getTreeNodeId(broadPhaseId));
+        }
+        else {
+            dynamicShapesToTest.add(broadPhaseId);
+        }
+    }
+
+    const uint32 nbMovedShapes = dynamicShapesToTest.size() + staticShapesToTest.size();
+
+    // If the colliders of the non-static bodies are stored in the sweep-and-prune
+    if (mAlgorithmType == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE) {
 
-    // Ask the dynamic AABB tree to report all collision shapes that overlap with the shapes to test
-    mDynamicAABBTree.reportAllShapesOverlappingWithShapes(shapesToTest, 0, shapesToTest.size(), overlappingNodes);
+        reportOverlappingNodesSweepAndPrune(dynamicShapesToTest, staticShapesToTest, memoryManager, overlappingNodes);
+
+        mMovedShapes.clear();
+        return;
+    }
+
+    const uint32 nbLeaves = static_cast<uint32>((mDynamicAABBTree.getNbNodes() + 1) / 2 + (mStaticAABBTree.getNbNodes() + 1) / 2);
+
+    // If a large part of the colliders has moved
+    if (nbMovedShapes > 0 && DUAL_TREE_TRAVERSAL_MOVED_SHAPES_RATIO * nbMovedShapes >= nbLeaves) {
+
+        // Mark the moved leaves and their ancestors in both trees
+        MemoryAllocator& allocator = memoryManager.getPoolAllocator();
+        const size_t nbDynamicNodes = static_cast<size_t>(mDynamicAABBTree.getNbAllocatedNodes());
+        const size_t nbStaticNodes = static_cast<size_t>(mStaticAABBTree.getNbAllocatedNodes());
+        bool* dynamicMarkedNodes = static_cast<bool*>(allocator.allocate(nbDynamicNodes * sizeof(bool)));
+        bool* staticMarkedNodes = static_cast<bool*>(allocator.allocate(nbStaticNodes * sizeof(bool)));
+        std::memset(dynamicMarkedNodes, 0, nbDynamicNodes * sizeof(bool));
+        std::memset(staticMarkedNodes, 0, nbStaticNodes * sizeof(bool));
+        mDynamicAABBTree.markLeavesAndAncestors(dynamicShapesToTest, dynamicMarkedNodes);
+        mStaticAABBTree.markLeavesAndAncestors(staticShapesToTest, staticMarkedNodes);
+
+        // Report the pairs of the dynamic tree with at least one moved shape
+        reportOverlappingNodesDualTree(mDynamicAABBTree, mDynamicAABBTree, dynamicMarkedNodes, dynamicMarkedNodes,
+                                       dynamicShapesToTest.size(), memoryManager, overlappingNodes);
+
+        // Report the pairs between the dynamic and the static trees with at least one moved shape
+        const uint32 startIndex = overlappingNodes.size();
+        reportOverlappingNodesDualTree(mDynamicAABBTree, mStaticAABBTree, dynamicMarkedNodes, staticMarkedNodes,
+                                       nbMovedShapes, memoryManager, overlappingNodes);
+        for (uint32 i=startIndex; i < overlappingNodes.size(); i++) {
+            overlappingNodes[i].second |= STATIC_TREE_BROAD_PHASE_ID_FLAG;
+        }
+
+        allocator.release(dynamicMarkedNodes, nbDynamicNodes * sizeof(bool));
+        allocator.release(staticMarkedNodes, nbStaticNodes * sizeof(bool));
+    }
+    else {
+
+        // Report the pairs between the moved dynamic shapes and the dynamic tree
+        reportOverlappingNodes(mDynamicAABBTree, mDynamicAABBTree, dynamicShapesToTest, memoryManager, overlappingNodes);
+
+        // Report the pairs between the moved dynamic shapes and the static tree
+        uint32 startIndex = overlappingNodes.size();
+        reportOverlappingNodes(mStaticAABBTree, mDynamicAABBTree, dynamicShapesToTest, memoryManager, overlappingNodes);
+        for (uint32 i=startIndex; i < overlappingNodes.size(); i++) {
+            overlappingNodes[i].second |= STATIC_TREE_BROAD_PHASE_ID_FLAG;
+        }
+
+        // Report the pairs between the moved static shapes and the dynamic tree
+        startIndex = overlappingNodes.size();
+        reportOverlappingNodes(mDynamicAABBTree, mStaticAABBTree, staticShapesToTest, memoryManager, overlappingNodes);
+        for (uint32 i=startIndex; i < overlappingNodes.size(); i++) {
+            overlappingNodes[i].first |= STATIC_TREE_BROAD_PHASE_ID_FLAG;
+        }
+    }
 
     // Reset the array of collision shapes that have move (or have been created) during the
     // last simulation step
     mMovedShapes.clear();
 }
 
+// Report the pairs between the nodes of a tree and some shapes of another (or the same) tree
+void BroadPhaseSystem::reportOverlappingNodes(const DynamicAABBTree& tree, const DynamicAABBTree& shapesTree,
+                                              const List<int32>& shapesToTest, MemoryManager& memoryManager,
+                                              List<Pair<int32, int32>>& overlappingNodes) {
+
+    const uint32 nbShapesToTest = shapesToTest.size();
+    const uint32 nbThreads = mThreadPool.getNbThreads();
+
+    // If there are enough shapes to test, we split them into chunks that are tested in parallel
+    if (nbThreads > 1 && nbShapesToTest >= 2 * NB_MIN_SHAPES_PER_TASK) {
+
+        const uint32 nbTasks = std::min(nbThreads * NB_TASKS_PER_THREAD, nbShapesToTest / NB_MIN_SHAPES_PER_TASK);
+        const uint32 nbShapesPerTask = (nbShapesToTest + nbTasks - 1) / nbTasks;
+
+        // Create an output list of overlapping nodes for each task
+        MemoryAllocator& allocator = memoryManager.getPoolAllocator();
+        List<Pair<int32, int32>>* tasksOverlappingNodes = createTasksOverlappingNodes(nbTasks, nbShapesPerTask, allocator);
+
+        // Ask the AABB tree to report all collision shapes that overlap with each chunk of shapes
+        BroadPhaseOverlappingPairsTask task(tree, shapesTree, shapesToTest, nbShapesPerTask, tasksOverlappingNodes);
+        mThreadPool.execute(task, nbTasks);
+
+        mergeTasksOverlappingNodes(tasksOverlappingNodes, nbTasks, allocator, overlappingNodes);
+    }
+    else if (nbShapesToTest > 0) {
+
+        // Ask the AABB tree to report all collision shapes that overlap with the shapes to test
+        tree.reportAllShapesOverlappingWithShapes(shapesTree, shapesToTest, 0, nbShapesToTest, overlappingNodes);
+    }
+}
+
+// Report the pairs of overlapping leaves of two trees (or of a single tree) with a dual-tree traversal
+/// Only the pairs with at least one marked leaf are reported. If the traversal is large enough, it is
+/// split into independent pairs of sub-trees that are traversed in parallel.
+void BroadPhaseSystem::reportOverlappingNodesDualTree(const DynamicAABBTree& tree1, const DynamicAABBTree& tree2,
+                                                      const bool* markedNodes1, const bool* markedNodes2, uint32 nbMovedShapes,
+                                                      MemoryManager& memoryManager, List<Pair<int32, int32>>& overlappingNodes) {
+
+    RP3D_PROFILE("BroadPhaseSystem::reportOverlappingNodesDualTree()", mProfiler);
+
+    if (tree1.getRootNodeID() == TreeNode::NULL_TREE_NODE || tree2.getRootNodeID() == TreeNode::NULL_TREE_NODE) return;
+
+    MemoryAllocator& allocator = memoryManager.getPoolAllocator();
+
+    // The traversal starts at the pair of root nodes
+    List<Pair<int32, int32>> nodePairs(allocator);
+    nodePairs.add(Pair<int32, int32>(tree1.getRootNodeID(), tree2.getRootNodeID()));
+
+    // If there is enough work, we expand the pairs of nodes breadth-first to split the traversal into
+    // independent pairs of sub-trees. Note that the expansion does not depend on the number of threads
+    // so that the pairs are always reported in the same order.
+    if (nbMovedShapes >= 2 * NB_MIN_SHAPES_PER_TASK) {
+
+        List<Pair<int32, int32>> childNodePairs(allocator);
+        while (nodePairs.size() > 0 && nodePairs.size() < NB_DUAL_TREE_TRAVERSAL_START_NODE_PAIRS) {
+
+            childNodePairs.clear();
+            tree1.expandNodePairs(tree2, markedNodes1, markedNodes2, nodePairs, childNodePairs, overlappingNodes);
+            nodePairs = childNodePairs;
+        }
+    }
+
+    const uint32 nbThreads = mThreadPool.getNbThreads();
+
+    // If there is enough work, the pairs of sub-trees are traversed in parallel
+    if (nbThreads > 1 && nbMovedShapes >= 2 * NB_MIN_SHAPES_PER_TASK && nodePairs.size() > 1) {
+
+        const uint32 nbTasks = std::min(nbThreads * NB_TASKS_PER_THREAD, static_cast<uint32>(nodePairs.size()));
+        const uint32 nbNodePairsPerTask = (nodePairs.size() + nbTasks - 1) / nbTasks;
+
+        // Create an output list of overlapping nodes for each task
+        List<Pair<int32, int32>>* tasksOverlappingNodes = createTasksOverlappingNodes(nbTasks, nbMovedShapes / nbTasks, allocator);
+
+        BroadPhaseDualTreeTraversalTask task(tree1, tree2, markedNodes1, markedNodes2, nodePairs, nbNodePairsPerTask,
+                                             tasksOverlappingNodes);
+        mThreadPool.execute(task, nbTasks);
+
+        mergeTasksOverlappingNodes(tasksOverlappingNodes, nbTasks, allocator, overlappingNodes);
+    }
+    else {
+
+        tree1.reportAllOverlappingLeaves(tree2, markedNodes1, markedNodes2, nodePairs, 0, nodePairs.size(), overlappingNodes);
+    }
+}
+
+// Report the pairs of overlapping colliders with at least one moved collider when the
+// sweep-and-prune is used for the colliders of the non-static bodies
+/// The pairs between the proxies of the sweep-and-prune are found with a sweep over its sorted
+/// entries. The moved proxies are tested against the static tree and the moved static shapes are
+/// tested against the sweep-and-prune.
+void BroadPhaseSystem::reportOverlappingNodesSweepAndPrune(const List<int32>& dynamicShapesToTest,
+                                                           const List<int32>& staticShapesToTest, MemoryManager& memoryManager,
+                                                           List<Pair<int32, int32>>& overlappingNodes) {
+
+    RP3D_PROFILE("BroadPhaseSystem::reportOverlappingNodesSweepAndPrune()", mProfiler);
+
+    MemoryAllocator& allocator = memoryManager.getPoolAllocator();
+
+    // Restore the order of the entries after the proxies have moved
+    mSweepAndPrune.sortEntries();
+
+    // Report the pairs of proxies with at least one moved proxy
+    if (dynamicShapesToTest.size() > 0) {
+
+        const size_t nbProxies = static_cast<size_t>(mSweepAndPrune.getNbAllocatedProxies());
+        bool* movedProxies = static_cast<bool*>(allocator.allocate(nbProxies * sizeof(bool)));
+        std::memset(movedProxies, 0, nbProxies * sizeof(bool));
+        for (uint32 i=0; i < dynamicShapesToTest.size(); i++) {
+            movedProxies[dynamicShapesToTest[i]] = true;
+        }
+
+        const uint32 nbEntries = mSweepAndPrune.getNbEntries();
+        const uint32 nbThreads = mThreadPool.getNbThreads();
+
+        // If there are enough entries, the sweep is split into chunks of entries that are swept in parallel
+        if (nbThreads > 1 && nbEntries >= 2 * NB_MIN_SHAPES_PER_TASK) {
+
+            const uint32 nbTasks = std::min(nbThreads * NB_TASKS_PER_THREAD, nbEntries / NB_MIN_SHAPES_PER_TASK);
+            const uint32 nbEntriesPerTask = (nbEntries + nbTasks - 1) / nbTasks;
+
+            List<Pair<int32, int32>>* tasksOverlappingNodes = createTasksOverlappingNodes(nbTasks, nbEntriesPerTask, allocator);
+
+            BroadPhaseSweepAndPruneTask task(mSweepAndPrune, movedProxies, nbEntriesPerTask, tasksOverlappingNodes);
+            mThreadPool.execute(task, nbTasks);
+
+            mergeTasksOverlappingNodes(tasksOverlappingNodes, nbTasks, allocator, overlappingNodes);
+        }
+        else {
+            mSweepAndPrune.reportAllOverlappingPairs(movedProxies, 0, nbEntries, overlappingNodes);
+        }
+
+        allocator.release(movedProxies, nbProxies * sizeof(bool));
+    }
+
+    List<int> overlappingShapes(allocator);
+
+    // Report the pairs between the moved proxies and the static tree
+    for (uint32 i=0; i < dynamicShapesToTest.size(); i++) {
+
+        overlappingShapes.clear();
+        mStaticAABBTree.reportAllShapesOverlappingWithAABB(mSweepAndPrune.getFatAABB(dynamicShapesToTest[i]), overlappingShapes);
+        for (uint32 j=0; j < overlappingShapes.size(); j++) {
+            overlappingNodes.add(Pair<int32, int32>(dynamicShapesToTest[i], overlappingShapes[j] | STATIC_TREE_BROAD_PHASE_ID_FLAG));
+        }
+    }
+
+    // Report the pairs between the moved static shapes and the sweep-and-prune
+    for (uint32 i=0; i < staticShapesToTest.size(); i++) {
+
+        overlappingShapes.clear();
+        mSweepAndPrune.reportAllShapesOverlappingWithAABB(mStaticAABBTree.getFatAABB(staticShapesToTest[i]), overlappingShapes);
+        for (uint32 j=0; j < overlappingShapes.size(); j++) {
+            overlappingNodes.add(Pair<int32, int32>(staticShapesToTest[i] | STATIC_TREE_BROAD_PHASE_ID_FLAG, overlappingShapes[j]));
+        }
+    }
+}
+
+// Create the output lists of overlapping nodes of some parallel tasks
+List<Pair<int32, int32>>* BroadPhaseSystem::createTasksOverlappingNodes(uint32 nbTasks, uint32 initCapacity,
+                                                                        MemoryAllocator& allocator) const {
+
+    List<Pair<int32, int32>>* tasksOverlappingNodes = static_cast<List<Pair<int32, int32>>*>(
+                                   allocator.allocate(nbTasks * sizeof(List<Pair<int32, int32>>)));
+    for (uint32 i=0; i < nbTasks; i++) {
+        new (tasksOverlappingNodes + i) List<Pair<int32, int32>>(allocator, initCapacity);
+    }
+
+    return tasksOverlappingNodes;
+}
+
+// Merge the output lists of overlapping nodes of some parallel tasks and destroy them
+/// The lists are merged in the order of the tasks so that the result does not depend on
+/// the scheduling of the threads.
+void BroadPhaseSystem::mergeTasksOverlappingNodes(List<Pair<int32, int32>>* tasksOverlappingNodes, uint32 nbTasks,
+                                                  MemoryAllocator& allocator, List<Pair<int32, int32>>& overlappingNodes) const {
+
+    uint32 nbOverlappingNodes = overlappingNodes.size();
+    for (uint32 i=0; i < nbTasks; i++) {
+        nbOverlappingNodes += tasksOverlappingNodes[i].size();
+    }
+    overlappingNodes.reserve(nbOverlappingNodes);
+    for (uint32 i=0; i < nbTasks; i++) {
+        overlappingNodes.addRange(tasksOverlappingNodes[i]);
+        tasksOverlappingNodes[i].~List<Pair<int32, int32>>();
+    }
+
+    allocator.release(tasksOverlappingNodes, nbTasks * sizeof(List<Pair<int32, int32>>));
+}
+
+// Run the dual-tree traversal below a chunk of pairs of nodes
+void BroadPhaseDualTreeTraversalTask::run(uint32 taskIndex, uint32 /*threadIndex*/) {
+
+    const size_t startIndex = taskIndex * mNbNodePairsPerTask;
+    const size_t endIndex = std::min(startIndex + mNbNodePairsPerTask, static_cast<size_t>(mNodePairs.size()));
+
+    if (startIndex < endIndex) {
+        mTree1.reportAllOverlappingLeaves(mTree2, mMarkedNodes1, mMarkedNodes2, mNodePairs, startIndex, endIndex,
+                                          mTasksOverlappingNodes[taskIndex]);
+    }
+}
+
+// Sweep a chunk of the sorted entries
+void BroadPhaseSweepAndPruneTask::run(uint32 taskIndex, uint32 /*threadIndex*/) {
+
+    const uint32 startIndex = taskIndex * mNbEntriesPerTask;
+    const uint32 endIndex = std::min(startIndex + mNbEntriesPerTask, mSweepAndPrune.getNbEntries());
+
+    if (startIndex < endIndex) {
+        mSweepAndPrune.reportAllOverlappingPairs(mMovedProxies, startIndex, endIndex, mTasksOverlappingNodes[taskIndex]);
+    }
+}
+
+// Raycast a chunk of the rays of the batch
+void BroadPhaseRaycastBatchTask::run(uint32 taskIndex, uint32 /*threadIndex*/) {
+
+    const uint32 startIndex = taskIndex * mNbRaysPerTask;
+    const uint32 endIndex = std::min(startIndex + mNbRaysPerTask, mNbRays);
+
+    if (startIndex < endIndex) {
+        mBroadPhaseSystem.raycastBatchRange(mRays, startIndex, endIndex, mRaycastWithCategoryMaskBits, mOutHits, mAllocator);
+    }
+}
+
+// Compute the overlapping pairs of a chunk of the shapes to test
+void BroadPhaseOverlappingPairsTask::run(uint32 taskIndex, uint32 /*threadIndex*/) {
+
+    const size_t startIndex = taskIndex * mNbShapesPerTask;
+    const size_t endIndex = std::min(startIndex + mNbShapesPerTask, static_cast<size_t>(mShapesToTest.size()));
+
+    if (startIndex < endIndex) {
+        mDynamicAABBTree.reportAllShapesOverlappingWithShapes(mShapesTree, mShapesToTest, startIndex, endIndex,
+                                                              mTasksOverlappingNodes[taskIndex]);
+    }
+}
+
 // Called when a overlapping node has been found during the call to
 // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
 void AABBOverlapCallback::notifyOverlappingNode(int nodeId) {
     mOverlappingNodes.add(nodeId);
 }
 
+// Called when the fat AABB of a collider overlaps with the bounding AABB of the region
+void BroadPhaseRegionQueryCallback::notifyOverlappingNode(int nodeId) {
+
+    Collider* collider = mBroadPhaseSystem.getColliderForBroadPhaseId(nodeId | mBroadPhaseIdFlag);
+
+    // Check if the filtering mask allows this collider
+    if ((mCategoryMaskBits & collider->getCollisionCategoryBits()) == 0) return;
+
+    // Test the world-space AABB of the collider (tighter than its fat AABB) against the region
+    const AABB colliderAABB = collider->getWorldAABB();
+    bool isOverlapping;
+    switch (mRegionType) {
+        case RegionQueryType::SPHERE_REGION:
+            isOverlapping = colliderAABB.testCollisionSphere(mSphereCenter, mSphereRadius);
+            break;
+        case RegionQueryType::FRUSTUM_REGION:
+            isOverlapping = colliderAABB.testCollisionFrustum(*mFrustum);
+            break;
+        default:
+            isOverlapping = colliderAABB.testCollision(mAABB);
+            break;
+    }
+
+    if (isOverlapping) {
+
+        if (mNbColliders < mMaxNbColliders) {
+            mOutColliders[mNbColliders] = collider;
+        }
+        mNbColliders++;
+    }
+}
+
 // Called for a broad-phase shape that has to be tested for raycast
 decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
 
     decimal hitFraction = decimal(-1.0);
 
     // Get the collider from the node
-    Collider* collider = static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(nodeId));
+    Collider* collider = mBroadPhaseSystem.getColliderForBroadPhaseId(nodeId | mBroadPhaseIdFlag);
 
     // Check if the raycast filtering mask allows raycast against this shape
     if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) != 0) {
@@ -246,3 +1045,34 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
 
     return hitFraction;
 }
+
+// Called for a broad-phase shape that has to be tested for raycast by a ray of the packet
+/// The ray is clipped to the closest hit found so far. Therefore, a hit with the collider
+/// is always closer than the hit stored in the output raycast info of the ray.
+decimal BroadPhaseRaycastPacketCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray, uint32 rayIndex) {
+
+    // Get the collider from the node
+    Collider* collider = mBroadPhaseSystem.getColliderForBroadPhaseId(nodeId | mBroadPhaseIdFlag);
+
+    // Check if the raycast filtering mask allows raycast against this shape
+    if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) == 0) {
+        return decimal(-1.0);
+    }
+
+    RaycastInfo raycastInfo;
+    if (!collider->raycast(ray, raycastInfo)) {
+        return ray.maxFraction;
+    }
+
+    // Keep the hit as the closest hit of the ray
+    RaycastInfo& outHit = mOutHits[rayIndex];
+    outHit.worldPoint = raycastInfo.worldPoint;
+    outHit.worldNormal = raycastInfo.worldNormal;
+    outHit.hitFraction = raycastInfo.hitFraction;
+    outHit.meshSubpart = raycastInfo.meshSubpart;
+    outHit.triangleIndex = raycastInfo.triangleIndex;
+    outHit.body = raycastInfo.body;
+    outHit.collider = raycastInfo.collider;
+
+    return raycastInfo.hitFraction;
+}
@@ -29,6 +29,8 @@
 #include <reactphysics3d/collision/OverlapCallback.h>
 #include <reactphysics3d/collision/shapes/BoxShape.h>
 #include <reactphysics3d/collision/shapes/ConcaveShape.h>
+#include <reactphysics3d/collision/shapes/TriangleShape.h>
+#include <reactphysics3d/collision/narrowphase/GJK/GJKAlgorithm.h>
 #include <reactphysics3d/collision/ContactManifoldInfo.h>
 #include <reactphysics3d/constraint/ContactPoint.h>
 #include <reactphysics3d/body/RigidBody.h>
@@ -40,8 +42,10 @@
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/engine/EventListener.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/DistanceInfo.h>
 #include <reactphysics3d/containers/Pair.h>
 #include <cassert>
+#include <algorithm>
 #include <iostream>
 
 // We want to use the ReactPhysics3D namespace
@@ -50,13 +54,19 @@ using namespace std;
 
 // Constructor
 CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, ColliderComponents& collidersComponents, TransformComponents& transformComponents,
-                                       CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents, MemoryManager& memoryManager)
-                   : mMemoryManager(memoryManager), mCollidersComponents(collidersComponents),
+                                       CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents, MemoryManager& memoryManager,
+                                       ThreadPool& threadPool)
+                   : mMemoryManager(memoryManager), mThreadPool(threadPool), mWorkerFrameAllocators(memoryManager.getHeapAllocator()),
+                     mCollidersComponents(collidersComponents),
                      mCollisionDispatch(mMemoryManager.getPoolAllocator()), mWorld(world),
                      mNoCollisionPairs(mMemoryManager.getPoolAllocator()),
                      mOverlappingPairs(mMemoryManager.getPoolAllocator(), mMemoryManager.getSingleFrameAllocator(), mCollidersComponents,
                                        collisionBodyComponents, rigidBodyComponents, mNoCollisionPairs, mCollisionDispatch),
-                     mBroadPhaseSystem(*this, mCollidersComponents, transformComponents, rigidBodyComponents),
+                     mBroadPhaseSystem(*this, mCollidersComponents, transformComponents, rigidBodyComponents, threadPool,
+                                      world->mConfig.isBroadPhaseWideTreeEnabled, world->mConfig.isBroadPhaseStaticTreeQuantized,
+                                      world->mConfig.broadPhaseCompactionThreshold,
+                                      world->mConfig.broadPhaseAlgorithmType,
+                                      world->mConfig.fatAABBMarginPolicy, world->mConfig.fatAABBVelocityMultiplier),
                      mMapBroadPhaseIdToColliderEntity(memoryManager.getPoolAllocator()),
                      mNarrowPhaseInput(mMemoryManager.getSingleFrameAllocator(), mOverlappingPairs), mPotentialContactPoints(mMemoryManager.getSingleFrameAllocator()),
                      mPotentialContactManifolds(mMemoryManager.getSingleFrameAllocator()), mContactPairs1(mMemoryManager.getPoolAllocator()),
@@ -78,6 +88,22 @@ CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, Collider
 
 #endif
 
+    // Create a single frame allocator for each worker thread
+    for (uint32 i=1; i < mThreadPool.getNbThreads(); i++) {
+        SingleFrameAllocator* allocator = new (mMemoryManager.getHeapAllocator().allocate(sizeof(SingleFrameAllocator)))
+                                              SingleFrameAllocator(mMemoryManager.getHeapAllocator());
+        mWorkerFrameAllocators.add(allocator);
+    }
+}
+
+// Destructor
+CollisionDetectionSystem::~CollisionDetectionSystem() {
+
+    // Destroy the single frame allocators of the worker threads
+    for (uint32 i=0; i < mWorkerFrameAllocators.size(); i++) {
+        mWorkerFrameAllocators[i]->~SingleFrameAllocator();
+        mMemoryManager.getHeapAllocator().release(mWorkerFrameAllocators[i], sizeof(SingleFrameAllocator));
+    }
 }
 
 // Compute the collision detection
@@ -260,6 +286,12 @@ void CollisionDetectionSystem::computeMiddlePhase(NarrowPhaseInput& narrowPhaseI
             CollisionShape* collisionShape1 = mCollidersComponents.mCollisionShapes[collider1Index];
             CollisionShape* collisionShape2 = mCollidersComponents.mCollisionShapes[collider2Index];
 
+            // If the size of a collision shape has changed, the cached narrow-phase result of the pair cannot be reused
+            if (mCollidersComponents.mHasCollisionShapeChangedSize[collider1Index] ||
+                mCollidersComponents.mHasCollisionShapeChangedSize[collider2Index]) {
+                mOverlappingPairs.invalidateNarrowPhaseCaches(i);
+            }
+
             NarrowPhaseAlgorithmType algorithmType = mOverlappingPairs.mNarrowPhaseAlgorithmType[i];
 
             const bool isCollider1Trigger = mCollidersComponents.mIsTrigger[collider1Index];
@@ -364,6 +396,14 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
     const uint collider1Index = mCollidersComponents.getEntityIndex(collider1);
     const uint collider2Index = mCollidersComponents.getEntityIndex(collider2);
 
+    // If the size of a collision shape has changed, the cached narrow-phase results and triangles of the pair cannot be reused
+    ConcaveTrianglesCache* trianglesCache = mOverlappingPairs.getConcaveTrianglesCache(pairIndex);
+    if (mCollidersComponents.mHasCollisionShapeChangedSize[collider1Index] ||
+        mCollidersComponents.mHasCollisionShapeChangedSize[collider2Index]) {
+        mOverlappingPairs.invalidateNarrowPhaseCaches(pairIndex);
+        trianglesCache->isValid = false;
+    }
+
     Transform& shape1LocalToWorldTransform = mCollidersComponents.mLocalToWorldTransforms[collider1Index];
     Transform& shape2LocalToWorldTransform = mCollidersComponents.mLocalToWorldTransforms[collider2Index];
 
@@ -388,15 +428,30 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
     assert(!concaveShape->isConvex());
     assert(mOverlappingPairs.mNarrowPhaseAlgorithmType[pairIndex] != NarrowPhaseAlgorithmType::None);
 
-    // Compute the convex shape AABB in the local-space of the convex shape
+    // Compute the convex shape AABB in the local-space of the concave shape
     AABB aabb;
     convexShape->computeAABB(aabb, convexToConcaveTransform);
 
-    // Compute the concave shape triangles that are overlapping with the convex mesh AABB
-    List<Vector3> triangleVertices(allocator);
-    List<Vector3> triangleVerticesNormals(allocator);
-    List<uint> shapeIds(allocator);
-    concaveShape->computeOverlappingTriangles(aabb, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+    // If the convex shape AABB is not inside the region of the cached triangles anymore
+    if (!trianglesCache->isValid || !trianglesCache->queryAABB.contains(aabb)) {
+
+        // Inflate the convex shape AABB so that the triangles can be reused while the convex shape moves a little bit
+        trianglesCache->queryAABB = aabb;
+        const Vector3 gap = aabb.getExtent() * CONCAVE_TRIANGLES_CACHE_AABB_INFLATE_PERCENTAGE;
+        trianglesCache->queryAABB.inflate(gap.x, gap.y, gap.z);
+
+        // Compute the concave shape triangles that are overlapping with the inflated AABB
+        trianglesCache->triangleVertices.clear();
+        trianglesCache->triangleVerticesNormals.clear();
+        trianglesCache->shapeIds.clear();
+        concaveShape->computeOverlappingTriangles(trianglesCache->queryAABB, trianglesCache->triangleVertices,
+                                                  trianglesCache->triangleVerticesNormals, trianglesCache->shapeIds, allocator);
+        trianglesCache->isValid = true;
+    }
+
+    const List<Vector3>& triangleVertices = trianglesCache->triangleVertices;
+    const List<Vector3>& triangleVerticesNormals = trianglesCache->triangleVerticesNormals;
+    const List<uint>& shapeIds = trianglesCache->shapeIds;
 
     assert(triangleVertices.size() == triangleVerticesNormals.size());
     assert(shapeIds.size() == triangleVertices.size() / 3);
@@ -407,9 +462,12 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
     const bool isCollider2Trigger = mCollidersComponents.mIsTrigger[collider2Index];
     const bool reportContacts = !isCollider1Trigger && !isCollider2Trigger;
 
-    // For each overlapping triangle
+    // For each cached triangle
     for (uint i=0; i < shapeIds.size(); i++)
     {
+        // Skip the triangles that are not overlapping with the convex shape AABB
+        if (!aabb.testCollision(AABB::createAABBForTriangle(&(triangleVertices[i * 3])))) continue;
+
         // Create a triangle collision shape (the allocated memory for the TriangleShape will be released in the
         // destructor of the corresponding NarrowPhaseInfo.
         TriangleShape* triangleShape = new (allocator.allocate(sizeof(TriangleShape)))
@@ -432,50 +490,266 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
 }
 
 // Execute the narrow-phase collision detection algorithm on batches
-bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput,
-                                                        bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator) {
+bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding,
+                                                        bool useNarrowPhaseCache, MemoryAllocator& allocator) {
 
     bool contactFound = false;
 
-    // Get the narrow-phase collision detection algorithms for each kind of collision shapes
-    SphereVsSphereAlgorithm* sphereVsSphereAlgo = mCollisionDispatch.getSphereVsSphereAlgorithm();
-    SphereVsCapsuleAlgorithm* sphereVsCapsuleAlgo = mCollisionDispatch.getSphereVsCapsuleAlgorithm();
-    CapsuleVsCapsuleAlgorithm* capsuleVsCapsuleAlgo = mCollisionDispatch.getCapsuleVsCapsuleAlgorithm();
-    SphereVsConvexPolyhedronAlgorithm* sphereVsConvexPolyAlgo = mCollisionDispatch.getSphereVsConvexPolyhedronAlgorithm();
-    CapsuleVsConvexPolyhedronAlgorithm* capsuleVsConvexPolyAlgo = mCollisionDispatch.getCapsuleVsConvexPolyhedronAlgorithm();
-    ConvexPolyhedronVsConvexPolyhedronAlgorithm* convexPolyVsConvexPolyAlgo = mCollisionDispatch.getConvexPolyhedronVsConvexPolyhedronAlgorithm();
+    const NarrowPhaseAlgorithmType algorithmTypes[] = {NarrowPhaseAlgorithmType::SphereVsSphere, NarrowPhaseAlgorithmType::SphereVsCapsule,
+                                                       NarrowPhaseAlgorithmType::CapsuleVsCapsule, NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron,
+                                                       NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron,
+                                                       NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron,
+                                                       NarrowPhaseAlgorithmType::BoxVsBox};
+    const uint nbAlgorithmTypes = sizeof(algorithmTypes) / sizeof(algorithmTypes[0]);
 
-    // get the narrow-phase batches to test for collision for contacts
-    SphereVsSphereNarrowPhaseInfoBatch& sphereVsSphereBatchContacts = narrowPhaseInput.getSphereVsSphereBatch();
-    SphereVsCapsuleNarrowPhaseInfoBatch& sphereVsCapsuleBatchContacts = narrowPhaseInput.getSphereVsCapsuleBatch();
-    CapsuleVsCapsuleNarrowPhaseInfoBatch& capsuleVsCapsuleBatchContacts = narrowPhaseInput.getCapsuleVsCapsuleBatch();
-    NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatchContacts = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
-    NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatchContacts = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
-    NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatchContacts = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
-
-    // Compute the narrow-phase collision detection for each kind of collision shapes (for contacts)
-    if (sphereVsSphereBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsSphereAlgo->testCollision(sphereVsSphereBatchContacts, 0, sphereVsSphereBatchContacts.getNbObjects(), allocator);
+    uint nbTotalItems = 0;
+    for (uint i=0; i < nbAlgorithmTypes; i++) {
+        nbTotalItems += narrowPhaseInput.getBatch(algorithmTypes[i]).getNbObjects();
     }
-    if (sphereVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsCapsuleAlgo->testCollision(sphereVsCapsuleBatchContacts, 0, sphereVsCapsuleBatchContacts.getNbObjects(), allocator);
+
+    const uint32 nbThreads = mThreadPool.getNbThreads();
+
+    // If there are enough items to test, we split the batches into ranges that are tested in parallel
+    if (nbThreads > 1 && nbTotalItems >= 2 * NB_MIN_NARROW_PHASE_ITEMS_PER_TASK) {
+
+        const uint nbMaxTasks = nbThreads * NB_NARROW_PHASE_TASKS_PER_THREAD;
+        const uint nbMinItemsPerTask = NB_MIN_NARROW_PHASE_ITEMS_PER_TASK;
+        const uint nbItemsPerTask = std::max(nbMinItemsPerTask, (nbTotalItems + nbMaxTasks - 1) / nbMaxTasks);
+
+        // Split each batch into ranges of items
+        MemoryAllocator& poolAllocator = mMemoryManager.getPoolAllocator();
+        List<NarrowPhaseCollisionTask::BatchRange> ranges(poolAllocator);
+        for (uint i=0; i < nbAlgorithmTypes; i++) {
+
+            const uint nbItems = narrowPhaseInput.getBatch(algorithmTypes[i]).getNbObjects();
+            for (uint startIndex = 0; startIndex < nbItems; startIndex += nbItemsPerTask) {
+                ranges.add(NarrowPhaseCollisionTask::BatchRange(algorithmTypes[i], startIndex, std::min(nbItemsPerTask, nbItems - startIndex)));
+            }
+        }
+
+        const uint32 nbTasks = ranges.size();
+        bool* tasksContactFound = static_cast<bool*>(poolAllocator.allocate(nbTasks * sizeof(bool)));
+
+        NarrowPhaseCollisionTask task(*this, narrowPhaseInput, ranges, clipWithPreviousAxisIfStillColliding, useNarrowPhaseCache,
+                                      allocator, tasksContactFound);
+        mThreadPool.execute(task, nbTasks);
+
+        for (uint32 i=0; i < nbTasks; i++) {
+            contactFound |= tasksContactFound[i];
+        }
+
+        poolAllocator.release(tasksContactFound, nbTasks * sizeof(bool));
     }
-    if (capsuleVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsCapsuleAlgo->testCollision(capsuleVsCapsuleBatchContacts, 0, capsuleVsCapsuleBatchContacts.getNbObjects(), allocator);
+    else {
+
+        // Compute the narrow-phase collision detection for each kind of collision shapes
+        for (uint i=0; i < nbAlgorithmTypes; i++) {
+
+            const uint nbItems = narrowPhaseInput.getBatch(algorithmTypes[i]).getNbObjects();
+            if (nbItems > 0) {
+                contactFound |= testNarrowPhaseCollisionRange(narrowPhaseInput, algorithmTypes[i], 0, nbItems,
+                                                              clipWithPreviousAxisIfStillColliding, useNarrowPhaseCache, allocator);
+            }
+        }
     }
-    if (sphereVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsConvexPolyAlgo->testCollision(sphereVsConvexPolyhedronBatchContacts, 0, sphereVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    return contactFound;
+}
+
+// Execute the narrow-phase collision detection on a range of items of a batch
+/// When the narrow-phase cache is used, the items whose shapes have not moved relative to each other
+/// since their result has been cached reuse this result. The narrow-phase algorithm only runs on the
+/// sub-ranges of the remaining items and their results are cached for the next frames.
+bool CollisionDetectionSystem::testNarrowPhaseCollisionRange(NarrowPhaseInput& narrowPhaseInput, NarrowPhaseAlgorithmType algorithmType,
+                                                             uint startIndex, uint nbItems, bool clipWithPreviousAxisIfStillColliding,
+                                                             bool useNarrowPhaseCache, MemoryAllocator& allocator) {
+
+    if (!useNarrowPhaseCache) {
+        return testNarrowPhaseAlgorithm(narrowPhaseInput, algorithmType, startIndex, nbItems, clipWithPreviousAxisIfStillColliding,
+                                        allocator);
     }
-    if (capsuleVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsConvexPolyAlgo->testCollision(capsuleVsConvexPolyhedronBatchContacts, 0, capsuleVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    NarrowPhaseInfoBatch& narrowPhaseInfoBatch = narrowPhaseInput.getBatch(algorithmType);
+
+    const decimal translationTolerance = mWorld->mConfig.narrowPhaseCacheTranslationTolerance;
+    const decimal maxTranslationSquare = translationTolerance * translationTolerance;
+    const decimal minRotationCos = std::cos(mWorld->mConfig.narrowPhaseCacheRotationTolerance * decimal(0.5));
+
+    bool contactFound = false;
+
+    // Start index of the current sub-range of items that need to be tested by the algorithm
+    uint subRangeStartIndex = startIndex;
+
+    const uint endIndex = startIndex + nbItems;
+    for (uint i=startIndex; i < endIndex; i++) {
+
+        if (reuseCachedNarrowPhaseResult(narrowPhaseInfoBatch, i, maxTranslationSquare, minRotationCos)) {
+
+            // Test the items before the current one
+            if (subRangeStartIndex < i) {
+                contactFound |= testNarrowPhaseAlgorithm(narrowPhaseInput, algorithmType, subRangeStartIndex, i - subRangeStartIndex,
+                                                         clipWithPreviousAxisIfStillColliding, allocator);
+                cacheNarrowPhaseResults(narrowPhaseInfoBatch, subRangeStartIndex, i - subRangeStartIndex);
+            }
+
+            contactFound |= narrowPhaseInfoBatch.isColliding[i];
+            subRangeStartIndex = i + 1;
+        }
     }
-    if (convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= convexPolyVsConvexPolyAlgo->testCollision(convexPolyhedronVsConvexPolyhedronBatchContacts, 0, convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    // Test the remaining items
+    if (subRangeStartIndex < endIndex) {
+        contactFound |= testNarrowPhaseAlgorithm(narrowPhaseInput, algorithmType, subRangeStartIndex, endIndex - subRangeStartIndex,
+                                                 clipWithPreviousAxisIfStillColliding, allocator);
+        cacheNarrowPhaseResults(narrowPhaseInfoBatch, subRangeStartIndex, endIndex - subRangeStartIndex);
     }
 
     return contactFound;
 }
 
+// Reuse the cached narrow-phase result of an item if the relative transform of its shapes has not changed
+/// The cached result is reused if the relative transform of the two shapes is within the translation and
+/// rotation tolerances of the transform used to compute the result. In this case, the collision state and
+/// the contact points of the item are set from the cached result and the method returns true.
+bool CollisionDetectionSystem::reuseCachedNarrowPhaseResult(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint index,
+                                                            decimal maxTranslationSquare, decimal minRotationCos) const {
+
+    const LastFrameCollisionInfo* lastFrameInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[index];
+
+    if (!lastFrameInfo->isNarrowPhaseCacheValid || lastFrameInfo->cachedReportContacts != narrowPhaseInfoBatch.reportContacts[index]) {
+        return false;
+    }
+
+    const Transform& shape1ToWorldTransform = narrowPhaseInfoBatch.shape1ToWorldTransforms[index];
+    const Transform shape2ToShape1Transform = shape1ToWorldTransform.getInverse() * narrowPhaseInfoBatch.shape2ToWorldTransforms[index];
+    const Transform& cachedTransform = lastFrameInfo->cachedShape2ToShape1Transform;
+
+    // Check the relative translation and rotation since the result has been cached
+    if ((shape2ToShape1Transform.getPosition() - cachedTransform.getPosition()).lengthSquare() > maxTranslationSquare ||
+        std::abs(shape2ToShape1Transform.getOrientation().dot(cachedTransform.getOrientation())) < minRotationCos) {
+        return false;
+    }
+
+    narrowPhaseInfoBatch.isColliding[index] = lastFrameInfo->cachedIsColliding;
+
+    // Add the cached contact points
+    for (uint8 i=0; i < lastFrameInfo->nbCachedContactPoints; i++) {
+
+        const LastFrameCollisionInfo::CachedContactPoint& contactPoint = lastFrameInfo->cachedContactPoints[i];
+        narrowPhaseInfoBatch.addContactPoint(index, shape1ToWorldTransform.getOrientation() * contactPoint.localNormal,
+                                             contactPoint.penetrationDepth, contactPoint.localPoint1, contactPoint.localPoint2);
+    }
+
+    return true;
+}
+
+// Cache the narrow-phase results of a range of items of a batch
+/// An item with more contact points than a cached result can hold is not cached.
+void CollisionDetectionSystem::cacheNarrowPhaseResults(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint startIndex, uint nbItems) const {
+
+    for (uint i=startIndex; i < startIndex + nbItems; i++) {
+
+        LastFrameCollisionInfo* lastFrameInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[i];
+
+        const uint nbContactPoints = narrowPhaseInfoBatch.contactPoints[i].size();
+        if (nbContactPoints > LastFrameCollisionInfo::NB_MAX_CACHED_CONTACT_POINTS) {
+            lastFrameInfo->isNarrowPhaseCacheValid = false;
+            continue;
+        }
+
+        const Transform& shape1ToWorldTransform = narrowPhaseInfoBatch.shape1ToWorldTransforms[i];
+        const Quaternion worldToShape1Orientation = shape1ToWorldTransform.getOrientation().getInverse();
+
+        lastFrameInfo->isNarrowPhaseCacheValid = true;
+        lastFrameInfo->cachedIsColliding = narrowPhaseInfoBatch.isColliding[i];
+        lastFrameInfo->cachedReportContacts = narrowPhaseInfoBatch.reportContacts[i];
+        lastFrameInfo->cachedShape2ToShape1Transform = shape1ToWorldTransform.getInverse() * narrowPhaseInfoBatch.shape2ToWorldTransforms[i];
+        lastFrameInfo->nbCachedContactPoints = static_cast<uint8>(nbContactPoints);
+
+        for (uint j=0; j < nbContactPoints; j++) {
+
+            const ContactPointInfo& contactPoint = *(narrowPhaseInfoBatch.contactPoints[i][j]);
+            LastFrameCollisionInfo::CachedContactPoint& cachedContactPoint = lastFrameInfo->cachedContactPoints[j];
+            cachedContactPoint.localNormal = worldToShape1Orientation * contactPoint.normal;
+            cachedContactPoint.penetrationDepth = contactPoint.penetrationDepth;
+            cachedContactPoint.localPoint1 = contactPoint.localPoint1;
+            cachedContactPoint.localPoint2 = contactPoint.localPoint2;
+        }
+    }
+}
+
+// Execute the narrow-phase collision detection algorithm on a range of items of a batch
+bool CollisionDetectionSystem::testNarrowPhaseAlgorithm(NarrowPhaseInput& narrowPhaseInput, NarrowPhaseAlgorithmType algorithmType,
+                                                        uint startIndex, uint nbItems, bool clipWithPreviousAxisIfStillColliding,
+                                                        MemoryAllocator& allocator) {
+
+    switch (algorithmType) {
+
+        case NarrowPhaseAlgorithmType::SphereVsSphere:
+            return mCollisionDispatch.getSphereVsSphereAlgorithm()->testCollision(narrowPhaseInput.getSphereVsSphereBatch(),
+                                                                                  startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::SphereVsCapsule:
+            return mCollisionDispatch.getSphereVsCapsuleAlgorithm()->testCollision(narrowPhaseInput.getSphereVsCapsuleBatch(),
+                                                                                   startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::CapsuleVsCapsule:
+            return mCollisionDispatch.getCapsuleVsCapsuleAlgorithm()->testCollision(narrowPhaseInput.getCapsuleVsCapsuleBatch(),
+                                                                                    startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron:
+            return mCollisionDispatch.getSphereVsConvexPolyhedronAlgorithm()->testCollision(narrowPhaseInput.getSphereVsConvexPolyhedronBatch(),
+                                                                                            startIndex, nbItems,
+                                                                                            clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron:
+            return mCollisionDispatch.getCapsuleVsConvexPolyhedronAlgorithm()->testCollision(narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch(),
+                                                                                             startIndex, nbItems,
+                                                                                             clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron:
+            return mCollisionDispatch.getConvexPolyhedronVsConvexPolyhedronAlgorithm()->testCollision(
+                                                narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch(), startIndex, nbItems,
+                                                clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::BoxVsBox:
+            return mCollisionDispatch.getBoxVsBoxAlgorithm()->testCollision(narrowPhaseInput.getBoxVsBoxBatch(), startIndex, nbItems,
+                                                                            clipWithPreviousAxisIfStillColliding);
+        case NarrowPhaseAlgorithmType::None:
+            break;
+    }
+
+    assert(false);
+    return false;
+}
+
+// Reset the single frame allocators of the worker threads
+void CollisionDetectionSystem::resetWorkerFrameAllocators() {
+
+    for (uint32 i=0; i < mWorkerFrameAllocators.size(); i++) {
+        mWorkerFrameAllocators[i]->reset();
+    }
+}
+
+// Run the narrow-phase collision detection on a range of items
+/// The calling thread (thread index zero) uses the memory allocator given to the narrow-phase
+/// and each worker thread uses its own single frame allocator.
+void NarrowPhaseCollisionTask::run(uint32 taskIndex, uint32 threadIndex) {
+
+    const BatchRange& range = mRanges[taskIndex];
+
+    MemoryAllocator* allocator = &mAllocator;
+    if (threadIndex > 0) {
+
+        allocator = mCollisionDetection.mWorkerFrameAllocators[threadIndex - 1];
+
+        // Create the contact points of the items with the allocator of the thread
+        NarrowPhaseInfoBatch& batch = mNarrowPhaseInput.getBatch(range.algorithmType);
+        for (uint i = range.startIndex; i < range.startIndex + range.nbItems; i++) {
+            batch.setContactPointsAllocator(i, *allocator);
+        }
+    }
+
+    mTasksContactFound[taskIndex] = mCollisionDetection.testNarrowPhaseCollisionRange(mNarrowPhaseInput, range.algorithmType,
+                                                                                       range.startIndex, range.nbItems,
+                                                                                       mClipWithPreviousAxisIfStillColliding,
+                                                                                       mUseNarrowPhaseCache, *allocator);
+}
+
 // Process the potential contacts after narrow-phase collision detection
 void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& narrowPhaseInput, bool updateLastFrameInfo,
                                                      List<ContactPointInfo>& potentialContactPoints,
@@ -494,6 +768,7 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
     NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatch = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatch = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatch = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
+    NarrowPhaseInfoBatch& boxVsBoxBatch = narrowPhaseInput.getBoxVsBoxBatch();
 
     // Process the potential contacts
     processPotentialContacts(sphereVsSphereBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
@@ -508,6 +783,8 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
                              potentialContactManifolds, contactPairs, mapBodyToContactPairs);
     processPotentialContacts(convexPolyhedronVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
                              potentialContactManifolds, contactPairs, mapBodyToContactPairs);
+    processPotentialContacts(boxVsBoxBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
+                             potentialContactManifolds, contactPairs, mapBodyToContactPairs);
 }
 
 // Compute the narrow-phase collision detection
@@ -521,7 +798,7 @@ void CollisionDetectionSystem::computeNarrowPhase() {
     swapPreviousAndCurrentContacts();
 
     // Test the narrow-phase collision detection on the batches to be tested
-    testNarrowPhaseCollision(mNarrowPhaseInput, true, allocator);
+    testNarrowPhaseCollision(mNarrowPhaseInput, true, mWorld->mConfig.isNarrowPhaseCacheEnabled, allocator);
 
     // Process all the potential contacts after narrow-phase collision
     processAllPotentialContacts(mNarrowPhaseInput, true, mPotentialContactPoints, mCurrentMapPairIdToContactPairIndex,
@@ -543,7 +820,7 @@ bool CollisionDetectionSystem::computeNarrowPhaseOverlapSnapshot(NarrowPhaseInpu
     MemoryAllocator& allocator = mMemoryManager.getPoolAllocator();
 
     // Test the narrow-phase collision detection on the batches to be tested
-    bool collisionFound = testNarrowPhaseCollision(narrowPhaseInput, false, allocator);
+    bool collisionFound = testNarrowPhaseCollision(narrowPhaseInput, false, false, allocator);
     if (collisionFound && callback != nullptr) {
 
         // Compute the overlapping colliders
@@ -571,6 +848,7 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInp
     NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatch = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatch = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatch = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
+    NarrowPhaseInfoBatch& boxVsBoxBatch = narrowPhaseInput.getBoxVsBoxBatch();
 
     // Process the potential contacts
     computeOverlapSnapshotContactPairs(sphereVsSphereBatch, contactPairs, setOverlapContactPairId);
@@ -579,6 +857,7 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInp
     computeOverlapSnapshotContactPairs(sphereVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
     computeOverlapSnapshotContactPairs(capsuleVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
     computeOverlapSnapshotContactPairs(convexPolyhedronVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
+    computeOverlapSnapshotContactPairs(boxVsBoxBatch, contactPairs, setOverlapContactPairId);
 }
 
 // Notify that the overlapping pairs where a given collider is involved need to be tested for overlap
@@ -642,7 +921,7 @@ bool CollisionDetectionSystem::computeNarrowPhaseCollisionSnapshot(NarrowPhaseIn
     MemoryAllocator& allocator = mMemoryManager.getHeapAllocator();
 
     // Test the narrow-phase collision detection on the batches to be tested
-    bool collisionFound = testNarrowPhaseCollision(narrowPhaseInput, false, allocator);
+    bool collisionFound = testNarrowPhaseCollision(narrowPhaseInput, false, false, allocator);
 
     // If collision has been found, create contacts
     if (collisionFound) {
@@ -978,6 +1257,94 @@ void CollisionDetectionSystem::removeCollider(Collider* collider) {
     mBroadPhaseSystem.removeCollider(collider);
 }
 
+// Move the colliders of a body between the static and dynamic broad-phase trees after its type has changed
+/// The overlapping pairs of the colliders (and therefore their contacts and the cached narrow-phase
+/// data) are kept with the new broad-phase IDs. Only the pairs between two static colliders are removed
+/// because they are never tested (a lost contact pair is reported if the colliders were colliding).
+void CollisionDetectionSystem::moveCollidersBetweenTrees(const List<Entity>& colliderEntities) {
+
+    RP3D_PROFILE("CollisionDetectionSystem::moveCollidersBetweenTrees()", mProfiler);
+
+    // Remove the pairs between a collider that is now static and another static collider
+    for (uint i=0; i < colliderEntities.size(); i++) {
+
+        const uint32 colliderIndex = mCollidersComponents.mMapEntityToComponentIndex[colliderEntities[i]];
+        Collider* collider = mCollidersComponents.mColliders[colliderIndex];
+        if (collider->getBroadPhaseId() == -1 || !mBroadPhaseSystem.isColliderInStaticTree(collider)) continue;
+
+        List<uint64>& overlappingPairs = mCollidersComponents.mOverlappingPairs[colliderIndex];
+        uint p = 0;
+        while (p < overlappingPairs.size()) {
+
+            const uint64 pairIndex = mOverlappingPairs.mMapPairIdToPairIndex[overlappingPairs[p]];
+            const bool isCollider1 = mOverlappingPairs.mColliders1[pairIndex] == colliderEntities[i];
+            const Entity& otherColliderEntity = isCollider1 ? mOverlappingPairs.mColliders2[pairIndex] : mOverlappingPairs.mColliders1[pairIndex];
+            Collider* otherCollider = mCollidersComponents.mColliders[mCollidersComponents.mMapEntityToComponentIndex[otherColliderEntity]];
+
+            if (!mBroadPhaseSystem.isColliderInStaticTree(otherCollider)) {
+                p++;
+                continue;
+            }
+
+            // If the two colliders of the pair were colliding in the previous frame
+            if (mOverlappingPairs.mCollidingInPreviousFrame[pairIndex]) {
+
+                // Create a new lost contact pair
+                addLostContactPair(pairIndex);
+            }
+
+            mOverlappingPairs.removePair(overlappingPairs[p]);
+        }
+    }
+
+    // Move the colliders in the broad-phase and update the IDs of the remaining pairs
+    Map<int32, int32> mapOldToNewBroadPhaseIds(mMemoryManager.getPoolAllocator(), colliderEntities.size());
+    mBroadPhaseSystem.moveCollidersBetweenTrees(colliderEntities, mapOldToNewBroadPhaseIds);
+    if (mapOldToNewBroadPhaseIds.size() > 0) {
+        remapBroadPhaseIds(mapOldToNewBroadPhaseIds);
+    }
+}
+
+// Update the data that depend on the broad-phase IDs after the broad-phase IDs of colliders have changed
+/// This is called by the broad-phase when the nodes of its trees have been compacted. The IDs of
+/// the overlapping pairs and of the contact pairs of the last frame (used to warm start the
+/// contacts of the next frame) are computed from the broad-phase IDs and are updated here.
+void CollisionDetectionSystem::remapBroadPhaseIds(const Map<int32, int32>& mapOldToNewBroadPhaseIds) {
+
+    RP3D_PROFILE("CollisionDetectionSystem::remapBroadPhaseIds()", mProfiler);
+
+    MemoryAllocator& allocator = mMemoryManager.getPoolAllocator();
+
+    // Update the overlapping pairs
+    Map<uint64, uint64> mapOldToNewPairIds(allocator, mOverlappingPairs.getNbPairs());
+    mOverlappingPairs.remapBroadPhaseIds(mapOldToNewBroadPhaseIds, mapOldToNewPairIds);
+
+    // Update the map from the broad-phase IDs to the colliders
+    Map<int, Entity> mapBroadPhaseIdToColliderEntity(allocator, mMapBroadPhaseIdToColliderEntity.size());
+    for (auto it = mMapBroadPhaseIdToColliderEntity.begin(); it != mMapBroadPhaseIdToColliderEntity.end(); ++it) {
+
+        auto itNewId = mapOldToNewBroadPhaseIds.find(it->first);
+        const int broadPhaseId = itNewId != mapOldToNewBroadPhaseIds.end() ? itNewId->second : it->first;
+        mapBroadPhaseIdToColliderEntity.add(Pair<int, Entity>(broadPhaseId, it->second));
+    }
+    mMapBroadPhaseIdToColliderEntity = mapBroadPhaseIdToColliderEntity;
+
+    // Update the contact pairs of the last frame. The contact pairs whose overlapping pair has
+    // been removed are not needed anymore to warm start the contacts and are removed from the map.
+    assert(mPreviousContactPairs->size() == 0);
+    mCurrentMapPairIdToContactPairIndex->clear();
+    for (uint i=0; i < mCurrentContactPairs->size(); i++) {
+
+        ContactPair& contactPair = (*mCurrentContactPairs)[i];
+
+        auto it = mapOldToNewPairIds.find(contactPair.pairId);
+        if (it != mapOldToNewPairIds.end()) {
+            contactPair.pairId = it->second;
+            mCurrentMapPairIdToContactPairIndex->add(Pair<uint64, uint>(contactPair.pairId, i));
+        }
+    }
+}
+
 // Ray casting method
 void CollisionDetectionSystem::raycast(RaycastCallback* raycastCallback,
                                         const Ray& ray,
@@ -992,6 +1359,417 @@ void CollisionDetectionSystem::raycast(RaycastCallback* raycastCallback,
     mBroadPhaseSystem.raycast(ray, rayCastTest, raycastWithCategoryMaskBits);
 }
 
+// Sweep a convex shape along a translation and report the colliders it hits
+/// The shape moves from "fromTransform" to the position of "toTransform" while keeping the
+/// orientation of "fromTransform". The colliders overlapping with the AABB swept by the shape
+/// are found with the broad-phase and the first contact with each of them is computed with
+/// the GJK ray cast algorithm (against the overlapping triangles for a concave collider). Each
+/// hit is reported to the callback the same way as for a raycast, where the hit fraction
+/// is the fraction of the translation where the shape starts to touch the collider.
+void CollisionDetectionSystem::sweep(const ConvexShape* shape, const Transform& fromTransform, const Transform& toTransform,
+                                     RaycastCallback* callback, unsigned short sweepWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::sweep()", mProfiler);
+
+    const Vector3 translation = toTransform.getPosition() - fromTransform.getPosition();
+    const Transform endTransform(toTransform.getPosition(), fromTransform.getOrientation());
+
+    // Compute the AABB swept by the shape
+    AABB sweptAABB;
+    AABB endAABB;
+    shape->computeAABB(sweptAABB, fromTransform);
+    shape->computeAABB(endAABB, endTransform);
+    sweptAABB.mergeWithAABB(endAABB);
+
+    // Find the colliders overlapping with the swept AABB in the broad-phase
+    Collider* localColliders[NB_MAX_LOCAL_QUERY_COLLIDERS];
+    uint32 nbColliders;
+    Collider** colliders = findBroadPhaseColliders(sweptAABB, sweepWithCategoryMaskBits, localColliders,
+                                                   NB_MAX_LOCAL_QUERY_COLLIDERS, nbColliders);
+
+    decimal maxFraction = decimal(1.0);
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        RaycastInfo raycastInfo;
+        if (sweepAgainstCollider(shape, fromTransform, translation, colliders[i], maxFraction, raycastInfo)) {
+
+            // Report the hit to the user
+            const decimal hitFraction = callback->notifyRaycastHit(raycastInfo);
+
+            // If the user returned a hit fraction of zero, the sweep stops here
+            if (hitFraction == decimal(0.0)) break;
+
+            // If the user returned a positive fraction, we update the maximum fraction of the sweep
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+        }
+    }
+
+    releaseBroadPhaseColliders(colliders, localColliders, nbColliders);
+}
+
+// Find the colliders overlapping with a shape that is not in the world
+/// The candidate colliders are found with the AABB of the shape in the broad-phase and the
+/// overlap is then tested with the GJK algorithm (against the triangles overlapping with the
+/// shape if one of the two shapes is concave). No body or collider is created for the shape.
+/// Two concave shapes are never reported as overlapping (as in the narrow-phase). At most
+/// "maxNbColliders" colliders are written into the buffer but the returned number is the
+/// total number of overlapping colliders.
+uint32 CollisionDetectionSystem::overlapShape(const CollisionShape* shape, const Transform& transform, unsigned short categoryMaskBits,
+                                              Collider** outColliders, uint32 maxNbColliders) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::overlapShape()", mProfiler);
+
+    AABB aabb;
+    shape->computeAABB(aabb, transform);
+
+    // Find the colliders overlapping with the AABB of the shape in the broad-phase
+    Collider* localColliders[NB_MAX_LOCAL_QUERY_COLLIDERS];
+    uint32 nbColliders;
+    Collider** colliders = findBroadPhaseColliders(aabb, categoryMaskBits, localColliders, NB_MAX_LOCAL_QUERY_COLLIDERS, nbColliders);
+
+    uint32 nbOverlappingColliders = 0;
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        if (testOverlapShapeWithCollider(shape, transform, colliders[i])) {
+
+            if (nbOverlappingColliders < maxNbColliders) {
+                outColliders[nbOverlappingColliders] = colliders[i];
+            }
+            nbOverlappingColliders++;
+        }
+    }
+
+    releaseBroadPhaseColliders(colliders, localColliders, nbColliders);
+
+    return nbOverlappingColliders;
+}
+
+// Find the colliders overlapping with an AABB in the broad-phase
+/// The colliders are written into the local array if it is large enough. Otherwise, a larger
+/// array is allocated and returned. The returned array must be given to releaseBroadPhaseColliders().
+Collider** CollisionDetectionSystem::findBroadPhaseColliders(const AABB& aabb, unsigned short categoryMaskBits, Collider** localColliders,
+                                                             uint32 nbMaxLocalColliders, uint32& outNbColliders) const {
+
+    outNbColliders = mBroadPhaseSystem.queryAABB(aabb, categoryMaskBits, localColliders, nbMaxLocalColliders);
+    if (outNbColliders <= nbMaxLocalColliders) return localColliders;
+
+    // The local array is too small, we query the broad-phase again with a larger array
+    const uint32 nbAllocatedColliders = outNbColliders;
+    Collider** colliders = static_cast<Collider**>(mMemoryManager.getPoolAllocator().allocate(nbAllocatedColliders * sizeof(Collider*)));
+    outNbColliders = mBroadPhaseSystem.queryAABB(aabb, categoryMaskBits, colliders, nbAllocatedColliders);
+    assert(outNbColliders == nbAllocatedColliders);
+
+    return colliders;
+}
+
+// Release the array of colliders returned by findBroadPhaseColliders() if it has been allocated
+void CollisionDetectionSystem::releaseBroadPhaseColliders(Collider** colliders, Collider** localColliders, uint32 nbColliders) const {
+
+    if (colliders != localColliders) {
+        mMemoryManager.getPoolAllocator().release(colliders, nbColliders * sizeof(Collider*));
+    }
+}
+
+// Return true if a shape overlaps with a collider
+bool CollisionDetectionSystem::testOverlapShapeWithCollider(const CollisionShape* shape, const Transform& transform,
+                                                            Collider* collider) const {
+
+    GJKAlgorithm gjkAlgorithm;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    gjkAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+    const CollisionShape* colliderShape = collider->getCollisionShape();
+    const Transform colliderTransform = collider->getLocalToWorldTransform();
+
+    const bool isShapeConvex = shape->isConvex();
+    const bool isColliderShapeConvex = colliderShape->isConvex();
+
+    // Two concave shapes cannot collide
+    if (!isShapeConvex && !isColliderShapeConvex) return false;
+
+    if (isShapeConvex && isColliderShapeConvex) {
+        return gjkAlgorithm.testOverlap(static_cast<const ConvexShape*>(shape), transform,
+                                        static_cast<const ConvexShape*>(colliderShape), colliderTransform);
+    }
+
+    // Get the convex and the concave shapes
+    const ConvexShape* convexShape = static_cast<const ConvexShape*>(isShapeConvex ? shape : colliderShape);
+    const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(isShapeConvex ? colliderShape : shape);
+    const Transform& convexTransform = isShapeConvex ? transform : colliderTransform;
+    const Transform& concaveTransform = isShapeConvex ? colliderTransform : transform;
+
+    MemoryAllocator& allocator = mMemoryManager.getPoolAllocator();
+
+    // Compute the AABB of the convex shape in the local-space of the concave shape
+    AABB aabb;
+    convexShape->computeAABB(aabb, concaveTransform.getInverse() * convexTransform);
+
+    // Compute the concave shape triangles that are overlapping with the convex shape AABB
+    List<Vector3> triangleVertices(allocator);
+    List<Vector3> triangleVerticesNormals(allocator);
+    List<uint> shapeIds(allocator);
+    concaveShape->computeOverlappingTriangles(aabb, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+
+    for (uint i=0; i < shapeIds.size(); i++) {
+
+        TriangleShape triangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        triangleShape.setProfiler(mProfiler);
+
+#endif
+
+        if (gjkAlgorithm.testOverlap(convexShape, convexTransform, &triangleShape, concaveTransform)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Compute the first hit of a translating convex shape with a collider
+bool CollisionDetectionSystem::sweepAgainstCollider(const ConvexShape* shape, const Transform& fromTransform, const Vector3& translation,
+                                                    Collider* collider, decimal maxFraction, RaycastInfo& outRaycastInfo) const {
+
+    GJKAlgorithm gjkAlgorithm;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    gjkAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+    const CollisionShape* colliderShape = collider->getCollisionShape();
+    const Transform colliderTransform = collider->getLocalToWorldTransform();
+
+    bool isHit = false;
+    decimal hitFraction;
+    Vector3 worldPoint;
+    Vector3 worldNormal;
+
+    if (colliderShape->isConvex()) {
+
+        isHit = gjkAlgorithm.sweep(shape, fromTransform, translation, static_cast<const ConvexShape*>(colliderShape),
+                                   colliderTransform, maxFraction, hitFraction, worldPoint, worldNormal);
+    }
+    else {
+
+        const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(colliderShape);
+        MemoryAllocator& allocator = mMemoryManager.getPoolAllocator();
+
+        // Compute the AABB swept by the shape in the local-space of the concave shape
+        const Transform worldToColliderTransform = colliderTransform.getInverse();
+        const Transform endTransform(fromTransform.getPosition() + maxFraction * translation, fromTransform.getOrientation());
+        AABB sweptAABB;
+        AABB endAABB;
+        shape->computeAABB(sweptAABB, worldToColliderTransform * fromTransform);
+        shape->computeAABB(endAABB, worldToColliderTransform * endTransform);
+        sweptAABB.mergeWithAABB(endAABB);
+
+        // Compute the concave shape triangles that are overlapping with the swept AABB
+        List<Vector3> triangleVertices(allocator);
+        List<Vector3> triangleVerticesNormals(allocator);
+        List<uint> shapeIds(allocator);
+        concaveShape->computeOverlappingTriangles(sweptAABB, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+
+        // Keep the first hit with the triangles
+        for (uint i=0; i < shapeIds.size(); i++) {
+
+            TriangleShape triangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            triangleShape.setProfiler(mProfiler);
+
+#endif
+
+            decimal triangleHitFraction;
+            Vector3 triangleWorldPoint;
+            Vector3 triangleWorldNormal;
+            if (gjkAlgorithm.sweep(shape, fromTransform, translation, &triangleShape, colliderTransform, maxFraction,
+                                   triangleHitFraction, triangleWorldPoint, triangleWorldNormal)) {
+
+                isHit = true;
+                maxFraction = triangleHitFraction;
+                hitFraction = triangleHitFraction;
+                worldPoint = triangleWorldPoint;
+                worldNormal = triangleWorldNormal;
+            }
+        }
+    }
+
+    if (isHit) {
+        outRaycastInfo.worldPoint = worldPoint;
+        outRaycastInfo.worldNormal = worldNormal;
+        outRaycastInfo.hitFraction = hitFraction;
+        outRaycastInfo.body = collider->getBody();
+        outRaycastInfo.collider = collider;
+    }
+
+    return isHit;
+}
+
+// Compute the distance and the closest points between two convex colliders
+/// The separating axis of the distance info is used as the starting axis of the GJK
+/// algorithm if it is not zero. It is updated by the query so that the same distance
+/// info can be given again in the next frame. Concave colliders are not supported.
+bool CollisionDetectionSystem::computeDistance(Collider* collider1, Collider* collider2, DistanceInfo& distanceInfo) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::computeDistance()", mProfiler);
+
+    const CollisionShape* shape1 = collider1->getCollisionShape();
+    const CollisionShape* shape2 = collider2->getCollisionShape();
+    assert(shape1->isConvex() && shape2->isConvex());
+    if (!shape1->isConvex() || !shape2->isConvex()) return false;
+
+    GJKAlgorithm gjkAlgorithm;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    gjkAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+    distanceInfo.collider = collider2;
+
+    return gjkAlgorithm.computeDistance(static_cast<const ConvexShape*>(shape1), collider1->getLocalToWorldTransform(),
+                                        static_cast<const ConvexShape*>(shape2), collider2->getLocalToWorldTransform(),
+                                        distanceInfo.separatingAxis, distanceInfo.distance,
+                                        distanceInfo.worldPoint1, distanceInfo.worldPoint2);
+}
+
+// Find the closest collider to a convex shape within a maximum distance
+/// The candidate colliders are found in the broad-phase with the AABB of the shape inflated
+/// by the maximum distance. The distance to each of them is computed with the GJK algorithm
+/// (with the triangles that are closer than the maximum distance for the concave colliders)
+/// and the maximum distance shrinks as closer colliders are found. If the shape overlaps
+/// with a collider, the distance is zero and the closest points are not computed.
+bool CollisionDetectionSystem::findClosestCollider(const ConvexShape* shape, const Transform& transform, decimal maxDistance,
+                                                   unsigned short categoryMaskBits, DistanceInfo& outDistanceInfo) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::findClosestCollider()", mProfiler);
+
+    assert(maxDistance >= decimal(0.0));
+
+    AABB aabb;
+    shape->computeAABB(aabb, transform);
+    aabb.inflate(maxDistance, maxDistance, maxDistance);
+
+    // Find the colliders overlapping with the inflated AABB of the shape in the broad-phase
+    Collider* localColliders[NB_MAX_LOCAL_QUERY_COLLIDERS];
+    uint32 nbColliders;
+    Collider** colliders = findBroadPhaseColliders(aabb, categoryMaskBits, localColliders, NB_MAX_LOCAL_QUERY_COLLIDERS, nbColliders);
+
+    bool isColliderFound = false;
+    outDistanceInfo.collider = nullptr;
+
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        DistanceInfo distanceInfo;
+        if (computeDistanceToCollider(shape, transform, colliders[i], maxDistance, distanceInfo)) {
+
+            maxDistance = distanceInfo.distance;
+            outDistanceInfo.distance = distanceInfo.distance;
+            outDistanceInfo.worldPoint1 = distanceInfo.worldPoint1;
+            outDistanceInfo.worldPoint2 = distanceInfo.worldPoint2;
+            outDistanceInfo.separatingAxis = distanceInfo.separatingAxis;
+            outDistanceInfo.collider = colliders[i];
+            isColliderFound = true;
+
+            // No collider can be closer than an overlapping one
+            if (maxDistance == decimal(0.0)) break;
+        }
+    }
+
+    releaseBroadPhaseColliders(colliders, localColliders, nbColliders);
+
+    return isColliderFound;
+}
+
+// Compute the distance between a convex shape and a collider if it is not larger than a maximum distance
+bool CollisionDetectionSystem::computeDistanceToCollider(const ConvexShape* shape, const Transform& transform, Collider* collider,
+                                                         decimal maxDistance, DistanceInfo& outDistanceInfo) const {
+
+    GJKAlgorithm gjkAlgorithm;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    gjkAlgorithm.setProfiler(mProfiler);
+
+#endif
+
+    const CollisionShape* colliderShape = collider->getCollisionShape();
+    const Transform colliderTransform = collider->getLocalToWorldTransform();
+
+    // Start the GJK algorithm with the axis between the origins of the two shapes
+    const Vector3 initialAxis = transform.getPosition() - colliderTransform.getPosition();
+
+    if (colliderShape->isConvex()) {
+
+        outDistanceInfo.separatingAxis = initialAxis;
+        gjkAlgorithm.computeDistance(shape, transform, static_cast<const ConvexShape*>(colliderShape), colliderTransform,
+                                     outDistanceInfo.separatingAxis, outDistanceInfo.distance,
+                                     outDistanceInfo.worldPoint1, outDistanceInfo.worldPoint2);
+
+        return outDistanceInfo.distance <= maxDistance;
+    }
+
+    const ConcaveShape* concaveShape = static_cast<const ConcaveShape*>(colliderShape);
+    MemoryAllocator& allocator = mMemoryManager.getPoolAllocator();
+
+    // Compute the AABB of the shape inflated by the maximum distance in the local-space of the concave shape
+    AABB aabb;
+    shape->computeAABB(aabb, colliderTransform.getInverse() * transform);
+    aabb.inflate(maxDistance, maxDistance, maxDistance);
+
+    // Compute the concave shape triangles that are overlapping with the inflated AABB
+    List<Vector3> triangleVertices(allocator);
+    List<Vector3> triangleVerticesNormals(allocator);
+    List<uint> shapeIds(allocator);
+    concaveShape->computeOverlappingTriangles(aabb, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+
+    // Keep the closest triangle
+    bool isTriangleFound = false;
+    for (uint i=0; i < shapeIds.size(); i++) {
+
+        TriangleShape triangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        triangleShape.setProfiler(mProfiler);
+
+#endif
+
+        Vector3 separatingAxis = initialAxis;
+        decimal distance;
+        Vector3 worldPoint1;
+        Vector3 worldPoint2;
+        gjkAlgorithm.computeDistance(shape, transform, &triangleShape, colliderTransform, separatingAxis, distance,
+                                     worldPoint1, worldPoint2);
+
+        if (distance <= maxDistance) {
+
+            maxDistance = distance;
+            outDistanceInfo.distance = distance;
+            outDistanceInfo.worldPoint1 = worldPoint1;
+            outDistanceInfo.worldPoint2 = worldPoint2;
+            outDistanceInfo.separatingAxis = separatingAxis;
+            isTriangleFound = true;
+
+            if (distance == decimal(0.0)) break;
+        }
+    }
+
+    return isTriangleFound;
+}
+
 // Convert the potential contact into actual contacts
 void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, bool updateLastFrameInfo,
                                                         List<ContactPointInfo>& potentialContactPoints,
@@ -37,8 +37,10 @@
 #include "tests/collision/TestCollisionWorld.h"
 #include "tests/collision/TestAABB.h"
 #include "tests/collision/TestDynamicAABBTree.h"
+#include "tests/collision/TestSweepAndPrune.h"
 #include "tests/collision/TestHalfEdgeStructure.h"
 #include "tests/collision/TestTriangleVertexArray.h"
+#include "tests/collision/TestWorldQueries.h"
 #include "tests/containers/TestList.h"
 #include "tests/containers/TestMap.h"
 #include "tests/containers/TestSet.h"
@@ -77,7 +79,9 @@ int main() {
     testSuite.addTest(new TestRaycast("Raycasting"));
     testSuite.addTest(new TestCollisionWorld("CollisionWorld"));
     testSuite.addTest(new TestDynamicAABBTree("DynamicAABBTree"));
+    testSuite.addTest(new TestSweepAndPrune("SweepAndPrune"));
     testSuite.addTest(new TestHalfEdgeStructure("HalfEdgeStructure"));
+    testSuite.addTest(new TestWorldQueries("WorldQueries"));
 
     // Run the tests
     testSuite.run();
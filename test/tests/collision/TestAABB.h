@@ -189,6 +189,18 @@ class TestAABB : public Test {
             rp3d_test(approxEqual(aabb7.getMax().x, 5));
             rp3d_test(approxEqual(aabb7.getMax().y, 12));
             rp3d_test(approxEqual(aabb7.getMax().z, 21));
+
+            // -------- Test extendAlongDisplacement() -------- //
+
+            AABB aabb8(Vector3(1,2,3), Vector3(5, 6, 7));
+            aabb8.extendAlongDisplacement(Vector3(2, -3, 0));
+
+            rp3d_test(approxEqual(aabb8.getMin().x, 1));
+            rp3d_test(approxEqual(aabb8.getMin().y, -1));
+            rp3d_test(approxEqual(aabb8.getMin().z, 3));
+            rp3d_test(approxEqual(aabb8.getMax().x, 7));
+            rp3d_test(approxEqual(aabb8.getMax().y, 6));
+            rp3d_test(approxEqual(aabb8.getMax().z, 7));
         }
 
         void testMergeMethods() {
@@ -294,6 +306,41 @@ class TestAABB : public Test {
             rp3d_test(mAABB1.testRayIntersect(ray6));
             rp3d_test(!mAABB1.testRayIntersect(ray7));
             rp3d_test(!mAABB1.testRayIntersect(ray8));
+
+            // -------- Test testCollisionSphere() -------- //
+
+            rp3d_test(mAABB1.testCollisionSphere(Vector3(0, 0, 0), 1));
+            rp3d_test(mAABB1.testCollisionSphere(Vector3(14, 0, 0), 5));
+            rp3d_test(!mAABB1.testCollisionSphere(Vector3(14, 0, 0), 3));
+            rp3d_test(!mAABB1.testCollisionSphere(Vector3(13, 13, 13), 5));
+            rp3d_test(mAABB1.testCollisionSphere(Vector3(13, 13, 13), 6));
+
+            // -------- Test testCollisionFrustum() -------- //
+
+            Frustum frustum1 = Frustum::createPerspective(Transform(Vector3(0, 0, 30), Quaternion::identity()),
+                                                          PI / decimal(3.0), decimal(1.0), decimal(0.1), decimal(100.0));
+            Frustum frustum2 = Frustum::createPerspective(Transform(Vector3(0, 0, 30), Quaternion::fromEulerAngles(0, PI, 0)),
+                                                          PI / decimal(3.0), decimal(1.0), decimal(0.1), decimal(100.0));
+            Frustum frustum3 = Frustum::createPerspective(Transform(Vector3(0, 0, 30), Quaternion::identity()),
+                                                          PI / decimal(3.0), decimal(1.0), decimal(0.1), decimal(15.0));
+
+            rp3d_test(frustum1.contains(Vector3(0, 0, 0)));
+            rp3d_test(!frustum2.contains(Vector3(0, 0, 0)));
+            rp3d_test(frustum2.contains(Vector3(0, 0, 40)));
+            rp3d_test(mAABB1.testCollisionFrustum(frustum1));
+            rp3d_test(!mAABB1.testCollisionFrustum(frustum2));
+            rp3d_test(!mAABB1.testCollisionFrustum(frustum3));
+            rp3d_test(mAABB4.testCollisionFrustum(frustum1));
+            rp3d_test(!mAABB4.testCollisionFrustum(frustum3));
+
+            // The corners of the frustum are on its planes
+            Vector3 corners[8];
+            frustum1.computeCorners(corners);
+            for (int i=0; i < 8; i++) {
+                rp3d_test(approxEqual(frustum1.planeNormals[i & 1].dot(corners[i]) + frustum1.planeDistances[i & 1], 0, decimal(0.0001)));
+                rp3d_test(approxEqual(frustum1.planeNormals[4 + (i >> 2)].dot(corners[i]) + frustum1.planeDistances[4 + (i >> 2)], 0, decimal(0.0001)));
+            }
+            rp3d_test(approxEqual(corners[7].z, -70, decimal(0.0001)));
         }
  };
 
@@ -31,8 +31,11 @@
 #include "Test.h"
 #include <reactphysics3d/constraint/ContactPoint.h>
 #include <reactphysics3d/collision/ContactManifold.h>
+#include <reactphysics3d/systems/BroadPhaseSystem.h>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -242,6 +245,10 @@ class WorldOverlapCallback : public OverlapCallback {
 			mOverlapBodies.clear();
 		}
 
+        const std::vector<std::pair<CollisionBody*, CollisionBody*>>& getOverlapBodies() const {
+            return mOverlapBodies;
+        }
+
         bool hasOverlapWithBody(CollisionBody* collisionBody) const {
 
             for (uint i=0; i < mOverlapBodies.size(); i++) {
@@ -253,6 +260,63 @@ class WorldOverlapCallback : public OverlapCallback {
 
             return false;
 		}
+
+        bool hasOverlapBetweenBodies(CollisionBody* body1, CollisionBody* body2) const {
+
+            for (uint i=0; i < mOverlapBodies.size(); i++) {
+
+                if ((mOverlapBodies[i].first == body1 && mOverlapBodies[i].second == body2) ||
+                    (mOverlapBodies[i].first == body2 && mOverlapBodies[i].second == body1)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+};
+
+/// Event listener that keeps the contact points reported during the last update of the world
+class WorldContactListener : public EventListener {
+
+    public:
+
+        /// Penetration depths of the contact points of the last update
+        std::vector<decimal> penetrationDepths;
+
+        /// Event types of the contact pairs of the last update
+        std::vector<CollisionCallback::ContactPair::EventType> eventTypes;
+
+        /// This method is called when some contacts occur
+        virtual void onContact(const CollisionCallback::CallbackData& callbackData) override {
+
+            penetrationDepths.clear();
+            eventTypes.clear();
+
+            for (uint p=0; p < callbackData.getNbContactPairs(); p++) {
+
+                ContactPair contactPair = callbackData.getContactPair(p);
+                eventTypes.push_back(contactPair.getEventType());
+                for (uint c=0; c < contactPair.getNbContactPoints(); c++) {
+                    penetrationDepths.push_back(contactPair.getContactPoint(c).getPenetrationDepth());
+                }
+            }
+        }
+
+        /// Return the number of contact pairs of the last update with a given event type
+        uint getNbEventTypes(CollisionCallback::ContactPair::EventType eventType) const {
+            return static_cast<uint>(std::count(eventTypes.begin(), eventTypes.end(), eventType));
+        }
+
+        /// Return the maximum penetration depth of the contact points of the last update
+        decimal getMaxPenetrationDepth() const {
+
+            decimal maxDepth = 0;
+            for (uint i=0; i < penetrationDepths.size(); i++) {
+                maxDepth = std::max(maxDepth, penetrationDepths[i]);
+            }
+
+            return maxDepth;
+        }
 };
 
 // Class TestCollisionWorld
@@ -503,6 +567,8 @@ class TestCollisionWorld : public Test {
             testSphereVsConcaveMeshCollision();
 
             testBoxVsBoxCollision();
+            testBoxVsBoxAlgorithm();
+            testBoxVsBoxTemporalCoherence();
             testBoxVsConvexMeshCollision();
             testBoxVsCapsuleCollision();
             testBoxVsConcaveMeshCollision();
@@ -511,8 +577,18 @@ class TestCollisionWorld : public Test {
             testCapsuleVsConcaveMeshCollision();
 
             testConvexMeshVsConvexMeshCollision();
+            testConvexMeshVsConvexMeshFeaturesArrays();
             testConvexMeshVsCapsuleCollision();
             testConvexMeshVsConcaveMeshCollision();
+
+            testParallelNarrowPhase();
+            testParallelBroadPhase();
+            testSphereAndCapsuleBatches();
+            testNarrowPhaseCache();
+            testConcaveTrianglesCache();
+            testStaticAndDynamicPairs();
+            testStaticAndDynamicTrees();
+            testStaticTreeIncrementalChanges();
         }
 
 		void testNoCollisions() {
@@ -1870,6 +1946,204 @@ class TestCollisionWorld : public Test {
             mBoxBody2->setTransform(initTransform2);
         }
 
+        void testBoxVsBoxAlgorithm() {
+
+            // The boxes are tested with the dedicated box vs box algorithm and the result is compared
+            // with a brute-force projection of the corners of the two boxes on the fifteen candidate
+            // separating axes. The convex meshes with the same geometry are tested with the general
+            // SAT algorithm, which must never find a collision that the box algorithm has missed.
+
+            Transform initBoxTransform1 = mBoxBody1->getTransform();
+            Transform initBoxTransform2 = mBoxBody2->getTransform();
+            Transform initConvexMeshTransform1 = mConvexMeshBody1->getTransform();
+            Transform initConvexMeshTransform2 = mConvexMeshBody2->getTransform();
+
+            const Vector3 halfExtents1 = mBoxShape1->getHalfExtents();
+            const Vector3 halfExtents2 = mBoxShape2->getHalfExtents();
+
+            // Return the smallest overlap of the projections of the two boxes on the candidate axes
+            auto computeMinOverlap = [&](const Transform& transform1, const Transform& transform2) {
+
+                Vector3 corners1[8];
+                Vector3 corners2[8];
+                for (int c=0; c < 8; c++) {
+                    const Vector3 signs((c & 1) ? 1 : -1, (c & 2) ? 1 : -1, (c & 4) ? 1 : -1);
+                    corners1[c] = transform1 * Vector3(signs.x * halfExtents1.x, signs.y * halfExtents1.y, signs.z * halfExtents1.z);
+                    corners2[c] = transform2 * Vector3(signs.x * halfExtents2.x, signs.y * halfExtents2.y, signs.z * halfExtents2.z);
+                }
+
+                const Matrix3x3 orientation1 = transform1.getOrientation().getMatrix();
+                const Matrix3x3 orientation2 = transform2.getOrientation().getMatrix();
+                Vector3 axes[15];
+                for (int a=0; a < 3; a++) {
+                    axes[a] = orientation1.getColumn(a);
+                    axes[3 + a] = orientation2.getColumn(a);
+                    for (int b=0; b < 3; b++) {
+                        axes[6 + 3 * a + b] = orientation1.getColumn(a).cross(orientation2.getColumn(b));
+                    }
+                }
+
+                decimal minOverlap = DECIMAL_LARGEST;
+                for (int a=0; a < 15; a++) {
+                    if (axes[a].lengthSquare() < decimal(1e-6)) continue;
+                    const Vector3 axis = axes[a].getUnit();
+                    decimal min1 = DECIMAL_LARGEST, max1 = -DECIMAL_LARGEST, min2 = DECIMAL_LARGEST, max2 = -DECIMAL_LARGEST;
+                    for (int c=0; c < 8; c++) {
+                        min1 = std::min(min1, corners1[c].dot(axis));
+                        max1 = std::max(max1, corners1[c].dot(axis));
+                        min2 = std::min(min2, corners2[c].dot(axis));
+                        max2 = std::max(max2, corners2[c].dot(axis));
+                    }
+                    minOverlap = std::min(minOverlap, std::min(max1 - min2, max2 - min1));
+                }
+
+                return minOverlap;
+            };
+
+            std::srand(7);
+
+            const Vector3 origin(100, 100, 100);
+            bool areCollisionsSame = true;
+            bool areContactPointsConsistent = true;
+            uint nbCollisions = 0;
+            for (uint i=0; i < 200; i++) {
+
+                const Transform transform1(origin, Quaternion::fromEulerAngles(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6));
+                const Transform transform2(origin + Vector3(computeRandomNumber() * 18 - 9, computeRandomNumber() * 18 - 9, computeRandomNumber() * 18 - 9),
+                                           Quaternion::fromEulerAngles(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6));
+                mBoxBody1->setTransform(transform1);
+                mBoxBody2->setTransform(transform2);
+                mConvexMeshBody1->setTransform(transform1);
+                mConvexMeshBody2->setTransform(transform2);
+
+                mCollisionCallback.reset();
+                mWorld->testCollision(mBoxBody1, mBoxBody2, mCollisionCallback);
+                const bool areBoxesColliding = mCollisionCallback.areCollidersColliding(mBoxCollider1, mBoxCollider2);
+
+                // The contact points on the two boxes must be separated by the penetration depth
+                if (areBoxesColliding) {
+
+                    nbCollisions++;
+
+                    const CollisionData* collisionData = mCollisionCallback.getCollisionData(mBoxCollider1, mBoxCollider2);
+                    const bool swappedBodies = collisionData->getBody1()->getEntity() != mBoxBody1->getEntity();
+                    const Transform& bodyTransform1 = swappedBodies ? transform2 : transform1;
+                    const Transform& bodyTransform2 = swappedBodies ? transform1 : transform2;
+                    for (uint p=0; p < collisionData->contactPairs.size(); p++) {
+                        for (uint c=0; c < collisionData->contactPairs[p].contactPoints.size(); c++) {
+
+                            const CollisionPointData& point = collisionData->contactPairs[p].contactPoints[c];
+                            const decimal distance = (bodyTransform1 * point.localPointBody1 - bodyTransform2 * point.localPointBody2).length();
+                            areContactPointsConsistent &= point.penetrationDepth > decimal(0.0) &&
+                                                          approxEqual(distance, point.penetrationDepth, decimal(0.001));
+                        }
+                    }
+                }
+
+                mCollisionCallback.reset();
+                mWorld->testCollision(mConvexMeshBody1, mConvexMeshBody2, mCollisionCallback);
+                const bool areConvexMeshesColliding = mCollisionCallback.areCollidersColliding(mConvexMeshCollider1, mConvexMeshCollider2);
+
+                // Configurations where the boxes are only touching are not compared
+                const decimal minOverlap = computeMinOverlap(transform1, transform2);
+                if (std::abs(minOverlap) > decimal(0.01)) {
+                    areCollisionsSame &= areBoxesColliding == (minOverlap > decimal(0.0));
+                }
+                areCollisionsSame &= areBoxesColliding || !areConvexMeshesColliding;
+            }
+
+            rp3d_test(areCollisionsSame);
+            rp3d_test(areContactPointsConsistent);
+            rp3d_test(nbCollisions > 0);
+
+            // reset the init transforms
+            mBoxBody1->setTransform(initBoxTransform1);
+            mBoxBody2->setTransform(initBoxTransform2);
+            mConvexMeshBody1->setTransform(initConvexMeshTransform1);
+            mConvexMeshBody2->setTransform(initConvexMeshTransform2);
+        }
+
+        void testBoxVsBoxTemporalCoherence() {
+
+            // A kinematic box is moved against a static box over several updates of the world so that
+            // the axis of the last frame is reused (face and edge axes, colliding and separated boxes).
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            WorldContactListener listener;
+            world->setEventListener(&listener);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(boxShape, Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+
+            RigidBody* box = world->createRigidBody(Transform(Vector3(0, decimal(0.45), 0), Quaternion::identity()));
+            box->setType(BodyType::KINEMATIC);
+            box->addCollider(boxShape, Transform::identity());
+
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            // Face contact found with all the axes and then by clipping with the face of the last frame
+            const decimal faceDepths[3] = {decimal(0.05), decimal(0.06), decimal(0.07)};
+            for (uint i=0; i < 3; i++) {
+                box->setTransform(Transform(Vector3(0, decimal(0.5) - faceDepths[i], 0), Quaternion::identity()));
+                listener.penetrationDepths.clear();
+                world->update(timeStep);
+                rp3d_test(listener.penetrationDepths.size() == 4);
+                rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), faceDepths[i], decimal(0.0001)));
+            }
+
+            // The boxes are separated along the face axis of the last frame
+            for (uint i=0; i < 2; i++) {
+                box->setTransform(Transform(Vector3(0, decimal(0.6) + decimal(i) * decimal(0.1), 0), Quaternion::identity()));
+                listener.penetrationDepths.clear();
+                world->update(timeStep);
+                rp3d_test(listener.penetrationDepths.size() == 0);
+            }
+
+            // The box is moved to the side of the ground box: the axis of the last frame is not a separating axis anymore
+            box->setTransform(Transform(Vector3(decimal(0.95), decimal(-0.5), 0), Quaternion::identity()));
+            listener.penetrationDepths.clear();
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 4);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.05), decimal(0.0001)));
+
+            // The boxes are separated before the edge vs edge configuration (the contacts of a resting pair are
+            // only computed again when the box is not penetrating along the axis of the last frame anymore)
+            box->setTransform(Transform(Vector3(0, decimal(2.0), 0), Quaternion::identity()));
+            listener.penetrationDepths.clear();
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 0);
+
+            // Edge vs edge contact: the ground box is rotated around the z axis and the other box around the x axis
+            const decimal halfDiagonal = decimal(0.5) * std::sqrt(decimal(2.0));
+            ground->setTransform(Transform(Vector3(0, -1, 0), Quaternion::fromEulerAngles(0, 0, rp3d::PI / decimal(4.0))));
+            ground->getCollider(0)->setLocalToBodyTransform(Transform::identity());
+            const decimal edgeDepths[3] = {decimal(0.01), decimal(0.02), decimal(0.03)};
+            for (uint i=0; i < 3; i++) {
+                box->setTransform(Transform(Vector3(0, decimal(-1.0) + decimal(2.0) * halfDiagonal - edgeDepths[i], 0),
+                                            Quaternion::fromEulerAngles(rp3d::PI / decimal(4.0), 0, 0)));
+                listener.penetrationDepths.clear();
+                world->update(timeStep);
+                rp3d_test(listener.penetrationDepths.size() == 1);
+                rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), edgeDepths[i], decimal(0.0001)));
+            }
+
+            // The boxes are separated along the edges axis of the last frame
+            box->setTransform(Transform(Vector3(0, decimal(-0.9) + decimal(2.0) * halfDiagonal, 0),
+                                        Quaternion::fromEulerAngles(rp3d::PI / decimal(4.0), 0, 0)));
+            listener.penetrationDepths.clear();
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 0);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+
         void testBoxVsConvexMeshCollision() {
 
             Transform initTransform1 = mBoxBody1->getTransform();
@@ -2030,6 +2304,70 @@ class TestCollisionWorld : public Test {
             mConvexMeshBody2->setTransform(initTransform2);
         }
 
+        void testConvexMeshVsConvexMeshFeaturesArrays() {
+
+            // Two convex meshes are tested by the SAT algorithm with the cached arrays of the meshes. The
+            // first convex mesh has the same geometry as the first box, which is tested against the second
+            // convex mesh with the polyhedron accessors. Both tests must find the same collisions.
+
+            Transform initBoxTransform1 = mBoxBody1->getTransform();
+            Transform initConvexMeshTransform1 = mConvexMeshBody1->getTransform();
+            Transform initConvexMeshTransform2 = mConvexMeshBody2->getTransform();
+
+            std::srand(11);
+
+            // Return the largest penetration depth of the contact points between two colliders
+            auto computeMaxPenetrationDepth = [this](Collider* collider1, Collider* collider2) {
+                decimal maxPenetrationDepth = decimal(0.0);
+                const CollisionData* collisionData = mCollisionCallback.getCollisionData(collider1, collider2);
+                for (uint p=0; p < collisionData->contactPairs.size(); p++) {
+                    for (uint c=0; c < collisionData->contactPairs[p].contactPoints.size(); c++) {
+                        maxPenetrationDepth = std::max(maxPenetrationDepth, collisionData->contactPairs[p].contactPoints[c].penetrationDepth);
+                    }
+                }
+                return maxPenetrationDepth;
+            };
+
+            const Vector3 origin(100, 100, 100);
+            bool areCollisionsSame = true;
+            bool arePenetrationDepthsSame = true;
+            uint nbCollisions = 0;
+            for (uint i=0; i < 200; i++) {
+
+                const Transform transform1(origin, Quaternion::fromEulerAngles(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6));
+                const Transform transform2(origin + Vector3(computeRandomNumber() * 18 - 9, computeRandomNumber() * 18 - 9, computeRandomNumber() * 18 - 9),
+                                           Quaternion::fromEulerAngles(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6));
+                mBoxBody1->setTransform(transform1);
+                mConvexMeshBody1->setTransform(transform1);
+                mConvexMeshBody2->setTransform(transform2);
+
+                mCollisionCallback.reset();
+                mWorld->testCollision(mConvexMeshBody1, mConvexMeshBody2, mCollisionCallback);
+                const bool areConvexMeshesColliding = mCollisionCallback.areCollidersColliding(mConvexMeshCollider1, mConvexMeshCollider2);
+                const decimal convexMeshesPenetrationDepth = areConvexMeshesColliding ?
+                                                             computeMaxPenetrationDepth(mConvexMeshCollider1, mConvexMeshCollider2) : decimal(0.0);
+
+                mCollisionCallback.reset();
+                mWorld->testCollision(mBoxBody1, mConvexMeshBody2, mCollisionCallback);
+                const bool areBoxAndConvexMeshColliding = mCollisionCallback.areCollidersColliding(mBoxCollider1, mConvexMeshCollider2);
+                const decimal boxAndConvexMeshPenetrationDepth = areBoxAndConvexMeshColliding ?
+                                                                 computeMaxPenetrationDepth(mBoxCollider1, mConvexMeshCollider2) : decimal(0.0);
+
+                areCollisionsSame &= areConvexMeshesColliding == areBoxAndConvexMeshColliding;
+                arePenetrationDepthsSame &= approxEqual(convexMeshesPenetrationDepth, boxAndConvexMeshPenetrationDepth, decimal(0.001));
+                if (areConvexMeshesColliding) nbCollisions++;
+            }
+
+            rp3d_test(areCollisionsSame);
+            rp3d_test(arePenetrationDepthsSame);
+            rp3d_test(nbCollisions > 0);
+
+            // reset the init transforms
+            mBoxBody1->setTransform(initBoxTransform1);
+            mConvexMeshBody1->setTransform(initConvexMeshTransform1);
+            mConvexMeshBody2->setTransform(initConvexMeshTransform2);
+        }
+
         void testConvexMeshVsConvexMeshCollision() {
 
             Transform initTransform1 = mConvexMeshBody1->getTransform();
@@ -2953,6 +3291,604 @@ class TestCollisionWorld : public Test {
             mCapsuleBody1->setTransform(initTransform1);
             mConcaveMeshBody->setTransform(initTransform2);
         }
+
+        void testParallelNarrowPhase() {
+
+            // The same scene is simulated with a single thread and with several threads
+            // and the narrow-phase must give exactly the same results
+            std::vector<Transform> transforms1;
+            std::vector<Transform> transforms2;
+            simulateNarrowPhaseScene(1, transforms1);
+            simulateNarrowPhaseScene(4, transforms2);
+
+            rp3d_test(transforms1.size() == transforms2.size());
+
+            bool areTransformsEqual = transforms1.size() == transforms2.size();
+            for (uint i=0; areTransformsEqual && i < transforms1.size(); i++) {
+                areTransformsEqual = transforms1[i] == transforms2[i];
+            }
+            rp3d_test(areTransformsEqual);
+        }
+
+        // Simulate a few frames of a scene with many overlapping shapes and return the final transforms of the bodies
+        void simulateNarrowPhaseScene(uint nbWorkerThreads, std::vector<Transform>& outTransforms) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.nbWorkerThreads = nbWorkerThreads;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.4), decimal(0.6));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            // Grid of bodies that overlap with their neighbors
+            std::vector<RigidBody*> bodies;
+            for (int i=0; i < 12; i++) {
+                for (int j=0; j < 12; j++) {
+                    for (int k=0; k < 2; k++) {
+
+                        const Vector3 position(decimal(i) * decimal(0.9) - 5, decimal(0.45) + decimal(k) * decimal(0.9), decimal(j) * decimal(0.9) - 5);
+                        RigidBody* body = world->createRigidBody(Transform(position, Quaternion::identity()));
+
+                        switch ((i + j + k) % 3) {
+                            case 0: body->addCollider(sphereShape, Transform::identity()); break;
+                            case 1: body->addCollider(boxShape, Transform::identity()); break;
+                            default: body->addCollider(capsuleShape, Transform::identity()); break;
+                        }
+
+                        bodies.push_back(body);
+                    }
+                }
+            }
+
+            for (int i=0; i < 10; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+
+            for (uint i=0; i < bodies.size(); i++) {
+                outTransforms.push_back(bodies[i]->getTransform());
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(groundShape);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroyCapsuleShape(capsuleShape);
+        }
+
+        void testParallelBroadPhase() {
+
+            // The same scene is queried with a single thread and with several threads
+            // and the broad-phase must find exactly the same pairs of bodies
+            std::vector<std::vector<std::pair<int, int>>> pairs1;
+            std::vector<std::vector<std::pair<int, int>>> pairs2;
+            simulateBroadPhaseScene(1, pairs1);
+            simulateBroadPhaseScene(4, pairs2);
+
+            rp3d_test(pairs1.size() == 3);
+            rp3d_test(pairs1 == pairs2);
+            for (uint i=0; i < pairs1.size(); i++) {
+                rp3d_test(pairs1[i].size() > 0);
+            }
+        }
+
+        // Query the overlapping bodies of a large scene after some of its bodies have been moved and return
+        // the sorted pairs of overlapping bodies (as indices of the bodies) after each query
+        void simulateBroadPhaseScene(uint nbWorkerThreads, std::vector<std::vector<std::pair<int, int>>>& outPairs) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.nbWorkerThreads = nbWorkerThreads;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* floorShape = mPhysicsCommon.createBoxShape(Vector3(30, 1, 30));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.55), decimal(0.55), decimal(0.55)));
+
+            std::map<CollisionBody*, int> bodiesIndices;
+
+            // Two static floors below the boxes
+            for (int i=0; i < 2; i++) {
+                RigidBody* floor = world->createRigidBody(Transform(Vector3(decimal(i) * 60 - 5, -1, 20), Quaternion::identity()));
+                floor->setType(BodyType::STATIC);
+                floor->addCollider(floorShape, Transform::identity());
+                bodiesIndices.insert(std::make_pair(floor, static_cast<int>(bodiesIndices.size())));
+            }
+
+            // Grid of boxes that overlap with their neighbors (enough boxes so that the
+            // queries of the broad-phase are split into several tasks)
+            std::vector<CollisionBody*> bodies;
+            for (int i=0; i < 50; i++) {
+                for (int j=0; j < 50; j++) {
+
+                    const Vector3 position(decimal(i), decimal(0.5), decimal(j));
+                    CollisionBody* body = world->createCollisionBody(Transform(position, Quaternion::identity()));
+                    body->addCollider(boxShape, Transform::identity());
+                    bodiesIndices.insert(std::make_pair(body, static_cast<int>(bodiesIndices.size())));
+                    bodies.push_back(body);
+                }
+            }
+
+            WorldOverlapCallback overlapCallback;
+
+            for (int step=0; step < 3; step++) {
+
+                // All the boxes are new in the first query (dual-tree traversal). Then, a part of the boxes
+                // is moved (queries of the moved shapes) and finally most of the boxes are moved again.
+                if (step > 0) {
+                    const uint nbMovedBodies = step == 1 ? 600 : 2000;
+                    for (uint i=0; i < nbMovedBodies; i++) {
+                        CollisionBody* body = bodies[(i * 7) % bodies.size()];
+                        const Vector3 displacement(decimal(2.3), decimal(step - 1) * decimal(0.7), decimal(0.4));
+                        body->setTransform(Transform(body->getTransform().getPosition() + displacement, Quaternion::identity()));
+                    }
+                }
+
+                overlapCallback.reset();
+                world->testOverlap(overlapCallback);
+
+                std::vector<std::pair<int, int>> pairs;
+                for (uint i=0; i < overlapCallback.getOverlapBodies().size(); i++) {
+                    const int index1 = bodiesIndices[overlapCallback.getOverlapBodies()[i].first];
+                    const int index2 = bodiesIndices[overlapCallback.getOverlapBodies()[i].second];
+                    pairs.push_back(std::make_pair(std::min(index1, index2), std::max(index1, index2)));
+                }
+                std::sort(pairs.begin(), pairs.end());
+                outPairs.push_back(pairs);
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(floorShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+
+        /// Return a pseudo-random number between 0 and 1 (the sequence is selected with std::srand())
+        static decimal computeRandomNumber() {
+            return decimal(std::rand()) / decimal(RAND_MAX);
+        }
+
+        void testSphereAndCapsuleBatches() {
+
+            // Many sphere and capsule pairs are tested in the same narrow-phase batches
+            // and the results are compared with the exact distances
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            const uint nbBodies = 40;
+            std::vector<CollisionBody*> sphereBodies;
+            std::vector<CollisionBody*> capsuleBodies;
+            std::vector<SphereShape*> sphereShapes;
+            std::vector<CapsuleShape*> capsuleShapes;
+
+            std::srand(1);
+
+            for (uint i=0; i < nbBodies; i++) {
+
+                // The spheres and the capsules are far away from each other
+                const Vector3 spherePosition(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6);
+                SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.3) + computeRandomNumber() * decimal(0.3));
+                CollisionBody* sphereBody = world->createCollisionBody(Transform(spherePosition, Quaternion::identity()));
+                sphereBody->addCollider(sphereShape, Transform::identity());
+                sphereShapes.push_back(sphereShape);
+                sphereBodies.push_back(sphereBody);
+
+                const Vector3 capsulePosition(computeRandomNumber() * 8 + 100, computeRandomNumber() * 8, computeRandomNumber() * 8);
+                const Quaternion capsuleOrientation = Quaternion::fromEulerAngles(computeRandomNumber() * 6, computeRandomNumber() * 6, computeRandomNumber() * 6);
+                CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.2) + computeRandomNumber() * decimal(0.3),
+                                                                               decimal(0.5) + computeRandomNumber() * 2);
+                CollisionBody* capsuleBody = world->createCollisionBody(Transform(capsulePosition, capsuleOrientation));
+                capsuleBody->addCollider(capsuleShape, Transform::identity());
+                capsuleShapes.push_back(capsuleShape);
+                capsuleBodies.push_back(capsuleBody);
+            }
+
+            WorldOverlapCallback overlapCallback;
+            world->testOverlap(overlapCallback);
+
+            // The pairs that are too close to the contact are not checked
+            const decimal tolerance = decimal(0.01);
+
+            bool areSphereResultsCorrect = true;
+            bool areCapsuleResultsCorrect = true;
+            uint nbCheckedOverlaps = 0;
+            for (uint i=0; i < nbBodies; i++) {
+                for (uint j=i+1; j < nbBodies; j++) {
+
+                    const decimal sphereDistance = (sphereBodies[j]->getTransform().getPosition() -
+                                                    sphereBodies[i]->getTransform().getPosition()).length() -
+                                                   sphereShapes[i]->getRadius() - sphereShapes[j]->getRadius();
+                    if (std::abs(sphereDistance) > tolerance) {
+                        const bool isOverlapping = sphereDistance < decimal(0.0);
+                        areSphereResultsCorrect &= overlapCallback.hasOverlapBetweenBodies(sphereBodies[i], sphereBodies[j]) == isOverlapping;
+                        if (isOverlapping) nbCheckedOverlaps++;
+                    }
+
+                    const Transform& transform1 = capsuleBodies[i]->getTransform();
+                    const Transform& transform2 = capsuleBodies[j]->getTransform();
+                    const Vector3 halfSegment1(0, capsuleShapes[i]->getHeight() * decimal(0.5), 0);
+                    const Vector3 halfSegment2(0, capsuleShapes[j]->getHeight() * decimal(0.5), 0);
+                    Vector3 closestPoint1;
+                    Vector3 closestPoint2;
+                    computeClosestPointBetweenTwoSegments(transform1 * (-halfSegment1), transform1 * halfSegment1,
+                                                          transform2 * (-halfSegment2), transform2 * halfSegment2,
+                                                          closestPoint1, closestPoint2);
+                    const decimal capsuleDistance = (closestPoint2 - closestPoint1).length() -
+                                                    capsuleShapes[i]->getRadius() - capsuleShapes[j]->getRadius();
+                    if (std::abs(capsuleDistance) > tolerance) {
+                        const bool isOverlapping = capsuleDistance < decimal(0.0);
+                        areCapsuleResultsCorrect &= overlapCallback.hasOverlapBetweenBodies(capsuleBodies[i], capsuleBodies[j]) == isOverlapping;
+                        if (isOverlapping) nbCheckedOverlaps++;
+                    }
+                }
+            }
+
+            rp3d_test(areSphereResultsCorrect);
+            rp3d_test(areCapsuleResultsCorrect);
+            rp3d_test(nbCheckedOverlaps > 0);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            for (uint i=0; i < nbBodies; i++) {
+                mPhysicsCommon.destroySphereShape(sphereShapes[i]);
+                mPhysicsCommon.destroyCapsuleShape(capsuleShapes[i]);
+            }
+        }
+
+        void testNarrowPhaseCache() {
+
+            // A kinematic box rests on a static box and is moved by small and large displacements.
+            // The cached contacts must be reused for the small displacements only.
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.isNarrowPhaseCacheEnabled = true;
+            settings.narrowPhaseCacheTranslationTolerance = decimal(0.001);
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            WorldContactListener listener;
+            world->setEventListener(&listener);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(5, 1, 5));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            RigidBody* box = world->createRigidBody(Transform(Vector3(0, decimal(0.45), 0), Quaternion::identity()));
+            box->setType(BodyType::KINEMATIC);
+            box->addCollider(boxShape, Transform::identity());
+
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 4);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.05), decimal(0.0001)));
+
+            // Small displacement (smaller than the tolerance): the cached contacts are reused
+            box->setTransform(Transform(Vector3(0, decimal(0.4495), 0), Quaternion::identity()));
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 4);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.05), decimal(0.00001)));
+
+            // Small rotation (smaller than the tolerance): the cached contacts are reused
+            box->setTransform(Transform(Vector3(0, decimal(0.4495), 0), Quaternion::fromEulerAngles(0, decimal(0.0005), 0)));
+            world->update(timeStep);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.05), decimal(0.00001)));
+
+            // Large displacement: the contacts are computed again
+            box->setTransform(Transform(Vector3(0, decimal(0.44), 0), Quaternion::identity()));
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 4);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.06), decimal(0.0001)));
+
+            // Large rotation: the contacts are computed again
+            box->setTransform(Transform(Vector3(0, decimal(0.44), 0), Quaternion::fromEulerAngles(decimal(0.01), 0, 0)));
+            world->update(timeStep);
+            const decimal rotatedDepth = decimal(0.5) * (std::cos(decimal(0.01)) + std::sin(decimal(0.01))) - decimal(0.44);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), rotatedDepth, decimal(0.0001)));
+
+            // The size of a shape changes: the cached contacts cannot be reused
+            box->setTransform(Transform(Vector3(0, decimal(0.44), 0), Quaternion::identity()));
+            world->update(timeStep);
+            boxShape->setHalfExtents(Vector3(decimal(0.6), decimal(0.6), decimal(0.6)));
+            world->update(timeStep);
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.16), decimal(0.0001)));
+
+            // The two bodies are separated
+            box->setTransform(Transform(Vector3(0, decimal(0.65), 0), Quaternion::identity()));
+            listener.penetrationDepths.clear();
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 0);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(groundShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+
+        void testConcaveTrianglesCache() {
+
+            // A small sphere slides over the flat concave mesh in small steps so that the triangles
+            // of the mesh are sometimes reused from the cache of the pair and sometimes queried again.
+            // The sphere must always collide with the mesh with the same maximum penetration depth (the sphere
+            // stays below the part of the mesh where the grid of triangles is complete and on the side of
+            // the normals of the triangles).
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            CollisionBody* meshBody = world->createCollisionBody(Transform::identity());
+            Collider* meshCollider = meshBody->addCollider(mConcaveMeshShape, Transform::identity());
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.25));
+            CollisionBody* sphereBody = world->createCollisionBody(Transform::identity());
+            Collider* sphereCollider = sphereBody->addCollider(sphereShape, Transform::identity());
+
+            const uint nbSteps = 100;
+            bool isAlwaysColliding = true;
+            bool isDepthCorrect = true;
+            for (uint i=0; i <= nbSteps; i++) {
+
+                const decimal t = decimal(i) / decimal(nbSteps);
+                const Vector3 position(decimal(-2.1) + t * decimal(1.2), decimal(-0.2), decimal(-2.2) + t * decimal(4.4));
+                sphereBody->setTransform(Transform(position, Quaternion::identity()));
+
+                // Move the sphere away from the mesh once
+                const bool isAwayFromMesh = (i == nbSteps / 2);
+                if (isAwayFromMesh) {
+                    sphereBody->setTransform(Transform(position - Vector3(0, decimal(0.1), 0), Quaternion::identity()));
+                }
+
+                mCollisionCallback.reset();
+                world->testCollision(sphereBody, meshBody, mCollisionCallback);
+
+                const bool isColliding = mCollisionCallback.areCollidersColliding(sphereCollider, meshCollider);
+                if (isAwayFromMesh) {
+                    isAlwaysColliding &= !isColliding;
+                    continue;
+                }
+
+                isAlwaysColliding &= isColliding;
+                if (!isColliding) continue;
+
+                // The deepest contact is with the triangle right above the sphere (the other contacts are
+                // with the edges of the neighbor triangles)
+                const CollisionData* collisionData = mCollisionCallback.getCollisionData(sphereCollider, meshCollider);
+                decimal maxDepth = 0;
+                for (uint p=0; p < collisionData->contactPairs.size(); p++) {
+                    for (uint c=0; c < collisionData->contactPairs[p].contactPoints.size(); c++) {
+                        maxDepth = std::max(maxDepth, collisionData->contactPairs[p].contactPoints[c].penetrationDepth);
+                    }
+                }
+                isDepthCorrect &= approxEqual(maxDepth, decimal(0.05), decimal(0.001));
+            }
+
+            rp3d_test(isAlwaysColliding);
+            rp3d_test(isDepthCorrect);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+        }
+
+        void testStaticAndDynamicPairs() {
+
+            // Several dynamic boxes rest on each static box. The broad-phase IDs of the static colliders
+            // are large (they have the static tree flag) and every pair of an overlapping static and dynamic
+            // box must have a unique pair ID and report contacts.
+
+            const uint nbStaticBoxes = 4;
+            const uint nbDynamicBoxesPerStaticBox = 10;
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.gravity = Vector3::zero();
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            WorldContactListener listener;
+            world->setEventListener(&listener);
+
+            BoxShape* staticShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 5));
+            BoxShape* dynamicShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.4), decimal(0.5), decimal(0.4)));
+
+            std::vector<RigidBody*> staticBodies;
+            std::vector<RigidBody*> dynamicBodies;
+            for (uint i=0; i < nbStaticBoxes; i++) {
+
+                RigidBody* staticBody = world->createRigidBody(Transform(Vector3(decimal(i) * 10, 0, 0), Quaternion::identity()));
+                staticBody->setType(BodyType::STATIC);
+                staticBody->addCollider(staticShape, Transform::identity());
+                staticBodies.push_back(staticBody);
+            }
+            for (uint i=0; i < nbStaticBoxes * nbDynamicBoxesPerStaticBox; i++) {
+
+                // The dynamic box penetrates 0.1 inside the top face of its static box
+                const uint staticBoxIndex = i % nbStaticBoxes;
+                const decimal z = decimal(-4.5) + decimal(i / nbStaticBoxes);
+                RigidBody* dynamicBody = world->createRigidBody(Transform(Vector3(decimal(staticBoxIndex) * 10, decimal(1.4), z),
+                                                                          Quaternion::identity()));
+                dynamicBody->addCollider(dynamicShape, Transform::identity());
+                dynamicBodies.push_back(dynamicBody);
+            }
+
+            // Each dynamic box must only collide with its static box (with four contact points)
+            bool areContactsCorrect = true;
+            for (uint s=0; s < nbStaticBoxes; s++) {
+                for (uint d=0; d < dynamicBodies.size(); d++) {
+
+                    mCollisionCallback.reset();
+                    world->testCollision(staticBodies[s], dynamicBodies[d], mCollisionCallback);
+
+                    const bool shouldCollide = d % nbStaticBoxes == s;
+                    const Collider* staticCollider = staticBodies[s]->getCollider(0);
+                    const Collider* dynamicCollider = dynamicBodies[d]->getCollider(0);
+                    const bool areColliding = mCollisionCallback.areCollidersColliding(staticCollider, dynamicCollider);
+                    areContactsCorrect &= areColliding == shouldCollide;
+                    if (areColliding) {
+                        areContactsCorrect &= mCollisionCallback.getCollisionData(staticCollider, dynamicCollider)->getTotalNbContactPoints() == 4;
+                    }
+                }
+            }
+            rp3d_test(areContactsCorrect);
+
+            // All the pairs must also report their contacts when the world is updated
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(listener.penetrationDepths.size() == 4 * dynamicBodies.size());
+            rp3d_test(approxEqual(listener.getMaxPenetrationDepth(), decimal(0.1), decimal(0.0001)));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(staticShape);
+            mPhysicsCommon.destroyBoxShape(dynamicShape);
+        }
+
+        void testStaticAndDynamicTrees() {
+
+            // Two static boxes and a dynamic box overlap each other. The colliders of the static bodies
+            // are in the static tree of the broad-phase and a pair is never created between two of them.
+            // The colliders must move to the other tree when the type of their body changes.
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            settings.gravity = Vector3::zero();
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            WorldContactListener listener;
+            world->setEventListener(&listener);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+
+            RigidBody* staticBody1 = world->createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            staticBody1->setType(BodyType::STATIC);
+            Collider* staticCollider1 = staticBody1->addCollider(boxShape, Transform::identity());
+
+            RigidBody* staticBody2 = world->createRigidBody(Transform(Vector3(decimal(1.5), 0, 0), Quaternion::identity()));
+            Collider* staticCollider2 = staticBody2->addCollider(boxShape, Transform::identity());
+            staticBody2->setType(BodyType::STATIC);
+
+            RigidBody* dynamicBody = world->createRigidBody(Transform(Vector3(decimal(0.75), decimal(1.5), 0), Quaternion::identity()));
+            Collider* dynamicCollider = dynamicBody->addCollider(boxShape, Transform::identity());
+
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            // A body that becomes static after its colliders have been added must also move them to the static tree
+            rp3d_test(BroadPhaseSystem::isStaticTreeBroadPhaseId(staticCollider1->getBroadPhaseId()));
+            rp3d_test(BroadPhaseSystem::isStaticTreeBroadPhaseId(staticCollider2->getBroadPhaseId()));
+            rp3d_test(!BroadPhaseSystem::isStaticTreeBroadPhaseId(dynamicCollider->getBroadPhaseId()));
+
+            // There is no pair between the two static bodies
+            rp3d_test(!world->testOverlap(staticBody1, staticBody2));
+            rp3d_test(world->testOverlap(staticBody1, dynamicBody));
+            rp3d_test(world->testOverlap(staticBody2, dynamicBody));
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 8);
+
+            // The dynamic body becomes static: its collider moves to the static tree and its pairs are removed
+            // (the contacts with the two static bodies are reported as lost)
+            dynamicBody->setType(BodyType::STATIC);
+            rp3d_test(BroadPhaseSystem::isStaticTreeBroadPhaseId(dynamicCollider->getBroadPhaseId()));
+            rp3d_test(!world->testOverlap(staticBody1, dynamicBody));
+            rp3d_test(!world->testOverlap(staticBody2, dynamicBody));
+            listener.penetrationDepths.clear();
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 0);
+            rp3d_test(listener.getNbEventTypes(CollisionCallback::ContactPair::EventType::ContactExit) == 2);
+
+            // A static body becomes dynamic: its collider moves to the dynamic tree and overlaps the two other static bodies
+            staticBody1->setType(BodyType::DYNAMIC);
+            rp3d_test(!BroadPhaseSystem::isStaticTreeBroadPhaseId(staticCollider1->getBroadPhaseId()));
+            rp3d_test(world->testOverlap(staticBody1, staticBody2));
+            rp3d_test(world->testOverlap(staticBody1, dynamicBody));
+            rp3d_test(!world->testOverlap(staticBody2, dynamicBody));
+            world->update(timeStep);
+            rp3d_test(listener.penetrationDepths.size() == 8);
+
+            // The static body becomes dynamic again. Its pair with the dynamic body is kept (the contact
+            // stays) and only its pair with the other static body is new.
+            dynamicBody->setType(BodyType::DYNAMIC);
+            rp3d_test(!BroadPhaseSystem::isStaticTreeBroadPhaseId(dynamicCollider->getBroadPhaseId()));
+            world->update(timeStep);
+            rp3d_test(listener.getNbEventTypes(CollisionCallback::ContactPair::EventType::ContactStart) == 1);
+            rp3d_test(listener.getNbEventTypes(CollisionCallback::ContactPair::EventType::ContactStay) == 2);
+
+            // A kinematic body is stored in the dynamic tree
+            staticBody2->setType(BodyType::KINEMATIC);
+            rp3d_test(!BroadPhaseSystem::isStaticTreeBroadPhaseId(staticCollider2->getBroadPhaseId()));
+            rp3d_test(world->testOverlap(staticBody1, staticBody2));
+            rp3d_test(world->testOverlap(staticBody2, dynamicBody));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+
+        void testStaticTreeIncrementalChanges() {
+
+            // A few static bodies are added to and removed from a large static tree. They are inserted
+            // and removed incrementally (without a rebuild of the tree) and their pairs with the dynamic
+            // bodies must still be found. Adding many static bodies at once rebuilds the static tree.
+
+            const uint nbStaticBoxes = 64;
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            // A row of static boxes with a dynamic box resting on each one of them
+            std::vector<RigidBody*> bottomStaticBodies;
+            std::vector<RigidBody*> dynamicBodies;
+            for (uint i=0; i < nbStaticBoxes; i++) {
+
+                RigidBody* staticBody = world->createRigidBody(Transform(Vector3(decimal(i) * 2, 0, 0), Quaternion::identity()));
+                staticBody->setType(BodyType::STATIC);
+                staticBody->addCollider(boxShape, Transform::identity());
+                bottomStaticBodies.push_back(staticBody);
+
+                RigidBody* dynamicBody = world->createRigidBody(Transform(Vector3(decimal(i) * 2, decimal(0.9), 0), Quaternion::identity()));
+                dynamicBody->addCollider(boxShape, Transform::identity());
+                dynamicBodies.push_back(dynamicBody);
+            }
+            bool areOverlapsCorrect = true;
+            for (uint i=0; i < nbStaticBoxes; i++) {
+                areOverlapsCorrect &= world->testOverlap(bottomStaticBodies[i], dynamicBodies[i]);
+            }
+            rp3d_test(areOverlapsCorrect);
+
+            // A single static box is added above the first dynamic box and the last bottom static box is removed
+            std::vector<RigidBody*> topStaticBodies;
+            RigidBody* newStaticBody = world->createRigidBody(Transform(Vector3(0, decimal(1.8), 0), Quaternion::identity()));
+            newStaticBody->setType(BodyType::STATIC);
+            newStaticBody->addCollider(boxShape, Transform::identity());
+            topStaticBodies.push_back(newStaticBody);
+            world->destroyRigidBody(bottomStaticBodies.back());
+            bottomStaticBodies.pop_back();
+            rp3d_test(world->testOverlap(newStaticBody, dynamicBodies[0]));
+            rp3d_test(!world->testOverlap(newStaticBody, dynamicBodies[1]));
+            areOverlapsCorrect = true;
+            for (uint i=0; i < nbStaticBoxes - 1; i++) {
+                areOverlapsCorrect &= world->testOverlap(bottomStaticBodies[i], dynamicBodies[i]);
+            }
+            rp3d_test(areOverlapsCorrect);
+
+            // Many static boxes are added above the other dynamic boxes (the static tree is rebuilt)
+            for (uint i=1; i < nbStaticBoxes; i++) {
+
+                RigidBody* staticBody = world->createRigidBody(Transform(Vector3(decimal(i) * 2, decimal(1.8), 0), Quaternion::identity()));
+                staticBody->setType(BodyType::STATIC);
+                staticBody->addCollider(boxShape, Transform::identity());
+                topStaticBodies.push_back(staticBody);
+            }
+            areOverlapsCorrect = true;
+            for (uint i=0; i < nbStaticBoxes; i++) {
+                areOverlapsCorrect &= world->testOverlap(topStaticBodies[i], dynamicBodies[i]);
+                areOverlapsCorrect &= !world->testOverlap(topStaticBodies[i], bottomStaticBodies[0]);
+                if (i < nbStaticBoxes - 1) {
+                    areOverlapsCorrect &= world->testOverlap(bottomStaticBodies[i], dynamicBodies[i]);
+                }
+            }
+            rp3d_test(areOverlapsCorrect);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
  };
 
 }
@@ -33,6 +33,9 @@
 #include <reactphysics3d/engine/PhysicsCommon.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -136,6 +139,15 @@ class TestDynamicAABBTree : public Test {
             testBasicsMethods();
             testOverlapping();
             testRaycast();
+            testWideTree();
+            testQuantizedTree();
+            testRebuildAndOptimize();
+            testPredictiveFatAABB();
+            testWorldPredictiveFatAABB();
+            testBulkInsertion();
+            testCompaction();
+            testWorldCompaction();
+            testDualTreeTraversal();
 
         }
 
@@ -187,6 +199,18 @@ class TestDynamicAABBTree : public Test {
             rp3d_test(*(int*)(tree.getNodeDataPointer(object2Id)) == object2Data);
             rp3d_test(*(int*)(tree.getNodeDataPointer(object3Id)) == object3Data);
             rp3d_test(*(int*)(tree.getNodeDataPointer(object4Id)) == object4Data);
+
+            // Test the moved flag of the leaves (reset when a node is released)
+            rp3d_test(!tree.getIsLeafMoved(object1Id));
+            tree.setIsLeafMoved(object1Id, true);
+            tree.setIsLeafMoved(object3Id, true);
+            rp3d_test(tree.getIsLeafMoved(object1Id));
+            tree.updateObject(object1Id, AABB(Vector3(20, 20, 20), Vector3(21, 21, 21)));
+            rp3d_test(tree.getIsLeafMoved(object1Id));
+            tree.removeObject(object3Id);
+            rp3d_test(!tree.getIsLeafMoved(object3Id));
+            int object5Id = tree.addObject(aabb3, &object3Data);
+            rp3d_test(!tree.getIsLeafMoved(object5Id));
         }
 
         void testOverlapping() {
@@ -560,6 +584,740 @@ class TestDynamicAABBTree : public Test {
             rp3d_test(mRaycastCallback.isHit(object4Id));
 
         }
+
+        void testPredictiveFatAABB() {
+
+            DynamicAABBTree tree(mAllocator);
+
+            int objectData = 56;
+            int objectId = tree.addObject(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), &objectData);
+
+            // The fat AABB is extended along the displacement when the object leaves its fat AABB
+            rp3d_test(tree.updateObject(objectId, AABB(Vector3(2, 0, 0), Vector3(3, 1, 1)), Vector3(2, 0, -1)));
+            rp3d_test(tree.getFatAABB(objectId).getMin() == Vector3(2, 0, -1));
+            rp3d_test(tree.getFatAABB(objectId).getMax() == Vector3(5, 1, 1));
+
+            // The object stays inside its fat AABB while it moves as predicted
+            rp3d_test(!tree.updateObject(objectId, AABB(Vector3(4, 0, -1), Vector3(5, 1, 0)), Vector3(2, 0, -1)));
+
+            // The fat AABB is not extended if the object does not leave it
+            rp3d_test(tree.getFatAABB(objectId).getMax() == Vector3(5, 1, 1));
+
+            // A forced reinsertion without displacement shrinks the fat AABB
+            rp3d_test(tree.updateObject(objectId, AABB(Vector3(4, 0, -1), Vector3(5, 1, 0)), true));
+            rp3d_test(tree.getFatAABB(objectId).getMin() == Vector3(4, 0, -1));
+            rp3d_test(tree.getFatAABB(objectId).getMax() == Vector3(5, 1, 0));
+            rp3d_test(*(int*)(tree.getNodeDataPointer(objectId)) == objectData);
+        }
+
+        void testWorldPredictiveFatAABB() {
+
+            // Fast boxes cross the world with the constant and the velocity-predictive fat AABB margins.
+            // The predictive margin must reinsert the boxes into the broad-phase tree at most half as often.
+            const uint nbReinsertionsConstant = computeNbWorldReinsertions(FatAABBMarginPolicy::CONSTANT_PERCENTAGE);
+            const uint nbReinsertionsPredictive = computeNbWorldReinsertions(FatAABBMarginPolicy::VELOCITY_PREDICTIVE);
+
+            rp3d_test(nbReinsertionsConstant > 0);
+            rp3d_test(nbReinsertionsPredictive > 0);
+            rp3d_test(2 * nbReinsertionsPredictive <= nbReinsertionsConstant);
+        }
+
+        /// Return the number of reinsertions of fast moving boxes in the broad-phase tree of a world
+        uint computeNbWorldReinsertions(FatAABBMarginPolicy marginPolicy) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.fatAABBMarginPolicy = marginPolicy;
+            settings.isSleepingEnabled = false;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            world->setIsGravityEnabled(false);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+
+            const uint nbBoxes = 20;
+            for (uint i=0; i < nbBoxes; i++) {
+                RigidBody* box = world->createRigidBody(Transform(Vector3(0, 0, decimal(i) * 5), Quaternion::identity()));
+                box->addCollider(boxShape, Transform::identity());
+                box->setLinearVelocity(Vector3(20, 0, 0));
+            }
+
+            // Each reinsertion removes a leaf from the tree and inserts it again
+            const uint nbChangesBefore = world->getNbBroadPhaseStructuralChanges();
+            for (uint i=0; i < 60; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            const uint nbReinsertions = (world->getNbBroadPhaseStructuralChanges() - nbChangesBefore) / 2;
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+
+            return nbReinsertions;
+        }
+
+        void testWideTree() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            int objectData = 0;
+            std::vector<int> objectIds;
+
+            // Create a grid of objects with different sizes
+            for (int x=0; x < 10; x++) {
+                for (int y=0; y < 6; y++) {
+                    for (int z=0; z < 5; z++) {
+                        const Vector3 min(x * decimal(2.5), y * decimal(3.0), z * decimal(2.0));
+                        const Vector3 size(decimal(1.0) + (x % 3), decimal(0.5) + (y % 2), decimal(1.0) + (z % 4) * decimal(0.3));
+                        objectIds.push_back(tree.addObject(AABB(min, min + size), &objectData));
+                    }
+                }
+            }
+
+            const AABB queryAABBs[4] = {AABB(Vector3(-10, -10, -10), Vector3(-5, -5, -5)),
+                                        AABB(Vector3(2, 3, 1), Vector3(7, 8, 4)),
+                                        AABB(Vector3(-1, -1, -1), Vector3(30, 20, 12)),
+                                        AABB(Vector3(12, 0, 3), Vector3(12.5, 16, 3.5))};
+            const Ray rays[3] = {Ray(Vector3(-5, 4, 3), Vector3(30, 4, 3)),
+                                 Ray(Vector3(-5, -5, -5), Vector3(30, 20, 12)),
+                                 Ray(Vector3(6, 30, 1), Vector3(6, -10, 1))};
+
+            // Compute the results of the queries with the binary tree
+            std::vector<std::vector<int>> binaryOverlaps;
+            std::vector<std::vector<int>> binaryHits;
+            computeTreeQueries(tree, queryAABBs, 4, rays, 3, binaryOverlaps, binaryHits);
+
+            // ---------- Tests ---------- //
+
+            rp3d_test(binaryOverlaps[0].empty());
+            rp3d_test(binaryOverlaps[2].size() == objectIds.size());
+
+            // The wide tree must give the same results
+            std::vector<std::vector<int>> wideOverlaps;
+            std::vector<std::vector<int>> wideHits;
+            tree.setIsWideTreeEnabled(true);
+            tree.updateWideTree();
+            computeTreeQueries(tree, queryAABBs, 4, rays, 3, wideOverlaps, wideHits);
+            rp3d_test(wideOverlaps == binaryOverlaps);
+            rp3d_test(wideHits == binaryHits);
+
+            // Move some objects (the queries use the binary tree until the wide tree is updated)
+            for (uint i=0; i < objectIds.size(); i += 7) {
+                const Vector3 min(decimal(i % 13), decimal(i % 5), decimal(i % 11));
+                tree.updateObject(objectIds[i], AABB(min, min + Vector3(2, 2, 2)));
+            }
+
+            binaryOverlaps.clear();
+            binaryHits.clear();
+            computeTreeQueries(tree, queryAABBs, 4, rays, 3, binaryOverlaps, binaryHits);
+
+            wideOverlaps.clear();
+            wideHits.clear();
+            tree.updateWideTree();
+            computeTreeQueries(tree, queryAABBs, 4, rays, 3, wideOverlaps, wideHits);
+            rp3d_test(wideOverlaps == binaryOverlaps);
+            rp3d_test(wideHits == binaryHits);
+        }
+
+        void testQuantizedTree() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            int objectData = 0;
+            std::vector<int> objectIds;
+
+            // Create a grid of objects with very different sizes (far from the origin)
+            for (int x=0; x < 12; x++) {
+                for (int y=0; y < 5; y++) {
+                    for (int z=0; z < 6; z++) {
+                        const Vector3 min(decimal(500.0) + x * decimal(2.5), y * decimal(3.0), z * decimal(2.0) - decimal(300.0));
+                        const Vector3 size(decimal(0.01) + (x % 3), decimal(0.5) + (y % 2) * decimal(0.001), decimal(1.0) + (z % 4) * decimal(0.3));
+                        objectIds.push_back(tree.addObject(AABB(min, min + size), &objectData));
+                    }
+                }
+            }
+
+            const AABB queryAABBs[5] = {AABB(Vector3(-10, -10, -10), Vector3(-5, -5, -5)),
+                                        AABB(Vector3(502, 3, -299), Vector3(507, 8, -296)),
+                                        AABB(Vector3(499, -1, -301), Vector3(530, 20, -287)),
+                                        AABB(Vector3(512, 0, -297), Vector3(512.5, 16, -296.5)),
+                                        AABB(Vector3(502.51, 0, -300), Vector3(502.52, 0.1, -299))};
+            const Ray rays[3] = {Ray(Vector3(495, 4, -297), Vector3(530, 4, -297)),
+                                 Ray(Vector3(495, -5, -305), Vector3(530, 20, -288)),
+                                 Ray(Vector3(506, 30, -299), Vector3(506, -10, -299))};
+
+            // Compute the results of the queries with the binary tree
+            std::vector<std::vector<int>> binaryOverlaps;
+            std::vector<std::vector<int>> binaryHits;
+            computeTreeQueries(tree, queryAABBs, 5, rays, 3, binaryOverlaps, binaryHits);
+
+            // ---------- Tests ---------- //
+
+            rp3d_test(sizeof(QuantizedTreeNode) == 16);
+            rp3d_test(binaryOverlaps[0].empty());
+            rp3d_test(binaryOverlaps[2].size() == objectIds.size());
+
+            // The quantized tree must give the same results
+            std::vector<std::vector<int>> quantizedOverlaps;
+            std::vector<std::vector<int>> quantizedHits;
+            tree.setIsQuantizedTreeEnabled(true);
+            tree.updateQuantizedTree();
+            rp3d_test(tree.getIsQuantizedTreeEnabled());
+            computeTreeQueries(tree, queryAABBs, 5, rays, 3, quantizedOverlaps, quantizedHits);
+            rp3d_test(quantizedOverlaps == binaryOverlaps);
+            rp3d_test(quantizedHits == binaryHits);
+
+            // Modify the tree (the queries use the binary tree until the quantized tree is updated)
+            for (uint i=0; i < objectIds.size(); i += 5) {
+                const Vector3 min(decimal(500 + i % 13), decimal(i % 5), decimal(i % 11) - decimal(300.0));
+                tree.updateObject(objectIds[i], AABB(min, min + Vector3(2, 2, 2)));
+            }
+            tree.removeObject(objectIds[3]);
+
+            binaryOverlaps.clear();
+            binaryHits.clear();
+            computeTreeQueries(tree, queryAABBs, 5, rays, 3, binaryOverlaps, binaryHits);
+
+            quantizedOverlaps.clear();
+            quantizedHits.clear();
+            tree.updateQuantizedTree();
+            computeTreeQueries(tree, queryAABBs, 5, rays, 3, quantizedOverlaps, quantizedHits);
+            rp3d_test(quantizedOverlaps == binaryOverlaps);
+            rp3d_test(quantizedHits == binaryHits);
+
+            // Overlapping pairs between some leaves and the tree
+            List<int32> nodesToTest(mAllocator);
+            for (uint i=0; i < objectIds.size(); i += 4) {
+                nodesToTest.add(objectIds[i]);
+            }
+            List<Pair<int32, int32>> quantizedPairs(mAllocator);
+            tree.reportAllShapesOverlappingWithShapes(nodesToTest, 0, nodesToTest.size(), quantizedPairs);
+            tree.setIsQuantizedTreeEnabled(false);
+            List<Pair<int32, int32>> binaryPairs(mAllocator);
+            tree.reportAllShapesOverlappingWithShapes(nodesToTest, 0, nodesToTest.size(), binaryPairs);
+            rp3d_test(computeSortedPairs(quantizedPairs) == computeSortedPairs(binaryPairs));
+            rp3d_test(binaryPairs.size() > nodesToTest.size());
+
+            // A tree with a single leaf
+            DynamicAABBTree singleLeafTree(mAllocator);
+            singleLeafTree.setIsQuantizedTreeEnabled(true);
+            singleLeafTree.addObject(AABB(Vector3(1, 1, 1), Vector3(2, 2, 2)), &objectData);
+            singleLeafTree.updateQuantizedTree();
+            List<int> overlappingNodes(mAllocator);
+            singleLeafTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), overlappingNodes);
+            rp3d_test(overlappingNodes.size() == 1);
+        }
+
+        void testRebuildAndOptimize() {
+
+            // ------------- Create tree ----------- //
+
+            // Dynamic AABB Tree
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            std::vector<int> objectsData(200);
+            std::vector<int> objectIds;
+
+            // Insert objects in a scattered order
+            for (int i=0; i < 200; i++) {
+                objectsData[i] = i;
+                const int k = (i * 37) % 200;
+                const Vector3 min(decimal(k % 20) * decimal(1.5), decimal(k / 20) * decimal(2.0), decimal(k % 7));
+                objectIds.push_back(tree.addObject(AABB(min, min + Vector3(1, 1, 1)), &(objectsData[i])));
+            }
+
+            const AABB queryAABBs[3] = {AABB(Vector3(-5, -5, -5), Vector3(-1, -1, -1)),
+                                        AABB(Vector3(3, 2, 1), Vector3(9, 7, 4)),
+                                        AABB(Vector3(-1, -1, -1), Vector3(40, 30, 10))};
+            const Ray rays[2] = {Ray(Vector3(-5, 4.5, 3.5), Vector3(40, 4.5, 3.5)),
+                                 Ray(Vector3(-5, -5, -5), Vector3(40, 30, 10))};
+
+            std::vector<std::vector<int>> initialOverlaps;
+            std::vector<std::vector<int>> initialHits;
+            computeTreeQueries(tree, queryAABBs, 3, rays, 2, initialOverlaps, initialHits);
+
+            const decimal initialCost = tree.computeTreeCost();
+
+            // ---------- Tests ---------- //
+
+            rp3d_test(initialCost > decimal(0.0));
+            rp3d_test(initialOverlaps[2].size() == objectIds.size());
+
+            // Rebuild the tree top-down
+            tree.rebuildTopDown();
+
+            // The IDs of the leaves and the results of the queries must not change
+            for (uint i=0; i < objectIds.size(); i++) {
+                rp3d_test(*(int*)(tree.getNodeDataPointer(objectIds[i])) == objectsData[i]);
+            }
+            std::vector<std::vector<int>> overlaps;
+            std::vector<std::vector<int>> hits;
+            computeTreeQueries(tree, queryAABBs, 3, rays, 2, overlaps, hits);
+            rp3d_test(overlaps == initialOverlaps);
+            rp3d_test(hits == initialHits);
+
+            // The rebuilt tree must have a smaller cost
+            const decimal rebuiltCost = tree.computeTreeCost();
+            rp3d_test(rebuiltCost < initialCost);
+
+            // Incrementally optimize the tree (more than once around all the leaves)
+            for (int i=0; i < 30; i++) {
+                tree.optimizeIncremental(20);
+            }
+
+            for (uint i=0; i < objectIds.size(); i++) {
+                rp3d_test(*(int*)(tree.getNodeDataPointer(objectIds[i])) == objectsData[i]);
+            }
+            overlaps.clear();
+            hits.clear();
+            computeTreeQueries(tree, queryAABBs, 3, rays, 2, overlaps, hits);
+            rp3d_test(overlaps == initialOverlaps);
+            rp3d_test(hits == initialHits);
+        }
+
+        void testBulkInsertion() {
+
+            // ------------- Create trees ----------- //
+
+            // Tree built with incremental insertions and tree built with a bulk insertion
+            DynamicAABBTree incrementalTree(mAllocator);
+            DynamicAABBTree bulkTree(mAllocator);
+
+            std::vector<int> objectsData(200);
+            std::vector<int> incrementalIds;
+            std::vector<int> bulkIds;
+
+            for (int i=0; i < 200; i++) {
+
+                objectsData[i] = i;
+                const int k = (i * 37) % 200;
+                const Vector3 min(decimal(k % 20) * decimal(1.5), decimal(k / 20) * decimal(2.0), decimal(k % 7));
+                const AABB aabb(min, min + Vector3(1, 1, 1));
+
+                incrementalIds.push_back(incrementalTree.addObject(aabb, &(objectsData[i])));
+
+                // The first objects are added to the second tree before the bulk insertion
+                if (i == 20) {
+                    bulkTree.beginBulkInsertion();
+                }
+                bulkIds.push_back(bulkTree.addObject(aabb, &(objectsData[i])));
+            }
+
+            rp3d_test(bulkTree.getIsBulkInsertionActive());
+
+            // Objects can be updated, removed and optimized during the bulk insertion
+            incrementalTree.updateObject(incrementalIds[50], AABB(Vector3(40, 0, 0), Vector3(41, 1, 1)));
+            bulkTree.updateObject(bulkIds[50], AABB(Vector3(40, 0, 0), Vector3(41, 1, 1)));
+            incrementalTree.updateObject(incrementalIds[5], AABB(Vector3(0, 40, 0), Vector3(1, 41, 1)));
+            bulkTree.updateObject(bulkIds[5], AABB(Vector3(0, 40, 0), Vector3(1, 41, 1)));
+            incrementalTree.removeObject(incrementalIds[100]);
+            bulkTree.removeObject(bulkIds[100]);
+            incrementalTree.removeObject(incrementalIds[10]);
+            bulkTree.removeObject(bulkIds[10]);
+            bulkTree.optimizeIncremental(300);
+
+            bulkTree.endBulkInsertion();
+
+            // ---------- Tests ---------- //
+
+            rp3d_test(!bulkTree.getIsBulkInsertionActive());
+            rp3d_test(bulkTree.getNbNodes() == 2 * 198 - 1);
+
+            const AABB queryAABBs[4] = {AABB(Vector3(-5, -5, -5), Vector3(-1, -1, -1)),
+                                        AABB(Vector3(3, 2, 1), Vector3(9, 7, 4)),
+                                        AABB(Vector3(39, -1, -1), Vector3(42, 42, 2)),
+                                        AABB(Vector3(-1, -1, -1), Vector3(45, 45, 10))};
+            const Ray rays[2] = {Ray(Vector3(-5, 4.5, 3.5), Vector3(40, 4.5, 3.5)),
+                                 Ray(Vector3(-5, -5, -5), Vector3(40, 30, 10))};
+
+            std::vector<std::vector<int>> incrementalOverlaps;
+            std::vector<std::vector<int>> incrementalHits;
+            computeTreeQueries(incrementalTree, queryAABBs, 4, rays, 2, incrementalOverlaps, incrementalHits);
+            std::vector<std::vector<int>> bulkOverlaps;
+            std::vector<std::vector<int>> bulkHits;
+            computeTreeQueries(bulkTree, queryAABBs, 4, rays, 2, bulkOverlaps, bulkHits);
+
+            // Both trees must report the same objects
+            convertNodesToData(incrementalTree, incrementalOverlaps);
+            convertNodesToData(incrementalTree, incrementalHits);
+            convertNodesToData(bulkTree, bulkOverlaps);
+            convertNodesToData(bulkTree, bulkHits);
+            rp3d_test(bulkOverlaps == incrementalOverlaps);
+            rp3d_test(bulkHits == incrementalHits);
+            rp3d_test(bulkOverlaps[2].size() == 1);
+            rp3d_test(bulkOverlaps[3].size() == 198);
+
+            // The tree built in bulk has a better quality
+            rp3d_test(bulkTree.computeTreeCost() < incrementalTree.computeTreeCost());
+        }
+
+        void testCompaction() {
+
+            // ------------- Create tree ----------- //
+
+            DynamicAABBTree tree(mAllocator);
+
+            std::vector<int> objectsData(100);
+            std::vector<int> objectsIds(100);
+            for (int i=0; i < 100; i++) {
+                objectsData[i] = i;
+                const Vector3 min(decimal(i % 10) * decimal(2.0), decimal(i / 10) * decimal(2.0), 0);
+                objectsIds[i] = tree.addObject(AABB(min, min + Vector3(1, 1, 1)), &(objectsData[i]));
+            }
+
+            // Remove half of the objects and move the other ones to scatter the nodes in the array
+            for (int i=0; i < 100; i += 2) {
+                tree.removeObject(objectsIds[i]);
+                objectsIds[i] = -1;
+            }
+            for (int i=1; i < 100; i += 2) {
+                const Vector3 min(decimal((i * 7) % 10) * decimal(2.0), decimal(i / 10) * decimal(2.0), decimal(i % 3) * decimal(0.5));
+                tree.updateObject(objectsIds[i], AABB(min, min + Vector3(1, 1, 1)), true);
+            }
+
+            rp3d_test(tree.getNbStructuralChanges() > 0);
+
+            const AABB queryAABBs[3] = {AABB(Vector3(-5, -5, -5), Vector3(-1, -1, -1)),
+                                        AABB(Vector3(3, 2, -1), Vector3(9, 7, 4)),
+                                        AABB(Vector3(-1, -1, -1), Vector3(45, 45, 10))};
+            const Ray rays[2] = {Ray(Vector3(-5, 4.5, 0.5), Vector3(40, 4.5, 0.5)),
+                                 Ray(Vector3(-5, -5, -5), Vector3(40, 30, 10))};
+
+            std::vector<std::vector<int>> overlapsBefore;
+            std::vector<std::vector<int>> hitsBefore;
+            computeTreeQueries(tree, queryAABBs, 3, rays, 2, overlapsBefore, hitsBefore);
+            convertNodesToData(tree, overlapsBefore);
+            convertNodesToData(tree, hitsBefore);
+            const decimal costBefore = tree.computeTreeCost();
+
+            // ------------- Compact the tree ----------- //
+
+            std::vector<int32> newNodeIDs(tree.getNbAllocatedNodes());
+            tree.compactNodes(newNodeIDs.data());
+
+            // ---------- Tests ---------- //
+
+            rp3d_test(tree.getNbStructuralChanges() == 0);
+            rp3d_test(tree.getNbNodes() == 2 * 50 - 1);
+
+            // Each leaf keeps its data at its new ID and the used nodes are at the beginning of the array
+            for (int i=0; i < 100; i++) {
+                if (objectsIds[i] == -1) continue;
+                const int32 newID = newNodeIDs[objectsIds[i]];
+                rp3d_test(newID >= 0 && newID < tree.getNbNodes());
+                rp3d_test(*(int*)(tree.getNodeDataPointer(newID)) == i);
+                objectsIds[i] = newID;
+            }
+
+            // The queries report the same objects and the shape of the tree does not change
+            std::vector<std::vector<int>> overlapsAfter;
+            std::vector<std::vector<int>> hitsAfter;
+            computeTreeQueries(tree, queryAABBs, 3, rays, 2, overlapsAfter, hitsAfter);
+            convertNodesToData(tree, overlapsAfter);
+            convertNodesToData(tree, hitsAfter);
+            rp3d_test(overlapsAfter == overlapsBefore);
+            rp3d_test(hitsAfter == hitsBefore);
+            rp3d_test(approxEqual(tree.computeTreeCost(), costBefore));
+
+            // The tree can still be modified after the compaction
+            for (int i=0; i < 100; i += 2) {
+                const Vector3 min(decimal(i % 10) * decimal(2.0), decimal(i / 10) * decimal(2.0), 0);
+                objectsIds[i] = tree.addObject(AABB(min, min + Vector3(1, 1, 1)), &(objectsData[i]));
+            }
+            tree.removeObject(objectsIds[1]);
+            rp3d_test(tree.getNbNodes() == 2 * 99 - 1);
+
+            List<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(queryAABBs[2], overlappingNodes);
+            rp3d_test(overlappingNodes.size() == 99);
+        }
+
+        void testWorldCompaction() {
+
+            // Create a world with a floor and boxes that are added and removed
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseCompactionThreshold = 50;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            world->setIsGravityEnabled(false);
+
+            BoxShape* floorShape = mPhysicsCommon.createBoxShape(Vector3(100, 1, 100));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+
+            RigidBody* floor = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollider(floorShape, Transform::identity());
+
+            std::vector<RigidBody*> boxes;
+            for (int i=0; i < 40; i++) {
+                RigidBody* box = world->createRigidBody(Transform(Vector3(decimal(i) * decimal(2.5), decimal(0.5), 0), Quaternion::identity()));
+                box->addCollider(boxShape, Transform::identity());
+                boxes.push_back(box);
+            }
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            // Destroy some of the boxes so that the automatic compaction is triggered during the next update
+            for (int i=0; i < 40; i += 3) {
+                world->destroyRigidBody(boxes[i]);
+                boxes[i] = nullptr;
+            }
+            RigidBody* box1 = world->createRigidBody(Transform(Vector3(decimal(1.5), decimal(0.5), 0), Quaternion::identity()));
+            box1->addCollider(boxShape, Transform::identity());
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            rp3d_test(world->testOverlap(box1, boxes[1]));
+            rp3d_test(world->testOverlap(box1, floor));
+            rp3d_test(!world->testOverlap(box1, boxes[4]));
+
+            // Compact the broad-phase explicitly between two updates
+            world->compactBroadPhase();
+
+            rp3d_test(world->testOverlap(box1, boxes[1]));
+            rp3d_test(world->testOverlap(boxes[4], floor));
+
+            for (int i=0; i < 5; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(world->testOverlap(box1, boxes[1]));
+            rp3d_test(world->testOverlap(box1, floor));
+            rp3d_test(!world->testOverlap(box1, boxes[4]));
+            for (int i=0; i < 40; i++) {
+                if (boxes[i] != nullptr) {
+                    rp3d_test(world->testOverlap(boxes[i], floor));
+                }
+            }
+
+            // The colliders can still be removed after the compaction
+            world->destroyRigidBody(box1);
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world->testOverlap(boxes[1], floor));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(floorShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+
+        void testDualTreeTraversal() {
+
+            // ------------- Create trees ----------- //
+
+            std::srand(11);
+
+            DynamicAABBTree dynamicTree(mAllocator);
+            DynamicAABBTree staticTree(mAllocator);
+
+            std::vector<int> objectsData(700);
+            std::vector<int32> dynamicIds;
+            std::vector<int32> staticIds;
+            for (int i=0; i < 700; i++) {
+                objectsData[i] = i;
+                if (i < 400) {
+                    dynamicIds.push_back(dynamicTree.addObject(computeRandomAABB(), &(objectsData[i])));
+                }
+                else {
+                    staticIds.push_back(staticTree.addObject(computeRandomAABB(), &(objectsData[i])));
+                }
+            }
+
+            // Move some of the leaves of both trees (the other leaves are not moved)
+            List<int32> dynamicMovedNodes(mAllocator);
+            List<int32> staticMovedNodes(mAllocator);
+            for (uint i=0; i < dynamicIds.size(); i += 5) {
+                dynamicTree.updateObject(dynamicIds[i], computeRandomAABB(), true);
+                dynamicMovedNodes.add(dynamicIds[i]);
+            }
+            for (uint i=0; i < staticIds.size(); i += 30) {
+                staticTree.updateObject(staticIds[i], computeRandomAABB(), true);
+                staticMovedNodes.add(staticIds[i]);
+            }
+
+            std::unique_ptr<bool[]> dynamicMarkedNodes(new bool[dynamicTree.getNbAllocatedNodes()]());
+            std::unique_ptr<bool[]> staticMarkedNodes(new bool[staticTree.getNbAllocatedNodes()]());
+            dynamicTree.markLeavesAndAncestors(dynamicMovedNodes, dynamicMarkedNodes.get());
+            staticTree.markLeavesAndAncestors(staticMovedNodes, staticMarkedNodes.get());
+
+            // The moved leaves and their ancestors are marked
+            rp3d_test(dynamicMarkedNodes[dynamicTree.getRootNodeID()]);
+            rp3d_test(staticMarkedNodes[staticTree.getRootNodeID()]);
+            for (uint i=0; i < dynamicIds.size(); i++) {
+                rp3d_test(dynamicMarkedNodes[dynamicIds[i]] == (i % 5 == 0));
+            }
+
+            // ------------- Pairs inside the dynamic tree ----------- //
+
+            // Pairs reported by the queries of the moved shapes (each pair of two moved shapes is found twice)
+            List<Pair<int32, int32>> queryPairs(mAllocator);
+            dynamicTree.reportAllShapesOverlappingWithShapes(dynamicMovedNodes, 0, dynamicMovedNodes.size(), queryPairs);
+            const std::vector<std::pair<int, int>> expectedPairs = computeUniqueUnorderedPairs(queryPairs);
+            rp3d_test(expectedPairs.size() > dynamicMovedNodes.size());
+
+            // Pairs reported by a single dual-tree traversal from the root
+            List<Pair<int32, int32>> dualTreePairs(mAllocator);
+            computeDualTreeTraversalPairs(dynamicTree, dynamicTree, dynamicMarkedNodes.get(), dynamicMarkedNodes.get(), 1,
+                                          dualTreePairs);
+            rp3d_test(computeUnorderedPairs(dualTreePairs) == expectedPairs);
+
+            // Pairs reported by a dual-tree traversal split into independent tasks (as with worker threads)
+            List<Pair<int32, int32>> splitDualTreePairs(mAllocator);
+            computeDualTreeTraversalPairs(dynamicTree, dynamicTree, dynamicMarkedNodes.get(), dynamicMarkedNodes.get(), 64,
+                                          splitDualTreePairs);
+            rp3d_test(computeUnorderedPairs(splitDualTreePairs) == expectedPairs);
+
+            // ------------- Pairs between the dynamic and the static trees ----------- //
+
+            // Pairs reported by the queries of the moved dynamic and static shapes (as (dynamic, static) pairs)
+            List<Pair<int32, int32>> dynamicQueryPairs(mAllocator);
+            List<Pair<int32, int32>> staticQueryPairs(mAllocator);
+            staticTree.reportAllShapesOverlappingWithShapes(dynamicTree, dynamicMovedNodes, 0, dynamicMovedNodes.size(),
+                                                            dynamicQueryPairs);
+            dynamicTree.reportAllShapesOverlappingWithShapes(staticTree, staticMovedNodes, 0, staticMovedNodes.size(),
+                                                             staticQueryPairs);
+            for (uint i=0; i < staticQueryPairs.size(); i++) {
+                dynamicQueryPairs.add(Pair<int32, int32>(staticQueryPairs[i].second, staticQueryPairs[i].first));
+            }
+            std::vector<std::pair<int, int>> expectedTreesPairs = computeSortedPairs(dynamicQueryPairs);
+            expectedTreesPairs.erase(std::unique(expectedTreesPairs.begin(), expectedTreesPairs.end()), expectedTreesPairs.end());
+            rp3d_test(expectedTreesPairs.size() > staticMovedNodes.size());
+
+            List<Pair<int32, int32>> dualTreeTreesPairs(mAllocator);
+            computeDualTreeTraversalPairs(dynamicTree, staticTree, dynamicMarkedNodes.get(), staticMarkedNodes.get(), 1,
+                                          dualTreeTreesPairs);
+            rp3d_test(computeSortedPairs(dualTreeTreesPairs) == expectedTreesPairs);
+
+            List<Pair<int32, int32>> splitDualTreeTreesPairs(mAllocator);
+            computeDualTreeTraversalPairs(dynamicTree, staticTree, dynamicMarkedNodes.get(), staticMarkedNodes.get(), 64,
+                                          splitDualTreeTreesPairs);
+            rp3d_test(computeSortedPairs(splitDualTreeTreesPairs) == expectedTreesPairs);
+
+            // ------------- No moved leaves ----------- //
+
+            std::unique_ptr<bool[]> noMarkedNodes(new bool[dynamicTree.getNbAllocatedNodes()]());
+            List<Pair<int32, int32>> noPairs(mAllocator);
+            computeDualTreeTraversalPairs(dynamicTree, dynamicTree, noMarkedNodes.get(), noMarkedNodes.get(), 64, noPairs);
+            rp3d_test(noPairs.size() == 0);
+        }
+
+        /// Return a random AABB of a box in a small region so that many boxes overlap
+        AABB computeRandomAABB() const {
+
+            const Vector3 min(decimal(std::rand() % 200) * decimal(0.1), decimal(std::rand() % 200) * decimal(0.1),
+                              decimal(std::rand() % 50) * decimal(0.1));
+            const Vector3 size(decimal(0.5) + decimal(std::rand() % 20) * decimal(0.1),
+                               decimal(0.5) + decimal(std::rand() % 20) * decimal(0.1),
+                               decimal(0.5) + decimal(std::rand() % 20) * decimal(0.1));
+            return AABB(min, min + size);
+        }
+
+        /// Compute the pairs of overlapping leaves of two trees with a dual-tree traversal
+        /// The pairs of nodes are first expanded until there are at least a given number of them and
+        /// are then traversed in independent chunks of pairs as it is done by the worker threads.
+        void computeDualTreeTraversalPairs(const DynamicAABBTree& tree1, const DynamicAABBTree& tree2,
+                                           const bool* markedNodes1, const bool* markedNodes2, size_t nbMinNodePairs,
+                                           List<Pair<int32, int32>>& outOverlappingNodes) {
+
+            List<Pair<int32, int32>> nodePairs(mAllocator);
+            nodePairs.add(Pair<int32, int32>(tree1.getRootNodeID(), tree2.getRootNodeID()));
+            while (nodePairs.size() > 0 && nodePairs.size() < nbMinNodePairs) {
+                List<Pair<int32, int32>> childNodePairs(mAllocator);
+                tree1.expandNodePairs(tree2, markedNodes1, markedNodes2, nodePairs, childNodePairs, outOverlappingNodes);
+                nodePairs = childNodePairs;
+            }
+
+            const size_t nbNodePairsPerChunk = 5;
+            for (size_t i=0; i < nodePairs.size(); i += nbNodePairsPerChunk) {
+                List<Pair<int32, int32>> chunkOverlappingNodes(mAllocator);
+                tree1.reportAllOverlappingLeaves(tree2, markedNodes1, markedNodes2, nodePairs, i,
+                                                 std::min(i + nbNodePairsPerChunk, nodePairs.size()), chunkOverlappingNodes);
+                outOverlappingNodes.addRange(chunkOverlappingNodes);
+            }
+        }
+
+        /// Return the pairs of nodes of a list with the smallest ID first and sorted by node IDs
+        std::vector<std::pair<int, int>> computeUnorderedPairs(const List<Pair<int32, int32>>& pairs) const {
+
+            std::vector<std::pair<int, int>> sortedPairs;
+            for (uint i=0; i < pairs.size(); i++) {
+                sortedPairs.push_back(std::make_pair(std::min(pairs[i].first, pairs[i].second),
+                                                     std::max(pairs[i].first, pairs[i].second)));
+            }
+            std::sort(sortedPairs.begin(), sortedPairs.end());
+
+            return sortedPairs;
+        }
+
+        /// Return the unordered pairs of two different nodes of a list without duplicates
+        std::vector<std::pair<int, int>> computeUniqueUnorderedPairs(const List<Pair<int32, int32>>& pairs) const {
+
+            std::vector<std::pair<int, int>> sortedPairs = computeUnorderedPairs(pairs);
+            sortedPairs.erase(std::unique(sortedPairs.begin(), sortedPairs.end()), sortedPairs.end());
+            sortedPairs.erase(std::remove_if(sortedPairs.begin(), sortedPairs.end(),
+                                             [](const std::pair<int, int>& pair) { return pair.first == pair.second; }),
+                              sortedPairs.end());
+
+            return sortedPairs;
+        }
+
+        /// Replace the node IDs of the results of some queries by the data of the nodes
+        void convertNodesToData(const DynamicAABBTree& tree, std::vector<std::vector<int>>& results) {
+
+            for (uint i=0; i < results.size(); i++) {
+                for (uint j=0; j < results[i].size(); j++) {
+                    results[i][j] = *(int*)(tree.getNodeDataPointer(results[i][j]));
+                }
+                std::sort(results[i].begin(), results[i].end());
+            }
+        }
+
+        /// Return the pairs of nodes of a list sorted by node IDs
+        std::vector<std::pair<int, int>> computeSortedPairs(const List<Pair<int32, int32>>& pairs) const {
+
+            std::vector<std::pair<int, int>> sortedPairs;
+            for (uint i=0; i < pairs.size(); i++) {
+                sortedPairs.push_back(std::make_pair(pairs[i].first, pairs[i].second));
+            }
+            std::sort(sortedPairs.begin(), sortedPairs.end());
+
+            return sortedPairs;
+        }
+
+        /// Compute the sorted results of some AABB overlap and raycast queries on a tree
+        void computeTreeQueries(const DynamicAABBTree& tree, const AABB* aabbs, int nbAABBs, const Ray* rays, int nbRays,
+                                std::vector<std::vector<int>>& outOverlaps, std::vector<std::vector<int>>& outHits) {
+
+            List<int> overlappingNodes(mAllocator);
+            for (int i=0; i < nbAABBs; i++) {
+                overlappingNodes.clear();
+                tree.reportAllShapesOverlappingWithAABB(aabbs[i], overlappingNodes);
+                std::vector<int> nodes(overlappingNodes.begin(), overlappingNodes.end());
+                std::sort(nodes.begin(), nodes.end());
+                outOverlaps.push_back(nodes);
+            }
+
+            for (int i=0; i < nbRays; i++) {
+                mRaycastCallback.reset();
+                tree.raycast(rays[i], mRaycastCallback);
+                std::vector<int> nodes = mRaycastCallback.mHitNodes;
+                std::sort(nodes.begin(), nodes.end());
+                outHits.push_back(nodes);
+            }
+        }
  };
 
 }
@@ -5,6 +5,7 @@
 #include <reactphysics3d/reactphysics3d.h>
 #include "Test.h"
 #include <vector>
+#include <cstdlib>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -42,6 +43,7 @@ class TestHalfEdgeStructure : public Test {
         void run() {
             testCube();
             testTetrahedron();
+            testPolyhedronMeshSupportVertex();
         }
 
         void testCube() {
@@ -257,6 +259,72 @@ class TestHalfEdgeStructure : public Test {
                 rp3d_test(firstEdgeIndex == edgeIndex);
             }
         }
+
+        void testPolyhedronMeshSupportVertex() {
+
+            PhysicsCommon physicsCommon;
+
+            // Prisms with a small number of vertices (linear search) and with
+            // a large number of vertices (hill climbing on the edges)
+            const uint nbSidesPrisms[2] = {5, 40};
+            for (uint p=0; p < 2; p++) {
+
+                // Create the vertices of the top and bottom faces of the prism
+                const uint nbSides = nbSidesPrisms[p];
+                std::vector<float> vertices;
+                for (uint i=0; i < 2 * nbSides; i++) {
+                    const float angle = float(i % nbSides) * float(PI_TIMES_2) / float(nbSides);
+                    vertices.push_back(2.0f * std::cos(angle));
+                    vertices.push_back(i < nbSides ? 3.0f : -3.0f);
+                    vertices.push_back(-2.0f * std::sin(angle));
+                }
+
+                // Create the faces (top, bottom and sides) of the prism
+                std::vector<int> indices;
+                std::vector<PolygonVertexArray::PolygonFace> faces(nbSides + 2);
+                for (uint i=0; i < nbSides; i++) indices.push_back(int(i));
+                for (uint i=0; i < nbSides; i++) indices.push_back(int(2 * nbSides - 1 - i));
+                for (uint i=0; i < nbSides; i++) {
+                    const uint next = (i + 1) % nbSides;
+                    indices.push_back(int(i)); indices.push_back(int(nbSides + i));
+                    indices.push_back(int(nbSides + next)); indices.push_back(int(next));
+                }
+                faces[0].indexBase = 0; faces[0].nbVertices = nbSides;
+                faces[1].indexBase = nbSides; faces[1].nbVertices = nbSides;
+                for (uint i=0; i < nbSides; i++) {
+                    faces[i + 2].indexBase = 2 * nbSides + 4 * i;
+                    faces[i + 2].nbVertices = 4;
+                }
+
+                PolygonVertexArray polygonVertexArray(2 * nbSides, vertices.data(), 3 * sizeof(float), indices.data(), sizeof(int),
+                                                      nbSides + 2, faces.data(), PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                      PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+                PolyhedronMesh* polyhedronMesh = physicsCommon.createPolyhedronMesh(&polygonVertexArray);
+
+                // The support vertex must have the largest projection for any start vertex
+                std::srand(3);
+                bool isSupportVertexFound = true;
+                uint startVertex = 0;
+                for (uint i=0; i < 200; i++) {
+
+                    const Vector3 direction(decimal(std::rand() % 2001 - 1000) * decimal(0.001),
+                                            decimal(std::rand() % 2001 - 1000) * decimal(0.001),
+                                            decimal(std::rand() % 2001 - 1000) * decimal(0.001));
+
+                    decimal maxDotProduct = DECIMAL_SMALLEST;
+                    for (uint v=0; v < polyhedronMesh->getNbVertices(); v++) {
+                        maxDotProduct = std::max(maxDotProduct, direction.dot(polyhedronMesh->getVertex(v)));
+                    }
+
+                    startVertex = (i % 2 == 0) ? polyhedronMesh->getSupportVertex(direction, startVertex) :
+                                                 polyhedronMesh->getSupportVertex(direction, i % polyhedronMesh->getNbVertices());
+                    isSupportVertexFound &= approxEqual(direction.dot(polyhedronMesh->getVertex(startVertex)), maxDotProduct, decimal(0.0001));
+                }
+                rp3d_test(isSupportVertexFound);
+
+                physicsCommon.destroyPolyhedronMesh(polyhedronMesh);
+            }
+        }
  };
 
 }
@@ -42,6 +42,7 @@
 #include <reactphysics3d/collision/TriangleVertexArray.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/collision/PolygonVertexArray.h>
+#include <reactphysics3d/memory/DefaultAllocator.h>
 #include <vector>
 
 /// Reactphysics3D namespace
@@ -327,6 +328,8 @@ class TestRaycast : public Test {
             testCompound();
             testConcaveMesh();
             testHeightField();
+            testHeightFieldPyramid();
+            testHeightFieldDataTypesAndNormals();
         }
 
         /// Test the Collider::raycast(), CollisionBody::raycast() and
@@ -1742,6 +1745,224 @@ class TestRaycast : public Test {
             mWorld->raycast(Ray(ray14.point1, ray14.point2, decimal(0.8)), &mCallback);
             rp3d_test(mCallback.isHit);
         }
+
+        /// Test the raycast and the overlapping triangles query of a height field with random
+        /// height values (that use the min/max height pyramid) against a concave mesh made
+        /// of the same triangles.
+        void testHeightFieldPyramid() {
+
+            std::srand(11);
+
+            const int nbColumns = 37;
+            const int nbRows = 29;
+            std::vector<float> heightData(nbColumns * nbRows);
+            for (int i=0; i < nbColumns * nbRows; i++) {
+                heightData[i] = float(std::rand() % 1000) * 0.01f;
+            }
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            CollisionBody* heightFieldBody = world->createCollisionBody(Transform::identity());
+            CollisionBody* concaveMeshBody = world->createCollisionBody(Transform::identity());
+
+            HeightFieldShape* heightFieldShape = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 10, &(heightData[0]),
+                                                                                       HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE);
+            Collider* heightFieldCollider = heightFieldBody->addCollider(heightFieldShape, Transform::identity());
+
+            // Create a concave mesh with the triangles of the height field
+            std::vector<Vector3> vertices;
+            std::vector<uint> indices;
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+                    vertices.push_back(heightFieldShape->getVertexAt(i, j));
+                }
+            }
+            for (int j=0; j < nbRows - 1; j++) {
+                for (int i=0; i < nbColumns - 1; i++) {
+                    const uint p1 = j * nbColumns + i;
+                    const uint p2 = (j + 1) * nbColumns + i;
+                    const uint p3 = j * nbColumns + i + 1;
+                    const uint p4 = (j + 1) * nbColumns + i + 1;
+                    indices.push_back(p1); indices.push_back(p2); indices.push_back(p3);
+                    indices.push_back(p3); indices.push_back(p2); indices.push_back(p4);
+                }
+            }
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray vertexArray(uint(vertices.size()), &(vertices[0]), sizeof(Vector3),
+                                            uint(indices.size() / 3), &(indices[0]), 3 * sizeof(uint),
+                                            vertexType, TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            TriangleMesh* triangleMesh = mPhysicsCommon.createTriangleMesh();
+            triangleMesh->addSubpart(&vertexArray);
+            ConcaveMeshShape* concaveMeshShape = mPhysicsCommon.createConcaveMeshShape(triangleMesh);
+            Collider* concaveMeshCollider = concaveMeshBody->addCollider(concaveMeshShape, Transform::identity());
+
+            // ----- Raycast ----- //
+
+            for (int r=0; r < 500; r++) {
+
+                const Vector3 point1(decimal(std::rand() % 500 - 250) * decimal(0.1), decimal(std::rand() % 300 - 100) * decimal(0.1),
+                                     decimal(std::rand() % 400 - 200) * decimal(0.1));
+                const Vector3 point2(decimal(std::rand() % 500 - 250) * decimal(0.1), decimal(std::rand() % 300 - 200) * decimal(0.1),
+                                     decimal(std::rand() % 400 - 200) * decimal(0.1));
+                const Ray ray(point1, point2);
+
+                RaycastInfo heightFieldRaycastInfo;
+                RaycastInfo concaveMeshRaycastInfo;
+                const bool isHeightFieldHit = heightFieldCollider->raycast(ray, heightFieldRaycastInfo);
+                const bool isConcaveMeshHit = concaveMeshCollider->raycast(ray, concaveMeshRaycastInfo);
+
+                rp3d_test(isHeightFieldHit == isConcaveMeshHit);
+                if (isHeightFieldHit && isConcaveMeshHit) {
+                    rp3d_test(approxEqual(heightFieldRaycastInfo.hitFraction, concaveMeshRaycastInfo.hitFraction, epsilon));
+                    rp3d_test(approxEqual(heightFieldRaycastInfo.worldPoint.x, concaveMeshRaycastInfo.worldPoint.x, epsilon));
+                    rp3d_test(approxEqual(heightFieldRaycastInfo.worldPoint.y, concaveMeshRaycastInfo.worldPoint.y, epsilon));
+                    rp3d_test(approxEqual(heightFieldRaycastInfo.worldPoint.z, concaveMeshRaycastInfo.worldPoint.z, epsilon));
+                }
+            }
+
+            // ----- Overlapping triangles ----- //
+
+            DefaultAllocator allocator;
+            for (int q=0; q < 100; q++) {
+
+                const Vector3 center(decimal(std::rand() % 400 - 200) * decimal(0.1), decimal(std::rand() % 140 - 70) * decimal(0.1),
+                                     decimal(std::rand() % 300 - 150) * decimal(0.1));
+                const Vector3 halfExtents(decimal(0.1) + decimal(std::rand() % 30) * decimal(0.1), decimal(0.1) + decimal(std::rand() % 10) * decimal(0.1),
+                                          decimal(0.1) + decimal(std::rand() % 30) * decimal(0.1));
+                const AABB aabb(center - halfExtents, center + halfExtents);
+
+                List<Vector3> triangleVertices(allocator);
+                List<Vector3> triangleVerticesNormals(allocator);
+                List<uint> shapeIds(allocator);
+                heightFieldShape->computeOverlappingTriangles(aabb, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+
+                // Every triangle of the height field that overlaps the AABB must be returned
+                bool isAllOverlappingTrianglesFound = true;
+                for (uint t=0; t < indices.size() / 3; t++) {
+
+                    const Vector3 trianglePoints[3] = {vertices[indices[t * 3]], vertices[indices[t * 3 + 1]], vertices[indices[t * 3 + 2]]};
+                    if (!aabb.testCollisionTriangleAABB(trianglePoints)) continue;
+
+                    bool isTriangleFound = false;
+                    for (uint k=0; k < triangleVertices.size() / 3; k++) {
+                        if (triangleVertices[k * 3] == trianglePoints[0] && triangleVertices[k * 3 + 1] == trianglePoints[1] &&
+                            triangleVertices[k * 3 + 2] == trianglePoints[2]) {
+                            isTriangleFound = true;
+                            break;
+                        }
+                    }
+                    isAllOverlappingTrianglesFound &= isTriangleFound;
+                }
+                rp3d_test(isAllOverlappingTrianglesFound);
+                rp3d_test(triangleVerticesNormals.size() == triangleVertices.size());
+                rp3d_test(shapeIds.size() * 3 == triangleVertices.size());
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyConcaveMeshShape(concaveMeshShape);
+            mPhysicsCommon.destroyTriangleMesh(triangleMesh);
+            mPhysicsCommon.destroyHeightFieldShape(heightFieldShape);
+        }
+
+        /// Test the height values of the different data types of a height field and the
+        /// precomputed normals of the grid points against the normals of a concave mesh
+        void testHeightFieldDataTypesAndNormals() {
+
+            std::srand(13);
+
+            const int nbColumns = 9;
+            const int nbRows = 7;
+            std::vector<int> intHeightData(nbColumns * nbRows);
+            std::vector<double> doubleHeightData(nbColumns * nbRows);
+            std::vector<float> floatHeightData(nbColumns * nbRows);
+            for (int i=0; i < nbColumns * nbRows; i++) {
+                intHeightData[i] = std::rand() % 500;
+                doubleHeightData[i] = intHeightData[i] * 0.01;
+                floatHeightData[i] = float(intHeightData[i]) * 0.01f;
+            }
+
+            // ----- Data types ----- //
+
+            HeightFieldShape* intHeightField = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 5, &(intHeightData[0]),
+                                                                                     HeightFieldShape::HeightDataType::HEIGHT_INT_TYPE, 2, decimal(0.01));
+            HeightFieldShape* doubleHeightField = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 5, &(doubleHeightData[0]),
+                                                                                        HeightFieldShape::HeightDataType::HEIGHT_DOUBLE_TYPE, 2);
+
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+
+                    rp3d_test(approxEqual(intHeightField->getHeightAt(i, j), decimal(doubleHeightData[j * nbColumns + i]), epsilon));
+                    rp3d_test(approxEqual(doubleHeightField->getHeightAt(i, j), decimal(doubleHeightData[j * nbColumns + i]), epsilon));
+
+                    const Vector3 vertex = doubleHeightField->getVertexAt(i, j);
+                    rp3d_test(approxEqual(vertex.x, decimal(-4 + i), epsilon));
+                    rp3d_test(approxEqual(vertex.y, decimal(-3 + j), epsilon));
+                    rp3d_test(approxEqual(vertex.z, decimal(doubleHeightData[j * nbColumns + i] - 2.5), epsilon));
+                    rp3d_test(approxEqual(intHeightField->getVertexAt(i, j).z, vertex.z, epsilon));
+                }
+            }
+
+            // ----- Vertices normals ----- //
+
+            HeightFieldShape* heightField = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 5, &(floatHeightData[0]),
+                                                                                  HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 1, 1,
+                                                                                  Vector3(2, 2, 2), true);
+            rp3d_test(heightField->hasVerticesNormals());
+            rp3d_test(!doubleHeightField->hasVerticesNormals());
+
+            // Create a triangle array with the triangles of the height field (the normals of the vertices are computed by the array)
+            std::vector<Vector3> vertices;
+            std::vector<uint> indices;
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+                    vertices.push_back(heightField->getVertexAt(i, j));
+                }
+            }
+            for (int j=0; j < nbRows - 1; j++) {
+                for (int i=0; i < nbColumns - 1; i++) {
+                    const uint p1 = j * nbColumns + i;
+                    const uint p2 = (j + 1) * nbColumns + i;
+                    const uint p3 = j * nbColumns + i + 1;
+                    const uint p4 = (j + 1) * nbColumns + i + 1;
+                    indices.push_back(p1); indices.push_back(p2); indices.push_back(p3);
+                    indices.push_back(p3); indices.push_back(p2); indices.push_back(p4);
+                }
+            }
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray vertexArray(uint(vertices.size()), &(vertices[0]), sizeof(Vector3),
+                                            uint(indices.size() / 3), &(indices[0]), 3 * sizeof(uint),
+                                            vertexType, TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+
+            DefaultAllocator allocator;
+            List<Vector3> triangleVertices(allocator);
+            List<Vector3> triangleVerticesNormals(allocator);
+            List<uint> shapeIds(allocator);
+            heightField->computeOverlappingTriangles(AABB(Vector3(-100, -100, -100), Vector3(100, 100, 100)), triangleVertices,
+                                                     triangleVerticesNormals, shapeIds, allocator);
+
+            rp3d_test(shapeIds.size() == indices.size() / 3);
+            for (uint t=0; t < shapeIds.size(); t++) {
+                for (uint v=0; v < 3; v++) {
+
+                    const uint vertexIndex = indices[shapeIds[t] * 3 + v];
+                    Vector3 expectedNormal;
+                    vertexArray.getNormal(vertexIndex, &expectedNormal);
+                    const Vector3& normal = triangleVerticesNormals[t * 3 + v];
+
+                    rp3d_test(approxEqual(triangleVertices[t * 3 + v].x, vertices[vertexIndex].x, epsilon));
+                    rp3d_test(approxEqual(triangleVertices[t * 3 + v].y, vertices[vertexIndex].y, epsilon));
+                    rp3d_test(approxEqual(triangleVertices[t * 3 + v].z, vertices[vertexIndex].z, epsilon));
+                    rp3d_test(approxEqual(normal.x, expectedNormal.x, decimal(0.001)));
+                    rp3d_test(approxEqual(normal.y, expectedNormal.y, decimal(0.001)));
+                    rp3d_test(approxEqual(normal.z, expectedNormal.z, decimal(0.001)));
+                }
+            }
+
+            mPhysicsCommon.destroyHeightFieldShape(intHeightField);
+            mPhysicsCommon.destroyHeightFieldShape(doubleHeightField);
+            mPhysicsCommon.destroyHeightFieldShape(heightField);
+        }
 };
 
 }
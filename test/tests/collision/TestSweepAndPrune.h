@@ -0,0 +1,355 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_SWEEP_AND_PRUNE_H
+#define TEST_SWEEP_AND_PRUNE_H
+
+// Libraries
+#include "Test.h"
+#include "TestDynamicAABBTree.h"
+#include <reactphysics3d/collision/broadphase/SweepAndPrune.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/engine/PhysicsCommon.h>
+#include <reactphysics3d/engine/PhysicsWorld.h>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+class SweepAndPruneWorldRaycastCallback : public RaycastCallback {
+
+    public:
+
+        std::vector<CollisionBody*> mHitBodies;
+
+        // Called when a collider is hit by the ray
+        virtual decimal notifyRaycastHit(const RaycastInfo& raycastInfo) override {
+            mHitBodies.push_back(raycastInfo.body);
+            return decimal(-1.0);
+        }
+
+        bool isHit(CollisionBody* body) const {
+            return std::find(mHitBodies.begin(), mHitBodies.end(), body) != mHitBodies.end();
+        }
+};
+
+// Class TestSweepAndPrune
+/**
+ * Unit test for the sweep-and-prune broad-phase
+ */
+class TestSweepAndPrune : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultTestTreeAllocator mAllocator;
+
+        PhysicsCommon mPhysicsCommon;
+
+        // ---------- Methods ---------- //
+
+        /// Compute the sorted pairs of overlapping proxies with the sweep-and-prune
+        std::vector<std::pair<int, int>> computeSweepPairs(SweepAndPrune& sweepAndPrune, const std::vector<bool>& movedProxies) {
+
+            sweepAndPrune.sortEntries();
+
+            bool* moved = new bool[sweepAndPrune.getNbAllocatedProxies()];
+            for (int i=0; i < sweepAndPrune.getNbAllocatedProxies(); i++) {
+                moved[i] = i < static_cast<int>(movedProxies.size()) && movedProxies[i];
+            }
+
+            List<Pair<int32, int32>> pairs(mAllocator);
+            sweepAndPrune.reportAllOverlappingPairs(moved, 0, sweepAndPrune.getNbEntries(), pairs);
+            delete[] moved;
+
+            std::vector<std::pair<int, int>> result;
+            for (uint32 i=0; i < pairs.size(); i++) {
+                result.push_back(std::make_pair(std::min(pairs[i].first, pairs[i].second),
+                                                std::max(pairs[i].first, pairs[i].second)));
+            }
+            std::sort(result.begin(), result.end());
+
+            return result;
+        }
+
+        /// Compute the sorted pairs of overlapping proxies by testing all the pairs
+        std::vector<std::pair<int, int>> computeBruteForcePairs(const SweepAndPrune& sweepAndPrune, const std::vector<int>& proxies,
+                                                                const std::vector<bool>& movedProxies) {
+
+            std::vector<std::pair<int, int>> result;
+            for (uint32 i=0; i < proxies.size(); i++) {
+                for (uint32 j=i+1; j < proxies.size(); j++) {
+                    if ((movedProxies[proxies[i]] || movedProxies[proxies[j]]) &&
+                        sweepAndPrune.getFatAABB(proxies[i]).testCollision(sweepAndPrune.getFatAABB(proxies[j]))) {
+                        result.push_back(std::make_pair(std::min(proxies[i], proxies[j]), std::max(proxies[i], proxies[j])));
+                    }
+                }
+            }
+            std::sort(result.begin(), result.end());
+
+            return result;
+        }
+
+        /// Return a random AABB of a small box lying on a large floor
+        AABB createRandomBoxAABB() const {
+
+            const Vector3 center(decimal(std::rand() % 2000) * decimal(0.1), decimal(std::rand() % 10) * decimal(0.1),
+                                 decimal(std::rand() % 2000) * decimal(0.1));
+            const Vector3 halfExtents(decimal(0.5) + decimal(std::rand() % 10) * decimal(0.1), decimal(0.5),
+                                      decimal(0.5) + decimal(std::rand() % 10) * decimal(0.1));
+
+            return AABB(center - halfExtents, center + halfExtents);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestSweepAndPrune(const std::string& name): Test(name)  {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testBasicsMethods();
+            testOverlappingPairs();
+            testOverlappingAABB();
+            testRaycast();
+            testWorld();
+        }
+
+        void testBasicsMethods() {
+
+            SweepAndPrune sweepAndPrune(mAllocator);
+
+            int object1Data = 56;
+            int object2Data = 23;
+
+            AABB aabb1(Vector3(-6, 4, -3), Vector3(4, 8, 3));
+            AABB aabb2(Vector3(5, 2, -3), Vector3(10, 7, 3));
+            int32 object1Id = sweepAndPrune.addObject(aabb1, &object1Data);
+            int32 object2Id = sweepAndPrune.addObject(aabb2, &object2Data);
+
+            rp3d_test(sweepAndPrune.getNbProxies() == 2);
+            rp3d_test(sweepAndPrune.getFatAABB(object1Id).getMin() == aabb1.getMin());
+            rp3d_test(sweepAndPrune.getFatAABB(object2Id).getMax() == aabb2.getMax());
+            rp3d_test(*(static_cast<int*>(sweepAndPrune.getProxyDataPointer(object1Id))) == 56);
+            rp3d_test(*(static_cast<int*>(sweepAndPrune.getProxyDataPointer(object2Id))) == 23);
+
+            // The fat AABB is only updated if the new AABB is not inside it
+            rp3d_test(!sweepAndPrune.updateObject(object1Id, AABB(Vector3(-5, 5, -2), Vector3(3, 7, 2))));
+            rp3d_test(sweepAndPrune.getFatAABB(object1Id).getMin() == aabb1.getMin());
+            rp3d_test(sweepAndPrune.updateObject(object1Id, AABB(Vector3(-5, 5, -2), Vector3(3, 7, 2)), true));
+            rp3d_test(sweepAndPrune.getFatAABB(object1Id).getMin() == Vector3(-5, 5, -2));
+            rp3d_test(sweepAndPrune.updateObject(object2Id, AABB(Vector3(20, 2, -3), Vector3(25, 7, 3))));
+            rp3d_test(sweepAndPrune.getFatAABB(object2Id).getMin() == Vector3(20, 2, -3));
+
+            // The ID of a removed proxy is reused (and its moved flag is reset)
+            sweepAndPrune.setIsProxyMoved(object1Id, true);
+            rp3d_test(sweepAndPrune.getIsProxyMoved(object1Id));
+            rp3d_test(!sweepAndPrune.getIsProxyMoved(object2Id));
+            sweepAndPrune.removeObject(object1Id);
+            rp3d_test(sweepAndPrune.getNbProxies() == 1);
+            int32 object3Id = sweepAndPrune.addObject(aabb1, &object1Data);
+            rp3d_test(object3Id == object1Id);
+            rp3d_test(!sweepAndPrune.getIsProxyMoved(object3Id));
+
+            sweepAndPrune.sortEntries();
+            rp3d_test(sweepAndPrune.getNbEntries() == 2);
+        }
+
+        void testOverlappingPairs() {
+
+            std::srand(7);
+
+            SweepAndPrune sweepAndPrune(mAllocator);
+
+            std::vector<int> proxies;
+            for (int i=0; i < 500; i++) {
+                proxies.push_back(sweepAndPrune.addObject(createRandomBoxAABB(), nullptr));
+            }
+
+            // All the proxies have moved
+            std::vector<bool> allMoved(sweepAndPrune.getNbAllocatedProxies(), true);
+            rp3d_test(computeSweepPairs(sweepAndPrune, allMoved) == computeBruteForcePairs(sweepAndPrune, proxies, allMoved));
+
+            // Move a few proxies a little bit, remove some proxies and add some new ones
+            for (int step=0; step < 10; step++) {
+
+                std::vector<bool> moved(sweepAndPrune.getNbAllocatedProxies(), false);
+                for (uint32 i=0; i < proxies.size(); i += 3) {
+                    AABB aabb = sweepAndPrune.getFatAABB(proxies[i]);
+                    aabb.setMin(aabb.getMin() + Vector3(decimal(0.7), 0, decimal(-0.4)));
+                    aabb.setMax(aabb.getMax() + Vector3(decimal(0.7), 0, decimal(-0.4)));
+                    moved[proxies[i]] = sweepAndPrune.updateObject(proxies[i], aabb);
+                }
+
+                sweepAndPrune.removeObject(proxies.back());
+                proxies.pop_back();
+                sweepAndPrune.removeObject(proxies.front());
+                proxies.erase(proxies.begin());
+
+                const int32 newProxy = sweepAndPrune.addObject(createRandomBoxAABB(), nullptr);
+                proxies.push_back(newProxy);
+                moved.resize(sweepAndPrune.getNbAllocatedProxies(), false);
+                moved[newProxy] = true;
+
+                rp3d_test(computeSweepPairs(sweepAndPrune, moved) == computeBruteForcePairs(sweepAndPrune, proxies, moved));
+            }
+
+            // Spread the proxies along the z axis only so that the sweep axis changes
+            for (uint32 i=0; i < proxies.size(); i++) {
+                const decimal z = decimal(i) * decimal(3.0);
+                sweepAndPrune.updateObject(proxies[i], AABB(Vector3(-1, -1, z - 1), Vector3(1, 1, z + decimal(2.5))), true);
+            }
+            std::vector<bool> allMoved2(sweepAndPrune.getNbAllocatedProxies(), true);
+            std::vector<std::pair<int, int>> pairs = computeSweepPairs(sweepAndPrune, allMoved2);
+            rp3d_test(pairs == computeBruteForcePairs(sweepAndPrune, proxies, allMoved2));
+            rp3d_test(pairs.size() == proxies.size() - 1);
+        }
+
+        void testOverlappingAABB() {
+
+            SweepAndPrune sweepAndPrune(mAllocator);
+
+            int32 object1Id = sweepAndPrune.addObject(AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3)), nullptr);
+            int32 object2Id = sweepAndPrune.addObject(AABB(Vector3(5, 2, -3), Vector3(10, 7, 3)), nullptr);
+            int32 object3Id = sweepAndPrune.addObject(AABB(Vector3(-5, -7, -3), Vector3(5, -2, 3)), nullptr);
+
+            // The query must work with and without sorted entries
+            for (int i=0; i < 2; i++) {
+
+                List<int> overlappingProxies(mAllocator);
+                sweepAndPrune.reportAllShapesOverlappingWithAABB(AABB(Vector3(-4, -5, -2), Vector3(6, 5, 2)), overlappingProxies);
+                rp3d_test(overlappingProxies.size() == 3);
+
+                overlappingProxies.clear();
+                sweepAndPrune.reportAllShapesOverlappingWithAABB(AABB(Vector3(-8, 5, -3), Vector3(-2, 11, 3)), overlappingProxies);
+                rp3d_test(overlappingProxies.size() == 1);
+                rp3d_test(overlappingProxies[0] == object1Id);
+
+                overlappingProxies.clear();
+                sweepAndPrune.reportAllShapesOverlappingWithAABB(AABB(Vector3(7, -6, -3), Vector3(9, 5, 3)), overlappingProxies);
+                rp3d_test(overlappingProxies.size() == 1);
+                rp3d_test(overlappingProxies[0] == object2Id);
+
+                overlappingProxies.clear();
+                sweepAndPrune.reportAllShapesOverlappingWithAABB(AABB(Vector3(-3, -5, -2), Vector3(-2, -4, 2)), overlappingProxies);
+                rp3d_test(overlappingProxies.size() == 1);
+                rp3d_test(overlappingProxies[0] == object3Id);
+
+                sweepAndPrune.sortEntries();
+            }
+        }
+
+        void testRaycast() {
+
+            SweepAndPrune sweepAndPrune(mAllocator);
+
+            int32 object1Id = sweepAndPrune.addObject(AABB(Vector3(-6, 4, -3), Vector3(4, 8, 3)), nullptr);
+            int32 object2Id = sweepAndPrune.addObject(AABB(Vector3(5, 2, -3), Vector3(10, 7, 3)), nullptr);
+            int32 object3Id = sweepAndPrune.addObject(AABB(Vector3(-5, -7, -3), Vector3(5, -2, 3)), nullptr);
+
+            DynamicTreeRaycastCallback callback;
+            sweepAndPrune.raycast(Ray(Vector3(-20, 6, 0), Vector3(20, 6, 0)), callback);
+            rp3d_test(callback.isHit(object1Id));
+            rp3d_test(callback.isHit(object2Id));
+            rp3d_test(!callback.isHit(object3Id));
+
+            DynamicTreeRaycastCallback callback2;
+            sweepAndPrune.raycast(Ray(Vector3(0, -20, 0), Vector3(0, -10, 0)), callback2);
+            rp3d_test(callback2.mHitNodes.empty());
+        }
+
+        void testWorld() {
+
+            // Create a world that uses the sweep-and-prune for the non-static bodies
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = BroadPhaseAlgorithmType::SWEEP_AND_PRUNE;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            world->setIsGravityEnabled(false);
+
+            BoxShape* floorShape = mPhysicsCommon.createBoxShape(Vector3(100, 1, 100));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+
+            RigidBody* floor = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            floor->setType(BodyType::STATIC);
+            floor->addCollider(floorShape, Transform::identity());
+
+            RigidBody* box1 = world->createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            box1->addCollider(boxShape, Transform::identity());
+            RigidBody* box2 = world->createRigidBody(Transform(Vector3(decimal(0.5), decimal(0.5), 0), Quaternion::identity()));
+            box2->addCollider(boxShape, Transform::identity());
+            RigidBody* box3 = world->createRigidBody(Transform(Vector3(50, decimal(0.5), 0), Quaternion::identity()));
+            box3->addCollider(boxShape, Transform::identity());
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            rp3d_test(world->testOverlap(box1, floor));
+            rp3d_test(world->testOverlap(box1, box2));
+            rp3d_test(!world->testOverlap(box1, box3));
+            rp3d_test(world->testOverlap(box3, floor));
+
+            // Raycast against the colliders of the sweep-and-prune and of the static tree
+            SweepAndPruneWorldRaycastCallback raycastCallback;
+            world->raycast(Ray(Vector3(50, 10, 0), Vector3(50, -10, 0)), &raycastCallback);
+            rp3d_test(raycastCallback.isHit(box3));
+            rp3d_test(raycastCallback.isHit(floor));
+            rp3d_test(!raycastCallback.isHit(box1));
+
+            // A body that becomes dynamic is moved from the static tree into the sweep-and-prune
+            floor->setType(BodyType::KINEMATIC);
+            box1->setType(BodyType::STATIC);
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world->testOverlap(box1, floor));
+            rp3d_test(world->testOverlap(box1, box2));
+
+            world->destroyRigidBody(box2);
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world->testOverlap(box3, floor));
+
+            // A collider removed and replaced during the same frame reuses the same broad-phase ID
+            box3->removeCollider(box3->getCollider(0));
+            box3->addCollider(boxShape, Transform::identity());
+            box1->removeCollider(box1->getCollider(0));
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(world->testOverlap(box3, floor));
+            rp3d_test(!world->testOverlap(box1, floor));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(floorShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,694 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_WORLD_QUERIES_H
+#define TEST_WORLD_QUERIES_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/engine/PhysicsCommon.h>
+#include <reactphysics3d/engine/PhysicsWorld.h>
+#include <reactphysics3d/collision/TriangleMesh.h>
+#include <reactphysics3d/collision/TriangleVertexArray.h>
+#include <algorithm>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ClosestHitRaycastCallback
+/**
+ * Raycast callback that keeps the closest hit of a ray
+ */
+class ClosestHitRaycastCallback : public RaycastCallback {
+
+    public:
+
+        Collider* collider = nullptr;
+        decimal hitFraction = decimal(1.0);
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) override {
+
+            collider = info.collider;
+            hitFraction = info.hitFraction;
+
+            return info.hitFraction;
+        }
+};
+
+// Class AllHitsSweepCallback
+/**
+ * Sweep callback that keeps all the hits
+ */
+class AllHitsSweepCallback : public RaycastCallback {
+
+    public:
+
+        struct Hit {
+            Collider* collider;
+            decimal hitFraction;
+            Vector3 worldPoint;
+            Vector3 worldNormal;
+        };
+
+        std::vector<Hit> hits;
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) override {
+
+            hits.push_back({info.collider, info.hitFraction, info.worldPoint, info.worldNormal});
+
+            return decimal(1.0);
+        }
+
+        /// Return the hit with a given collider (or nullptr if there is no such hit)
+        const Hit* getHit(Collider* collider) const {
+            for (const Hit& hit : hits) {
+                if (hit.collider == collider) return &hit;
+            }
+            return nullptr;
+        }
+};
+
+// Class TestWorldQueries
+/**
+ * Unit test for the AABB, sphere and frustum queries, the batches of raycasts and the
+ * sweeps of shapes against the colliders of a world
+ */
+class TestWorldQueries : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        BoxShape* mBoxShape;
+
+        SphereShape* mSphereShape;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestWorldQueries(const std::string& name) : Test(name) {
+
+            mBoxShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+            mSphereShape = mPhysicsCommon.createSphereShape(1);
+        }
+
+        /// Destructor
+        virtual ~TestWorldQueries() {
+
+            mPhysicsCommon.destroyBoxShape(mBoxShape);
+            mPhysicsCommon.destroySphereShape(mSphereShape);
+        }
+
+        /// Run the tests
+        void run() {
+
+            testQueries(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE);
+            testQueries(BroadPhaseAlgorithmType::SWEEP_AND_PRUNE);
+            testRaycastBatch(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE, 1);
+            testRaycastBatch(BroadPhaseAlgorithmType::SWEEP_AND_PRUNE, 1);
+            testRaycastBatch(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE, 4);
+            testSweep(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE);
+            testSweep(BroadPhaseAlgorithmType::SWEEP_AND_PRUNE);
+            testOverlapShape(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE);
+            testOverlapShape(BroadPhaseAlgorithmType::SWEEP_AND_PRUNE);
+            testDistance(BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE);
+            testDistance(BroadPhaseAlgorithmType::SWEEP_AND_PRUNE);
+        }
+
+        /// Return true if a collider is in the first colliders of a buffer
+        bool isInBuffer(Collider* collider, Collider** colliders, uint nbColliders) const {
+            return std::find(colliders, colliders + nbColliders, collider) != colliders + nbColliders;
+        }
+
+        void testQueries(BroadPhaseAlgorithmType algorithmType) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = algorithmType;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // ---------- Create the colliders ---------- //
+
+            CollisionBody* body1 = world->createCollisionBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            Collider* collider1 = body1->addCollider(mBoxShape, Transform::identity());
+
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            Collider* collider2 = body2->addCollider(mSphereShape, Transform::identity());
+
+            CollisionBody* body3 = world->createCollisionBody(Transform(Vector3(0, 0, -20), Quaternion::identity()));
+            Collider* collider3 = body3->addCollider(mBoxShape, Transform::identity());
+            collider3->setCollisionCategoryBits(0x0002);
+
+            // Collider of a static body (in the static tree of the broad-phase)
+            RigidBody* body4 = world->createRigidBody(Transform(Vector3(0, -5, 0), Quaternion::identity()));
+            body4->setType(BodyType::STATIC);
+            Collider* collider4 = body4->addCollider(mBoxShape, Transform::identity());
+
+            CollisionBody* body5 = world->createCollisionBody(Transform(Vector3(50, 50, 50), Quaternion::identity()));
+            body5->addCollider(mBoxShape, Transform::identity());
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            Collider* colliders[8];
+
+            // ---------- AABB queries ---------- //
+
+            uint nbColliders = world->queryAABB(AABB(Vector3(-2, -2, -2), Vector3(2, 2, 2)), colliders, 8);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider1);
+
+            nbColliders = world->queryAABB(AABB(Vector3(-15, -10, -25), Vector3(15, 5, 5)), colliders, 8);
+            rp3d_test(nbColliders == 4);
+            rp3d_test(isInBuffer(collider1, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider2, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider3, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider4, colliders, nbColliders));
+
+            // Filter the colliders with their category
+            nbColliders = world->queryAABB(AABB(Vector3(-15, -10, -25), Vector3(15, 5, 5)), colliders, 8, 0x0001);
+            rp3d_test(nbColliders == 3);
+            rp3d_test(!isInBuffer(collider3, colliders, nbColliders));
+
+            // If the buffer is too small, only its size is filled but all the colliders are counted
+            colliders[1] = nullptr;
+            nbColliders = world->queryAABB(AABB(Vector3(-15, -10, -25), Vector3(15, 5, 5)), colliders, 1);
+            rp3d_test(nbColliders == 4);
+            rp3d_test(colliders[1] == nullptr);
+
+            nbColliders = world->queryAABB(AABB(Vector3(20, 20, 20), Vector3(30, 30, 30)), colliders, 8);
+            rp3d_test(nbColliders == 0);
+
+            // ---------- Sphere queries ---------- //
+
+            nbColliders = world->querySphere(Vector3(5, 0, 0), decimal(4.5), colliders, 8);
+            rp3d_test(nbColliders == 2);
+            rp3d_test(isInBuffer(collider1, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider2, colliders, nbColliders));
+
+            nbColliders = world->querySphere(Vector3(5, 0, 0), decimal(3.5), colliders, 8);
+            rp3d_test(nbColliders == 0);
+
+            // The AABB of the sphere overlaps with the first box but not the sphere itself
+            nbColliders = world->querySphere(Vector3(decimal(2.5), decimal(2.5), decimal(2.5)), 2, colliders, 8);
+            rp3d_test(nbColliders == 0);
+
+            // ---------- Frustum queries ---------- //
+
+            const Frustum frustum1 = Frustum::createPerspective(Transform(Vector3(0, 0, 10), Quaternion::identity()),
+                                                                PI / decimal(3.0), decimal(1.0), decimal(0.1), decimal(100.0));
+            nbColliders = world->queryFrustum(frustum1, colliders, 8);
+            rp3d_test(nbColliders == 3);
+            rp3d_test(isInBuffer(collider1, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider3, colliders, nbColliders));
+            rp3d_test(isInBuffer(collider4, colliders, nbColliders));
+
+            nbColliders = world->queryFrustum(frustum1, colliders, 8, 0x0001);
+            rp3d_test(nbColliders == 2);
+            rp3d_test(!isInBuffer(collider3, colliders, nbColliders));
+
+            // Frustum looking in the opposite direction
+            const Frustum frustum2 = Frustum::createPerspective(Transform(Vector3(0, 0, 10), Quaternion::fromEulerAngles(0, PI, 0)),
+                                                                PI / decimal(3.0), decimal(1.0), decimal(0.1), decimal(100.0));
+            nbColliders = world->queryFrustum(frustum2, colliders, 8);
+            rp3d_test(nbColliders == 0);
+
+            // ---------- Moved and removed colliders ---------- //
+
+            body2->setTransform(Transform(Vector3(1, 0, 0), Quaternion::identity()));
+            world->destroyCollisionBody(body1);
+            world->update(decimal(1.0) / decimal(60.0));
+
+            nbColliders = world->queryAABB(AABB(Vector3(-2, -2, -2), Vector3(2, 2, 2)), colliders, 8);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider2);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testRaycastBatch(BroadPhaseAlgorithmType algorithmType, uint nbWorkerThreads) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = algorithmType;
+            settings.nbWorkerThreads = nbWorkerThreads;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // ---------- Create the colliders ---------- //
+
+            // Grid of boxes and spheres
+            for (int i=0; i < 8; i++) {
+                for (int j=0; j < 8; j++) {
+                    CollisionBody* body = world->createCollisionBody(Transform(Vector3(i * 4 - 14, 0, j * 4 - 14), Quaternion::identity()));
+                    Collider* collider = body->addCollider((i + j) % 2 == 0 ? static_cast<CollisionShape*>(mBoxShape) :
+                                                                              static_cast<CollisionShape*>(mSphereShape),
+                                                           Transform::identity());
+                    collider->setCollisionCategoryBits(j == 0 ? 0x0002 : 0x0001);
+                }
+            }
+
+            // Floor of a static body (in the static tree of the broad-phase)
+            BoxShape* floorShape = mPhysicsCommon.createBoxShape(Vector3(20, 1, 20));
+            RigidBody* floorBody = world->createRigidBody(Transform(Vector3(0, -3, 0), Quaternion::identity()));
+            floorBody->setType(BodyType::STATIC);
+            Collider* floorCollider = floorBody->addCollider(floorShape, Transform::identity());
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            // ---------- Create the rays ---------- //
+
+            // Coherent rays pointing down on a grid (packets) followed by rays in all directions
+            const uint nbRays = 1200;
+            Ray* rays = static_cast<Ray*>(std::malloc(nbRays * sizeof(Ray)));
+            for (uint i=0; i < nbRays; i++) {
+                const decimal x = decimal(i % 40) - decimal(20.0);
+                const decimal z = decimal((i / 40) % 20) * decimal(2.0) - decimal(20.0);
+                const Vector3 origin(x, 10, z);
+                Vector3 target(x + decimal(0.1), -10, z);
+                if (i >= 800) {
+                    target = Vector3(std::sin(decimal(i)) * 40, std::cos(decimal(i * 3)) * 40, std::sin(decimal(i * 7)) * 40);
+                }
+                new (rays + i) Ray(origin, target, i % 50 == 0 ? decimal(0.4) : decimal(1.0));
+            }
+
+            RaycastInfo* hits = new RaycastInfo[nbRays];
+
+            // ---------- Compare with the single raycasts ---------- //
+
+            for (unsigned short mask : {static_cast<unsigned short>(0xFFFF), static_cast<unsigned short>(0x0002)}) {
+
+                uint nbHits = world->raycastBatch(rays, nbRays, hits, mask);
+
+                uint nbExpectedHits = 0;
+                bool isSameHits = true;
+                bool isFloorHit = false;
+                for (uint i=0; i < nbRays; i++) {
+
+                    ClosestHitRaycastCallback callback;
+                    world->raycast(rays[i], &callback, mask);
+
+                    if (callback.collider != nullptr) nbExpectedHits++;
+                    if (hits[i].collider != callback.collider) isSameHits = false;
+                    if (hits[i].collider == floorCollider) isFloorHit = true;
+                    if (callback.collider != nullptr) {
+                        if (!approxEqual(hits[i].hitFraction, callback.hitFraction, decimal(0.0001))) isSameHits = false;
+                        if (hits[i].body != callback.collider->getBody()) isSameHits = false;
+                    }
+                }
+
+                rp3d_test(isSameHits);
+                rp3d_test(nbHits == nbExpectedHits);
+                rp3d_test(nbHits > 0);
+                rp3d_test(isFloorHit == (mask == 0xFFFF));
+            }
+
+            // ---------- Empty batch ---------- //
+
+            rp3d_test(world->raycastBatch(rays, 0, hits) == 0);
+
+            delete[] hits;
+            std::free(rays);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(floorShape);
+        }
+
+        void testSweep(BroadPhaseAlgorithmType algorithmType) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = algorithmType;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // ---------- Create the colliders ---------- //
+
+            CollisionBody* body1 = world->createCollisionBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            Collider* collider1 = body1->addCollider(mBoxShape, Transform::identity());
+
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            Collider* collider2 = body2->addCollider(mSphereShape, Transform::identity());
+            collider2->setCollisionCategoryBits(0x0002);
+
+            // Collider of a static body (in the static tree of the broad-phase)
+            RigidBody* body3 = world->createRigidBody(Transform(Vector3(0, -5, 0), Quaternion::identity()));
+            body3->setType(BodyType::STATIC);
+            Collider* collider3 = body3->addCollider(mBoxShape, Transform::identity());
+
+            // Concave mesh with a single quad at y=-10
+            std::vector<Vector3> meshVertices = {Vector3(25, -10, -5), Vector3(35, -10, -5), Vector3(35, -10, 5), Vector3(25, -10, 5)};
+            std::vector<uint> meshIndices = {0, 2, 1, 0, 3, 2};
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray* meshVertexArray = new TriangleVertexArray(4, &(meshVertices[0]), sizeof(Vector3), 2, &(meshIndices[0]),
+                                                                           3 * sizeof(uint), vertexType,
+                                                                           TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            TriangleMesh* triangleMesh = mPhysicsCommon.createTriangleMesh();
+            triangleMesh->addSubpart(meshVertexArray);
+            ConcaveMeshShape* concaveMeshShape = mPhysicsCommon.createConcaveMeshShape(triangleMesh);
+            CollisionBody* body4 = world->createCollisionBody(Transform::identity());
+            Collider* collider4 = body4->addCollider(concaveMeshShape, Transform::identity());
+
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.5), decimal(1.0));
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            // ---------- Sphere sweeps ---------- //
+
+            AllHitsSweepCallback callback1;
+            world->sweep(mSphereShape, Transform(Vector3(-10, 0, 0), Quaternion::identity()),
+                         Transform(Vector3(10, 0, 0), Quaternion::identity()), &callback1);
+            rp3d_test(callback1.hits.size() == 2);
+            const AllHitsSweepCallback::Hit* hit = callback1.getHit(collider1);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.4), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldPoint, Vector3(-1, 0, 0), decimal(0.001)));
+            hit = callback1.getHit(collider2);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.9), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldPoint, Vector3(9, 0, 0), decimal(0.001)));
+
+            // The closest hit is kept when the callback clips the sweep
+            ClosestHitRaycastCallback callback2;
+            world->sweep(mSphereShape, Transform(Vector3(-10, 0, 0), Quaternion::identity()),
+                         Transform(Vector3(10, 0, 0), Quaternion::identity()), &callback2);
+            rp3d_test(callback2.collider == collider1);
+            rp3d_test(approxEqual(callback2.hitFraction, decimal(0.4), decimal(0.001)));
+
+            // Filter the colliders with their category
+            AllHitsSweepCallback callback3;
+            world->sweep(mSphereShape, Transform(Vector3(-10, 0, 0), Quaternion::identity()),
+                         Transform(Vector3(10, 0, 0), Quaternion::identity()), &callback3, 0x0002);
+            rp3d_test(callback3.hits.size() == 1);
+            rp3d_test(callback3.getHit(collider2) != nullptr);
+
+            // Sweep against the concave mesh
+            AllHitsSweepCallback callback4;
+            world->sweep(mSphereShape, Transform(Vector3(30, -5, 0), Quaternion::identity()),
+                         Transform(Vector3(30, -15, 0), Quaternion::identity()), &callback4);
+            rp3d_test(callback4.hits.size() == 1);
+            hit = callback4.getHit(collider4);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.4), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(0, 1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldPoint, Vector3(30, -10, 0), decimal(0.001)));
+
+            // Initial overlap
+            AllHitsSweepCallback callback5;
+            world->sweep(mSphereShape, Transform(Vector3(decimal(0.5), 0, 0), Quaternion::identity()),
+                         Transform(Vector3(decimal(0.5), 5, 0), Quaternion::identity()), &callback5);
+            rp3d_test(callback5.hits.size() == 1);
+            hit = callback5.getHit(collider1);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.0)));
+
+            // ---------- Box sweeps ---------- //
+
+            AllHitsSweepCallback callback6;
+            world->sweep(mBoxShape, Transform(Vector3(0, 10, 0), Quaternion::identity()),
+                         Transform(Vector3(0, -10, 0), Quaternion::identity()), &callback6);
+            rp3d_test(callback6.hits.size() == 2);
+            hit = callback6.getHit(collider1);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.4), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(0, 1, 0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldPoint.y, decimal(1.0), decimal(0.001)));
+            hit = callback6.getHit(collider3);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(0.65), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(0, 1, 0), decimal(0.001)));
+
+            // Rotated box (the orientation of the start transform is used)
+            const Quaternion rotation = Quaternion::fromEulerAngles(0, PI / decimal(4.0), 0);
+            AllHitsSweepCallback callback7;
+            world->sweep(mBoxShape, Transform(Vector3(-10, 0, 0), rotation), Transform(Vector3(10, 0, 0), rotation), &callback7, 0x0001);
+            hit = callback7.getHit(collider1);
+            rp3d_test(callback7.hits.size() == 1);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, (decimal(9.0) - std::sqrt(decimal(2.0))) / decimal(20.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+
+            // ---------- Capsule sweeps ---------- //
+
+            // The capsule passes above the box and the sphere
+            AllHitsSweepCallback callback8;
+            world->sweep(capsuleShape, Transform(Vector3(-10, 5, 0), Quaternion::identity()),
+                         Transform(Vector3(10, 5, 0), Quaternion::identity()), &callback8);
+            rp3d_test(callback8.hits.size() == 0);
+
+            // The bottom of the capsule hits the box
+            AllHitsSweepCallback callback9;
+            world->sweep(capsuleShape, Transform(Vector3(-10, decimal(1.2), 0), Quaternion::identity()),
+                         Transform(Vector3(10, decimal(1.2), 0), Quaternion::identity()), &callback9, 0x0001);
+            rp3d_test(callback9.hits.size() == 1);
+            hit = callback9.getHit(collider1);
+            rp3d_test(hit != nullptr);
+            rp3d_test(approxEqual(hit->hitFraction, decimal(8.5) / decimal(20.0), decimal(0.001)));
+            rp3d_test(approxEqual(hit->worldNormal, Vector3(-1, 0, 0), decimal(0.001)));
+
+            // ---------- Moving away ---------- //
+
+            AllHitsSweepCallback callback10;
+            world->sweep(mSphereShape, Transform(Vector3(-3, 0, 0), Quaternion::identity()),
+                         Transform(Vector3(-10, 0, 0), Quaternion::identity()), &callback10);
+            rp3d_test(callback10.hits.size() == 0);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyCapsuleShape(capsuleShape);
+            mPhysicsCommon.destroyConcaveMeshShape(concaveMeshShape);
+            mPhysicsCommon.destroyTriangleMesh(triangleMesh);
+            delete meshVertexArray;
+        }
+
+        void testOverlapShape(BroadPhaseAlgorithmType algorithmType) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = algorithmType;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // ---------- Create the colliders ---------- //
+
+            CollisionBody* body1 = world->createCollisionBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            Collider* collider1 = body1->addCollider(mBoxShape, Transform::identity());
+
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            Collider* collider2 = body2->addCollider(mSphereShape, Transform::identity());
+            collider2->setCollisionCategoryBits(0x0002);
+
+            // Concave mesh with a single quad at y=-10
+            std::vector<Vector3> meshVertices = {Vector3(25, -10, -5), Vector3(35, -10, -5), Vector3(35, -10, 5), Vector3(25, -10, 5)};
+            std::vector<uint> meshIndices = {0, 2, 1, 0, 3, 2};
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray* meshVertexArray = new TriangleVertexArray(4, &(meshVertices[0]), sizeof(Vector3), 2, &(meshIndices[0]),
+                                                                           3 * sizeof(uint), vertexType,
+                                                                           TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            TriangleMesh* triangleMesh = mPhysicsCommon.createTriangleMesh();
+            triangleMesh->addSubpart(meshVertexArray);
+            ConcaveMeshShape* concaveMeshShape = mPhysicsCommon.createConcaveMeshShape(triangleMesh);
+            CollisionBody* body3 = world->createCollisionBody(Transform::identity());
+            Collider* collider3 = body3->addCollider(concaveMeshShape, Transform::identity());
+
+            SphereShape* largeSphereShape = mPhysicsCommon.createSphereShape(decimal(6.0));
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            Collider* colliders[4];
+
+            // ---------- Convex shapes ---------- //
+
+            uint nbColliders = world->overlapShape(*mSphereShape, Transform(Vector3(decimal(1.5), 0, 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider1);
+
+            // The AABBs overlap but the sphere does not touch the corner of the box
+            nbColliders = world->overlapShape(*mSphereShape, Transform(Vector3(decimal(1.9), decimal(1.9), decimal(1.9)),
+                                                                       Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 0);
+
+            // Rotated box
+            const Quaternion rotation = Quaternion::fromEulerAngles(0, PI / decimal(4.0), 0);
+            nbColliders = world->overlapShape(*mBoxShape, Transform(Vector3(decimal(2.3), 0, 0), rotation), colliders, 4);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider1);
+            nbColliders = world->overlapShape(*mBoxShape, Transform(Vector3(decimal(2.3), 0, 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 0);
+
+            nbColliders = world->overlapShape(*largeSphereShape, Transform(Vector3(5, 0, 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 2);
+            rp3d_test((colliders[0] == collider1 && colliders[1] == collider2) ||
+                      (colliders[0] == collider2 && colliders[1] == collider1));
+
+            // Filter the colliders with their category
+            nbColliders = world->overlapShape(*largeSphereShape, Transform(Vector3(5, 0, 0), Quaternion::identity()), colliders, 4, 0x0002);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider2);
+
+            // The buffer is too small
+            colliders[1] = nullptr;
+            nbColliders = world->overlapShape(*largeSphereShape, Transform(Vector3(5, 0, 0), Quaternion::identity()), colliders, 1);
+            rp3d_test(nbColliders == 2);
+            rp3d_test(colliders[0] == collider1 || colliders[0] == collider2);
+            rp3d_test(colliders[1] == nullptr);
+
+            // ---------- Concave shapes ---------- //
+
+            // Convex shape against the concave mesh collider
+            nbColliders = world->overlapShape(*mSphereShape, Transform(Vector3(30, decimal(-10.5), 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider3);
+            nbColliders = world->overlapShape(*mSphereShape, Transform(Vector3(30, decimal(-11.5), 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 0);
+
+            // Concave mesh against the convex colliders (the quad is moved to y=0.5 over the box)
+            nbColliders = world->overlapShape(*concaveMeshShape, Transform(Vector3(-30, decimal(10.5), 0), Quaternion::identity()), colliders, 4);
+            rp3d_test(nbColliders == 1);
+            rp3d_test(colliders[0] == collider1);
+
+            // Two concave shapes are never reported as overlapping
+            nbColliders = world->overlapShape(*concaveMeshShape, Transform::identity(), colliders, 4);
+            rp3d_test(nbColliders == 0);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroySphereShape(largeSphereShape);
+            mPhysicsCommon.destroyConcaveMeshShape(concaveMeshShape);
+            mPhysicsCommon.destroyTriangleMesh(triangleMesh);
+            delete meshVertexArray;
+        }
+
+        void testDistance(BroadPhaseAlgorithmType algorithmType) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.broadPhaseAlgorithmType = algorithmType;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // ---------- Create the colliders ---------- //
+
+            CollisionBody* body1 = world->createCollisionBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            Collider* collider1 = body1->addCollider(mBoxShape, Transform::identity());
+
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            Collider* collider2 = body2->addCollider(mSphereShape, Transform::identity());
+            collider2->setCollisionCategoryBits(0x0002);
+
+            // Sphere overlapping with the box
+            CollisionBody* body3 = world->createCollisionBody(Transform(Vector3(decimal(1.5), 0, 0), Quaternion::identity()));
+            Collider* collider3 = body3->addCollider(mSphereShape, Transform::identity());
+            collider3->setCollisionCategoryBits(0x0004);
+
+            // Concave mesh with a single quad at y=-10
+            std::vector<Vector3> meshVertices = {Vector3(25, -10, -5), Vector3(35, -10, -5), Vector3(35, -10, 5), Vector3(25, -10, 5)};
+            std::vector<uint> meshIndices = {0, 2, 1, 0, 3, 2};
+            TriangleVertexArray::VertexDataType vertexType = sizeof(decimal) == 4 ? TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE :
+                                                                                    TriangleVertexArray::VertexDataType::VERTEX_DOUBLE_TYPE;
+            TriangleVertexArray* meshVertexArray = new TriangleVertexArray(4, &(meshVertices[0]), sizeof(Vector3), 2, &(meshIndices[0]),
+                                                                           3 * sizeof(uint), vertexType,
+                                                                           TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            TriangleMesh* triangleMesh = mPhysicsCommon.createTriangleMesh();
+            triangleMesh->addSubpart(meshVertexArray);
+            ConcaveMeshShape* concaveMeshShape = mPhysicsCommon.createConcaveMeshShape(triangleMesh);
+            CollisionBody* body4 = world->createCollisionBody(Transform::identity());
+            Collider* collider4 = body4->addCollider(concaveMeshShape, Transform::identity());
+            collider4->setCollisionCategoryBits(0x0008);
+
+            world->update(decimal(1.0) / decimal(60.0));
+
+            // ---------- Distance between two colliders ---------- //
+
+            DistanceInfo distanceInfo1;
+            rp3d_test(world->computeDistance(collider1, collider2, distanceInfo1));
+            rp3d_test(distanceInfo1.collider == collider2);
+            rp3d_test(approxEqual(distanceInfo1.distance, decimal(8.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo1.worldPoint1.x, decimal(1.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo1.worldPoint2, Vector3(9, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo1.separatingAxis.getUnit(), Vector3(-1, 0, 0), decimal(0.001)));
+
+            // Start again from the separating axis of the previous query
+            body2->setTransform(Transform(Vector3(10, 1, 0), Quaternion::identity()));
+            rp3d_test(world->computeDistance(collider1, collider2, distanceInfo1));
+            rp3d_test(approxEqual(distanceInfo1.distance, decimal(8.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo1.worldPoint2, Vector3(9, 1, 0), decimal(0.001)));
+            body2->setTransform(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+
+            // Overlapping colliders
+            DistanceInfo distanceInfo2;
+            rp3d_test(!world->computeDistance(collider1, collider3, distanceInfo2));
+            rp3d_test(approxEqual(distanceInfo2.distance, decimal(0.0)));
+
+            // ---------- Closest collider to a shape ---------- //
+
+            DistanceInfo distanceInfo3;
+            rp3d_test(world->findClosestCollider(*mSphereShape, Transform(Vector3(4, 0, 0), Quaternion::identity()), decimal(10.0),
+                                                 distanceInfo3, 0x0003));
+            rp3d_test(distanceInfo3.collider == collider1);
+            rp3d_test(approxEqual(distanceInfo3.distance, decimal(2.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo3.worldPoint1, Vector3(3, 0, 0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo3.worldPoint2.x, decimal(1.0), decimal(0.001)));
+
+            rp3d_test(world->findClosestCollider(*mSphereShape, Transform(Vector3(7, 0, 0), Quaternion::identity()), decimal(10.0),
+                                                 distanceInfo3, 0x0003));
+            rp3d_test(distanceInfo3.collider == collider2);
+            rp3d_test(approxEqual(distanceInfo3.distance, decimal(1.0), decimal(0.001)));
+
+            // No collider within the maximum distance
+            rp3d_test(!world->findClosestCollider(*mSphereShape, Transform(Vector3(4, 0, 0), Quaternion::identity()), decimal(1.0),
+                                                  distanceInfo3, 0x0003));
+            rp3d_test(distanceInfo3.collider == nullptr);
+
+            // Rotated box
+            const Quaternion rotation = Quaternion::fromEulerAngles(0, PI / decimal(4.0), 0);
+            rp3d_test(world->findClosestCollider(*mBoxShape, Transform(Vector3(4, 0, 0), rotation), decimal(10.0), distanceInfo3, 0x0001));
+            rp3d_test(distanceInfo3.collider == collider1);
+            rp3d_test(approxEqual(distanceInfo3.distance, decimal(3.0) - std::sqrt(decimal(2.0)), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo3.worldPoint1.x, decimal(4.0) - std::sqrt(decimal(2.0)), decimal(0.001)));
+
+            // Overlapping collider
+            rp3d_test(world->findClosestCollider(*mSphereShape, Transform(Vector3(2, 0, 0), Quaternion::identity()), decimal(10.0),
+                                                 distanceInfo3));
+            rp3d_test(distanceInfo3.collider == collider1 || distanceInfo3.collider == collider3);
+            rp3d_test(approxEqual(distanceInfo3.distance, decimal(0.0)));
+
+            // Concave mesh
+            rp3d_test(world->findClosestCollider(*mSphereShape, Transform(Vector3(30, -7, 0), Quaternion::identity()), decimal(5.0),
+                                                 distanceInfo3));
+            rp3d_test(distanceInfo3.collider == collider4);
+            rp3d_test(approxEqual(distanceInfo3.distance, decimal(2.0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo3.worldPoint1, Vector3(30, -8, 0), decimal(0.001)));
+            rp3d_test(approxEqual(distanceInfo3.worldPoint2, Vector3(30, -10, 0), decimal(0.001)));
+            rp3d_test(!world->findClosestCollider(*mSphereShape, Transform(Vector3(30, -7, 0), Quaternion::identity()), decimal(1.5),
+                                                  distanceInfo3));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyConcaveMeshShape(concaveMeshShape);
+            mPhysicsCommon.destroyTriangleMesh(triangleMesh);
+            delete meshVertexArray;
+        }
+ };
+
+}
+
+#endif
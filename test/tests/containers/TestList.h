@@ -226,6 +226,22 @@ class TestList : public Test {
             list7.add("new");
             rp3d_test(list7.size() == 1);
             rp3d_test(list7[0] == "new");
+
+            // ----- Test addWithoutInit() ----- //
+
+            List<int> list8(mAllocator);
+            list8.addWithoutInit(2);
+            rp3d_test(list8.size() == 2);
+            rp3d_test(list8.capacity() >= 2);
+
+            // The cleared list keeps its capacity and must grow if more elements are added
+            list8.clear();
+            list8.addWithoutInit(5);
+            rp3d_test(list8.size() == 5);
+            rp3d_test(list8.capacity() >= 5);
+            list8.addWithoutInit(1);
+            rp3d_test(list8.size() == 6);
+            rp3d_test(list8.capacity() >= 6);
         }
 
         void testAssignment() {